@@ -80,6 +80,25 @@ static const wxChar RealtimeConnectivity[] = wxT( "RealtimeConnectivity" );
  */
 static const wxChar CoroutineStackSize[] = wxT( "CoroutineStackSize" );
 
+/**
+ * Path of a file to which the interactive router appends collision query counters
+ * (queries, candidates, shape collision calls by type, branch depth, time per phase)
+ * at the end of each routing session, one JSON object per line.
+ */
+static const wxChar RouterStatsFile[] = wxT( "RouterStatsFile" );
+
+/**
+ * Show the same router counters over the canvas while routing, updated after each move.
+ */
+static const wxChar ShowRouterStats[] = wxT( "ShowRouterStats" );
+
+/**
+ * Show frame timings (per drawing phase), items drawn per layer, the cache hit rate and a
+ * histogram of the recent frame times over the drawing canvases.  The same figures are
+ * written to the KICAD_FRAME_STATS trace.
+ */
+static const wxChar ShowFrameStats[] = wxT( "ShowFrameStats" );
+
 } // namespace KEYS
 
 
@@ -160,6 +179,9 @@ ADVANCED_CFG::ADVANCED_CFG()
     m_EnableUsePadProperty = false;
     m_realTimeConnectivity = true;
     m_coroutineStackSize = AC_STACK::default_stack;
+    m_RouterStatsFile = wxEmptyString;
+    m_ShowRouterStats = false;
+    m_ShowFrameStats = false;
 
     loadFromConfigFile();
 }
@@ -203,6 +225,15 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
                                                &m_coroutineStackSize, AC_STACK::default_stack,
                                                AC_STACK::min_stack, AC_STACK::max_stack ) );
 
+    configParams.push_back( new PARAM_CFG_WXSTRING( true, AC_KEYS::RouterStatsFile,
+                                                    &m_RouterStatsFile, wxEmptyString ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::ShowRouterStats,
+                                                &m_ShowRouterStats, false ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::ShowFrameStats,
+                                                &m_ShowFrameStats, false ) );
+
     wxConfigLoadSetups( &aCfg, configParams );
 
     for( auto param : configParams )
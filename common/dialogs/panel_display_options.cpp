@@ -55,9 +55,8 @@ bool PANEL_DISPLAY_OPTIONS::TransferDataFromWindow()
 {
     m_galOptsPanel->TransferDataFromWindow();
 
-    // refresh view
+    // The GAL options (grid and cursor) do not change the items, so there is nothing to recache
     KIGFX::VIEW* view = m_frame->GetCanvas()->GetView();
-    view->RecacheAllItems();
     view->MarkTargetDirty( KIGFX::TARGET_NONCACHED );
     m_frame->GetCanvas()->Refresh();
 
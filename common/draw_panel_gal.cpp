@@ -24,13 +24,16 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <advanced_config.h>
 #include <confirm.h>
 #include <eda_draw_frame.h>
 #include <kiface_i.h>
 #include <macros.h>
 #include <settings/app_settings.h>
+#include <trace_helpers.h>
 
 #include <class_draw_panel_gal.h>
+#include <view/frame_stats.h>
 #include <view/view.h>
 #include <view/wx_view_controls.h>
 #include <painter.h>
@@ -42,9 +45,7 @@
 #include <tool/tool_dispatcher.h>
 #include <tool/tool_manager.h>
 
-#ifdef PROFILE
 #include <profile.h>
-#endif /* PROFILE */
 
 
 EDA_DRAW_PANEL_GAL::EDA_DRAW_PANEL_GAL( wxWindow* aParentWindow, wxWindowID aWindowId,
@@ -115,6 +116,9 @@ EDA_DRAW_PANEL_GAL::EDA_DRAW_PANEL_GAL( wxWindow* aParentWindow, wxWindowID aWin
     m_drawing = false;
     m_drawingEnabled = false;
 
+    if( ADVANCED_CFG::GetCfg().m_ShowFrameStats )
+        m_frameStats.reset( new KIGFX::FRAME_STATS );
+
     // Set up timer that prevents too frequent redraw commands
     m_refreshTimer.SetOwner( this );
     Connect( m_refreshTimer.GetId(), wxEVT_TIMER,
@@ -180,6 +184,9 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
     PROF_COUNTER totalRealTime;
 #endif /* PROFILE */
 
+    PROF_COUNTER               frameTimer;
+    KIGFX::FRAME_STATS::FRAME  frame;
+
     wxASSERT( m_painter );
 
     m_drawing = true;
@@ -189,34 +196,57 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
     {
         m_view->UpdateItems();
 
-        KIGFX::GAL_DRAWING_CONTEXT ctx( m_gal );
+        frame.m_update = m_view->GetDrawStats().m_updateTime;
+        frame.m_paint = m_view->GetDrawStats().m_paintTime;
+        frame.m_upload = m_view->GetDrawStats().m_uploadTime;
 
-        m_gal->SetClearColor( settings->GetBackgroundColor() );
-        m_gal->SetGridColor( settings->GetGridColor() );
-        m_gal->SetCursorColor( settings->GetCursorColor() );
+        {
+            KIGFX::GAL_DRAWING_CONTEXT ctx( m_gal );
 
-        // TODO: find why ClearScreen() must be called here in opengl mode
-        // and only if m_view->IsDirty() in Cairo mode to avoid distaly artifacts
-        // when moving the mouse cursor
-        if( m_backend == GAL_TYPE_OPENGL )
-            m_gal->ClearScreen();
+            m_gal->SetClearColor( settings->GetBackgroundColor() );
+            m_gal->SetGridColor( settings->GetGridColor() );
+            m_gal->SetCursorColor( settings->GetCursorColor() );
 
-        if( m_view->IsDirty() )
-        {
-            if( m_backend != GAL_TYPE_OPENGL &&     // Already called in opengl
-                m_view->IsTargetDirty( KIGFX::TARGET_NONCACHED ) )
+            // The statistics are drawn over the overlay, which has to be cleared for them
+            if( m_frameStats )
+                m_view->MarkTargetDirty( KIGFX::TARGET_OVERLAY );
+
+            // TODO: find why ClearScreen() must be called here in opengl mode
+            // and only if m_view->IsDirty() in Cairo mode to avoid distaly artifacts
+            // when moving the mouse cursor
+            if( m_backend == GAL_TYPE_OPENGL )
                 m_gal->ClearScreen();
 
-            m_view->ClearTargets();
+            if( m_view->IsDirty() )
+            {
+                if( m_backend != GAL_TYPE_OPENGL &&     // Already called in opengl
+                    m_view->IsTargetDirty( KIGFX::TARGET_NONCACHED ) )
+                    m_gal->ClearScreen();
+
+                m_view->ClearTargets();
 
-            // Grid has to be redrawn only when the NONCACHED target is redrawn
-            if( m_view->IsTargetDirty( KIGFX::TARGET_NONCACHED ) )
-                m_gal->DrawGrid();
+                // Grid has to be redrawn only when the NONCACHED target is redrawn
+                if( m_view->IsTargetDirty( KIGFX::TARGET_NONCACHED ) )
+                    m_gal->DrawGrid();
 
-            m_view->Redraw();
+                m_view->Redraw();
+                frame.m_draw = m_view->GetDrawStats().m_drawTime;
+            }
+
+            if( m_frameStats )
+            {
+                m_gal->SetTarget( KIGFX::TARGET_OVERLAY );
+                m_frameStats->Draw( m_gal, m_view );
+            }
+
+            m_gal->DrawCursor( m_viewControls->GetCursorPosition() );
+
+            // Start the compositing lap
+            frameTimer.msecs( true );
         }
 
-        m_gal->DrawCursor( m_viewControls->GetCursorPosition() );
+        // Finishing the drawing composites the targets and shows the frame
+        frame.m_composite = frameTimer.msecs( true );
     }
     catch( std::runtime_error& err )
     {
@@ -234,6 +264,13 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
     wxLogTrace( "GAL_PROFILE", "EDA_DRAW_PANEL_GAL::onPaint(): %.1f ms", totalRealTime.msecs() );
 #endif /* PROFILE */
 
+    if( m_frameStats )
+    {
+        frame.m_total = frameTimer.msecs();
+        m_frameStats->AddFrame( frame, m_view->GetDrawStats() );
+        wxLogTrace( traceFrameStats, "%s", m_frameStats->Format() );
+    }
+
     m_lastRefresh = wxGetLocalTimeMillis();
     m_drawing = false;
 }
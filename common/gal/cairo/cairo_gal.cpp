@@ -932,14 +932,26 @@ void CAIRO_GAL_BASE::EnableDepthTest( bool aEnabled )
 }
 
 
-void CAIRO_GAL_BASE::resetContext()
+cairo_t* CAIRO_GAL_BASE::GetTargetContext()
+{
+    storePath();
+
+    if( currentContext )
+        cairo_surface_flush( cairo_get_target( currentContext ) );
+
+    return currentContext;
+}
+
+
+void CAIRO_GAL_BASE::resetContext( bool aClear )
 {
     for( auto imageSurface : imageSurfaces )
         cairo_surface_destroy( imageSurface );
 
     imageSurfaces.clear();
 
-    ClearScreen();
+    if( aClear )
+        ClearScreen();
 
     // Compute the world <-> screen transformations
     ComputeWorldScreenMatrix();
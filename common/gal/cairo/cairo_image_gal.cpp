@@ -0,0 +1,116 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#include <gal/cairo/cairo_image_gal.h>
+
+using namespace KIGFX;
+
+
+CAIRO_IMAGE_GAL::CAIRO_IMAGE_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions, int aWidth,
+                                  int aHeight ) :
+        CAIRO_GAL_BASE( aDisplayOptions )
+{
+    screenSize = VECTOR2I( aWidth, aHeight );
+    allocateSurface();
+}
+
+
+void CAIRO_IMAGE_GAL::ResizeScreen( int aWidth, int aHeight )
+{
+    CAIRO_GAL_BASE::ResizeScreen( aWidth, aHeight );
+    allocateSurface();
+}
+
+
+bool CAIRO_IMAGE_GAL::WritePng( const std::string& aFileName )
+{
+    cairo_surface_flush( surface );
+
+    return cairo_surface_write_to_png( surface, aFileName.c_str() ) == CAIRO_STATUS_SUCCESS;
+}
+
+
+bool CAIRO_IMAGE_GAL::AttachToArea( cairo_t* aTarget, const GAL& aView, const BOX2I& aArea )
+{
+    cairo_surface_t* image = cairo_get_target( aTarget );
+
+    if( cairo_surface_get_type( image ) != CAIRO_SURFACE_TYPE_IMAGE
+            || cairo_image_surface_get_format( image ) != CAIRO_FORMAT_ARGB32 )
+    {
+        return false;
+    }
+
+    BOX2I bounds( VECTOR2I( 0, 0 ), VECTOR2I( cairo_image_surface_get_width( image ),
+                                              cairo_image_surface_get_height( image ) ) );
+    BOX2I area = bounds.Intersect( aArea );
+
+    if( area.GetWidth() <= 0 || area.GetHeight() <= 0 )
+        return false;
+
+    if( context )
+        cairo_destroy( context );
+
+    if( surface )
+        cairo_surface_destroy( surface );
+
+    // A surface over the pixels of the area: nothing has to be copied back
+    int            stride = cairo_image_surface_get_stride( image );
+    unsigned char* data = cairo_image_surface_get_data( image ) + area.GetY() * stride
+                          + area.GetX() * 4;
+
+    surface = cairo_image_surface_create_for_data( data, CAIRO_FORMAT_ARGB32, area.GetWidth(),
+                                                   area.GetHeight(), stride );
+    context = currentContext = cairo_create( surface );
+    cairo_set_antialias( context, cairo_get_antialias( aTarget ) );
+
+    // The same view, looking at the world point shown in the middle of the area
+    VECTOR2D centre = VECTOR2D( area.GetPosition() ) + 0.5 * VECTOR2D( area.GetSize() );
+
+    screenSize = area.GetSize();
+    SetWorldUnitLength( aView.GetWorldUnitLength() );
+    SetScreenDPI( aView.GetScreenDPI() );
+    SetZoomFactor( aView.GetZoomFactor() );
+    SetRotation( aView.GetRotation() );
+    SetFlip( aView.IsFlippedX(), aView.IsFlippedY() );
+    SetLookAtPoint( aView.GetScreenWorldMatrix() * centre );
+
+    resetContext( false );
+
+    return true;
+}
+
+
+void CAIRO_IMAGE_GAL::allocateSurface()
+{
+    if( context )
+        cairo_destroy( context );
+
+    if( surface )
+        cairo_surface_destroy( surface );
+
+    surface = cairo_image_surface_create( CAIRO_FORMAT_ARGB32, std::max( screenSize.x, 1 ),
+                                          std::max( screenSize.y, 1 ) );
+    context = currentContext = cairo_create( surface );
+
+    resetContext();
+}
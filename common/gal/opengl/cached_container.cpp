@@ -124,7 +124,7 @@ VERTEX* CACHED_CONTAINER::Allocate( unsigned int aSize )
         }
     }
 
-    VERTEX* reserved = &m_vertices[m_chunkOffset + itemSize];
+    VERTEX* reserved = GetVertices( m_chunkOffset + itemSize );
 
     // Now the item officially possesses the memory chunk
     m_item->setSize( newSize );
@@ -225,21 +225,7 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
     // Is there enough space to store vertices?
     if( newChunk == m_freeChunks.end() )
     {
-        bool result;
-
-        // Would it be enough to double the current space?
-        if( aSize < m_freeSpace + m_currentSize )
-        {
-            // Yes: exponential growing
-            result = defragmentResize( m_currentSize * 2 );
-        }
-        else
-        {
-            // No: grow to the nearest greater power of 2
-            result = defragmentResize( pow( 2, ceil( log2( m_currentSize * 2 + aSize ) ) ) );
-        }
-
-        if( !result )
+        if( !grow( aSize ) )
             return false;
 
         newChunk = m_freeChunks.lower_bound( aSize );
@@ -251,7 +237,10 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
     unsigned int newChunkOffset = getChunkOffset( *newChunk );
 
     assert( newChunkSize >= aSize );
-    assert( newChunkOffset < m_currentSize );
+
+    // Remove the new allocated chunk from the free space pool, before the previous chunk is
+    // freed (it may be merged with the new one)
+    removeFreeChunk( newChunk );
 
     // Check if the item was previously stored in the container
     if( itemSize > 0 )
@@ -261,16 +250,13 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
                     (int) m_item, oldChunkOffset, newChunkOffset );
 #endif
         // The item was reallocated, so we have to copy all the old data to the new place
-        memcpy( &m_vertices[newChunkOffset], &m_vertices[m_chunkOffset], itemSize * VERTEX_SIZE );
+        memcpy( GetVertices( newChunkOffset ), GetVertices( m_chunkOffset ),
+                itemSize * VERTEX_SIZE );
 
         // Free the space used by the previous chunk
         addFreeChunk( m_chunkOffset, m_chunkSize );
     }
 
-    // Remove the new allocated chunk from the free space pool
-    m_freeChunks.erase( newChunk );
-    m_freeSpace -= newChunkSize;
-
     m_chunkSize = newChunkSize;
     m_chunkOffset = newChunkOffset;
 
@@ -383,6 +369,13 @@ void CACHED_CONTAINER::addFreeChunk( unsigned int aOffset, unsigned int aSize )
 }
 
 
+void CACHED_CONTAINER::removeFreeChunk( FREE_CHUNK_MAP::iterator aChunk )
+{
+    m_freeSpace -= getChunkSize( *aChunk );
+    m_freeChunks.erase( aChunk );
+}
+
+
 void CACHED_CONTAINER::showFreeChunks()
 {
 #ifdef __WXDEBUG__
@@ -29,6 +29,7 @@
 #include <gal/opengl/utils.h>
 
 #include <list>
+#include <cmath>
 
 #ifdef __WXDEBUG__
 #include <wx/log.h>
@@ -95,6 +96,20 @@ void CACHED_CONTAINER_GPU::Unmap()
 }
 
 
+bool CACHED_CONTAINER_GPU::grow( unsigned int aSize )
+{
+    // Would it be enough to double the current space?
+    if( aSize < m_freeSpace + m_currentSize )
+    {
+        // Yes: exponential growing
+        return defragmentResize( m_currentSize * 2 );
+    }
+
+    // No: grow to the nearest greater power of 2
+    return defragmentResize( pow( 2, ceil( log2( m_currentSize * 2 + aSize ) ) ) );
+}
+
+
 bool CACHED_CONTAINER_GPU::defragmentResize( unsigned int aNewSize )
 {
     if( !m_useCopyBuffer )
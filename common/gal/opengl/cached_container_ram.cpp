@@ -29,8 +29,12 @@
 #include <gal/opengl/utils.h>
 
 #include <confirm.h>
-#include <list>
+#include <algorithm>
 #include <cassert>
+#include <climits>
+#include <cstring>
+#include <iterator>
+#include <list>
 
 #ifdef __WXDEBUG__
 #include <wx/log.h>
@@ -40,19 +44,33 @@
 using namespace KIGFX;
 
 CACHED_CONTAINER_RAM::CACHED_CONTAINER_RAM( unsigned int aSize ) :
-    CACHED_CONTAINER( aSize ), m_verticesBuffer( 0 )
+    CACHED_CONTAINER( aSize )
 {
-    glGenBuffers( 1, &m_verticesBuffer );
-    checkGlError( "generating vertices buffer" );
+    // The base container is a single free chunk, make it a segment instead
+    m_freeChunks.clear();
+    m_currentSize = 0;
+    m_freeSpace = 0;
 
-    m_vertices = static_cast<VERTEX*>( malloc( aSize * VERTEX_SIZE ) );
+    if( !grow( aSize ) )
+        m_failed = true;
 }
 
 
 CACHED_CONTAINER_RAM::~CACHED_CONTAINER_RAM()
 {
-    glDeleteBuffers( 1, &m_verticesBuffer );
-    free( m_vertices );
+    for( const std::unique_ptr<SEGMENT>& segment : m_segments )
+    {
+        glDeleteBuffers( 1, &segment->m_buffer );
+        free( segment->m_vertices );
+    }
+}
+
+
+void CACHED_CONTAINER_RAM::Map()
+{
+    // No item is being modified between updates, so it is safe to move the stored data
+    compactSparseSegment();
+    releaseEmptySegments();
 }
 
 
@@ -61,56 +79,301 @@ void CACHED_CONTAINER_RAM::Unmap()
     if( !m_dirty )
         return;
 
-    // Upload vertices coordinates and shader types to GPU memory
-    glBindBuffer( GL_ARRAY_BUFFER, m_verticesBuffer );
-    checkGlError( "binding vertices buffer" );
-    glBufferData( GL_ARRAY_BUFFER, m_maxIndex * VERTEX_SIZE, m_vertices, GL_STREAM_DRAW );
-    checkGlError( "transferring vertices" );
+    // Upload vertices coordinates and shader types to GPU memory, only for modified segments
+    for( const std::unique_ptr<SEGMENT>& segment : m_segments )
+    {
+        if( !segment->m_dirty )
+            continue;
+
+        glBindBuffer( GL_ARRAY_BUFFER, segment->m_buffer );
+        checkGlError( "binding vertices buffer" );
+        glBufferData( GL_ARRAY_BUFFER, segment->m_size * VERTEX_SIZE, segment->m_vertices,
+                      GL_STREAM_DRAW );
+        checkGlError( "transferring vertices" );
+        segment->m_dirty = false;
+    }
+
     glBindBuffer( GL_ARRAY_BUFFER, 0 );
     checkGlError( "unbinding vertices buffer" );
 }
 
 
-bool CACHED_CONTAINER_RAM::defragmentResize( unsigned int aNewSize )
+void CACHED_CONTAINER_RAM::Clear()
 {
-    wxLogTrace( "GAL_CACHED_CONTAINER",
-            wxT( "Resizing & defragmenting container (memcpy) from %d to %d" ),
-            m_currentSize, aNewSize );
+    CACHED_CONTAINER::Clear();
+
+    // Each segment is a single free chunk now
+    m_freeChunks.clear();
+    m_freeChunkOffsets.clear();
+
+    for( const std::unique_ptr<SEGMENT>& segment : m_segments )
+    {
+        m_freeChunkOffsets[segment->m_offset] =
+                m_freeChunks.insert( std::make_pair( segment->m_size, segment->m_offset ) );
+        segment->m_freeSpace = segment->m_size;
+    }
+}
+
+
+bool CACHED_CONTAINER_RAM::grow( unsigned int aSize )
+{
+    unsigned int pageCount = std::max( 1u, ( aSize + PAGE_SIZE - 1 ) / PAGE_SIZE );
+    unsigned int firstPage = m_pages.size();
+
+    // Reuse the first range of unused pages that is long enough
+    for( unsigned int page = 0, freePages = 0; page < m_pages.size(); ++page )
+    {
+        freePages = m_pages[page] ? 0 : freePages + 1;
+
+        if( freePages == pageCount )
+        {
+            firstPage = page + 1 - pageCount;
+            break;
+        }
+    }
+
+    // Offsets are stored as unsigned int
+    if( (unsigned long long) ( firstPage + pageCount ) * PAGE_SIZE > UINT_MAX )
+        return false;
+
+    std::unique_ptr<SEGMENT> segment( new SEGMENT );
+
+    segment->m_size = pageCount * PAGE_SIZE;
+    segment->m_offset = firstPage * PAGE_SIZE;
+    segment->m_freeSpace = 0;
+    segment->m_dirty = true;
+    segment->m_vertices = static_cast<VERTEX*>( malloc( segment->m_size * VERTEX_SIZE ) );
 
-    // No shrinking if we cannot fit all the data
-    if( usedSpace() > aNewSize )
+    if( !segment->m_vertices )
         return false;
 
+    glGenBuffers( 1, &segment->m_buffer );
+    checkGlError( "generating vertices buffer" );
+
+    wxLogTrace( "GAL_CACHED_CONTAINER",
+                wxT( "Adding a segment of %u vertices at %u" ),
+                segment->m_size, segment->m_offset );
+
+    if( m_pages.size() < firstPage + pageCount )
+        m_pages.resize( firstPage + pageCount, nullptr );
+
+    std::fill( m_pages.begin() + firstPage, m_pages.begin() + firstPage + pageCount,
+               segment.get() );
+
+    m_currentSize += segment->m_size;
+    addFreeChunk( segment->m_offset, segment->m_size );
+    m_segments.push_back( std::move( segment ) );
+
+    return true;
+}
+
+
+void CACHED_CONTAINER_RAM::addFreeChunk( unsigned int aOffset, unsigned int aSize )
+{
+    SEGMENT* segment = m_pages[aOffset / PAGE_SIZE];
+
+    // Offsets may be greater than the container size, as there may be unused pages
+    assert( aOffset + aSize <= segment->m_offset + segment->m_size );
+    assert( aSize > 0 );
+
+    m_freeSpace += aSize;
+    segment->m_freeSpace += aSize;
+
+    // Merge the chunk with the free chunks next to it in the same segment, otherwise items
+    // larger than the freed ones would not fit in the free space and the container would grow
+    auto next = m_freeChunkOffsets.lower_bound( aOffset );
+
+    if( next != m_freeChunkOffsets.end() && next->first == aOffset + aSize
+            && next->first < segment->m_offset + segment->m_size )
+    {
+        aSize += getChunkSize( *next->second );
+        m_freeChunks.erase( next->second );
+        next = m_freeChunkOffsets.erase( next );
+    }
+
+    if( next != m_freeChunkOffsets.begin() )
+    {
+        auto         prev = std::prev( next );
+        unsigned int prevSize = getChunkSize( *prev->second );
+
+        if( prev->first + prevSize == aOffset && prev->first >= segment->m_offset )
+        {
+            aOffset = prev->first;
+            aSize += prevSize;
+            m_freeChunks.erase( prev->second );
+            m_freeChunkOffsets.erase( prev );
+        }
+    }
+
+    m_freeChunkOffsets[aOffset] = m_freeChunks.insert( std::make_pair( aSize, aOffset ) );
+}
+
+
+void CACHED_CONTAINER_RAM::removeFreeChunk( FREE_CHUNK_MAP::iterator aChunk )
+{
+    m_pages[getChunkOffset( *aChunk ) / PAGE_SIZE]->m_freeSpace -= getChunkSize( *aChunk );
+    m_freeChunkOffsets.erase( getChunkOffset( *aChunk ) );
+    CACHED_CONTAINER::removeFreeChunk( aChunk );
+}
+
+
+void CACHED_CONTAINER_RAM::releaseEmptySegments()
+{
+    std::set<SEGMENT*> released;
+    bool               keptOne = false;
+
+    for( const std::unique_ptr<SEGMENT>& segment : m_segments )
+    {
+        if( segment->m_freeSpace < segment->m_size )
+            continue;
+
+        if( keptOne )
+            released.insert( segment.get() );
+        else
+            keptOne = true;
+    }
+
+    if( released.empty() )
+        return;
+
+    // The free chunks of released segments are not available anymore
+    for( FREE_CHUNK_MAP::iterator it = m_freeChunks.begin(); it != m_freeChunks.end(); )
+    {
+        if( released.count( m_pages[getChunkOffset( *it ) / PAGE_SIZE] ) )
+        {
+            m_freeChunkOffsets.erase( getChunkOffset( *it ) );
+            it = m_freeChunks.erase( it );
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    for( SEGMENT* segment : released )
+    {
+        wxLogTrace( "GAL_CACHED_CONTAINER",
+                    wxT( "Releasing a segment of %u vertices at %u" ),
+                    segment->m_size, segment->m_offset );
+
+        m_currentSize -= segment->m_size;
+        m_freeSpace -= segment->m_size;
+
+        std::fill( m_pages.begin() + segment->m_offset / PAGE_SIZE,
+                   m_pages.begin() + ( segment->m_offset + segment->m_size ) / PAGE_SIZE,
+                   nullptr );
+
+        glDeleteBuffers( 1, &segment->m_buffer );
+        free( segment->m_vertices );
+    }
+
+    m_segments.erase( std::remove_if( m_segments.begin(), m_segments.end(),
+                                      [&released]( const std::unique_ptr<SEGMENT>& aSegment )
+                                      {
+                                          return released.count( aSegment.get() ) > 0;
+                                      } ),
+                      m_segments.end() );
+
+    while( !m_pages.empty() && !m_pages.back() )
+        m_pages.pop_back();
+}
+
+
+void CACHED_CONTAINER_RAM::compactSparseSegment()
+{
+    auto usage = []( const SEGMENT* aSegment )
+    {
+        return (double) ( aSegment->m_size - aSegment->m_freeSpace ) / aSegment->m_size;
+    };
+
+    SEGMENT* sparse = nullptr;
+
+    for( const std::unique_ptr<SEGMENT>& segment : m_segments )
+    {
+        double segmentUsage = usage( segment.get() );
+
+        if( segmentUsage > 0.0 && segmentUsage <= SPARSE_SEGMENT_RATIO
+                && ( !sparse || segmentUsage < usage( sparse ) ) )
+        {
+            sparse = segment.get();
+        }
+    }
+
+    if( !sparse )
+        return;
+
+    // Items are only moved to denser segments, so they never go back and forth
+    double       sparseUsage = usage( sparse );
+    unsigned int sparseUsed = sparse->m_size - sparse->m_freeSpace;
+    unsigned int room = 0;
+
+    auto isTarget = [&]( const SEGMENT* aSegment )
+    {
+        return usage( aSegment ) > sparseUsage;
+    };
+
+    for( const std::unique_ptr<SEGMENT>& segment : m_segments )
+    {
+        if( isTarget( segment.get() ) )
+            room += segment->m_freeSpace;
+    }
+
+    // Free space is fragmented, so ask for more than needed
+    if( room < 2 * sparseUsed )
+        return;
+
 #ifdef __WXDEBUG__
     PROF_COUNTER totalTime;
 #endif /* __WXDEBUG__ */
 
-    VERTEX* newBufferMem = static_cast<VERTEX*>( malloc( aNewSize * VERTEX_SIZE ) );
+    std::vector<VERTEX_ITEM*> moved;
 
-    if( !newBufferMem )
-        return false;
+    for( VERTEX_ITEM* item : m_items )
+    {
+        if( m_pages[item->GetOffset() / PAGE_SIZE] == sparse )
+            moved.push_back( item );
+    }
 
-    defragment( newBufferMem );
+    for( VERTEX_ITEM* item : moved )
+    {
+        unsigned int             itemSize = item->GetSize();
+        FREE_CHUNK_MAP::iterator chunk = m_freeChunks.lower_bound( itemSize );
 
-    // Switch to the new vertex buffer
-    free( m_vertices );
-    m_vertices = newBufferMem;
+        // Find a free chunk in a denser segment
+        while( chunk != m_freeChunks.end()
+                && !isTarget( m_pages[getChunkOffset( *chunk ) / PAGE_SIZE] ) )
+        {
+            ++chunk;
+        }
 
-#ifdef __WXDEBUG__
-    totalTime.Stop();
+        if( chunk == m_freeChunks.end() )
+            break;
 
-    wxLogTrace( "GAL_CACHED_CONTAINER",
-                "Defragmented container storing %d vertices / %.1f ms",
-                m_currentSize - m_freeSpace, totalTime.msecs() );
-#endif /* __WXDEBUG__ */
+        unsigned int chunkSize = getChunkSize( *chunk );
+        unsigned int chunkOffset = getChunkOffset( *chunk );
 
-    m_freeSpace += ( aNewSize - m_currentSize );
-    m_currentSize = aNewSize;
+        removeFreeChunk( chunk );
+
+        memcpy( GetVertices( chunkOffset ),
+                &sparse->m_vertices[item->GetOffset() - sparse->m_offset],
+                itemSize * VERTEX_SIZE );
+
+        addFreeChunk( item->GetOffset(), itemSize );
+
+        // Return the unused part of the chunk
+        if( chunkSize > itemSize )
+            addFreeChunk( chunkOffset + itemSize, chunkSize - itemSize );
+
+        item->setOffset( chunkOffset );
+    }
 
-    // Now there is only one big chunk of free memory
-    m_freeChunks.clear();
-    m_freeChunks.insert( std::make_pair( m_freeSpace, m_currentSize - m_freeSpace ) );
     m_dirty = true;
 
-    return true;
+#ifdef __WXDEBUG__
+    totalTime.Stop();
+
+    wxLogTrace( "GAL_CACHED_CONTAINER",
+                "Compacted a segment storing %u vertices / %.1f ms",
+                sparseUsed, totalTime.msecs() );
+#endif /* __WXDEBUG__ */
 }
@@ -77,12 +77,22 @@ const float SHADER_LINE_F               = 10.0;
 const float MIN_WIDTH = 1.0;
 
 attribute vec4 attrShaderParams;
+
+// Shape instances: offset & depth, color
+attribute vec3 attrInstance;
+attribute vec4 attrInstanceColor;
+
 varying vec4 shaderParams;
 varying vec2 circleCoords;
 uniform float worldPixelSize;
 uniform vec2 screenPixelSize;
 uniform float pixelSizeMultiplier;
 uniform float minLinePixelWidth;
+uniform float instanced;
+
+// Vertex position and color, after applying the instance if any
+vec4 vertexPos;
+vec4 vertexColor;
 
 
 float roundr( float f, float r )
@@ -98,11 +108,11 @@ vec4 roundv( vec4 x, vec2 t)
 void computeLineCoords( bool posture, vec2 vs, vec2 vp, vec2 texcoord, vec2 dir, float lineWidth, bool endV )
 {
     float lineLength = length(vs);
-    vec4 screenPos = gl_ModelViewProjectionMatrix * gl_Vertex + vec4(1, 1, 0, 0);
+    vec4 screenPos = gl_ModelViewProjectionMatrix * vertexPos + vec4(1, 1, 0, 0);
     float w = ((lineWidth == 0.0) ? worldPixelSize : lineWidth );
     float pixelWidth = roundr( w / worldPixelSize, 1.0 );
     float aspect = ( lineLength + w ) / w;
-    vec4 color = gl_Color;
+    vec4 color = vertexColor;
     vec2 s = sign( vec2( gl_ModelViewProjectionMatrix[0][0], gl_ModelViewProjectionMatrix[1][1] ) );
 
 
@@ -144,14 +154,14 @@ void computeLineCoords( bool posture, vec2 vs, vec2 vp, vec2 texcoord, vec2 dir,
     shaderParams[1] = aspect;
 
     gl_TexCoord[0].st = vec2(aspect * texcoord.x, texcoord.y);
-    gl_FrontColor = gl_Color;
+    gl_FrontColor = vertexColor;
 }
 
 
 void computeCircleCoords( float mode, float vertexIndex, float radius, float lineWidth )
 {
     vec4 delta;
-    vec4 center = roundv( gl_ModelViewProjectionMatrix * gl_Vertex + vec4(1, 1, 0, 0), screenPixelSize );
+    vec4 center = roundv( gl_ModelViewProjectionMatrix * vertexPos + vec4(1, 1, 0, 0), screenPixelSize );
     float pixelWidth = roundr( lineWidth / worldPixelSize, 1.0);
     float pixelR = roundr( radius / worldPixelSize, 1.0);
 
@@ -201,7 +211,7 @@ void computeCircleCoords( float mode, float vertexIndex, float radius, float lin
     delta.y *= screenPixelSize.y;
 
     gl_Position = center + delta + adjust;
-    gl_FrontColor = gl_Color;
+    gl_FrontColor = vertexColor;
 }
 
 
@@ -209,6 +219,17 @@ void main()
 {
     float mode = attrShaderParams[0];
 
+    if( instanced > 0.5 )
+    {
+        vertexPos = vec4( gl_Vertex.xy + attrInstance.xy, attrInstance.z, gl_Vertex.w );
+        vertexColor = attrInstanceColor;
+    }
+    else
+    {
+        vertexPos = gl_Vertex;
+        vertexColor = gl_Color;
+    }
+
     // Pass attributes to the fragment shader
     shaderParams = attrShaderParams;
 
@@ -234,8 +255,9 @@ void main()
     else
     {
         // Pass through the coordinates like in the fixed pipeline
-        gl_Position = ftransform();
-        gl_FrontColor = gl_Color;
+        gl_Position = ( instanced > 0.5 ) ? gl_ModelViewProjectionMatrix * vertexPos
+                                          : ftransform();
+        gl_FrontColor = vertexColor;
 
     }
 
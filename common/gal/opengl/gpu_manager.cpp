@@ -74,7 +74,9 @@ void GPU_MANAGER::SetShader( SHADER& aShader )
 // Cached manager
 GPU_CACHED_MANAGER::GPU_CACHED_MANAGER( VERTEX_CONTAINER* aContainer ) :
     GPU_MANAGER( aContainer ), m_buffersInitialized( false ), m_indicesPtr( NULL ),
-    m_indicesBuffer( 0 ), m_indicesSize( 0 ), m_indicesCapacity( 0 )
+    m_indicesBuffer( 0 ), m_indicesSize( 0 ), m_indicesCapacity( 0 ), m_layerInstanceRuns( 0 ),
+    m_instancesBuffer( 0 ), m_instanceAttrib( -1 ), m_instanceColorAttrib( -1 ),
+    m_instancedParam( -1 )
 {
     // Allocate the biggest possible buffer for indices
     resizeIndices( aContainer->GetSize() );
@@ -87,10 +89,23 @@ GPU_CACHED_MANAGER::~GPU_CACHED_MANAGER()
     {
         glBindBuffer( GL_ARRAY_BUFFER, 0 );
         glDeleteBuffers( 1, &m_indicesBuffer );
+        glDeleteBuffers( 1, &m_instancesBuffer );
     }
 }
 
 
+void GPU_CACHED_MANAGER::SetShader( SHADER& aShader )
+{
+    GPU_MANAGER::SetShader( aShader );
+
+    m_instanceAttrib = m_shader->GetAttribute( "attrInstance" );
+    m_instanceColorAttrib = m_shader->GetAttribute( "attrInstanceColor" );
+
+    if( m_instanceAttrib != -1 && m_instanceColorAttrib != -1 )
+        m_instancedParam = m_shader->AddParameter( "instanced" );
+}
+
+
 void GPU_CACHED_MANAGER::BeginDrawing()
 {
     wxASSERT( !m_isDrawing );
@@ -98,6 +113,7 @@ void GPU_CACHED_MANAGER::BeginDrawing()
     if( !m_buffersInitialized )
     {
         glGenBuffers( 1, &m_indicesBuffer );
+        glGenBuffers( 1, &m_instancesBuffer );
         checkGlError( "generating vertices buffer" );
         m_buffersInitialized = true;
     }
@@ -109,6 +125,11 @@ void GPU_CACHED_MANAGER::BeginDrawing()
     m_indicesSize = 0;
     // Set the indices pointer to the beginning of the indices-to-draw buffer
     m_indicesPtr = m_indices.get();
+    m_runs.clear();
+    m_instanceRuns.clear();
+    m_layerInstanceRuns = 0;
+    m_instanceRunIndex.clear();
+    m_instances.clear();
 
     m_isDrawing = true;
 }
@@ -118,10 +139,70 @@ void GPU_CACHED_MANAGER::DrawIndices( unsigned int aOffset, unsigned int aSize )
 {
     wxASSERT( m_isDrawing );
 
+    // Empty items (e.g. groups made of shape instances only) have no valid offset
+    if( aSize == 0 )
+        return;
+
+    CACHED_CONTAINER* cached = static_cast<CACHED_CONTAINER*>( m_container );
+    unsigned int      bufferOffset;
+    GLuint            vertexBuffer = cached->GetVertexBuffer( aOffset, bufferOffset );
+
+    // Items stored in the same vertex buffer are drawn together, as long as the drawing
+    // order does not change (instances of the previous layers are drawn after the last run)
+    bool instancesDrawn = m_layerInstanceRuns > 0
+                          && m_instanceRuns[m_layerInstanceRuns - 1].m_drawnAfter == m_runs.size();
+
+    if( m_runs.empty() || m_runs.back().m_vertexBuffer != vertexBuffer || instancesDrawn )
+        m_runs.push_back( { vertexBuffer, m_indicesSize, 0 } );
+
     // Copy indices of items that should be drawn to GPU memory
-    for( unsigned int i = aOffset; i < aOffset + aSize; *m_indicesPtr++ = i++ );
+    for( unsigned int i = aOffset - bufferOffset; i < aOffset - bufferOffset + aSize;
+         *m_indicesPtr++ = i++ );
 
     m_indicesSize += aSize;
+    m_runs.back().m_count += aSize;
+}
+
+
+void GPU_CACHED_MANAGER::DrawInstances( unsigned int aOffset, unsigned int aSize,
+                                        const INSTANCE* aInstances, unsigned int aCount )
+{
+    wxASSERT( m_isDrawing );
+    wxASSERT( m_instancedParam != -1 );
+
+    // Instances of a shape on a layer are all drawn together, after the other items of the
+    // layer: they have their own depth
+    auto it = m_instanceRunIndex.find( aOffset );
+
+    if( it == m_instanceRunIndex.end() )
+    {
+        CACHED_CONTAINER* cached = static_cast<CACHED_CONTAINER*>( m_container );
+        unsigned int      bufferOffset;
+        GLuint            vertexBuffer = cached->GetVertexBuffer( aOffset, bufferOffset );
+
+        it = m_instanceRunIndex.emplace( aOffset, m_instanceRuns.size() ).first;
+        m_instanceRuns.push_back( { vertexBuffer, aOffset - bufferOffset, aSize, {}, 0, 0 } );
+    }
+
+    std::vector<INSTANCE>& instances = m_instanceRuns[it->second].m_instances;
+    instances.insert( instances.end(), aInstances, aInstances + aCount );
+}
+
+
+void GPU_CACHED_MANAGER::BeginLayer()
+{
+    if( m_isDrawing )
+        endLayer();
+}
+
+
+void GPU_CACHED_MANAGER::endLayer()
+{
+    for( size_t i = m_layerInstanceRuns; i < m_instanceRuns.size(); ++i )
+        m_instanceRuns[i].m_drawnAfter = m_runs.size();
+
+    m_layerInstanceRuns = m_instanceRuns.size();
+    m_instanceRunIndex.clear();
 }
 
 
@@ -148,7 +229,7 @@ void GPU_CACHED_MANAGER::EndDrawing()
     if( cached->IsMapped() )
         cached->Unmap();
 
-    if( m_indicesSize == 0 )
+    if( m_indicesSize == 0 && m_instanceRuns.empty() )
     {
         m_isDrawing = false;
         return;
@@ -163,27 +244,78 @@ void GPU_CACHED_MANAGER::EndDrawing()
     glEnableClientState( GL_VERTEX_ARRAY );
     glEnableClientState( GL_COLOR_ARRAY );
 
-    // Bind vertices data buffers
-    glBindBuffer( GL_ARRAY_BUFFER, cached->GetBufferHandle() );
-    glVertexPointer( COORD_STRIDE, GL_FLOAT, VERTEX_SIZE, (GLvoid*) COORD_OFFSET );
-    glColorPointer( COLOR_STRIDE, GL_UNSIGNED_BYTE, VERTEX_SIZE, (GLvoid*) COLOR_OFFSET );
-
     if( m_shader != NULL )    // Use shader if applicable
     {
         m_shader->Use();
         glEnableVertexAttribArray( m_shaderAttrib );
-        glVertexAttribPointer( m_shaderAttrib, SHADER_STRIDE, GL_FLOAT, GL_FALSE,
-                               VERTEX_SIZE, (GLvoid*) SHADER_OFFSET );
     }
 
-    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_indicesBuffer );
-    glBufferData( GL_ELEMENT_ARRAY_BUFFER, m_indicesSize * sizeof(int),
-            (GLvoid*) m_indices.get(), GL_DYNAMIC_DRAW );
+    if( m_indicesSize > 0 )
+    {
+        glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_indicesBuffer );
+        glBufferData( GL_ELEMENT_ARRAY_BUFFER, m_indicesSize * sizeof(int),
+                (GLvoid*) m_indices.get(), GL_DYNAMIC_DRAW );
+    }
+
+    if( !m_instanceRuns.empty() )
+    {
+        endLayer();
+
+        for( INSTANCE_RUN& run : m_instanceRuns )
+        {
+            run.m_firstInstance = m_instances.size();
+            m_instances.insert( m_instances.end(), run.m_instances.begin(),
+                                run.m_instances.end() );
+        }
+
+        glBindBuffer( GL_ARRAY_BUFFER, m_instancesBuffer );
+        glBufferData( GL_ARRAY_BUFFER, m_instances.size() * INSTANCE_SIZE,
+                      (GLvoid*) m_instances.data(), GL_STREAM_DRAW );
+    }
+
+    size_t instanceRun = 0;
 
-    glDrawElements( GL_TRIANGLES, m_indicesSize, GL_UNSIGNED_INT, 0 );
+    for( size_t i = 0; i <= m_runs.size(); ++i )
+    {
+        // Instances of the layers drawn before the run
+        size_t lastInstanceRun = instanceRun;
+
+        while( lastInstanceRun < m_instanceRuns.size()
+               && m_instanceRuns[lastInstanceRun].m_drawnAfter == i )
+        {
+            lastInstanceRun++;
+        }
+
+        if( lastInstanceRun > instanceRun )
+        {
+            drawInstances( instanceRun, lastInstanceRun );
+            instanceRun = lastInstanceRun;
+        }
+
+        if( i == m_runs.size() )
+            break;
+
+        const DRAW_RUN& run = m_runs[i];
+
+        // Bind vertices data buffers
+        glBindBuffer( GL_ARRAY_BUFFER, run.m_vertexBuffer );
+        glVertexPointer( COORD_STRIDE, GL_FLOAT, VERTEX_SIZE, (GLvoid*) COORD_OFFSET );
+        glColorPointer( COLOR_STRIDE, GL_UNSIGNED_BYTE, VERTEX_SIZE, (GLvoid*) COLOR_OFFSET );
+
+        if( m_shader != NULL )
+        {
+            glVertexAttribPointer( m_shaderAttrib, SHADER_STRIDE, GL_FLOAT, GL_FALSE,
+                                   VERTEX_SIZE, (GLvoid*) SHADER_OFFSET );
+        }
+
+        glDrawElements( GL_TRIANGLES, run.m_count, GL_UNSIGNED_INT,
+                        (GLvoid*) ( run.m_first * sizeof( GLuint ) ) );
+    }
 
 #ifdef __WXDEBUG__
     wxLogTrace( "GAL_PROFILE", wxT( "Cached manager size: %d" ), m_indicesSize );
+    wxLogTrace( "GAL_PROFILE", wxT( "Cached manager shapes: %d, instances: %d" ),
+                (int) m_instanceRuns.size(), (int) m_instances.size() );
 #endif /* __WXDEBUG__ */
 
     glBindBuffer( GL_ARRAY_BUFFER, 0 );
@@ -220,6 +352,50 @@ void GPU_CACHED_MANAGER::resizeIndices( unsigned int aNewSize )
 }
 
 
+void GPU_CACHED_MANAGER::drawInstances( size_t aFirst, size_t aLast )
+{
+    wxASSERT( m_shader != NULL && m_instancedParam != -1 );
+
+    // The shader is already in use
+    m_shader->SetParameter( m_instancedParam, 1.0f );
+    glEnableVertexAttribArray( m_instanceAttrib );
+    glEnableVertexAttribArray( m_instanceColorAttrib );
+    glVertexAttribDivisorARB( m_instanceAttrib, 1 );
+    glVertexAttribDivisorARB( m_instanceColorAttrib, 1 );
+
+    for( size_t i = aFirst; i < aLast; ++i )
+    {
+        const INSTANCE_RUN& run = m_instanceRuns[i];
+
+        // Shape vertices
+        glBindBuffer( GL_ARRAY_BUFFER, run.m_vertexBuffer );
+        glVertexPointer( COORD_STRIDE, GL_FLOAT, VERTEX_SIZE, (GLvoid*) COORD_OFFSET );
+        glColorPointer( COLOR_STRIDE, GL_UNSIGNED_BYTE, VERTEX_SIZE, (GLvoid*) COLOR_OFFSET );
+        glVertexAttribPointer( m_shaderAttrib, SHADER_STRIDE, GL_FLOAT, GL_FALSE,
+                               VERTEX_SIZE, (GLvoid*) SHADER_OFFSET );
+
+        // Instances, advanced once per shape drawn
+        size_t base = run.m_firstInstance * INSTANCE_SIZE;
+
+        glBindBuffer( GL_ARRAY_BUFFER, m_instancesBuffer );
+        glVertexAttribPointer( m_instanceAttrib, INSTANCE_COORD_STRIDE, GL_FLOAT, GL_FALSE,
+                               INSTANCE_SIZE, (GLvoid*) ( base + INSTANCE_COORD_OFFSET ) );
+        glVertexAttribPointer( m_instanceColorAttrib, INSTANCE_COLOR_STRIDE, GL_UNSIGNED_BYTE,
+                               GL_TRUE, INSTANCE_SIZE, (GLvoid*) ( base + INSTANCE_COLOR_OFFSET ) );
+
+        glDrawArraysInstancedARB( GL_TRIANGLES, run.m_first, run.m_count,
+                                  run.m_instances.size() );
+    }
+
+    glVertexAttribDivisorARB( m_instanceAttrib, 0 );
+    glVertexAttribDivisorARB( m_instanceColorAttrib, 0 );
+    glDisableVertexAttribArray( m_instanceColorAttrib );
+    glDisableVertexAttribArray( m_instanceAttrib );
+    m_shader->SetParameter( m_instancedParam, 0.0f );
+    checkGlError( "drawing instances" );
+}
+
+
 // Noncached manager
 GPU_NONCACHED_MANAGER::GPU_NONCACHED_MANAGER( VERTEX_CONTAINER* aContainer ) :
     GPU_MANAGER( aContainer )
@@ -239,6 +415,13 @@ void GPU_NONCACHED_MANAGER::DrawIndices( unsigned int aOffset, unsigned int aSiz
 }
 
 
+void GPU_NONCACHED_MANAGER::DrawInstances( unsigned int aOffset, unsigned int aSize,
+                                           const INSTANCE* aInstances, unsigned int aCount )
+{
+    wxASSERT_MSG( false, wxT( "Not implemented yet" ) );
+}
+
+
 void GPU_NONCACHED_MANAGER::DrawAll()
 {
     // This is the default use case, nothing has to be done
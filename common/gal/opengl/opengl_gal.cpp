@@ -244,7 +244,9 @@ OPENGL_GAL::OPENGL_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions, wxWindow* aParent,
     isBitmapFontInitialized  = false;
     isInitialized            = false;
     isGrouping               = false;
+    isInstancingSupported    = false;
     groupCounter             = 0;
+    currentGroup             = 0;
 
     // Connecting the event handlers
     Connect( wxEVT_PAINT,           wxPaintEventHandler( OPENGL_GAL::onPaint ) );
@@ -1434,6 +1436,16 @@ void OPENGL_GAL::ClearScreen( )
 }
 
 
+void OPENGL_GAL::SetLayerDepth( double aLayerDepth )
+{
+    GAL::SetLayerDepth( aLayerDepth );
+
+    // Layers are drawn one after the other, the instanced shapes of a layer included
+    if( cachedManager )
+        cachedManager->BeginLayer();
+}
+
+
 void OPENGL_GAL::Transform( const MATRIX3x3D& aTransformation )
 {
     GLdouble matrixData[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
@@ -1489,6 +1501,7 @@ int OPENGL_GAL::BeginGroup()
     std::shared_ptr<VERTEX_ITEM> newItem = std::make_shared<VERTEX_ITEM>( *cachedManager );
     int groupNumber = getNewGroupNumber();
     groups.insert( std::make_pair( groupNumber, newItem ) );
+    currentGroup = groupNumber;
 
     return groupNumber;
 }
@@ -1505,6 +1518,14 @@ void OPENGL_GAL::DrawGroup( int aGroupNumber )
 {
     if( groups[aGroupNumber] )
         cachedManager->DrawItem( *groups[aGroupNumber] );
+
+    auto it = groupInstances.find( aGroupNumber );
+
+    if( it != groupInstances.end() )
+    {
+        for( const SHAPE_INSTANCE& shapeInstance : it->second )
+            cachedManager->DrawInstances( *shapeInstance.shape, &shapeInstance.instance, 1 );
+    }
 }
 
 
@@ -1512,6 +1533,19 @@ void OPENGL_GAL::ChangeGroupColor( int aGroupNumber, const COLOR4D& aNewColor )
 {
     if( groups[aGroupNumber] )
         cachedManager->ChangeItemColor( *groups[aGroupNumber], aNewColor );
+
+    auto it = groupInstances.find( aGroupNumber );
+
+    if( it != groupInstances.end() )
+    {
+        for( SHAPE_INSTANCE& shapeInstance : it->second )
+        {
+            shapeInstance.instance.r = aNewColor.r * 255.0;
+            shapeInstance.instance.g = aNewColor.g * 255.0;
+            shapeInstance.instance.b = aNewColor.b * 255.0;
+            shapeInstance.instance.a = aNewColor.a * 255.0;
+        }
+    }
 }
 
 
@@ -1519,6 +1553,14 @@ void OPENGL_GAL::ChangeGroupDepth( int aGroupNumber, int aDepth )
 {
     if( groups[aGroupNumber] )
         cachedManager->ChangeItemDepth( *groups[aGroupNumber], aDepth );
+
+    auto it = groupInstances.find( aGroupNumber );
+
+    if( it != groupInstances.end() )
+    {
+        for( SHAPE_INSTANCE& shapeInstance : it->second )
+            shapeInstance.instance.z = aDepth;
+    }
 }
 
 
@@ -1526,6 +1568,7 @@ void OPENGL_GAL::DeleteGroup( int aGroupNumber )
 {
     // Frees memory in the container as well
     groups.erase( aGroupNumber );
+    groupInstances.erase( aGroupNumber );
 }
 
 
@@ -1534,12 +1577,60 @@ void OPENGL_GAL::ClearCache()
     bitmapCache = std::make_unique<GL_BITMAP_CACHE>( );
 
     groups.clear();
+    groupInstances.clear();
+    shapes.clear();
 
     if( isInitialized )
         cachedManager->Clear();
 }
 
 
+void OPENGL_GAL::BeginShape( uint64_t aKey )
+{
+    wxASSERT_MSG( IsInstancingEnabled(), "Shapes are only drawn while caching a group" );
+
+    // Suspend the group, so the shape is stored in its own item
+    cachedManager->FinishItem();
+    shapes[aKey] = std::make_shared<VERTEX_ITEM>( *cachedManager );
+}
+
+
+void OPENGL_GAL::EndShape()
+{
+    cachedManager->FinishItem();
+
+    // Resume the group
+    if( isGrouping && groups[currentGroup] )
+        cachedManager->SetItem( *groups[currentGroup] );
+}
+
+
+void OPENGL_GAL::DrawShape( uint64_t aKey, const VECTOR2D& aPosition, const COLOR4D& aColor )
+{
+    wxASSERT_MSG( IsInstancingEnabled(), "Shapes are only drawn while caching a group" );
+
+    auto it = shapes.find( aKey );
+
+    if( it == shapes.end() )
+    {
+        wxASSERT_MSG( false, "Unknown shape" );
+        return;
+    }
+
+    SHAPE_INSTANCE shapeInstance;
+    shapeInstance.shape = it->second;
+    shapeInstance.instance.x = aPosition.x;
+    shapeInstance.instance.y = aPosition.y;
+    shapeInstance.instance.z = layerDepth;
+    shapeInstance.instance.r = aColor.r * 255.0;
+    shapeInstance.instance.g = aColor.g * 255.0;
+    shapeInstance.instance.b = aColor.b * 255.0;
+    shapeInstance.instance.a = aColor.a * 255.0;
+
+    groupInstances[currentGroup].push_back( shapeInstance );
+}
+
+
 void OPENGL_GAL::SetTarget( RENDER_TARGET aTarget )
 {
     switch( aTarget )
@@ -2049,6 +2140,9 @@ void OPENGL_GAL::init()
     nonCachedManager->SetShader( *shader );
     overlayManager->SetShader( *shader );
 
+    // Instances of cached shapes need the divisor of instanced vertex attributes
+    isInstancingSupported = GLEW_ARB_instanced_arrays && GLEW_ARB_draw_instanced;
+
     isInitialized = true;
 }
 
@@ -245,6 +245,20 @@ void VERTEX_MANAGER::DrawItem( const VERTEX_ITEM& aItem ) const
 }
 
 
+void VERTEX_MANAGER::DrawInstances( const VERTEX_ITEM& aItem, const INSTANCE* aInstances,
+                                    unsigned int aCount ) const
+{
+    if( aItem.GetSize() > 0 && aCount > 0 )
+        m_gpu->DrawInstances( aItem.GetOffset(), aItem.GetSize(), aInstances, aCount );
+}
+
+
+void VERTEX_MANAGER::BeginLayer() const
+{
+    m_gpu->BeginLayer();
+}
+
+
 void VERTEX_MANAGER::EndDrawing() const
 {
     m_gpu->EndDrawing();
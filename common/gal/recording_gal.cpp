@@ -0,0 +1,656 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#include <gal/recording_gal.h>
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+using namespace KIGFX;
+
+
+static bool sameChains( const SHAPE_LINE_CHAIN& aA, const SHAPE_LINE_CHAIN& aB )
+{
+    if( aA.PointCount() != aB.PointCount() || aA.IsClosed() != aB.IsClosed() )
+        return false;
+
+    for( int i = 0; i < aA.PointCount(); i++ )
+    {
+        if( aA.CPoint( i ) != aB.CPoint( i ) )
+            return false;
+    }
+
+    return true;
+}
+
+
+static bool samePolySets( const SHAPE_POLY_SET& aA, const SHAPE_POLY_SET& aB )
+{
+    if( aA.OutlineCount() != aB.OutlineCount()
+            || aA.IsTriangulationUpToDate() != aB.IsTriangulationUpToDate() )
+    {
+        return false;
+    }
+
+    for( int i = 0; i < aA.OutlineCount(); i++ )
+    {
+        if( aA.HoleCount( i ) != aB.HoleCount( i )
+                || !sameChains( aA.COutline( i ), aB.COutline( i ) ) )
+        {
+            return false;
+        }
+
+        for( int j = 0; j < aA.HoleCount( i ); j++ )
+        {
+            if( !sameChains( aA.CHole( i, j ), aB.CHole( i, j ) ) )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+bool RECORDING_GAL::COMMAND::operator==( const COMMAND& aOther ) const
+{
+    if( m_type != aOther.m_type || m_flag != aOther.m_flag || m_color != aOther.m_color
+            || m_points != aOther.m_points || m_key != aOther.m_key )
+    {
+        return false;
+    }
+
+    for( int i = 0; i < 4; i++ )
+    {
+        if( m_args[i] != aOther.m_args[i] )
+            return false;
+    }
+
+    if( !m_shape != !aOther.m_shape || !m_matrix != !aOther.m_matrix
+            || !m_text != !aOther.m_text )
+    {
+        return false;
+    }
+
+    if( m_shape && m_type == CMD_DRAW_POLY_SET )
+    {
+        if( !samePolySets( static_cast<const SHAPE_POLY_SET&>( *m_shape ),
+                           static_cast<const SHAPE_POLY_SET&>( *aOther.m_shape ) ) )
+        {
+            return false;
+        }
+    }
+    else if( m_shape )
+    {
+        if( !sameChains( static_cast<const SHAPE_LINE_CHAIN&>( *m_shape ),
+                         static_cast<const SHAPE_LINE_CHAIN&>( *aOther.m_shape ) ) )
+        {
+            return false;
+        }
+    }
+
+    if( m_matrix )
+    {
+        for( int i = 0; i < 3; i++ )
+        {
+            for( int j = 0; j < 3; j++ )
+            {
+                if( m_matrix->m_data[i][j] != aOther.m_matrix->m_data[i][j] )
+                    return false;
+            }
+        }
+    }
+
+    if( m_text )
+    {
+        const BITMAP_TEXT& a = *m_text;
+        const BITMAP_TEXT& b = *aOther.m_text;
+
+        if( a.m_text != b.m_text || a.m_glyphSize != b.m_glyphSize
+                || a.m_horizontalJustify != b.m_horizontalJustify
+                || a.m_verticalJustify != b.m_verticalJustify || a.m_bold != b.m_bold
+                || a.m_italic != b.m_italic || a.m_mirrored != b.m_mirrored )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+RECORDING_GAL::RECORDING_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions ) :
+    GAL( aDisplayOptions ),
+    m_currentGroup( nullptr ),
+    m_groupCounter( 0 ),
+    m_isOpenGl( false ),
+    m_isCairo( false ),
+    m_isInstancing( false )
+{
+}
+
+
+RECORDING_GAL::~RECORDING_GAL()
+{
+}
+
+
+void RECORDING_GAL::CopyViewSettings( GAL& aGal )
+{
+    SetScreenSize( aGal.GetScreenPixelSize() );
+    SetLookAtPoint( aGal.GetLookAtPoint() );
+    SetZoomFactor( aGal.GetZoomFactor() );
+    SetRotation( aGal.GetRotation() );
+    SetFlip( aGal.IsFlippedX(), aGal.IsFlippedY() );
+    SetDepthRange( VECTOR2D( aGal.GetMinDepth(), aGal.GetMaxDepth() ) );
+
+    SetWorldUnitLength( aGal.GetWorldUnitLength() );
+    SetScreenDPI( aGal.GetScreenDPI() );
+
+    // Take the resulting matrices, rather than computing them again
+    worldScreenMatrix = aGal.GetWorldScreenMatrix();
+    screenWorldMatrix = aGal.GetScreenWorldMatrix();
+    worldScale = aGal.GetWorldScale();
+
+    m_isOpenGl = aGal.IsOpenGlEngine();
+    m_isCairo = aGal.IsCairoEngine();
+    m_isInstancing = aGal.IsInstancingSupported();
+}
+
+
+RECORDING_GAL::COMMAND* RECORDING_GAL::record( COMMAND_TYPE aType )
+{
+    if( !m_currentGroup )
+        return nullptr;
+
+    m_currentGroup->emplace_back();
+    m_currentGroup->back().m_type = aType;
+
+    return &m_currentGroup->back();
+}
+
+
+void RECORDING_GAL::DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+{
+    if( COMMAND* cmd = record( CMD_DRAW_LINE ) )
+        cmd->m_points = { aStartPoint, aEndPoint };
+}
+
+
+void RECORDING_GAL::DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                                 double aWidth )
+{
+    if( COMMAND* cmd = record( CMD_DRAW_SEGMENT ) )
+    {
+        cmd->m_points = { aStartPoint, aEndPoint };
+        cmd->m_args[0] = aWidth;
+    }
+}
+
+
+void RECORDING_GAL::DrawPolyline( const std::deque<VECTOR2D>& aPointList )
+{
+    if( COMMAND* cmd = record( CMD_DRAW_POLYLINE ) )
+        cmd->m_points.assign( aPointList.begin(), aPointList.end() );
+}
+
+
+void RECORDING_GAL::DrawPolyline( const VECTOR2D aPointList[], int aListSize )
+{
+    if( COMMAND* cmd = record( CMD_DRAW_POLYLINE ) )
+        cmd->m_points.assign( aPointList, aPointList + aListSize );
+}
+
+
+void RECORDING_GAL::DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain )
+{
+    if( COMMAND* cmd = record( CMD_DRAW_LINE_CHAIN ) )
+        cmd->m_shape = std::make_shared<SHAPE_LINE_CHAIN>( aLineChain );
+}
+
+
+void RECORDING_GAL::DrawCircle( const VECTOR2D& aCenterPoint, double aRadius )
+{
+    if( COMMAND* cmd = record( CMD_DRAW_CIRCLE ) )
+    {
+        cmd->m_points = { aCenterPoint };
+        cmd->m_args[0] = aRadius;
+    }
+}
+
+
+void RECORDING_GAL::DrawArc( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
+                             double aEndAngle )
+{
+    if( COMMAND* cmd = record( CMD_DRAW_ARC ) )
+    {
+        cmd->m_points = { aCenterPoint };
+        cmd->m_args[0] = aRadius;
+        cmd->m_args[1] = aStartAngle;
+        cmd->m_args[2] = aEndAngle;
+    }
+}
+
+
+void RECORDING_GAL::DrawArcSegment( const VECTOR2D& aCenterPoint, double aRadius,
+                                    double aStartAngle, double aEndAngle, double aWidth )
+{
+    if( COMMAND* cmd = record( CMD_DRAW_ARC_SEGMENT ) )
+    {
+        cmd->m_points = { aCenterPoint };
+        cmd->m_args[0] = aRadius;
+        cmd->m_args[1] = aStartAngle;
+        cmd->m_args[2] = aEndAngle;
+        cmd->m_args[3] = aWidth;
+    }
+}
+
+
+void RECORDING_GAL::DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+{
+    if( COMMAND* cmd = record( CMD_DRAW_RECTANGLE ) )
+        cmd->m_points = { aStartPoint, aEndPoint };
+}
+
+
+void RECORDING_GAL::DrawPolygon( const std::deque<VECTOR2D>& aPointList )
+{
+    if( COMMAND* cmd = record( CMD_DRAW_POLYGON ) )
+        cmd->m_points.assign( aPointList.begin(), aPointList.end() );
+}
+
+
+void RECORDING_GAL::DrawPolygon( const VECTOR2D aPointList[], int aListSize )
+{
+    if( COMMAND* cmd = record( CMD_DRAW_POLYGON ) )
+        cmd->m_points.assign( aPointList, aPointList + aListSize );
+}
+
+
+void RECORDING_GAL::DrawPolygon( const SHAPE_POLY_SET& aPolySet )
+{
+    // The copy shares the triangulation of aPolySet, if it has one
+    if( COMMAND* cmd = record( CMD_DRAW_POLY_SET ) )
+        cmd->m_shape = std::make_shared<SHAPE_POLY_SET>( aPolySet );
+}
+
+
+void RECORDING_GAL::DrawPolygon( const SHAPE_LINE_CHAIN& aPolySet )
+{
+    if( COMMAND* cmd = record( CMD_DRAW_POLYGON_CHAIN ) )
+        cmd->m_shape = std::make_shared<SHAPE_LINE_CHAIN>( aPolySet );
+}
+
+
+void RECORDING_GAL::DrawCurve( const VECTOR2D& startPoint, const VECTOR2D& controlPointA,
+                               const VECTOR2D& controlPointB, const VECTOR2D& endPoint,
+                               double aFilterValue )
+{
+    if( COMMAND* cmd = record( CMD_DRAW_CURVE ) )
+    {
+        cmd->m_points = { startPoint, controlPointA, controlPointB, endPoint };
+        cmd->m_args[0] = aFilterValue;
+    }
+}
+
+
+void RECORDING_GAL::SetIsFill( bool aIsFillEnabled )
+{
+    if( COMMAND* cmd = record( CMD_SET_IS_FILL ) )
+        cmd->m_flag = aIsFillEnabled;
+
+    GAL::SetIsFill( aIsFillEnabled );
+}
+
+
+void RECORDING_GAL::SetIsStroke( bool aIsStrokeEnabled )
+{
+    if( COMMAND* cmd = record( CMD_SET_IS_STROKE ) )
+        cmd->m_flag = aIsStrokeEnabled;
+
+    GAL::SetIsStroke( aIsStrokeEnabled );
+}
+
+
+void RECORDING_GAL::SetFillColor( const COLOR4D& aColor )
+{
+    if( COMMAND* cmd = record( CMD_SET_FILL_COLOR ) )
+        cmd->m_color = aColor;
+
+    GAL::SetFillColor( aColor );
+}
+
+
+void RECORDING_GAL::SetStrokeColor( const COLOR4D& aColor )
+{
+    if( COMMAND* cmd = record( CMD_SET_STROKE_COLOR ) )
+        cmd->m_color = aColor;
+
+    GAL::SetStrokeColor( aColor );
+}
+
+
+void RECORDING_GAL::SetLineWidth( float aLineWidth )
+{
+    if( COMMAND* cmd = record( CMD_SET_LINE_WIDTH ) )
+        cmd->m_args[0] = aLineWidth;
+
+    GAL::SetLineWidth( aLineWidth );
+}
+
+
+void RECORDING_GAL::SetLayerDepth( double aLayerDepth )
+{
+    if( COMMAND* cmd = record( CMD_SET_LAYER_DEPTH ) )
+        cmd->m_args[0] = aLayerDepth;
+
+    GAL::SetLayerDepth( aLayerDepth );
+}
+
+
+void RECORDING_GAL::BitmapText( const wxString& aText, const VECTOR2D& aPosition,
+                                double aRotationAngle )
+{
+    COMMAND* cmd = record( CMD_BITMAP_TEXT );
+
+    if( !cmd )
+        return;
+
+    auto text = std::make_shared<BITMAP_TEXT>();
+
+    text->m_text = aText;
+    text->m_glyphSize = GetGlyphSize();
+    text->m_horizontalJustify = GetHorizontalJustify();
+    text->m_verticalJustify = GetVerticalJustify();
+    text->m_bold = IsFontBold();
+    text->m_italic = IsFontItalic();
+    text->m_mirrored = IsTextMirrored();
+
+    cmd->m_text = text;
+    cmd->m_points = { aPosition };
+    cmd->m_args[0] = aRotationAngle;
+}
+
+
+void RECORDING_GAL::Transform( const MATRIX3x3D& aTransformation )
+{
+    if( COMMAND* cmd = record( CMD_TRANSFORM ) )
+        cmd->m_matrix = std::make_shared<MATRIX3x3D>( aTransformation );
+}
+
+
+void RECORDING_GAL::Rotate( double aAngle )
+{
+    if( COMMAND* cmd = record( CMD_ROTATE ) )
+        cmd->m_args[0] = aAngle;
+}
+
+
+void RECORDING_GAL::Translate( const VECTOR2D& aTranslation )
+{
+    if( COMMAND* cmd = record( CMD_TRANSLATE ) )
+        cmd->m_points = { aTranslation };
+}
+
+
+void RECORDING_GAL::Scale( const VECTOR2D& aScale )
+{
+    if( COMMAND* cmd = record( CMD_SCALE ) )
+        cmd->m_points = { aScale };
+}
+
+
+void RECORDING_GAL::BeginShape( uint64_t aKey )
+{
+    if( COMMAND* cmd = record( CMD_BEGIN_SHAPE ) )
+    {
+        cmd->m_key = aKey;
+        m_groupShapes.insert( aKey );
+    }
+}
+
+
+void RECORDING_GAL::EndShape()
+{
+    record( CMD_END_SHAPE );
+}
+
+
+void RECORDING_GAL::DrawShape( uint64_t aKey, const VECTOR2D& aPosition, const COLOR4D& aColor )
+{
+    if( COMMAND* cmd = record( CMD_DRAW_SHAPE ) )
+    {
+        cmd->m_key = aKey;
+        cmd->m_points = { aPosition };
+        cmd->m_color = aColor;
+    }
+}
+
+
+void RECORDING_GAL::Save()
+{
+    record( CMD_SAVE );
+}
+
+
+void RECORDING_GAL::Restore()
+{
+    record( CMD_RESTORE );
+}
+
+
+int RECORDING_GAL::BeginGroup()
+{
+    int group = m_groupCounter++;
+
+    m_currentGroup = &m_groups[group];
+    m_groupShapes.clear();
+
+    return group;
+}
+
+
+void RECORDING_GAL::EndGroup()
+{
+    m_currentGroup = nullptr;
+}
+
+
+void RECORDING_GAL::DeleteGroup( int aGroupNumber )
+{
+    auto it = m_groups.find( aGroupNumber );
+
+    if( it != m_groups.end() && &it->second != m_currentGroup )
+        m_groups.erase( it );
+}
+
+
+void RECORDING_GAL::ClearCache()
+{
+    m_groups.clear();
+    m_currentGroup = nullptr;
+}
+
+
+RECORDING_GAL::COMMANDS RECORDING_GAL::TakeGroup( int aGroupNumber )
+{
+    COMMANDS commands;
+    auto     it = m_groups.find( aGroupNumber );
+
+    if( it != m_groups.end() )
+    {
+        if( &it->second == m_currentGroup )
+            m_currentGroup = nullptr;
+
+        commands.swap( it->second );
+        m_groups.erase( it );
+    }
+
+    return commands;
+}
+
+
+void RECORDING_GAL::Replay( const COMMANDS& aCommands, GAL& aTarget )
+{
+    // Set while skipping the calls drawing a shape the target already has
+    bool skipShape = false;
+
+    for( const COMMAND& cmd : aCommands )
+    {
+        const std::vector<VECTOR2D>& pts = cmd.m_points;
+
+        if( skipShape )
+        {
+            skipShape = cmd.m_type != CMD_END_SHAPE;
+            continue;
+        }
+
+        switch( cmd.m_type )
+        {
+        case CMD_SET_IS_FILL:
+            aTarget.SetIsFill( cmd.m_flag );
+            break;
+
+        case CMD_SET_IS_STROKE:
+            aTarget.SetIsStroke( cmd.m_flag );
+            break;
+
+        case CMD_SET_FILL_COLOR:
+            aTarget.SetFillColor( cmd.m_color );
+            break;
+
+        case CMD_SET_STROKE_COLOR:
+            aTarget.SetStrokeColor( cmd.m_color );
+            break;
+
+        case CMD_SET_LINE_WIDTH:
+            aTarget.SetLineWidth( (float) cmd.m_args[0] );
+            break;
+
+        case CMD_SET_LAYER_DEPTH:
+            aTarget.SetLayerDepth( cmd.m_args[0] );
+            break;
+
+        case CMD_DRAW_LINE:
+            aTarget.DrawLine( pts[0], pts[1] );
+            break;
+
+        case CMD_DRAW_SEGMENT:
+            aTarget.DrawSegment( pts[0], pts[1], cmd.m_args[0] );
+            break;
+
+        case CMD_DRAW_POLYLINE:
+            aTarget.DrawPolyline( pts.data(), (int) pts.size() );
+            break;
+
+        case CMD_DRAW_LINE_CHAIN:
+            aTarget.DrawPolyline( static_cast<const SHAPE_LINE_CHAIN&>( *cmd.m_shape ) );
+            break;
+
+        case CMD_DRAW_POLYGON_CHAIN:
+            aTarget.DrawPolygon( static_cast<const SHAPE_LINE_CHAIN&>( *cmd.m_shape ) );
+            break;
+
+        case CMD_DRAW_POLY_SET:
+            aTarget.DrawPolygon( static_cast<const SHAPE_POLY_SET&>( *cmd.m_shape ) );
+            break;
+
+        case CMD_DRAW_CIRCLE:
+            aTarget.DrawCircle( pts[0], cmd.m_args[0] );
+            break;
+
+        case CMD_DRAW_RECTANGLE:
+            aTarget.DrawRectangle( pts[0], pts[1] );
+            break;
+
+        case CMD_DRAW_POLYGON:
+            aTarget.DrawPolygon( pts.data(), (int) pts.size() );
+            break;
+
+        case CMD_DRAW_ARC:
+            aTarget.DrawArc( pts[0], cmd.m_args[0], cmd.m_args[1], cmd.m_args[2] );
+            break;
+
+        case CMD_DRAW_ARC_SEGMENT:
+            aTarget.DrawArcSegment( pts[0], cmd.m_args[0], cmd.m_args[1], cmd.m_args[2],
+                                    cmd.m_args[3] );
+            break;
+
+        case CMD_DRAW_CURVE:
+            aTarget.DrawCurve( pts[0], pts[1], pts[2], pts[3], cmd.m_args[0] );
+            break;
+
+        case CMD_BITMAP_TEXT:
+        {
+            const BITMAP_TEXT& text = *cmd.m_text;
+
+            aTarget.SetGlyphSize( text.m_glyphSize );
+            aTarget.SetHorizontalJustify( text.m_horizontalJustify );
+            aTarget.SetVerticalJustify( text.m_verticalJustify );
+            aTarget.SetFontBold( text.m_bold );
+            aTarget.SetFontItalic( text.m_italic );
+            aTarget.SetTextMirrored( text.m_mirrored );
+            aTarget.BitmapText( text.m_text, pts[0], cmd.m_args[0] );
+            break;
+        }
+
+        case CMD_TRANSFORM:
+            aTarget.Transform( *cmd.m_matrix );
+            break;
+
+        case CMD_ROTATE:
+            aTarget.Rotate( cmd.m_args[0] );
+            break;
+
+        case CMD_TRANSLATE:
+            aTarget.Translate( pts[0] );
+            break;
+
+        case CMD_SCALE:
+            aTarget.Scale( pts[0] );
+            break;
+
+        case CMD_SAVE:
+            aTarget.Save();
+            break;
+
+        case CMD_RESTORE:
+            aTarget.Restore();
+            break;
+
+        case CMD_BEGIN_SHAPE:
+            if( aTarget.HasShape( cmd.m_key ) )
+                skipShape = true;
+            else
+                aTarget.BeginShape( cmd.m_key );
+
+            break;
+
+        case CMD_END_SHAPE:
+            aTarget.EndShape();
+            break;
+
+        case CMD_DRAW_SHAPE:
+            aTarget.DrawShape( cmd.m_key, pts[0], cmd.m_color );
+            break;
+        }
+    }
+}
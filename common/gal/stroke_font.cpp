@@ -31,6 +31,12 @@
 #include <math/util.h>      // for KiROUND
 #include <wx/string.h>
 #include <gr_text.h>
+#include <fast_hash.h>
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 
 
 using namespace KIGFX;
@@ -196,20 +202,200 @@ void STROKE_FONT::Draw( const UTF8& aText, const VECTOR2D& aPosition, double aRo
     m_gal->Translate( aPosition );
     m_gal->Rotate( -aRotationAngle );
 
+    m_gal->SetIsStroke( true );
+    //m_gal->SetIsFill( false );
+
+    if( m_gal->IsFontBold() )
+        m_gal->SetLineWidth( m_gal->GetLineWidth() * BOLD_FACTOR );
+
+    std::shared_ptr<const GLYPH_RUN> run = getGlyphRun( aText );
+
+    for( const GLYPH_RUN_STROKE& stroke : *run )
+    {
+        if( stroke.m_isOverbar )
+            m_gal->DrawLine( stroke.m_points[0], stroke.m_points[1] );
+        else
+            m_gal->DrawPolyline( stroke.m_points.data(), (int) stroke.m_points.size() );
+    }
+
+    m_gal->Restore();
+}
+
+
+namespace
+{
+
+///> Everything the layout of a text depends on, except its position and orientation
+struct GLYPH_RUN_KEY
+{
+    std::string         m_text;
+    VECTOR2D            m_glyphSize;
+    double              m_lineWidth;
+    EDA_TEXT_HJUSTIFY_T m_horizontalJustify;
+    EDA_TEXT_VJUSTIFY_T m_verticalJustify;
+    bool                m_italic;
+    bool                m_mirrored;
+
+    ///> Hash of the other members, computed once as it picks the cache shard too
+    uint64_t            m_hash;
+
+    void computeHash()
+    {
+        FAST_HASH hash;
+
+        hash.Add( m_text );
+        hash.Add( m_glyphSize.x );
+        hash.Add( m_glyphSize.y );
+        hash.Add( m_lineWidth );
+        hash.Add( m_horizontalJustify );
+        hash.Add( m_verticalJustify );
+        hash.Add( m_italic );
+        hash.Add( m_mirrored );
+
+        m_hash = hash.Digest64();
+    }
+
+    bool operator==( const GLYPH_RUN_KEY& aOther ) const
+    {
+        return m_hash == aOther.m_hash && m_text == aOther.m_text
+               && m_glyphSize == aOther.m_glyphSize && m_lineWidth == aOther.m_lineWidth
+               && m_horizontalJustify == aOther.m_horizontalJustify
+               && m_verticalJustify == aOther.m_verticalJustify
+               && m_italic == aOther.m_italic && m_mirrored == aOther.m_mirrored;
+    }
+};
+
+
+struct GLYPH_RUN_KEY_HASH
+{
+    size_t operator()( const GLYPH_RUN_KEY& aKey ) const
+    {
+        return (size_t) aKey.m_hash;
+    }
+};
+
+
+///> A part of the cache of laid out texts, with its own lock.  The least recently used texts
+///> are dropped when it is full.
+struct GLYPH_RUN_CACHE_SHARD
+{
+    typedef std::list<std::pair<GLYPH_RUN_KEY, std::shared_ptr<const GLYPH_RUN>>> ENTRIES;
+
+    std::mutex m_mutex;
+
+    ///> Texts, the most recently used first
+    ENTRIES m_entries;
+
+    std::unordered_map<GLYPH_RUN_KEY, ENTRIES::iterator, GLYPH_RUN_KEY_HASH> m_index;
+};
+
+
+///> Number of shards of the cache, so threads drawing different texts rarely wait for each other
+const size_t GLYPH_RUN_CACHE_SHARDS = 16;
+
+///> Maximum number of laid out texts kept in each shard
+const size_t GLYPH_RUN_SHARD_SIZE = STROKE_FONT::LAYOUT_CACHE_SIZE / GLYPH_RUN_CACHE_SHARDS;
+
+// Shared by all the GALs, including the ones recording items on worker threads
+GLYPH_RUN_CACHE_SHARD g_glyphRunCache[GLYPH_RUN_CACHE_SHARDS];
+
+// Number of texts laid out since the cache was cleared
+std::atomic<size_t> g_glyphRunLayouts( 0 );
+
+}
+
+
+std::shared_ptr<const GLYPH_RUN> STROKE_FONT::getGlyphRun( const UTF8& aText ) const
+{
+    GLYPH_RUN_KEY key;
+
+    key.m_text = aText;
+    key.m_glyphSize = m_gal->GetGlyphSize();
+    key.m_lineWidth = m_gal->GetLineWidth();
+    key.m_horizontalJustify = m_gal->GetHorizontalJustify();
+    key.m_verticalJustify = m_gal->GetVerticalJustify();
+    key.m_italic = m_gal->IsFontItalic();
+    key.m_mirrored = m_gal->IsTextMirrored();
+    key.computeHash();
+
+    // The low bits of the hash pick the bucket of the shard map
+    GLYPH_RUN_CACHE_SHARD& shard = g_glyphRunCache[( key.m_hash >> 32 ) % GLYPH_RUN_CACHE_SHARDS];
+
+    {
+        std::lock_guard<std::mutex> lock( shard.m_mutex );
+        auto it = shard.m_index.find( key );
+
+        if( it != shard.m_index.end() )
+        {
+            shard.m_entries.splice( shard.m_entries.begin(), shard.m_entries, it->second );
+            return it->second->second;
+        }
+    }
+
+    // Lay the text out without holding the lock, other threads may need the cache meanwhile
+    std::shared_ptr<GLYPH_RUN> run = std::make_shared<GLYPH_RUN>();
+
+    layoutText( aText, *run );
+    g_glyphRunLayouts++;
+
+    std::lock_guard<std::mutex> lock( shard.m_mutex );
+
+    // Another thread may have laid the same text out meanwhile
+    auto it = shard.m_index.find( key );
+
+    if( it != shard.m_index.end() )
+        return it->second->second;
+
+    if( shard.m_entries.size() >= GLYPH_RUN_SHARD_SIZE )
+    {
+        shard.m_index.erase( shard.m_entries.back().first );
+        shard.m_entries.pop_back();
+    }
+
+    shard.m_entries.emplace_front( key, run );
+    shard.m_index.emplace( std::move( key ), shard.m_entries.begin() );
+
+    return run;
+}
+
+
+void STROKE_FONT::ClearLayoutCache()
+{
+    for( GLYPH_RUN_CACHE_SHARD& shard : g_glyphRunCache )
+    {
+        std::lock_guard<std::mutex> lock( shard.m_mutex );
+
+        shard.m_index.clear();
+        shard.m_entries.clear();
+    }
+
+    g_glyphRunLayouts = 0;
+}
+
+
+size_t STROKE_FONT::GetLayoutCount()
+{
+    return g_glyphRunLayouts;
+}
+
+
+void STROKE_FONT::layoutText( const UTF8& aText, GLYPH_RUN& aRun ) const
+{
     // Single line height
     int lineHeight = KiROUND( GetInterline( m_gal->GetGlyphSize().y ) );
     int lineCount = linesCount( aText );
     const VECTOR2D& glyphSize = m_gal->GetGlyphSize();
+    VECTOR2D offset( 0.0, 0.0 );
 
     // align the 1st line of text
     switch( m_gal->GetVerticalJustify() )
     {
     case GR_TEXT_VJUSTIFY_TOP:
-        m_gal->Translate( VECTOR2D( 0, glyphSize.y ) );
+        offset.y += glyphSize.y;
         break;
 
     case GR_TEXT_VJUSTIFY_CENTER:
-        m_gal->Translate( VECTOR2D( 0, glyphSize.y / 2.0 ) );
+        offset.y += glyphSize.y / 2.0;
         break;
 
     case GR_TEXT_VJUSTIFY_BOTTOM:
@@ -227,22 +413,16 @@ void STROKE_FONT::Draw( const UTF8& aText, const VECTOR2D& aPosition, double aRo
             break;
 
         case GR_TEXT_VJUSTIFY_CENTER:
-            m_gal->Translate( VECTOR2D(0, -( lineCount - 1 ) * lineHeight / 2) );
+            offset.y += -( lineCount - 1 ) * lineHeight / 2;
             break;
 
         case GR_TEXT_VJUSTIFY_BOTTOM:
-            m_gal->Translate( VECTOR2D(0, -( lineCount - 1 ) * lineHeight ) );
+            offset.y += -( lineCount - 1 ) * lineHeight;
             break;
         }
     }
 
-    m_gal->SetIsStroke( true );
-    //m_gal->SetIsFill( false );
-
-    if( m_gal->IsFontBold() )
-        m_gal->SetLineWidth( m_gal->GetLineWidth() * BOLD_FACTOR );
-
-    // Split multiline strings into separate ones and draw them line by line
+    // Split multiline strings into separate ones and lay them out line by line
     size_t  begin = 0;
     size_t  newlinePos = aText.find( '\n' );
 
@@ -250,22 +430,21 @@ void STROKE_FONT::Draw( const UTF8& aText, const VECTOR2D& aPosition, double aRo
     {
         size_t length = newlinePos - begin;
 
-        drawSingleLineText( aText.substr( begin, length ) );
-        m_gal->Translate( VECTOR2D( 0.0, lineHeight ) );
+        layoutSingleLineText( aText.substr( begin, length ), offset, aRun );
+        offset.y += lineHeight;
 
         begin = newlinePos + 1;
         newlinePos = aText.find( '\n', begin );
     }
 
-    // Draw the last (or the only one) line
+    // The last (or the only one) line
     if( !aText.empty() )
-        drawSingleLineText( aText.substr( begin ) );
-
-    m_gal->Restore();
+        layoutSingleLineText( aText.substr( begin ), offset, aRun );
 }
 
 
-void STROKE_FONT::drawSingleLineText( const UTF8& aText )
+void STROKE_FONT::layoutSingleLineText( const UTF8& aText, const VECTOR2D& aOffset,
+                                        GLYPH_RUN& aRun ) const
 {
     double      xOffset;
     double      yOffset;
@@ -279,31 +458,28 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
     VECTOR2D textSize = computeTextLineSize( aText );
     double half_thickness = m_gal->GetLineWidth()/2;
 
-    // Context needs to be saved before any transformations
-    m_gal->Save();
-
     // First adjust: the text X position is corrected by half_thickness
     // because when the text with thickness is draw, its full size is textSize,
     // but the position of lines is half_thickness to textSize - half_thickness
     // so we must translate the coordinates by half_thickness on the X axis
     // to place the text inside the 0 to textSize X area.
-    m_gal->Translate( VECTOR2D( half_thickness, 0 ) );
+    VECTOR2D origin = aOffset + VECTOR2D( half_thickness, 0 );
 
     // Adjust the text position to the given horizontal justification
     switch( m_gal->GetHorizontalJustify() )
     {
     case GR_TEXT_HJUSTIFY_CENTER:
-        m_gal->Translate( VECTOR2D( -textSize.x / 2.0, 0 ) );
+        origin.x -= textSize.x / 2.0;
         break;
 
     case GR_TEXT_HJUSTIFY_RIGHT:
         if( !m_gal->IsTextMirrored() )
-            m_gal->Translate( VECTOR2D( -textSize.x, 0 ) );
+            origin.x -= textSize.x;
         break;
 
     case GR_TEXT_HJUSTIFY_LEFT:
         if( m_gal->IsTextMirrored() )
-            m_gal->Translate( VECTOR2D( -textSize.x, 0 ) );
+            origin.x -= textSize.x;
         break;
 
     default:
@@ -437,7 +613,7 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
             VECTOR2D startOverbar( overbar_start_x, overbar_start_y );
             VECTOR2D endOverbar( overbar_end_x, overbar_end_y );
 
-            m_gal->DrawLine( startOverbar, endOverbar );
+            aRun.push_back( { { origin + startOverbar, origin + endOverbar }, true } );
         }
         else
         {
@@ -446,7 +622,11 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
 
         for( const std::vector<VECTOR2D>* ptList : *glyph )
         {
-            std::deque<VECTOR2D> ptListScaled;
+            aRun.push_back( { {}, false } );
+
+            std::vector<VECTOR2D>& ptListScaled = aRun.back().m_points;
+
+            ptListScaled.reserve( ptList->size() );
 
             for( const VECTOR2D& pt : *ptList )
             {
@@ -462,16 +642,12 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
                         scaledPt.x -= scaledPt.y * STROKE_FONT::ITALIC_TILT;
                 }
 
-                ptListScaled.push_back( scaledPt );
+                ptListScaled.push_back( origin + scaledPt );
             }
-
-            m_gal->DrawPolyline( ptListScaled );
         }
 
         xOffset += glyphSize.x * bbox.GetEnd().x;
     }
-
-    m_gal->Restore();
 }
 
 
@@ -29,25 +29,29 @@
 #include <class_edge_mod.h>
 #include <class_pad.h>
 
-#include <functional>
-
-using namespace std;
+#include <fast_hash.h>
 
 // Common calculation part for all BOARD_ITEMs
-static inline size_t hash_board_item( const BOARD_ITEM* aItem, int aFlags )
+static inline void hash_board_item( FAST_HASH& aHash, const BOARD_ITEM* aItem, int aFlags )
 {
-    size_t ret = 0;
-
     if( aFlags & LAYER )
-        ret = hash<unsigned long long>{}( aItem->GetLayerSet().to_ullong() );
+        aHash.Add( aItem->GetLayerSet().to_ullong() );
+}
 
-    return ret;
+
+// Angles are hashed by value, so that 0.0 and -0.0 give the same hash
+static inline void hash_angle( FAST_HASH& aHash, double aAngle )
+{
+    aHash.Add( aAngle == 0.0 ? 0.0 : aAngle );
 }
 
 
 size_t hash_eda( const EDA_ITEM* aItem, int aFlags )
 {
-    size_t ret = 0xa82de1c0;
+    FAST_HASH hash( 0xa82de1c0 );
+
+    // The hashes of the children are summed, so their order doesn't matter
+    size_t    children = 0;
 
     switch( aItem->Type() )
     {
@@ -55,57 +59,57 @@ size_t hash_eda( const EDA_ITEM* aItem, int aFlags )
         {
             const MODULE* module = static_cast<const MODULE*>( aItem );
 
-            ret += hash_board_item( module, aFlags );
+            hash_board_item( hash, module, aFlags );
 
             if( aFlags & POSITION )
             {
-                ret += hash<int>{}( module->GetPosition().x );
-                ret += hash<int>{}( module->GetPosition().y );
+                hash.Add( module->GetPosition().x );
+                hash.Add( module->GetPosition().y );
             }
 
             if( aFlags & ROTATION )
-                ret += hash<double>{}( module->GetOrientation() );
+                hash_angle( hash, module->GetOrientation() );
 
             for( auto i : module->GraphicalItems() )
-                ret += hash_eda( i, aFlags );
+                children += hash_eda( i, aFlags );
 
             for( auto i : module->Pads() )
-                ret += hash_eda( static_cast<EDA_ITEM*>( i ), aFlags );
+                children += hash_eda( static_cast<EDA_ITEM*>( i ), aFlags );
         }
         break;
 
     case PCB_PAD_T:
         {
             const D_PAD* pad = static_cast<const D_PAD*>( aItem );
-            ret += hash_board_item( pad, aFlags );
-            ret += hash<int>{}( pad->GetShape() << 16 );
-            ret += hash<int>{}( pad->GetDrillShape() << 18 );
-            ret += hash<int>{}( pad->GetSize().x << 8 );
-            ret += hash<int>{}( pad->GetSize().y << 9 );
-            ret += hash<int>{}( pad->GetOffset().x << 6 );
-            ret += hash<int>{}( pad->GetOffset().y << 7 );
-            ret += hash<int>{}( pad->GetDelta().x << 4 );
-            ret += hash<int>{}( pad->GetDelta().y << 5 );
+            hash_board_item( hash, pad, aFlags );
+            hash.Add( pad->GetShape() );
+            hash.Add( pad->GetDrillShape() );
+            hash.Add( pad->GetSize().x );
+            hash.Add( pad->GetSize().y );
+            hash.Add( pad->GetOffset().x );
+            hash.Add( pad->GetOffset().y );
+            hash.Add( pad->GetDelta().x );
+            hash.Add( pad->GetDelta().y );
 
             if( aFlags & POSITION )
             {
                 if( aFlags & REL_COORD )
                 {
-                    ret += hash<int>{}( pad->GetPos0().x );
-                    ret += hash<int>{}( pad->GetPos0().y );
+                    hash.Add( pad->GetPos0().x );
+                    hash.Add( pad->GetPos0().y );
                 }
                 else
                 {
-                    ret += hash<int>{}( pad->GetPosition().x );
-                    ret += hash<int>{}( pad->GetPosition().y );
+                    hash.Add( pad->GetPosition().x );
+                    hash.Add( pad->GetPosition().y );
                 }
             }
 
             if( aFlags & ROTATION )
-                ret += hash<double>{}( pad->GetOrientation() );
+                hash_angle( hash, pad->GetOrientation() );
 
             if( aFlags & NET )
-                ret += hash<int>{}( pad->GetNetCode() << 6 );
+                hash.Add( pad->GetNetCode() );
         }
         break;
 
@@ -119,64 +123,64 @@ size_t hash_eda( const EDA_ITEM* aItem, int aFlags )
             if( !( aFlags & VALUE ) && text->GetType() == TEXTE_MODULE::TEXT_is_VALUE )
                 break;
 
-            ret += hash_board_item( text, aFlags );
-            ret += hash<string>{}( text->GetText().ToStdString() );
-            ret += hash<bool>{}( text->IsItalic() );
-            ret += hash<bool>{}( text->IsBold() );
-            ret += hash<bool>{}( text->IsMirrored() );
-            ret += hash<int>{}( text->GetTextWidth() );
-            ret += hash<int>{}( text->GetTextHeight() );
-            ret += hash<int>{}( text->GetHorizJustify() );
-            ret += hash<int>{}( text->GetVertJustify() );
+            hash_board_item( hash, text, aFlags );
+            hash.Add( text->GetText().ToStdString() );
+            hash.Add( text->IsItalic() );
+            hash.Add( text->IsBold() );
+            hash.Add( text->IsMirrored() );
+            hash.Add( text->GetTextWidth() );
+            hash.Add( text->GetTextHeight() );
+            hash.Add( text->GetHorizJustify() );
+            hash.Add( text->GetVertJustify() );
 
             if( aFlags & POSITION )
             {
                 if( aFlags & REL_COORD )
                 {
-                    ret += hash<int>{}( text->GetPos0().x );
-                    ret += hash<int>{}( text->GetPos0().y );
+                    hash.Add( text->GetPos0().x );
+                    hash.Add( text->GetPos0().y );
                 }
                 else
                 {
-                    ret += hash<int>{}( text->GetPosition().x );
-                    ret += hash<int>{}( text->GetPosition().y );
+                    hash.Add( text->GetPosition().x );
+                    hash.Add( text->GetPosition().y );
                 }
             }
 
             if( aFlags & ROTATION )
-                ret += hash<double>{}( text->GetTextAngle() );
+                hash_angle( hash, text->GetTextAngle() );
         }
         break;
 
     case PCB_MODULE_EDGE_T:
         {
             const EDGE_MODULE* segment = static_cast<const EDGE_MODULE*>( aItem );
-            ret += hash_board_item( segment, aFlags );
-            ret += hash<int>{}( segment->GetType() );
-            ret += hash<int>{}( segment->GetShape() );
-            ret += hash<int>{}( segment->GetWidth() );
-            ret += hash<int>{}( segment->GetRadius() );
+            hash_board_item( hash, segment, aFlags );
+            hash.Add( segment->GetType() );
+            hash.Add( segment->GetShape() );
+            hash.Add( segment->GetWidth() );
+            hash.Add( segment->GetRadius() );
 
             if( aFlags & POSITION )
             {
                 if( aFlags & REL_COORD )
                 {
-                    ret += hash<int>{}( segment->GetStart0().x );
-                    ret += hash<int>{}( segment->GetStart0().y );
-                    ret += hash<int>{}( segment->GetEnd0().x );
-                    ret += hash<int>{}( segment->GetEnd0().y );
+                    hash.Add( segment->GetStart0().x );
+                    hash.Add( segment->GetStart0().y );
+                    hash.Add( segment->GetEnd0().x );
+                    hash.Add( segment->GetEnd0().y );
                 }
                 else
                 {
-                    ret += hash<int>{}( segment->GetStart().x );
-                    ret += hash<int>{}( segment->GetStart().y );
-                    ret += hash<int>{}( segment->GetEnd().x );
-                    ret += hash<int>{}( segment->GetEnd().y );
+                    hash.Add( segment->GetStart().x );
+                    hash.Add( segment->GetStart().y );
+                    hash.Add( segment->GetEnd().x );
+                    hash.Add( segment->GetEnd().y );
                 }
             }
 
             if( aFlags & ROTATION )
-                ret += hash<double>{}( segment->GetAngle() );
+                hash_angle( hash, segment->GetAngle() );
         }
         break;
 
@@ -184,5 +188,5 @@ size_t hash_eda( const EDA_ITEM* aItem, int aFlags )
         wxASSERT_MSG( false, "Unhandled type in function hashModItem() (exporter_gencad.cpp)" );
     }
 
-    return ret;
+    return (size_t) hash.Digest64() + children;
 }
@@ -31,7 +31,8 @@ using namespace KIGFX;
 
 PAINTER::PAINTER( GAL* aGal ) :
     m_gal( aGal ),
-    m_brightenedColor( 0.0, 1.0, 0.0, 0.9 )
+    m_brightenedColor( 0.0, 1.0, 0.0, 0.9 ),
+    m_lodTolerance( 0.0 )
 {
 }
 
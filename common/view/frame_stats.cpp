@@ -0,0 +1,212 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <view/frame_stats.h>
+#include <gal/graphics_abstraction_layer.h>
+
+#include <algorithm>
+#include <functional>
+
+using namespace KIGFX;
+
+
+// 120, 60, 30, 15 and 7.5 frames per second
+const std::vector<double> FRAME_STATS::BUCKET_LIMITS = { 8.3, 16.7, 33.3, 66.7, 133.3 };
+
+
+FRAME_STATS::FRAME_STATS()
+{
+}
+
+
+void FRAME_STATS::AddFrame( const FRAME& aFrame, const VIEW::DRAW_STATS& aViewStats )
+{
+    m_history.push_back( aFrame );
+
+    if( m_history.size() > HISTORY_SIZE )
+        m_history.pop_front();
+
+    m_lastViewStats = aViewStats;
+}
+
+
+const FRAME_STATS::FRAME& FRAME_STATS::GetLastFrame() const
+{
+    static const FRAME empty;
+
+    return m_history.empty() ? empty : m_history.back();
+}
+
+
+std::vector<int> FRAME_STATS::GetHistogram() const
+{
+    std::vector<int> histogram( BUCKET_LIMITS.size() + 1, 0 );
+
+    for( const FRAME& frame : m_history )
+    {
+        auto bucket = std::lower_bound( BUCKET_LIMITS.begin(), BUCKET_LIMITS.end(),
+                                        frame.m_total );
+
+        histogram[bucket - BUCKET_LIMITS.begin()]++;
+    }
+
+    return histogram;
+}
+
+
+double FRAME_STATS::GetCacheHitRate() const
+{
+    int drawn = m_lastViewStats.m_cacheHits + m_lastViewStats.m_cacheMisses;
+
+    return drawn > 0 ? (double) m_lastViewStats.m_cacheHits / drawn : 1.0;
+}
+
+
+std::vector<wxString> FRAME_STATS::formatLines() const
+{
+    const FRAME&          frame = GetLastFrame();
+    std::vector<wxString> lines;
+
+    lines.push_back( wxString::Format( "Frame %.1f ms (%.0f fps)", frame.m_total,
+                                       frame.m_total > 0.0 ? 1000.0 / frame.m_total : 0.0 ) );
+
+    lines.push_back( wxString::Format( "update %.1f  paint %.1f  upload %.1f  draw %.1f  "
+                                       "composite %.1f ms",
+                                       frame.m_update, frame.m_paint, frame.m_upload,
+                                       frame.m_draw, frame.m_composite ) );
+
+    lines.push_back( wxString::Format( "%d items updated, %.1f%% drawn from cache",
+                                       m_lastViewStats.m_updatedItems,
+                                       100.0 * GetCacheHitRate() ) );
+
+    // The layers with the most items drawn
+    std::vector<std::pair<int, int>> layers;
+
+    for( size_t i = 0; i < m_lastViewStats.m_layerItems.size(); i++ )
+    {
+        if( m_lastViewStats.m_layerItems[i] > 0 )
+            layers.emplace_back( m_lastViewStats.m_layerItems[i], (int) i );
+    }
+
+    std::sort( layers.begin(), layers.end(), std::greater<std::pair<int, int>>() );
+
+    wxString line = wxT( "items per layer:" );
+
+    for( size_t i = 0; i < layers.size() && i < 5; i++ )
+        line += wxString::Format( "  %d: %d", layers[i].second, layers[i].first );
+
+    lines.push_back( line );
+
+    return lines;
+}
+
+
+wxString FRAME_STATS::Format() const
+{
+    wxString text;
+
+    for( const wxString& line : formatLines() )
+    {
+        if( !text.IsEmpty() )
+            text += wxT( "; " );
+
+        text += line;
+    }
+
+    return text;
+}
+
+
+void FRAME_STATS::Draw( GAL* aGal, const VIEW* aView ) const
+{
+    // Sizes in pixels
+    const double margin = 8.0;
+    const double lineHeight = 16.0;
+    const double width = 440.0;
+    const double labelWidth = 110.0;
+
+    const std::vector<wxString> lines = formatLines();
+    const std::vector<int>      histogram = GetHistogram();
+    const double                height = ( lines.size() + histogram.size() ) * lineHeight;
+
+    auto toWorld =
+            [&]( double aX, double aY ) -> VECTOR2D
+            {
+                return aView->ToWorld( VECTOR2D( aX, aY ) );
+            };
+
+    // Background, behind the text
+    aGal->SetLayerDepth( aGal->GetMinDepth() + 1 );
+    aGal->SetIsFill( true );
+    aGal->SetIsStroke( false );
+    aGal->SetFillColor( COLOR4D( 0.0, 0.0, 0.0, 0.7 ) );
+    aGal->DrawRectangle( toWorld( 0.0, 0.0 ), toWorld( width, height + 2 * margin ) );
+
+    aGal->SetLayerDepth( aGal->GetMinDepth() );
+    aGal->SetStrokeColor( COLOR4D( 1.0, 1.0, 1.0, 1.0 ) );
+    aGal->SetFillColor( COLOR4D( 0.3, 0.8, 0.3, 1.0 ) );
+    aGal->SetLineWidth( aView->ToWorld( 1.0 ) );
+    aGal->SetGlyphSize( VECTOR2D( aView->ToWorld( 9.0 ), aView->ToWorld( 9.0 ) ) );
+    aGal->SetFontBold( false );
+    aGal->SetFontItalic( false );
+    aGal->SetTextMirrored( false );
+    aGal->SetHorizontalJustify( GR_TEXT_HJUSTIFY_LEFT );
+    aGal->SetVerticalJustify( GR_TEXT_VJUSTIFY_CENTER );
+
+    double y = margin + lineHeight / 2.0;
+
+    for( const wxString& line : lines )
+    {
+        aGal->SetIsStroke( true );
+        aGal->BitmapText( line, toWorld( margin, y ), 0.0 );
+        y += lineHeight;
+    }
+
+    // Histogram of the recent frame times, one bar per bucket
+    const double barLength = width - labelWidth - 2 * margin;
+
+    for( size_t i = 0; i < histogram.size(); i++ )
+    {
+        wxString label;
+
+        if( i < BUCKET_LIMITS.size() )
+            label.Printf( "< %.0f ms: %d", BUCKET_LIMITS[i], histogram[i] );
+        else
+            label.Printf( "> %.0f ms: %d", BUCKET_LIMITS.back(), histogram[i] );
+
+        aGal->SetIsStroke( true );
+        aGal->BitmapText( label, toWorld( margin, y ), 0.0 );
+
+        if( histogram[i] > 0 )
+        {
+            double length = barLength * histogram[i] / m_history.size();
+            double left = margin + labelWidth;
+
+            aGal->SetIsStroke( false );
+            aGal->DrawRectangle( toWorld( left, y - lineHeight / 3.0 ),
+                                 toWorld( left + length, y + lineHeight / 3.0 ) );
+        }
+
+        y += lineHeight;
+    }
+}
@@ -33,10 +33,18 @@
 #include <view/view_rtree.h>
 #include <view/view_overlay.h>
 
+#include <gal/cairo/cairo_image_gal.h>
 #include <gal/definitions.h>
 #include <gal/graphics_abstraction_layer.h>
+#include <gal/recording_gal.h>
 #include <painter.h>
 
+#include <atomic>
+#include <future>
+#include <map>
+#include <thread>
+#include <unordered_set>
+
 #ifdef __WXDEBUG__
 #include <profile.h>
 #endif /* __WXDEBUG__  */
@@ -45,6 +53,41 @@ namespace KIGFX {
 
 class VIEW;
 
+struct VIEW::RECORDED_ITEM
+{
+    ///> False if the painter doesn't know the item: it is drawn the usual way
+    bool m_drawn = false;
+
+    ///> Recorded calls for each recorded layer of the item
+    std::vector<std::pair<int, RECORDING_GAL::COMMANDS>> m_layers;
+
+    ///> Bounding box of the item, taken by the thread drawing it
+    BOX2I m_bbox;
+
+    ///> Scale of the view when the item was recorded
+    double m_scale = 0.0;
+
+    ///> Color generation of the view when the item was recorded
+    int m_colorGeneration = 0;
+
+    ///> Returns the recorded calls for a layer, or nullptr if the item has to be drawn the
+    ///> usual way or was not recorded on this layer
+    const RECORDING_GAL::COMMANDS* getLayer( int aLayer ) const
+    {
+        if( !m_drawn )
+            return nullptr;
+
+        for( const auto& layer : m_layers )
+        {
+            if( layer.first == aLayer )
+                return &layer.second;
+        }
+
+        return nullptr;
+    }
+};
+
+
 class VIEW_ITEM_DATA
 {
 public:
@@ -54,7 +97,9 @@ public:
         m_requiredUpdate( KIGFX::NONE ),
         m_drawPriority( 0 ),
         m_groups( nullptr ),
-        m_groupsSize( 0 ) {}
+        m_groupsSize( 0 ),
+        m_lodGroups( nullptr ),
+        m_lodGroupsSize( 0 ) {}
 
     ~VIEW_ITEM_DATA()
     {
@@ -99,6 +144,51 @@ private:
     GroupPair* m_groups;
     int        m_groupsSize;
 
+    ///> Same as m_groups, for the simplified variants drawn when the view is zoomed out
+    ///> (see VIEW::SetLODScale()).
+    GroupPair* m_lodGroups;
+    int        m_lodGroupsSize;
+
+    ///> Drawing calls replayed by the tiled redraws (see VIEW::SetTileSize()), kept until the
+    ///> item is updated.
+    std::unique_ptr<VIEW::RECORDED_ITEM> m_recording;
+
+    static int findGroup( const GroupPair* aGroups, int aSize, int aLayer )
+    {
+        for( int i = 0; i < aSize; ++i )
+        {
+            if( aGroups[i].first == aLayer )
+                return aGroups[i].second;
+        }
+
+        return -1;
+    }
+
+    static void storeGroup( GroupPair*& aGroups, int& aSize, int aLayer, int aGroup )
+    {
+        // Look if there is already an entry for the layer
+        for( int i = 0; i < aSize; ++i )
+        {
+            if( aGroups[i].first == aLayer )
+            {
+                aGroups[i].second = aGroup;
+                return;
+            }
+        }
+
+        // If there was no entry for the given layer - create one
+        GroupPair* newGroups = new GroupPair[aSize + 1];
+
+        if( aSize > 0 )
+        {
+            std::copy( aGroups, aGroups + aSize, newGroups );
+            delete[] aGroups;
+        }
+
+        aGroups = newGroups;
+        newGroups[aSize++] = GroupPair( aLayer, aGroup );
+    }
+
     /**
      * Function getGroup()
      * Returns number of the group id for the given layer, or -1 in case it was not cached before.
@@ -108,13 +198,17 @@ private:
      */
     int getGroup( int aLayer ) const
     {
-        for( int i = 0; i < m_groupsSize; ++i )
-        {
-            if( m_groups[i].first == aLayer )
-                return m_groups[i].second;
-        }
+        return findGroup( m_groups, m_groupsSize, aLayer );
+    }
 
-        return -1;
+    /**
+     * Function getLODGroup()
+     * Returns the group id of the simplified variant for the given layer, or -1 in case it was
+     * not cached.
+     */
+    int getLODGroup( int aLayer ) const
+    {
+        return findGroup( m_lodGroups, m_lodGroupsSize, aLayer );
     }
 
     /**
@@ -125,13 +219,18 @@ private:
      */
     std::vector<int> getAllGroups() const
     {
-        std::vector<int> groups( m_groupsSize );
+        std::vector<int> groups( m_groupsSize + m_lodGroupsSize );
 
         for( int i = 0; i < m_groupsSize; ++i )
         {
             groups[i] = m_groups[i].second;
         }
 
+        for( int i = 0; i < m_lodGroupsSize; ++i )
+        {
+            groups[m_groupsSize + i] = m_lodGroups[i].second;
+        }
+
         return groups;
     }
 
@@ -144,27 +243,16 @@ private:
      */
     void setGroup( int aLayer, int aGroup )
     {
-        // Look if there is already an entry for the layer
-        for( int i = 0; i < m_groupsSize; ++i )
-        {
-            if( m_groups[i].first == aLayer )
-            {
-                m_groups[i].second = aGroup;
-                return;
-            }
-        }
-
-        // If there was no entry for the given layer - create one
-        GroupPair* newGroups = new GroupPair[m_groupsSize + 1];
-
-        if( m_groupsSize > 0 )
-        {
-            std::copy( m_groups, m_groups + m_groupsSize, newGroups );
-            delete[] m_groups;
-        }
+        storeGroup( m_groups, m_groupsSize, aLayer, aGroup );
+    }
 
-        m_groups = newGroups;
-        newGroups[m_groupsSize++] = GroupPair( aLayer, aGroup );
+    /**
+     * Function setLODGroup()
+     * Sets the group id of the simplified variant for the item and the layer combination.
+     */
+    void setLODGroup( int aLayer, int aGroup )
+    {
+        storeGroup( m_lodGroups, m_lodGroupsSize, aLayer, aGroup );
     }
 
 
@@ -177,6 +265,12 @@ private:
         delete[] m_groups;
         m_groups = nullptr;
         m_groupsSize = 0;
+
+        delete[] m_lodGroups;
+        m_lodGroups = nullptr;
+        m_lodGroupsSize = 0;
+
+        m_recording.reset();
     }
 
 
@@ -200,19 +294,25 @@ private:
      */
     void reorderGroups( std::unordered_map<int, int> aReorderMap )
     {
-        for( int i = 0; i < m_groupsSize; ++i )
+        auto reorder = [&aReorderMap]( GroupPair* aGroups, int aSize )
         {
-            int orig_layer = m_groups[i].first;
-            int new_layer = orig_layer;
-
-            try
+            for( int i = 0; i < aSize; ++i )
             {
-                new_layer = aReorderMap.at( orig_layer );
+                int orig_layer = aGroups[i].first;
+                int new_layer = orig_layer;
+
+                try
+                {
+                    new_layer = aReorderMap.at( orig_layer );
+                }
+                catch( const std::out_of_range& ) {}
+
+                aGroups[i].first = new_layer;
             }
-            catch( const std::out_of_range& ) {}
+        };
 
-            m_groups[i].first = new_layer;
-        }
+        reorder( m_groups, m_groupsSize );
+        reorder( m_lodGroups, m_lodGroupsSize );
     }
 
 
@@ -293,7 +393,13 @@ VIEW::VIEW( bool aIsDynamic ) :
     m_dynamic( aIsDynamic ),
     m_useDrawPriority( false ),
     m_nextDrawPriority( 0 ),
-    m_reverseDrawOrder( false )
+    m_reverseDrawOrder( false ),
+    m_parallelCacheThreshold( std::thread::hardware_concurrency() > 1 ? 256 : 0 ),
+    m_replayItem( nullptr ),
+    m_lodScale( 0.0 ),
+    m_lodDirty( true ),
+    m_tileSize( 0 ),
+    m_colorGeneration( 0 )
 {
     // Set m_boundary to define the max area size. The default area size
     // is defined here as the max value of a int.
@@ -392,6 +498,8 @@ void VIEW::Remove( VIEW_ITEM* aItem )
         viewData->clearUpdateFlags();
     }
 
+    m_lodPending.erase( aItem );
+
     int layers[VIEW::VIEW_MAX_LAYERS], layers_count;
     viewData->getLayers( layers, layers_count );
 
@@ -404,6 +512,11 @@ void VIEW::Remove( VIEW_ITEM* aItem )
         // Clear the GAL cache
         int prevGroup = viewData->getGroup( layers[i] );
 
+        if( prevGroup >= 0 )
+            m_gal->DeleteGroup( prevGroup );
+
+        prevGroup = viewData->getLODGroup( layers[i] );
+
         if( prevGroup >= 0 )
             m_gal->DeleteGroup( prevGroup );
     }
@@ -413,6 +526,105 @@ void VIEW::Remove( VIEW_ITEM* aItem )
 }
 
 
+void VIEW::BulkAdd( const std::vector<VIEW_ITEM*>& aItems )
+{
+    int layers[VIEW_MAX_LAYERS], layers_count;
+    std::map<int, std::vector<VIEW_ITEM*>> layerItems;
+
+    m_allItems->reserve( m_allItems->size() + aItems.size() );
+
+    for( VIEW_ITEM* item : aItems )
+    {
+        if( !item->m_viewPrivData )
+            item->m_viewPrivData = new VIEW_ITEM_DATA;
+
+        item->m_viewPrivData->m_view = this;
+        item->m_viewPrivData->m_drawPriority = m_nextDrawPriority++;
+
+        item->ViewGetLayers( layers, layers_count );
+        item->viewPrivData()->saveLayers( layers, layers_count );
+
+        m_allItems->push_back( item );
+
+        for( int i = 0; i < layers_count; ++i )
+            layerItems[layers[i]].push_back( item );
+    }
+
+    // Each layer tree is built once with all its new items
+    for( auto& entry : layerItems )
+    {
+        VIEW_LAYER& l = m_layers[entry.first];
+        l.items->Insert( entry.second );
+        MarkTargetDirty( l.target );
+    }
+
+    for( VIEW_ITEM* item : aItems )
+    {
+        SetVisible( item, true );
+        Update( item, KIGFX::INITIAL_ADD );
+    }
+}
+
+
+void VIEW::BulkRemove( const std::vector<VIEW_ITEM*>& aItems )
+{
+    int layers[VIEW_MAX_LAYERS], layers_count;
+    std::map<int, std::vector<VIEW_ITEM*>> layerItems;
+    std::unordered_set<VIEW_ITEM*> removed;
+
+    for( VIEW_ITEM* item : aItems )
+    {
+        auto viewData = item ? item->viewPrivData() : nullptr;
+
+        if( !viewData )
+            continue;
+
+        wxCHECK2( viewData->m_view == this, continue );
+
+        removed.insert( item );
+        m_lodPending.erase( item );
+        viewData->clearUpdateFlags();
+        viewData->getLayers( layers, layers_count );
+
+        for( int i = 0; i < layers_count; ++i )
+        {
+            layerItems[layers[i]].push_back( item );
+
+            // Clear the GAL cache
+            int prevGroup = viewData->getGroup( layers[i] );
+
+            if( prevGroup >= 0 )
+                m_gal->DeleteGroup( prevGroup );
+
+            prevGroup = viewData->getLODGroup( layers[i] );
+
+            if( prevGroup >= 0 )
+                m_gal->DeleteGroup( prevGroup );
+        }
+
+        viewData->deleteGroups();
+        viewData->m_view = nullptr;
+    }
+
+    if( removed.empty() )
+        return;
+
+    m_allItems->erase( std::remove_if( m_allItems->begin(), m_allItems->end(),
+                                       [&removed]( VIEW_ITEM* aItem )
+                                       {
+                                           return removed.count( aItem ) > 0;
+                                       } ),
+                       m_allItems->end() );
+
+    for( auto& entry : layerItems )
+    {
+        VIEW_LAYER& l = m_layers[entry.first];
+        l.items->Remove( entry.second );
+        MarkTargetDirty( l.target );
+    }
+}
+
+
 void VIEW::SetRequired( int aLayerId, int aRequiredId, bool aRequired )
 {
     wxCHECK( (unsigned) aLayerId < m_layers.size(), /*void*/ );
@@ -762,6 +974,11 @@ struct VIEW::updateItemsColor
         const COLOR4D color = painter->GetSettings()->GetColor( aItem, layer );
         int group = aItem->viewPrivData()->getGroup( layer );
 
+        if( group >= 0 )
+            gal->ChangeGroupColor( group, color );
+
+        group = aItem->viewPrivData()->getLODGroup( layer );
+
         if( group >= 0 )
             gal->ChangeGroupColor( group, color );
 
@@ -776,6 +993,9 @@ struct VIEW::updateItemsColor
 
 void VIEW::UpdateLayerColor( int aLayer )
 {
+    // Recordings have their colors baked in, whichever layer they are drawn on
+    ++m_colorGeneration;
+
     // There is no point in updating non-cached layers
     if( !IsCached( aLayer ) )
         return;
@@ -797,6 +1017,8 @@ void VIEW::UpdateLayerColor( int aLayer )
 
 void VIEW::UpdateAllLayersColor()
 {
+    ++m_colorGeneration;
+
     if( m_gal->IsVisible() )
     {
         GAL_UPDATE_CONTEXT ctx( m_gal );
@@ -816,6 +1038,11 @@ void VIEW::UpdateAllLayersColor()
                 const COLOR4D color = m_painter->GetSettings()->GetColor( item, layers[i] );
                 int group = viewData->getGroup( layers[i] );
 
+                if( group >= 0 )
+                    m_gal->ChangeGroupColor( group, color );
+
+                group = viewData->getLODGroup( layers[i] );
+
                 if( group >= 0 )
                     m_gal->ChangeGroupColor( group, color );
             }
@@ -837,6 +1064,11 @@ struct VIEW::changeItemsDepth
     {
         int group = aItem->viewPrivData()->getGroup( layer );
 
+        if( group >= 0 )
+            gal->ChangeGroupDepth( group, depth );
+
+        group = aItem->viewPrivData()->getLODGroup( layer );
+
         if( group >= 0 )
             gal->ChangeGroupDepth( group, depth );
 
@@ -946,6 +1178,11 @@ void VIEW::UpdateAllLayersOrder()
             {
                 int group = viewData->getGroup( layers[i] );
 
+                if( group >= 0 )
+                    m_gal->ChangeGroupDepth( group, m_layers[layers[i]].renderingOrder );
+
+                group = viewData->getLODGroup( layers[i] );
+
                 if( group >= 0 )
                     m_gal->ChangeGroupDepth( group, m_layers[layers[i]].renderingOrder );
             }
@@ -961,7 +1198,8 @@ struct VIEW::drawItem
     drawItem( VIEW* aView, int aLayer, bool aUseDrawPriority, bool aReverseDrawOrder ) :
         view( aView ), layer( aLayer ),
         useDrawPriority( aUseDrawPriority ),
-        reverseDrawOrder( aReverseDrawOrder )
+        reverseDrawOrder( aReverseDrawOrder ),
+        drawnCount( 0 )
     {
     }
 
@@ -975,6 +1213,8 @@ struct VIEW::drawItem
         if( !drawCondition )
             return true;
 
+        drawnCount++;
+
         if( useDrawPriority )
             drawItems.push_back( aItem );
         else
@@ -983,7 +1223,7 @@ struct VIEW::drawItem
         return true;
     }
 
-    void deferredDraw()
+    void sortItems()
     {
         if( reverseDrawOrder )
             std::sort( drawItems.begin(), drawItems.end(),
@@ -995,6 +1235,11 @@ struct VIEW::drawItem
                        []( VIEW_ITEM* a, VIEW_ITEM* b ) -> bool {
                            return a->viewPrivData()->m_drawPriority < b->viewPrivData()->m_drawPriority;
                        });
+    }
+
+    void deferredDraw()
+    {
+        sortItems();
 
         for( auto item : drawItems )
             view->draw( item, layer );
@@ -1003,12 +1248,16 @@ struct VIEW::drawItem
     VIEW* view;
     int layer, layers[VIEW_MAX_LAYERS];
     bool useDrawPriority, reverseDrawOrder;
+    int drawnCount;
     std::vector<VIEW_ITEM*> drawItems;
 };
 
 
 void VIEW::redrawRect( const BOX2I& aRect )
 {
+    if( m_tileSize > 0 && redrawTiles( aRect ) )
+        return;
+
     for( VIEW_LAYER* l : m_orderedLayers )
     {
         if( l->visible && IsTargetDirty( l->target ) && areRequiredLayersEnabled( l->id ) )
@@ -1021,11 +1270,208 @@ void VIEW::redrawRect( const BOX2I& aRect )
 
             if( m_useDrawPriority )
                 drawFunc.deferredDraw();
+
+            m_drawStats.m_layerItems[l->id] += drawFunc.drawnCount;
         }
     }
 }
 
 
+bool VIEW::redrawTiles( const BOX2I& aRect )
+{
+    CAIRO_GAL_BASE* gal = dynamic_cast<CAIRO_GAL_BASE*>( m_gal );
+    cairo_t*        context = gal ? gal->GetTargetContext() : nullptr;
+
+    // Printing surfaces are not tiled
+    if( !context || cairo_surface_get_type( cairo_get_target( context ) )
+                            != CAIRO_SURFACE_TYPE_IMAGE )
+    {
+        return false;
+    }
+
+    // The items to draw, in the order redrawRect() draws them
+    std::vector<std::pair<VIEW_ITEM*, VIEW_LAYER*>> drawn;
+
+    for( VIEW_LAYER* l : m_orderedLayers )
+    {
+        if( l->visible && IsTargetDirty( l->target ) && areRequiredLayersEnabled( l->id ) )
+        {
+            drawItem collector( this, l->id, true, m_reverseDrawOrder );
+            l->items->Query( aRect, collector );
+
+            if( m_useDrawPriority )
+                collector.sortItems();
+
+            for( VIEW_ITEM* item : collector.drawItems )
+                drawn.emplace_back( item, l );
+        }
+    }
+
+    if( drawn.empty() )
+        return false;
+
+    // Recordings are replayed until their items are updated or the colors change, except on
+    // the overlay and, once the view is zoomed, on the layers which are not cached (the painter
+    // may draw them with a constant size on the screen).  Stale items are recorded with all
+    // their drawn layers.
+    std::set<std::pair<VIEW_ITEM*, int>> drawnLayers;
+    std::unordered_set<VIEW_ITEM*>       stale;
+    std::vector<VIEW_ITEM*>              items;
+
+    for( const auto& entry : drawn )
+    {
+        const RECORDED_ITEM* recording = entry.first->viewPrivData()->m_recording.get();
+        const VIEW_LAYER*    l = entry.second;
+
+        drawnLayers.emplace( entry.first, l->id );
+
+        if( !recording || l->target == TARGET_OVERLAY
+                || recording->m_colorGeneration != m_colorGeneration
+                || ( recording->m_drawn && !recording->getLayer( l->id ) )
+                || ( !IsCached( l->id ) && recording->m_scale != m_scale ) )
+        {
+            if( stale.insert( entry.first ).second )
+                items.push_back( entry.first );
+        }
+    }
+
+    if( !items.empty() )
+    {
+        std::vector<RECORDED_ITEM> recorded;
+
+        recordItems( items, recorded,
+                     [&drawnLayers]( VIEW_ITEM* aItem, int aLayer )
+                     {
+                         return drawnLayers.count( std::make_pair( aItem, aLayer ) ) > 0;
+                     } );
+
+        if( recorded.empty() )
+            return false;
+
+        m_drawStats.m_recordedItems += items.size();
+
+        for( size_t i = 0; i < items.size(); ++i )
+        {
+            recorded[i].m_scale = m_scale;
+            recorded[i].m_colorGeneration = m_colorGeneration;
+            items[i]->viewPrivData()->m_recording.reset(
+                    new RECORDED_ITEM( std::move( recorded[i] ) ) );
+        }
+    }
+
+    // Tiles, and the part of the world they show
+    const VECTOR2I     screenSize = m_gal->GetScreenPixelSize();
+    std::vector<BOX2I> tiles;
+    std::vector<BOX2I> tileViews;
+
+    for( int y = 0; y < screenSize.y; y += m_tileSize )
+    {
+        for( int x = 0; x < screenSize.x; x += m_tileSize )
+        {
+            BOX2I tile( VECTOR2I( x, y ), VECTOR2I( m_tileSize, m_tileSize ) );
+            BOX2D world( ToWorld( tile.GetOrigin() ), VECTOR2D( 0, 0 ) );
+
+            world.Merge( ToWorld( VECTOR2D( tile.GetRight(), tile.GetTop() ) ) );
+            world.Merge( ToWorld( VECTOR2D( tile.GetLeft(), tile.GetBottom() ) ) );
+            world.Merge( ToWorld( tile.GetEnd() ) );
+
+            tiles.push_back( tile );
+            tileViews.emplace_back( VECTOR2I( world.GetPosition() ), VECTOR2I( world.GetSize() ) );
+            tileViews.back().Inflate( 1 );
+        }
+    }
+
+    size_t threads = std::min<size_t>( std::max( std::thread::hardware_concurrency(), 1u ),
+                                       tiles.size() );
+
+    // The tile GALs draw straight to the target, they don't need an image of their own
+    GAL_DISPLAY_OPTIONS                           options;
+    std::vector<std::unique_ptr<CAIRO_IMAGE_GAL>> tileGals;
+
+    for( size_t ii = 0; ii < threads; ++ii )
+        tileGals.emplace_back( new CAIRO_IMAGE_GAL( options, 1, 1 ) );
+
+    // Consecutive items drawn to the same target, with their bounding boxes
+    std::vector<std::pair<const RECORDING_GAL::COMMANDS*, const BOX2I*>> batch;
+
+    auto drawBatch =
+            [&]()
+            {
+                if( batch.empty() )
+                    return;
+
+                cairo_t*            target = gal->GetTargetContext();
+                std::atomic<size_t> next( 0 );
+
+                // Tiles don't overlap, so each one can be drawn by a different thread
+                auto worker =
+                        [&]( size_t aThread )
+                        {
+                            CAIRO_IMAGE_GAL* tileGal = tileGals[aThread].get();
+
+                            for( size_t i = next++; i < tiles.size(); i = next++ )
+                            {
+                                if( !tileGal->AttachToArea( target, *m_gal, tiles[i] ) )
+                                    continue;
+
+                                for( const auto& entry : batch )
+                                {
+                                    if( entry.second->Intersects( tileViews[i] ) )
+                                        RECORDING_GAL::Replay( *entry.first, *tileGal );
+                                }
+
+                                tileGal->Flush();
+                            }
+                        };
+
+                std::vector<std::future<void>> returns;
+
+                for( size_t ii = 1; ii < threads; ++ii )
+                    returns.emplace_back( std::async( std::launch::async, worker, ii ) );
+
+                worker( 0 );
+
+                for( std::future<void>& ret : returns )
+                    ret.get();
+
+                cairo_surface_mark_dirty( cairo_get_target( target ) );
+                batch.clear();
+            };
+
+    for( size_t i = 0; i < drawn.size(); ++i )
+    {
+        VIEW_ITEM*                     item = drawn[i].first;
+        VIEW_LAYER*                    l = drawn[i].second;
+        const RECORDED_ITEM*           rec = item->viewPrivData()->m_recording.get();
+        const RECORDING_GAL::COMMANDS* commands = rec->getLayer( l->id );
+
+        m_drawStats.m_layerItems[l->id]++;
+
+        if( i == 0 || l->target != drawn[i - 1].second->target )
+        {
+            drawBatch();
+            m_gal->SetTarget( l->target );
+        }
+
+        if( commands )
+        {
+            batch.emplace_back( commands, &rec->m_bbox );
+        }
+        else
+        {
+            // Items the painter doesn't know are drawn the usual way, in between the batches
+            drawBatch();
+            m_gal->SetLayerDepth( l->renderingOrder );
+            draw( item, l->id );
+        }
+    }
+
+    drawBatch();
+
+    return true;
+}
+
+
 void VIEW::draw( VIEW_ITEM* aItem, int aLayer, bool aImmediate )
 {
     auto viewData = aItem->viewPrivData();
@@ -1035,13 +1481,23 @@ void VIEW::draw( VIEW_ITEM* aItem, int aLayer, bool aImmediate )
 
     if( IsCached( aLayer ) && !aImmediate )
     {
-        // Draw using cached information or create one
-        int group = viewData->getGroup( aLayer );
+        // Draw using cached information or create one.  Items without a simplified variant
+        // are drawn in full detail when zoomed out.
+        int group = useLODGroups() ? viewData->getLODGroup( aLayer ) : -1;
+
+        if( group < 0 )
+            group = viewData->getGroup( aLayer );
 
         if( group >= 0 )
+        {
             m_gal->DrawGroup( group );
+            m_drawStats.m_cacheHits++;
+        }
         else
+        {
             Update( aItem );
+            m_drawStats.m_cacheMisses++;
+        }
     }
     else
     {
@@ -1097,6 +1553,7 @@ struct VIEW::recacheItem
             gal->DeleteGroup( group );
 
         viewData->setGroup( layer, -1 );
+        view->deleteLODGroup( aItem, layer );
         view->Update( aItem );
 
         return true;
@@ -1113,6 +1570,7 @@ void VIEW::Clear()
     BOX2I r;
     r.SetMaximum();
     m_allItems->clear();
+    m_lodPending.clear();
 
     for( LAYER_MAP_ITER i = m_layers.begin(); i != m_layers.end(); ++i )
         i->second.items->RemoveAll();
@@ -1144,9 +1602,12 @@ void VIEW::ClearTargets()
 
 void VIEW::Redraw()
 {
-#ifdef __WXDEBUG__
     PROF_COUNTER totalRealTime;
-#endif /* __WXDEBUG__ */
+
+    m_drawStats.m_cacheHits = 0;
+    m_drawStats.m_cacheMisses = 0;
+    m_drawStats.m_recordedItems = 0;
+    m_drawStats.m_layerItems.assign( VIEW_MAX_LAYERS, 0 );
 
     VECTOR2D screenSize = m_gal->GetScreenPixelSize();
     BOX2D    rect( ToWorld( VECTOR2D( 0, 0 ) ),
@@ -1167,8 +1628,10 @@ void VIEW::Redraw()
     markTargetClean( TARGET_NONCACHED );
     markTargetClean( TARGET_OVERLAY );
 
-#ifdef __WXDEBUG__
     totalRealTime.Stop();
+    m_drawStats.m_drawTime = totalRealTime.msecs();
+
+#ifdef __WXDEBUG__
     wxLogTrace( "GAL_PROFILE", "VIEW::Redraw(): %.1f ms", totalRealTime.msecs() );
 #endif /* __WXDEBUG__ */
 }
@@ -1210,6 +1673,9 @@ void VIEW::clearGroupCache()
         VIEW_LAYER* l = &( ( *i ).second );
         l->items->Query( r, visitor );
     }
+
+    m_lodDirty = true;
+    m_lodPending.clear();
 }
 
 
@@ -1234,6 +1700,9 @@ void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
         }
     }
 
+    // The tiled redraws record the item again
+    aItem->viewPrivData()->m_recording.reset();
+
     int layers[VIEW_MAX_LAYERS], layers_count;
     aItem->ViewGetLayers( layers, layers_count );
 
@@ -1289,6 +1758,11 @@ void VIEW::updateItemColor( VIEW_ITEM* aItem, int aLayer )
     // Change the color, only if it has group assigned
     if( group >= 0 )
         m_gal->ChangeGroupColor( group, color );
+
+    group = viewData->getLODGroup( aLayer );
+
+    if( group >= 0 )
+        m_gal->ChangeGroupColor( group, color );
 }
 
 
@@ -1312,16 +1786,204 @@ void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer )
     if( group >= 0 )
         m_gal->DeleteGroup( group );
 
+    deleteLODGroup( aItem, aLayer );
+
+    // The simplified variant follows the new geometry
+    markLODPending( aItem );
+
     group = m_gal->BeginGroup();
     viewData->setGroup( aLayer, group );
 
-    if( !m_painter->Draw( static_cast<EDA_ITEM*>( aItem ), aLayer ) )
+    const RECORDING_GAL::COMMANDS* recorded =
+            m_replayItem ? m_replayItem->getLayer( aLayer ) : nullptr;
+
+    if( recorded )
+        RECORDING_GAL::Replay( *recorded, *m_gal );
+    else if( !m_painter->Draw( static_cast<EDA_ITEM*>( aItem ), aLayer ) )
         aItem->ViewDraw( aLayer, this ); // Alternative drawing method
 
     m_gal->EndGroup();
 }
 
 
+void VIEW::recordItems( const std::vector<VIEW_ITEM*>& aItems,
+                        std::vector<RECORDED_ITEM>& aRecorded,
+                        const std::function<bool( VIEW_ITEM*, int )>& aLayerFilter )
+{
+    size_t threads = std::min<size_t>( std::max( std::thread::hardware_concurrency(), 1u ),
+                                       aItems.size() );
+
+    // The GALs subscribe to the display options when created, which is not thread safe
+    GAL_DISPLAY_OPTIONS                         options;
+    std::vector<std::unique_ptr<RECORDING_GAL>> gals;
+    std::vector<std::unique_ptr<PAINTER>>       painters;
+
+    for( size_t ii = 0; ii < threads; ++ii )
+    {
+        gals.emplace_back( new RECORDING_GAL( options ) );
+        gals.back()->CopyViewSettings( *m_gal );
+        painters.emplace_back( m_painter->Clone( gals.back().get() ) );
+
+        if( !painters.back() )
+            return;
+    }
+
+    aRecorded.resize( aItems.size() );
+
+    std::atomic<size_t> next( 0 );
+
+    // Items are not shared between threads, so painters may cache data in the item they draw
+    auto worker =
+            [&]( size_t aThread )
+            {
+                RECORDING_GAL* gal = gals[aThread].get();
+                PAINTER*       painter = painters[aThread].get();
+
+                for( size_t i = next++; i < aItems.size(); i = next++ )
+                {
+                    RECORDED_ITEM& recorded = aRecorded[i];
+                    int            layers[VIEW_MAX_LAYERS], layers_count;
+
+                    aItems[i]->ViewGetLayers( layers, layers_count );
+                    recorded.m_drawn = true;
+                    recorded.m_bbox = aItems[i]->ViewBBox();
+
+                    for( int j = 0; j < layers_count && recorded.m_drawn; ++j )
+                    {
+                        if( !aLayerFilter( aItems[i], layers[j] ) )
+                            continue;
+
+                        gal->SetLayerDepth( m_layers.at( layers[j] ).renderingOrder );
+
+                        int group = gal->BeginGroup();
+                        recorded.m_drawn = painter->Draw( aItems[i], layers[j] );
+                        gal->EndGroup();
+
+                        recorded.m_layers.emplace_back( layers[j], gal->TakeGroup( group ) );
+                    }
+                }
+            };
+
+    std::vector<std::future<void>> returns;
+
+    for( size_t ii = 1; ii < threads; ++ii )
+        returns.emplace_back( std::async( std::launch::async, worker, ii ) );
+
+    worker( 0 );
+
+    for( std::future<void>& ret : returns )
+        ret.get();
+}
+
+
+void VIEW::SetLODScale( double aScale )
+{
+    if( aScale == m_lodScale )
+        return;
+
+    // The simplification error depends on the threshold scale: all the variants are cached
+    // again
+    m_lodDirty = true;
+    m_lodPending.clear();
+
+    for( VIEW_ITEM* item : *m_allItems )
+    {
+        auto viewData = item->viewPrivData();
+
+        if( !viewData )
+            continue;
+
+        for( int layer : viewData->m_layers )
+            deleteLODGroup( item, layer );
+    }
+
+    m_lodScale = aScale;
+    MarkDirty();
+}
+
+
+void VIEW::deleteLODGroup( VIEW_ITEM* aItem, int aLayer )
+{
+    auto viewData = aItem->viewPrivData();
+    int  group = viewData->getLODGroup( aLayer );
+
+    if( group >= 0 )
+    {
+        m_gal->DeleteGroup( group );
+        viewData->setLODGroup( aLayer, -1 );
+        markLODPending( aItem );
+    }
+}
+
+
+void VIEW::markLODPending( VIEW_ITEM* aItem )
+{
+    // Nothing to track if variants are disabled, or if all of them are due anyway
+    if( m_lodScale > 0.0 && !m_lodDirty )
+        m_lodPending.insert( aItem );
+}
+
+
+void VIEW::updateLODGroups()
+{
+    // The simplified variants are only cached once the view is zoomed out, and kept until
+    // the items change
+    if( !useLODGroups() || ( !m_lodDirty && m_lodPending.empty() ) )
+        return;
+
+    // Errors up to a pixel at the threshold scale (and less when zoomed out further)
+    m_painter->SetLODTolerance( ToWorld( 1.0 ) * m_scale / m_lodScale );
+
+    if( m_lodDirty )
+    {
+        for( VIEW_ITEM* item : *m_allItems )
+            cacheLODGroups( item );
+    }
+    else
+    {
+        for( VIEW_ITEM* item : m_lodPending )
+            cacheLODGroups( item );
+    }
+
+    m_painter->SetLODTolerance( 0.0 );
+    m_lodDirty = false;
+    m_lodPending.clear();
+    MarkDirty();
+}
+
+
+void VIEW::cacheLODGroups( VIEW_ITEM* aItem )
+{
+    auto viewData = aItem->viewPrivData();
+
+    if( !viewData || !viewData->storesGroups() )
+        return;
+
+    for( int layer : viewData->m_layers )
+    {
+        if( !IsCached( layer ) || viewData->getGroup( layer ) < 0
+                || viewData->getLODGroup( layer ) >= 0
+                || !m_painter->HasLODVariant( aItem, layer ) )
+        {
+            continue;
+        }
+
+        VIEW_LAYER& l = m_layers.at( layer );
+
+        m_gal->SetTarget( l.target );
+        m_gal->SetLayerDepth( l.renderingOrder );
+
+        int group = m_gal->BeginGroup();
+        viewData->setLODGroup( layer, group );
+
+        if( !m_painter->Draw( aItem, layer ) )
+            aItem->ViewDraw( layer, this );
+
+        m_gal->EndGroup();
+    }
+}
+
+
 void VIEW::updateBbox( VIEW_ITEM* aItem )
 {
     int layers[VIEW_MAX_LAYERS], layers_count;
@@ -1365,6 +2027,8 @@ void VIEW::updateLayers( VIEW_ITEM* aItem )
                 m_gal->DeleteGroup( prevGroup );
                 viewData->setGroup( l.id, -1 );
             }
+
+            deleteLODGroup( aItem, l.id );
         }
     }
 
@@ -1418,25 +2082,135 @@ void VIEW::RecacheAllItems()
 }
 
 
+void VIEW::RecacheLayer( int aLayer )
+{
+    wxCHECK( (unsigned) aLayer < m_layers.size(), /*void*/ );
+
+    VIEW_LAYER& l = m_layers.at( aLayer );
+    BOX2I       r;
+
+    r.SetMaximum();
+
+    // The tiled redraws record the items again, whether the layer is cached or not
+    auto dropRecording = []( VIEW_ITEM* aItem ) -> bool
+    {
+        aItem->viewPrivData()->m_recording.reset();
+        return true;
+    };
+
+    l.items->Query( r, dropRecording );
+
+    // Non-cached layers are drawn from scratch on every refresh anyway
+    if( IsCached( aLayer ) )
+    {
+        if( m_gal->IsVisible() )
+        {
+            GAL_UPDATE_CONTEXT ctx( m_gal );
+
+            auto redraw = [this, aLayer]( VIEW_ITEM* aItem ) -> bool
+            {
+                updateItemGeometry( aItem, aLayer );
+                return true;
+            };
+
+            l.items->Query( r, redraw );
+        }
+        else
+        {
+            // The GAL cannot draw now, redraw the items with the next UpdateItems()
+            auto markItem = [this]( VIEW_ITEM* aItem ) -> bool
+            {
+                Update( aItem, REPAINT );
+                return true;
+            };
+
+            l.items->Query( r, markItem );
+        }
+    }
+
+    MarkTargetDirty( l.target );
+}
+
+
 void VIEW::UpdateItems()
 {
+    m_drawStats.m_updateTime = 0.0;
+    m_drawStats.m_paintTime = 0.0;
+    m_drawStats.m_uploadTime = 0.0;
+    m_drawStats.m_updatedItems = 0;
+
     if( m_gal->IsVisible() )
     {
-        GAL_UPDATE_CONTEXT ctx( m_gal );
+        // Laps of the timer are added to the phase they end
+        PROF_COUNTER timer;
 
-        for( VIEW_ITEM* item : *m_allItems )
         {
-            auto viewData = item->viewPrivData();
+            GAL_UPDATE_CONTEXT ctx( m_gal );
 
-            if( !viewData )
-                continue;
+            // When many items have to be redrawn (e.g. after loading a board or changing display
+            // options), the painter runs on worker threads first and the GAL only gets the
+            // recorded calls
+            std::vector<VIEW_ITEM*>    redrawn;
+            std::vector<RECORDED_ITEM> recorded;
+
+            if( m_parallelCacheThreshold > 0 )
+            {
+                for( VIEW_ITEM* item : *m_allItems )
+                {
+                    auto viewData = item->viewPrivData();
+
+                    if( viewData && ( viewData->m_requiredUpdate
+                                      & ( INITIAL_ADD | GEOMETRY | LAYERS | REPAINT ) ) )
+                    {
+                        redrawn.push_back( item );
+                    }
+                }
+
+                if( redrawn.size() >= m_parallelCacheThreshold )
+                {
+                    m_drawStats.m_updateTime += timer.msecs( true );
+
+                    recordItems( redrawn, recorded,
+                                 [this]( VIEW_ITEM*, int aLayer )
+                                 {
+                                     return IsCached( aLayer );
+                                 } );
+
+                    m_drawStats.m_paintTime += timer.msecs( true );
+                }
+            }
+
+            size_t next = 0;
 
-            if( viewData->m_requiredUpdate != NONE )
+            for( VIEW_ITEM* item : *m_allItems )
             {
-                invalidateItem( item, viewData->m_requiredUpdate );
-                viewData->m_requiredUpdate = NONE;
+                auto viewData = item->viewPrivData();
+
+                if( !viewData )
+                    continue;
+
+                if( viewData->m_requiredUpdate != NONE )
+                {
+                    m_drawStats.m_updateTime += timer.msecs( true );
+
+                    if( next < recorded.size() && redrawn[next] == item )
+                        m_replayItem = &recorded[next++];
+
+                    invalidateItem( item, viewData->m_requiredUpdate );
+                    viewData->m_requiredUpdate = NONE;
+                    m_replayItem = nullptr;
+
+                    m_drawStats.m_paintTime += timer.msecs( true );
+                    m_drawStats.m_updatedItems++;
+                }
             }
+
+            updateLODGroups();
+            m_drawStats.m_updateTime += timer.msecs( true );
         }
+
+        // Ending the update uploaded the cached geometry
+        m_drawStats.m_uploadTime = timer.msecs( true );
     }
 }
 
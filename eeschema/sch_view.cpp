@@ -93,8 +93,12 @@ void SCH_VIEW::ResizeSheetWorkingArea( SCH_SCREEN* aScreen )
 
 void SCH_VIEW::DisplaySheet( SCH_SCREEN *aScreen )
 {
+    std::vector<VIEW_ITEM*> items;
+
     for( auto item : aScreen->Items() )
-        Add( item );
+        items.push_back( item );
+
+    BulkAdd( items );
 
     m_worksheet.reset( new KIGFX::WS_PROXY_VIEW_ITEM( static_cast< int >( IU_PER_MILS ),
                                                       &aScreen->GetPageSettings(),
@@ -136,6 +140,7 @@ void SCH_VIEW::DisplayComponent( LIB_PART* aPart )
 
     std::shared_ptr< LIB_PART > parent;
     LIB_PART* drawnPart = aPart;
+    std::vector<VIEW_ITEM*> items;
 
     // Draw the mandatory fields for aliases and parent symbols.
     for( auto& item : aPart->GetDrawItems() )
@@ -144,7 +149,7 @@ void SCH_VIEW::DisplayComponent( LIB_PART* aPart )
             continue;
 
         if( static_cast< LIB_FIELD* >( &item )->IsMandatory() )
-            Add( &item );
+            items.push_back( &item );
     }
 
     // Draw the parent items if the symbol is inherited from another symbol.
@@ -166,9 +171,11 @@ void SCH_VIEW::DisplayComponent( LIB_PART* aPart )
                 continue;
         }
 
-        Add( &item );
+        items.push_back( &item );
     }
 
+    BulkAdd( items );
+
     m_selectionArea.reset( new KIGFX::PREVIEW::SELECTION_AREA() );
     m_preview.reset( new KIGFX::VIEW_GROUP() );
     Add( m_selectionArea.get() );
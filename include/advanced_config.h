@@ -24,6 +24,8 @@
 #ifndef ADVANCED_CFG__H
 #define ADVANCED_CFG__H
 
+#include <wx/string.h>
+
 class wxConfigBase;
 
 /**
@@ -83,6 +85,23 @@ public:
      */
     int m_coroutineStackSize;
 
+    /**
+     * File the interactive router appends its per-session collision counters to, as one
+     * JSON object per line.  Counting is disabled when empty.
+     */
+    wxString m_RouterStatsFile;
+
+    /**
+     * Show the collision counters of the current routing session over the canvas.
+     */
+    bool m_ShowRouterStats;
+
+    /**
+     * Show the frame time statistics over the drawing canvases, and write them to the
+     * KICAD_FRAME_STATS trace.
+     */
+    bool m_ShowFrameStats;
+
 
 private:
     ADVANCED_CFG();
@@ -46,6 +46,7 @@ class WX_VIEW_CONTROLS;
 class VIEW_CONTROLS;
 class PAINTER;
 class GAL_DISPLAY_OPTIONS;
+class FRAME_STATS;
 }
 
 
@@ -261,6 +262,9 @@ protected:
     /// Flag to indicate whether the panel should take focus at certain times (when moused over,
     /// and on various mouse/key events)
     bool                     m_stealsFocus;
+
+    /// Frame time statistics, shown over the canvas (only if enabled in the advanced config)
+    std::unique_ptr<KIGFX::FRAME_STATS> m_frameStats;
 };
 
 #endif
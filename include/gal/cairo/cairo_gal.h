@@ -208,6 +208,13 @@ public:
     ///> @copydoc GAL::DrawGrid()
     virtual void DrawGrid() override;
 
+    /**
+     * Function GetTargetContext()
+     * Draws the pending path and returns the context of the current target, e.g. to draw
+     * parts of it with other GALs (see CAIRO_IMAGE_GAL::AttachToArea()).
+     */
+    cairo_t* GetTargetContext();
+
 
 protected:
     // Geometric transforms according to the currentWorld2Screen transform matrix:
@@ -234,7 +241,12 @@ protected:
     /// @copydoc GAL::EndDrawing()
     virtual void endDrawing() override;
 
-    void resetContext();
+    /**
+     * Function resetContext()
+     * Sets up the context for a new frame.
+     * @param aClear tells whether the screen is cleared.
+     */
+    void resetContext( bool aClear = true );
 
     /**
      * @brief Draw a grid line (usually a simplified line function).
@@ -0,0 +1,80 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#ifndef CAIRO_IMAGE_GAL_H
+#define CAIRO_IMAGE_GAL_H
+
+#include <gal/cairo/cairo_gal.h>
+
+namespace KIGFX
+{
+
+/**
+ * CAIRO_IMAGE_GAL
+ *
+ * Cairo GAL drawing to an image surface in memory, with no window attached.  Meant for
+ * headless uses, like render benchmarks and tests, where the result is only inspected (or
+ * written to a PNG file) afterwards, and for drawing tiles of another GAL's image on worker
+ * threads.
+ */
+class CAIRO_IMAGE_GAL : public CAIRO_GAL_BASE
+{
+public:
+    CAIRO_IMAGE_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions, int aWidth, int aHeight );
+
+    /// @copydoc GAL::ResizeScreen()
+    void ResizeScreen( int aWidth, int aHeight ) override;
+
+    ///> Returns the image surface (ARGB32 format) drawn to
+    cairo_surface_t* GetSurface() const
+    {
+        return surface;
+    }
+
+    /**
+     * Function WritePng()
+     * Saves the image drawn so far.
+     * @return true if the file was written.
+     */
+    bool WritePng( const std::string& aFileName );
+
+    /**
+     * Function AttachToArea()
+     * Draws to a part of the image another GAL draws to, instead of the GAL's own surface.
+     * Items are drawn where that GAL would draw them, and the area is not cleared.  Areas that
+     * don't overlap can be drawn at the same time, each one by its own CAIRO_IMAGE_GAL.
+     * @param aTarget is the context of the other GAL's target (only read from).
+     * @param aView is the other GAL, whose view is used.
+     * @param aArea is the area to draw to, in screen pixels.
+     * @return false if aTarget doesn't draw to an ARGB32 image, or the area is outside of it.
+     */
+    bool AttachToArea( cairo_t* aTarget, const GAL& aView, const BOX2I& aArea );
+
+private:
+    ///> Creates the surface and context for the current screen size
+    void allocateSurface();
+};
+
+} // namespace KIGFX
+
+#endif // CAIRO_IMAGE_GAL_H
@@ -30,6 +30,7 @@
 #include <deque>
 #include <stack>
 #include <limits>
+#include <cstdint>
 
 #include <math/matrix3x3.h>
 
@@ -602,6 +603,54 @@ public:
      */
     virtual void ClearCache() {};
 
+    // --------------------------------------------
+    // Instanced shapes
+    // ---------------------------------------------
+
+    /**
+     * @brief Returns true if shapes can be drawn as instances now.
+     *
+     * Instances are only supported by GALs that cache groups on the GPU, while a group is
+     * being cached.  Otherwise the shape has to be drawn with the usual methods.
+     */
+    virtual bool IsInstancingEnabled() const { return false; }
+
+    /**
+     * @brief Returns true if shapes can be drawn as instances while caching groups.
+     */
+    virtual bool IsInstancingSupported() const { return false; }
+
+    /**
+     * @brief Begin a shape, to be drawn once for every DrawShape() call with the same key.
+     *
+     * The items drawn until EndShape() are stored once, in coordinates relative to the shape
+     * origin, so no transformation should be active.  Rotations have to be drawn in the shape
+     * (and be a part of the key).  Shapes are deleted by ClearCache().
+     *
+     * @param aKey identifies the shape, e.g. a hash of its type, size and rotation.
+     */
+    virtual void BeginShape( uint64_t aKey ) {};
+
+    /// @brief End the shape.
+    virtual void EndShape() {};
+
+    /**
+     * @brief Returns true if a shape was stored with the given key.
+     *
+     * @param aKey is the shape key.
+     */
+    virtual bool HasShape( uint64_t aKey ) const { return false; }
+
+    /**
+     * @brief Draw an instance of a shape, in the group being cached.
+     *
+     * @param aKey is the shape key.
+     * @param aPosition is the world position of the shape origin (the current transformation
+     *                  is not applied).
+     * @param aColor replaces the colors used to draw the shape.
+     */
+    virtual void DrawShape( uint64_t aKey, const VECTOR2D& aPosition, const COLOR4D& aColor ) {};
+
     // --------------------------------------------------------
     // Handling the world <-> screen transformation
     // --------------------------------------------------------
@@ -653,6 +702,11 @@ public:
         worldUnitLength = aWorldUnitLength;
     }
 
+    inline double GetWorldUnitLength() const
+    {
+        return worldUnitLength;
+    }
+
     inline void SetScreenSize( const VECTOR2I& aSize )
     {
         screenSize = aSize;
@@ -671,6 +725,11 @@ public:
         screenDPI = aScreenDPI;
     }
 
+    inline double GetScreenDPI() const
+    {
+        return screenDPI;
+    }
+
     /**
      * @brief Set the Point in world space to look at.
      *
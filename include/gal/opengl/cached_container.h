@@ -71,6 +71,19 @@ public:
      */
     virtual unsigned int GetBufferHandle() const = 0;
 
+    /**
+     * Returns handle to the vertex buffer storing the vertex at a given offset. Containers may
+     * split their data between several buffers, which are then drawn separately, using indices
+     * relative to the first vertex of each buffer.
+     * @param aOffset is the offset of the vertex.
+     * @param aBufferOffset is set to the offset of the first vertex stored in the buffer.
+     */
+    virtual unsigned int GetVertexBuffer( unsigned int aOffset, unsigned int& aBufferOffset ) const
+    {
+        aBufferOffset = 0;
+        return GetBufferHandle();
+    }
+
     /**
      * Returns true if vertex buffer is currently mapped.
      */
@@ -117,13 +130,13 @@ protected:
     bool reallocate( unsigned int aSize );
 
     /**
-     * Removes empty spaces between chunks and optionally resizes the container.
-     * After the operation there is continous space for storing vertices at the end of the container.
+     * Makes room for a chunk of at least aSize vertices, when no free chunk is large enough.
+     * The current item may be moved, in which case m_chunkOffset is updated.
      *
-     * @param aNewSize is the new size of container, expressed in number of vertices
+     * @param aSize is the requested chunk size.
      * @return false in case of failure (e.g. memory shortage)
      */
-    virtual bool defragmentResize( unsigned int aNewSize ) = 0;
+    virtual bool grow( unsigned int aSize ) = 0;
 
     /**
      * Transfers all stored data to a new buffer, removing empty spaces between the data chunks
@@ -161,7 +174,12 @@ protected:
     /**
      * Adds a chunk marked as a free space.
      */
-    void addFreeChunk( unsigned int aOffset, unsigned int aSize );
+    virtual void addFreeChunk( unsigned int aOffset, unsigned int aSize );
+
+    /**
+     * Removes a chunk from the free space, as it is going to be used.
+     */
+    virtual void removeFreeChunk( FREE_CHUNK_MAP::iterator aChunk );
 
 private:
     /// Debug & test functions
@@ -66,6 +66,9 @@ protected:
     ///> Flag saying whether it is safe to use glCopyBufferSubData
     bool m_useCopyBuffer;
 
+    ///> @copydoc CACHED_CONTAINER::grow()
+    bool grow( unsigned int aSize ) override;
+
     /**
      * Function defragmentResize()
      * removes empty spaces between chunks and optionally resizes the container.
@@ -74,7 +77,7 @@ protected:
      * @param aNewSize is the new size of container, expressed in number of vertices
      * @return false in case of failure (e.g. memory shortage)
      */
-    bool defragmentResize( unsigned int aNewSize ) override;
+    bool defragmentResize( unsigned int aNewSize );
     bool defragmentResizeMemcpy( unsigned int aNewSize );
 };
 } // namespace KIGFX
@@ -27,7 +27,9 @@
 
 #include <gal/opengl/cached_container.h>
 #include <map>
+#include <memory>
 #include <set>
+#include <vector>
 
 namespace KIGFX
 {
@@ -37,6 +39,13 @@ class SHADER;
 /**
  * @brief Specialization of CACHED_CONTAINER that stores data in RAM. This is mainly for
  * video cards/drivers that do not cope well with video memory mapping.
+ *
+ * The vertices are stored in segments of one or more fixed size pages, each uploaded to its own
+ * vertex buffer. The container grows by adding segments, so the stored data is never copied to
+ * make room, and only the segments that were modified are uploaded again. Segments left empty
+ * are released, and sparse ones are compacted (their items moved to other segments) when an
+ * update starts, one segment at a time. Free chunks are merged with their neighbours in the
+ * same segment as soon as they are freed.
  */
 
 class CACHED_CONTAINER_RAM : public CACHED_CONTAINER
@@ -45,12 +54,15 @@ public:
     CACHED_CONTAINER_RAM( unsigned int aSize = DEFAULT_SIZE );
     ~CACHED_CONTAINER_RAM();
 
-    ///> @copydoc VERTEX_CONTAINER::Unmap()
-    void Map() override {}
+    ///> @copydoc VERTEX_CONTAINER::Map()
+    void Map() override;
 
     ///> @copydoc VERTEX_CONTAINER::Unmap()
     void Unmap() override;
 
+    ///> @copydoc VERTEX_CONTAINER::Clear()
+    void Clear() override;
+
     bool IsMapped() const override
     {
         return true;
@@ -58,23 +70,84 @@ public:
 
     /**
      * Function GetBufferHandle()
-     * returns handle to the vertex buffer. It might be negative if the buffer is not initialized.
+     * returns handle to the vertex buffer of the first segment.
      */
     unsigned int GetBufferHandle() const override
     {
-        return m_verticesBuffer;    // make common with CACHED_CONTAINER_RAM
+        return m_segments.empty() ? 0 : m_segments.front()->m_buffer;
+    }
+
+    ///> @copydoc CACHED_CONTAINER::GetVertexBuffer()
+    unsigned int GetVertexBuffer( unsigned int aOffset, unsigned int& aBufferOffset ) const override
+    {
+        const SEGMENT* segment = m_pages[aOffset / PAGE_SIZE];
+
+        aBufferOffset = segment->m_offset;
+        return segment->m_buffer;
     }
 
+    ///> @copydoc VERTEX_CONTAINER::GetVertices()
+    VERTEX* GetVertices( unsigned int aOffset ) const override
+    {
+        SEGMENT* segment = m_pages[aOffset / PAGE_SIZE];
+
+        // The vertices are handed out for modification
+        segment->m_dirty = true;
+
+        return &segment->m_vertices[aOffset - segment->m_offset];
+    }
+
+    ///> Size of a page, expressed in vertices
+    static constexpr unsigned int PAGE_SIZE = 262144;
+
 protected:
-    ///> Handle to vertices buffer
-    GLuint  m_verticesBuffer;
+    ///> A range of pages, stored in a single vertex buffer
+    struct SEGMENT
+    {
+        VERTEX*      m_vertices;    ///< Data stored in RAM
+        GLuint       m_buffer;      ///< Vertex buffer handle
+        unsigned int m_offset;      ///< Offset of the first vertex
+        unsigned int m_size;        ///< Size, expressed in vertices
+        unsigned int m_freeSpace;   ///< Free space left in the segment
+        bool         m_dirty;       ///< Has to be uploaded again
+    };
+
+    ///> Stored segments
+    std::vector<std::unique_ptr<SEGMENT>> m_segments;
+
+    ///> Segment storing each page, or nullptr for pages not in use
+    std::vector<SEGMENT*> m_pages;
+
+    ///> Free chunks sorted by their offsets, to merge the neighbouring ones
+    std::map<unsigned int, FREE_CHUNK_MAP::iterator> m_freeChunkOffsets;
+
+    ///> Segments using less than this fraction of their space are compacted
+    static constexpr double SPARSE_SEGMENT_RATIO = 0.25;
+
+    ///> Adds a new segment of at least aSize vertices, available as a free chunk.
+    bool grow( unsigned int aSize ) override;
+
+    /**
+     * Adds a chunk marked as a free space, merged with the free chunks next to it in the same
+     * segment.
+     */
+    void addFreeChunk( unsigned int aOffset, unsigned int aSize ) override;
+
+    ///> @copydoc CACHED_CONTAINER::removeFreeChunk()
+    void removeFreeChunk( FREE_CHUNK_MAP::iterator aChunk ) override;
+
+    /**
+     * Releases the segments not storing anything, except for one which is kept to avoid
+     * reallocating it soon.
+     */
+    void releaseEmptySegments();
 
     /**
-     * Defragments the currently stored data and resizes the buffer.
-     * @param aNewSize is the new buffer vertex buffer size, expressed as the number of vertices.
-     * @return true on success.
+     * Moves the items of the sparsest segment (if any is sparse enough) to the free space left
+     * in other segments, so the segment gets empty and can be released. This only copies the
+     * data stored in that segment.
      */
-    bool defragmentResize( unsigned int aNewSize ) override;
+    void compactSparseSegment();
 };
 } // namespace KIGFX
 
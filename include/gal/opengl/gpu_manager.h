@@ -27,6 +27,8 @@
 
 #include <gal/opengl/vertex_common.h>
 #include <boost/scoped_array.hpp>
+#include <unordered_map>
+#include <vector>
 
 namespace KIGFX
 {
@@ -60,6 +62,25 @@ public:
      */
     virtual void DrawIndices( unsigned int aOffset, unsigned int aSize ) = 0;
 
+    /**
+     * Function DrawInstances()
+     * Makes the GPU draw copies of a range of vertices, each moved, colored and set at the depth
+     * given by an instance.
+     * @param aOffset is the beginning of the range.
+     * @param aSize is the number of vertices in the range.
+     * @param aInstances is the array of instances.
+     * @param aCount is the number of instances.
+     */
+    virtual void DrawInstances( unsigned int aOffset, unsigned int aSize,
+                                const INSTANCE* aInstances, unsigned int aCount ) = 0;
+
+    /**
+     * Function BeginLayer()
+     * Starts drawing a new layer.  The instances of a shape are drawn together, but only with
+     * the other instances of their layer, so translucent layers are blended in their order.
+     */
+    virtual void BeginLayer() {}
+
     /**
      * Function DrawIndices()
      * Makes the GPU draw all the vertices stored in the container.
@@ -117,12 +138,22 @@ public:
     ///> @copydoc GPU_MANAGER::DrawIndices()
     virtual void DrawIndices( unsigned int aOffset, unsigned int aSize ) override;
 
+    ///> @copydoc GPU_MANAGER::DrawInstances()
+    virtual void DrawInstances( unsigned int aOffset, unsigned int aSize,
+                                const INSTANCE* aInstances, unsigned int aCount ) override;
+
+    ///> @copydoc GPU_MANAGER::BeginLayer()
+    virtual void BeginLayer() override;
+
     ///> @copydoc GPU_MANAGER::DrawAll()
     virtual void DrawAll() override;
 
     ///> @copydoc GPU_MANAGER::EndDrawing()
     virtual void EndDrawing() override;
 
+    ///> @copydoc GPU_MANAGER::SetShader()
+    virtual void SetShader( SHADER& aShader ) override;
+
     ///> Maps vertex buffer stored in GPU memory.
     void Map();
 
@@ -133,6 +164,12 @@ protected:
     ///> Resizes the indices buffer to aNewSize if necessary
     void resizeIndices( unsigned int aNewSize );
 
+    ///> Sets the position of the instance runs of the current layer among the other runs
+    void endLayer();
+
+    ///> Draws the instance runs from aFirst to aLast (excluded)
+    void drawInstances( size_t aFirst, size_t aLast );
+
     ///> Buffers initialization flag
     bool m_buffersInitialized;
 
@@ -150,6 +187,51 @@ protected:
 
     ///> Current indices buffer size
     unsigned int m_indicesCapacity;
+
+    ///> Consecutive indices drawn from the same vertex buffer
+    struct DRAW_RUN
+    {
+        GLuint       m_vertexBuffer;
+        unsigned int m_first;
+        unsigned int m_count;
+    };
+
+    ///> Runs to be drawn in EndDrawing(), in order
+    std::vector<DRAW_RUN> m_runs;
+
+    ///> Instances of a range of vertices (a shape) on a layer
+    struct INSTANCE_RUN
+    {
+        GLuint                m_vertexBuffer;
+        unsigned int          m_first;
+        unsigned int          m_count;
+        std::vector<INSTANCE> m_instances;
+        size_t                m_drawnAfter;     ///< Number of runs drawn before the instances
+        size_t                m_firstInstance;  ///< Offset in the instances buffer
+    };
+
+    ///> Instance runs to be drawn in EndDrawing(), one per shape and layer, in layer order
+    std::vector<INSTANCE_RUN> m_instanceRuns;
+
+    ///> Index of the first instance run of the current layer
+    size_t m_layerInstanceRuns;
+
+    ///> Index of the run in m_instanceRuns, by the shape offset in the container, for the
+    ///> current layer
+    std::unordered_map<unsigned int, size_t> m_instanceRunIndex;
+
+    ///> Instances of all the runs, as uploaded to the instances buffer
+    std::vector<INSTANCE> m_instances;
+
+    ///> Handle to the instances buffer
+    GLuint m_instancesBuffer;
+
+    ///> Location of the instance attributes, -1 if the shader does not support instancing
+    int m_instanceAttrib;
+    int m_instanceColorAttrib;
+
+    ///> Shader parameter telling if instances are drawn
+    int m_instancedParam;
 };
 
 
@@ -164,6 +246,10 @@ public:
     ///> @copydoc GPU_MANAGER::DrawIndices()
     virtual void DrawIndices( unsigned int aOffset, unsigned int aSize ) override;
 
+    ///> @copydoc GPU_MANAGER::DrawInstances()
+    virtual void DrawInstances( unsigned int aOffset, unsigned int aSize,
+                                const INSTANCE* aInstances, unsigned int aCount ) override;
+
     ///> @copydoc GPU_MANAGER::DrawAll()
     virtual void DrawAll() override;
 
@@ -168,6 +168,9 @@ public:
     /// @copydoc GAL::ClearScreen()
     virtual void ClearScreen( ) override;
 
+    /// @copydoc GAL::SetLayerDepth()
+    virtual void SetLayerDepth( double aLayerDepth ) override;
+
     // --------------
     // Transformation
     // --------------
@@ -215,6 +218,34 @@ public:
     /// @copydoc GAL::ClearCache()
     virtual void ClearCache() override;
 
+    /// @copydoc GAL::IsInstancingEnabled()
+    virtual bool IsInstancingEnabled() const override
+    {
+        return isInstancingSupported && isGrouping;
+    }
+
+    /// @copydoc GAL::IsInstancingSupported()
+    virtual bool IsInstancingSupported() const override
+    {
+        return isInstancingSupported;
+    }
+
+    /// @copydoc GAL::BeginShape()
+    virtual void BeginShape( uint64_t aKey ) override;
+
+    /// @copydoc GAL::EndShape()
+    virtual void EndShape() override;
+
+    /// @copydoc GAL::HasShape()
+    virtual bool HasShape( uint64_t aKey ) const override
+    {
+        return shapes.count( aKey ) > 0;
+    }
+
+    /// @copydoc GAL::DrawShape()
+    virtual void DrawShape( uint64_t aKey, const VECTOR2D& aPosition,
+                            const COLOR4D& aColor ) override;
+
     // --------------------------------------------------------
     // Handling the world <-> screen transformation
     // --------------------------------------------------------
@@ -295,11 +326,26 @@ private:
     typedef std::unordered_map< unsigned int, std::shared_ptr<VERTEX_ITEM> > GROUPS_MAP;
     GROUPS_MAP              groups;                 ///< Stores informations about VBO objects (groups)
     unsigned int            groupCounter;           ///< Counter used for generating keys for groups
+    unsigned int            currentGroup;           ///< Group being cached
     VERTEX_MANAGER*         currentManager;         ///< Currently used VERTEX_MANAGER (for storing VERTEX_ITEMs)
     VERTEX_MANAGER*         cachedManager;          ///< Container for storing cached VERTEX_ITEMs
     VERTEX_MANAGER*         nonCachedManager;       ///< Container for storing non-cached VERTEX_ITEMs
     VERTEX_MANAGER*         overlayManager;         ///< Container for storing overlaid VERTEX_ITEMs
 
+    // Instanced shapes
+    typedef std::unordered_map< uint64_t, std::shared_ptr<VERTEX_ITEM> > SHAPES_MAP;
+    SHAPES_MAP              shapes;                 ///< Shapes drawn as instances, by key
+
+    ///< Instances of shapes in a group
+    struct SHAPE_INSTANCE
+    {
+        std::shared_ptr<VERTEX_ITEM> shape;
+        INSTANCE                     instance;
+    };
+
+    typedef std::unordered_map< unsigned int, std::vector<SHAPE_INSTANCE> > GROUP_INSTANCES_MAP;
+    GROUP_INSTANCES_MAP     groupInstances;         ///< Shape instances of the groups
+
     // Framebuffer & compositing
     OPENGL_COMPOSITOR*      compositor;             ///< Handles multiple rendering targets
     unsigned int            mainBuffer;             ///< Main rendering target
@@ -316,6 +362,7 @@ private:
     bool                    isInitialized;              ///< Basic initialization flag, has to be done
                                                         ///< when the window is visible
     bool                    isGrouping;                 ///< Was a group started?
+    bool                    isInstancingSupported;      ///< Can shapes be drawn as instances?
     bool                    isContextLocked;            ///< Used for assertion checking
     int                     lockClientCookie;
     GLint                   ufm_worldPixelSize;
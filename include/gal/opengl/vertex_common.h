@@ -78,6 +78,21 @@ static constexpr size_t SHADER_STRIDE = SHADER_SIZE / sizeof(GLfloat);
 
 static constexpr size_t INDEX_SIZE    = sizeof(GLuint);
 
+///> Data structure for instances of a shape {X,Y,Z,R,G,B,A}
+struct INSTANCE
+{
+    GLfloat x, y, z;        // Shape offset & depth
+    GLubyte r, g, b, a;     // Color (replaces the color of the shape vertices)
+};
+
+static constexpr size_t INSTANCE_SIZE         = sizeof(INSTANCE);
+
+static constexpr size_t INSTANCE_COORD_OFFSET = offsetof(INSTANCE, x);
+static constexpr size_t INSTANCE_COORD_STRIDE = COORD_STRIDE;
+
+static constexpr size_t INSTANCE_COLOR_OFFSET = offsetof(INSTANCE, r);
+static constexpr size_t INSTANCE_COLOR_STRIDE = COLOR_STRIDE;
+
 } // namespace KIGFX
 
 #endif /* VERTEX_COMMON_H_ */
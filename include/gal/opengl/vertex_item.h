@@ -43,6 +43,7 @@ class VERTEX_ITEM
 public:
     friend class CACHED_CONTAINER;
     friend class CACHED_CONTAINER_GPU;
+    friend class CACHED_CONTAINER_RAM;
     friend class VERTEX_MANAGER;
 
     explicit VERTEX_ITEM( const VERTEX_MANAGER& aManager );
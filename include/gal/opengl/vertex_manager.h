@@ -343,6 +343,24 @@ public:
      */
     void DrawItem( const VERTEX_ITEM& aItem ) const;
 
+    /**
+     * Function DrawInstances()
+     * draws copies of an item to the buffer, each moved, colored and set at the depth given
+     * by an instance.
+     *
+     * @param aItem is the item to be drawn.
+     * @param aInstances is the array of instances.
+     * @param aCount is the number of instances.
+     */
+    void DrawInstances( const VERTEX_ITEM& aItem, const INSTANCE* aInstances,
+                        unsigned int aCount ) const;
+
+    /**
+     * Function BeginLayer()
+     * starts drawing a new layer, after the instances drawn on the previous ones.
+     */
+    void BeginLayer() const;
+
     /**
      * Function EndDrawing()
      * finishes drawing operations.
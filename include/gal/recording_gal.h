@@ -0,0 +1,317 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#ifndef RECORDING_GAL_H
+#define RECORDING_GAL_H
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include <gal/graphics_abstraction_layer.h>
+
+class SHAPE;
+
+namespace KIGFX
+{
+
+/**
+ * RECORDING_GAL
+ *
+ * A GAL that draws nothing, but stores the calls made to it inside groups, so they can be
+ * replayed later on another GAL.  Painters may run on worker threads, each one drawing to its
+ * own RECORDING_GAL, while the GAL tied to the GUI thread (and its GL context) only gets the
+ * final drawing calls.
+ *
+ * Stroke text is recorded as the lines drawn by the stroke font, bitmap text is recorded as is,
+ * since how it looks depends on the target GAL.  Calls made outside of a group, and bitmaps,
+ * are ignored.
+ *
+ * Instanced shapes are recorded if the target GAL supports them.  Each group stores the shapes
+ * it draws, so it can be replayed on its own: shapes the target already has are skipped.
+ */
+class RECORDING_GAL : public GAL
+{
+public:
+    ///> Recorded calls
+    enum COMMAND_TYPE
+    {
+        CMD_SET_IS_FILL,
+        CMD_SET_IS_STROKE,
+        CMD_SET_FILL_COLOR,
+        CMD_SET_STROKE_COLOR,
+        CMD_SET_LINE_WIDTH,
+        CMD_SET_LAYER_DEPTH,
+        CMD_DRAW_LINE,
+        CMD_DRAW_SEGMENT,
+        CMD_DRAW_POLYLINE,
+        CMD_DRAW_LINE_CHAIN,
+        CMD_DRAW_CIRCLE,
+        CMD_DRAW_ARC,
+        CMD_DRAW_ARC_SEGMENT,
+        CMD_DRAW_RECTANGLE,
+        CMD_DRAW_POLYGON,
+        CMD_DRAW_POLYGON_CHAIN,
+        CMD_DRAW_POLY_SET,
+        CMD_DRAW_CURVE,
+        CMD_BITMAP_TEXT,
+        CMD_TRANSFORM,
+        CMD_ROTATE,
+        CMD_TRANSLATE,
+        CMD_SCALE,
+        CMD_SAVE,
+        CMD_RESTORE,
+        CMD_BEGIN_SHAPE,
+        CMD_END_SHAPE,
+        CMD_DRAW_SHAPE
+    };
+
+    ///> Text drawn with BitmapText(), with the text attributes at the time of the call
+    struct BITMAP_TEXT
+    {
+        wxString            m_text;
+        VECTOR2D            m_glyphSize;
+        EDA_TEXT_HJUSTIFY_T m_horizontalJustify;
+        EDA_TEXT_VJUSTIFY_T m_verticalJustify;
+        bool                m_bold;
+        bool                m_italic;
+        bool                m_mirrored;
+    };
+
+    struct COMMAND
+    {
+        COMMAND_TYPE          m_type;
+        bool                  m_flag;         ///< Fill or stroke enabled
+        double                m_args[4];      ///< Widths, radius, angles, depth
+        COLOR4D               m_color;
+        std::vector<VECTOR2D> m_points;       ///< Points, vectors and positions
+        uint64_t              m_key;          ///< Instanced shape key
+
+        ///> Copy of the SHAPE_LINE_CHAIN or SHAPE_POLY_SET drawn
+        std::shared_ptr<const SHAPE>       m_shape;
+        std::shared_ptr<const MATRIX3x3D>  m_matrix;
+        std::shared_ptr<const BITMAP_TEXT> m_text;
+
+        bool operator==( const COMMAND& aOther ) const;
+
+        bool operator!=( const COMMAND& aOther ) const
+        {
+            return !( *this == aOther );
+        }
+    };
+
+    typedef std::vector<COMMAND> COMMANDS;
+
+    RECORDING_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions );
+    virtual ~RECORDING_GAL();
+
+    /**
+     * Function CopyViewSettings()
+     * Takes the view (world scale, matrices, flipping, depth range), the engine type and the
+     * instancing support of the GAL the recorded calls are going to be replayed on, since
+     * painters depend on them.
+     */
+    void CopyViewSettings( GAL& aGal );
+
+    virtual bool IsOpenGlEngine() override { return m_isOpenGl; }
+
+    virtual bool IsCairoEngine() override { return m_isCairo; }
+
+    // ----------------
+    // Instanced shapes
+    // ----------------
+
+    /// @copydoc GAL::IsInstancingSupported()
+    virtual bool IsInstancingSupported() const override { return m_isInstancing; }
+
+    /// @copydoc GAL::IsInstancingEnabled()
+    virtual bool IsInstancingEnabled() const override
+    {
+        return IsInstancingSupported() && m_currentGroup;
+    }
+
+    /// @copydoc GAL::BeginShape()
+    virtual void BeginShape( uint64_t aKey ) override;
+
+    /// @copydoc GAL::EndShape()
+    virtual void EndShape() override;
+
+    /// @copydoc GAL::HasShape()
+    virtual bool HasShape( uint64_t aKey ) const override
+    {
+        return m_groupShapes.count( aKey ) > 0;
+    }
+
+    /// @copydoc GAL::DrawShape()
+    virtual void DrawShape( uint64_t aKey, const VECTOR2D& aPosition,
+                            const COLOR4D& aColor ) override;
+
+    // ---------------
+    // Drawing methods
+    // ---------------
+
+    /// @copydoc GAL::DrawLine()
+    virtual void DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
+
+    /// @copydoc GAL::DrawSegment()
+    virtual void DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                              double aWidth ) override;
+
+    /// @copydoc GAL::DrawPolyline()
+    virtual void DrawPolyline( const std::deque<VECTOR2D>& aPointList ) override;
+    virtual void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) override;
+    virtual void DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain ) override;
+
+    /// @copydoc GAL::DrawCircle()
+    virtual void DrawCircle( const VECTOR2D& aCenterPoint, double aRadius ) override;
+
+    /// @copydoc GAL::DrawArc()
+    virtual void DrawArc( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
+                          double aEndAngle ) override;
+
+    /// @copydoc GAL::DrawArcSegment()
+    virtual void DrawArcSegment( const VECTOR2D& aCenterPoint, double aRadius,
+                                 double aStartAngle, double aEndAngle, double aWidth ) override;
+
+    /// @copydoc GAL::DrawRectangle()
+    virtual void DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
+
+    /// @copydoc GAL::DrawPolygon()
+    virtual void DrawPolygon( const std::deque<VECTOR2D>& aPointList ) override;
+    virtual void DrawPolygon( const VECTOR2D aPointList[], int aListSize ) override;
+    virtual void DrawPolygon( const SHAPE_POLY_SET& aPolySet ) override;
+    virtual void DrawPolygon( const SHAPE_LINE_CHAIN& aPolySet ) override;
+
+    /// @copydoc GAL::DrawCurve()
+    virtual void DrawCurve( const VECTOR2D& startPoint, const VECTOR2D& controlPointA,
+                            const VECTOR2D& controlPointB, const VECTOR2D& endPoint,
+                            double aFilterValue = 0.0 ) override;
+
+    // -----------------
+    // Attribute setting
+    // -----------------
+
+    /// @copydoc GAL::SetIsFill()
+    virtual void SetIsFill( bool aIsFillEnabled ) override;
+
+    /// @copydoc GAL::SetIsStroke()
+    virtual void SetIsStroke( bool aIsStrokeEnabled ) override;
+
+    /// @copydoc GAL::SetFillColor()
+    virtual void SetFillColor( const COLOR4D& aColor ) override;
+
+    /// @copydoc GAL::SetStrokeColor()
+    virtual void SetStrokeColor( const COLOR4D& aColor ) override;
+
+    /// @copydoc GAL::SetLineWidth()
+    virtual void SetLineWidth( float aLineWidth ) override;
+
+    /// @copydoc GAL::SetLayerDepth()
+    virtual void SetLayerDepth( double aLayerDepth ) override;
+
+    // ----
+    // Text
+    // ----
+
+    /// @copydoc GAL::BitmapText()
+    virtual void BitmapText( const wxString& aText, const VECTOR2D& aPosition,
+                             double aRotationAngle ) override;
+
+    // --------------
+    // Transformation
+    // --------------
+
+    /// @copydoc GAL::Transform()
+    virtual void Transform( const MATRIX3x3D& aTransformation ) override;
+
+    /// @copydoc GAL::Rotate()
+    virtual void Rotate( double aAngle ) override;
+
+    /// @copydoc GAL::Translate()
+    virtual void Translate( const VECTOR2D& aTranslation ) override;
+
+    /// @copydoc GAL::Scale()
+    virtual void Scale( const VECTOR2D& aScale ) override;
+
+    /// @copydoc GAL::Save()
+    virtual void Save() override;
+
+    /// @copydoc GAL::Restore()
+    virtual void Restore() override;
+
+    // -------------
+    // Group methods
+    // -------------
+
+    /// @copydoc GAL::BeginGroup()
+    virtual int BeginGroup() override;
+
+    /// @copydoc GAL::EndGroup()
+    virtual void EndGroup() override;
+
+    /// @copydoc GAL::DeleteGroup()
+    virtual void DeleteGroup( int aGroupNumber ) override;
+
+    /// @copydoc GAL::ClearCache()
+    virtual void ClearCache() override;
+
+    /**
+     * Function TakeGroup()
+     * Removes a group and returns the calls recorded in it.
+     */
+    COMMANDS TakeGroup( int aGroupNumber );
+
+    ///> Returns the recorded groups, by group number
+    const std::map<int, COMMANDS>& GetGroups() const
+    {
+        return m_groups;
+    }
+
+    /**
+     * Function Replay()
+     * Makes the recorded calls on another GAL.
+     */
+    static void Replay( const COMMANDS& aCommands, GAL& aTarget );
+
+private:
+    ///> Returns a new command appended to the current group, or nullptr outside of groups
+    COMMAND* record( COMMAND_TYPE aType );
+
+    std::map<int, COMMANDS> m_groups;
+    COMMANDS*               m_currentGroup;
+    int                     m_groupCounter;
+
+    ///> Keys of the shapes stored in the current group
+    std::set<uint64_t>      m_groupShapes;
+
+    bool                    m_isOpenGl;
+    bool                    m_isCairo;
+    bool                    m_isInstancing;
+};
+
+} // namespace KIGFX
+
+#endif // RECORDING_GAL_H
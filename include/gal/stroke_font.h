@@ -31,6 +31,8 @@
 
 #include <deque>
 #include <algorithm>
+#include <memory>
+#include <vector>
 
 #include <utf8.h>
 
@@ -45,6 +47,16 @@ class GAL;
 typedef std::vector<std::vector<VECTOR2D>*> GLYPH;
 typedef std::vector<GLYPH*>                 GLYPH_LIST;
 
+///> A stroke of a laid out text, in the text coordinates
+struct GLYPH_RUN_STROKE
+{
+    std::vector<VECTOR2D> m_points;
+    bool                  m_isOverbar;    ///< Overbars are drawn as lines, glyphs as polylines
+};
+
+///> The strokes of a laid out text, in drawing order
+typedef std::vector<GLYPH_RUN_STROKE> GLYPH_RUN;
+
 /**
  * @brief Class STROKE_FONT implements stroke font drawing.
  *
@@ -111,6 +123,22 @@ public:
      */
     static double GetInterline( double aGlyphHeight );
 
+    /**
+     * @brief Empties the cache of laid out texts shared by all the GALs, so the texts are
+     * laid out again the next time they are drawn.
+     */
+    static void ClearLayoutCache();
+
+    /**
+     * @brief Returns the number of texts laid out since the cache was last emptied. The other
+     * texts drawn meanwhile were taken from the cache.
+     */
+    static size_t GetLayoutCount();
+
+    ///> Maximum number of laid out texts kept in the cache, the least recently used ones are
+    ///> dropped first
+    static constexpr size_t LAYOUT_CACHE_SIZE = 4096;
+
 
 
 private:
@@ -144,12 +172,35 @@ private:
     BOX2D computeBoundingBox( const GLYPH* aGlyph, double aGlyphWidth ) const;
 
     /**
-     * @brief Draws a single line of text. Multiline texts should be split before using the
+     * @brief Returns the strokes of a text laid out with the current GAL text attributes and
+     * line width.
+     *
+     * Texts are laid out once and kept in a cache shared by all the GALs and threads, since
+     * the same reference designators, values and net names are drawn over and over again.
+     * The cache does not depend on the text position and orientation.
+     *
+     * @param aText is the text to be laid out.
+     */
+    std::shared_ptr<const GLYPH_RUN> getGlyphRun( const UTF8& aText ) const;
+
+    /**
+     * @brief Lays out a text (possibly multiline) relative to its anchor.
+     *
+     * @param aText is the text to be laid out.
+     * @param aRun receives the strokes of the text.
+     */
+    void layoutText( const UTF8& aText, GLYPH_RUN& aRun ) const;
+
+    /**
+     * @brief Lays out a single line of text. Multiline texts should be split before using the
      * function.
      *
-     * @param aText is the text to be drawn.
+     * @param aText is the text to be laid out.
+     * @param aOffset is the position of the line relative to the text anchor.
+     * @param aRun receives the strokes of the line.
      */
-    void drawSingleLineText( const UTF8& aText );
+    void layoutSingleLineText( const UTF8& aText, const VECTOR2D& aOffset,
+                               GLYPH_RUN& aRun ) const;
 
     /**
      * @brief Returns number of lines for a given text.
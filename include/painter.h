@@ -104,6 +104,40 @@ public:
      */
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) = 0;
 
+    /**
+     * Function Clone
+     * Creates a painter with the same settings, drawing on another GAL.  The copies are used to
+     * draw items on worker threads, so painters which can be copied must not change anything
+     * but the GAL and the item being drawn in Draw().
+     * @param aGal is the GAL the copy draws on.
+     * @return the copy (owned by the caller), or nullptr if the painter can't be copied.
+     */
+    virtual PAINTER* Clone( GAL* aGal ) const
+    {
+        return nullptr;
+    }
+
+    /**
+     * Function HasLODVariant
+     * Tells if the painter draws a simplified variant of the item on the layer when a LOD
+     * tolerance is set, for the view to cache it next to the full detail one.
+     * @see VIEW::SetLODScale()
+     */
+    virtual bool HasLODVariant( const VIEW_ITEM* aItem, int aLayer ) const
+    {
+        return false;
+    }
+
+    /**
+     * Function SetLODTolerance
+     * Sets the size (in world units) below which details may be dropped by Draw(), 0 to draw
+     * everything in full detail.
+     */
+    void SetLODTolerance( double aTolerance )
+    {
+        m_lodTolerance = aTolerance;
+    }
+
 protected:
     /// Instance of graphic abstraction layer that gives an interface to call
     /// commands used to draw (eg. DrawLine, DrawCircle, etc.)
@@ -111,6 +145,9 @@ protected:
 
     /// Color of brightened item frame
     COLOR4D m_brightenedColor;
+
+    /// Size of the details that may be dropped, 0 for full detail
+    double m_lodTolerance;
 };
 
 } // namespace KIGFX
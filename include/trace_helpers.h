@@ -174,6 +174,14 @@ extern const wxChar* const traceSymbolResolver;
  */
 extern const wxChar* const traceSchSheetPaths;
 
+/**
+ * Flag to enable debug output of the frame time statistics of the drawing canvases (needs
+ * ShowFrameStats in the advanced config).
+ *
+ * Use "KICAD_FRAME_STATS" to enable.
+ */
+extern const wxChar* const traceFrameStats;
+
 ///@}
 
 /**
@@ -0,0 +1,118 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __FRAME_STATS_H
+#define __FRAME_STATS_H
+
+#include <view/view.h>
+#include <wx/string.h>
+
+#include <deque>
+#include <vector>
+
+namespace KIGFX
+{
+class GAL;
+
+/**
+ * FRAME_STATS
+ *
+ * Timings of the frames drawn by a canvas, split in drawing phases, with the counters of the
+ * view for the last frame and a histogram of the recent frame times.  Used to diagnose slow
+ * redraws (e.g. laggy panning) on specific boards.
+ */
+class FRAME_STATS
+{
+public:
+    ///> Duration of the phases of a frame [ms]
+    struct FRAME
+    {
+        FRAME() :
+            m_update( 0.0 ),
+            m_paint( 0.0 ),
+            m_upload( 0.0 ),
+            m_draw( 0.0 ),
+            m_composite( 0.0 ),
+            m_total( 0.0 )
+        {}
+
+        double m_update;        ///< Updating the view (bounding boxes, R-tree, LOD groups)
+        double m_paint;         ///< Painter drawing the updated items to the GAL
+        double m_upload;        ///< Finishing the GAL update (uploading the cached geometry)
+        double m_draw;          ///< Redrawing the dirty targets
+        double m_composite;     ///< Compositing the targets and presenting the frame
+        double m_total;         ///< The whole frame
+    };
+
+    FRAME_STATS();
+
+    /**
+     * Function AddFrame()
+     * Adds a frame to the history.
+     * @param aFrame are the durations of the phases of the frame.
+     * @param aViewStats are the counters of the view after the frame was drawn.
+     */
+    void AddFrame( const FRAME& aFrame, const VIEW::DRAW_STATS& aViewStats );
+
+    ///> Returns the last frame added, or an empty one
+    const FRAME& GetLastFrame() const;
+
+    /**
+     * Function GetHistogram()
+     * Returns the number of recent frames in each bucket of the frame time histogram: the
+     * bucket i counts the frames up to BUCKET_LIMITS[i], the last one counts the slower ones.
+     */
+    std::vector<int> GetHistogram() const;
+
+    ///> Share of the items drawn from the cache in the last frame (1.0 if none were cached)
+    double GetCacheHitRate() const;
+
+    ///> Returns a one line summary of the last frame, for the log
+    wxString Format() const;
+
+    /**
+     * Function Draw()
+     * Draws the statistics in the top left corner of a view.  The GAL must be drawing with
+     * the world to screen transformation of the view.
+     * @param aGal is the GAL to draw with.
+     * @param aView is the view drawn by the GAL.
+     */
+    void Draw( GAL* aGal, const VIEW* aView ) const;
+
+    ///> Number of recent frames counted in the histogram
+    static const size_t HISTORY_SIZE = 240;
+
+    ///> Upper limits of the histogram buckets, but the last one [ms]
+    static const std::vector<double> BUCKET_LIMITS;
+
+private:
+    ///> Lines of text describing the last frame
+    std::vector<wxString> formatLines() const;
+
+    std::deque<FRAME> m_history;
+    VIEW::DRAW_STATS  m_lastViewStats;
+};
+
+} // namespace KIGFX
+
+#endif // __FRAME_STATS_H
@@ -28,6 +28,7 @@
 #include <vector>
 #include <set>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
 
 #include <math/box2.h>
@@ -62,6 +63,7 @@ class VIEW
 {
 public:
     friend class VIEW_ITEM;
+    friend class VIEW_ITEM_DATA;
 
     typedef std::pair<VIEW_ITEM*, int> LAYER_ITEM_PAIR;
 
@@ -95,6 +97,23 @@ public:
      */
     virtual void Remove( VIEW_ITEM* aItem );
 
+    /**
+     * Function BulkAdd()
+     * Adds many VIEW_ITEMs to the view at once, with sequential priorities.  Each layer's
+     * R-tree is built once with all its new items (packed, see VIEW_RTREE::Insert()), instead
+     * of growing one item at a time: use it to load whole documents.
+     * @param aItems: items to be added. No ownership is given
+     */
+    virtual void BulkAdd( const std::vector<VIEW_ITEM*>& aItems );
+
+    /**
+     * Function BulkRemove()
+     * Removes many VIEW_ITEMs from the view at once, visiting each layer's R-tree once instead
+     * of once per item.
+     * @param aItems: items to be removed. Caller must dispose the removed items if necessary
+     */
+    virtual void BulkRemove( const std::vector<VIEW_ITEM*>& aItems );
+
 
     /**
      * Function Query()
@@ -539,6 +558,15 @@ public:
      */
     void RecacheAllItems();
 
+    /**
+     * Function RecacheLayer()
+     * Redraws the items of a cached layer, e.g. when the painter draws them differently on
+     * this layer.  Bounding boxes and the other layers of the items are left untouched.
+     * Non-cached layers are only marked for a redraw.
+     * @param aLayer is the layer to be redrawn.
+     */
+    void RecacheLayer( int aLayer );
+
     /**
      * Function IsDynamic()
      * Tells if the VIEW is dynamic (ie. can be changed, for example displaying PCBs in a window)
@@ -626,6 +654,79 @@ public:
      */
     void UpdateItems();
 
+    /**
+     * Function SetParallelCacheThreshold()
+     * Sets the number of items that must need redrawing at once for UpdateItems() to run the
+     * painter on worker threads (if it can be cloned), before caching their geometry.
+     * @param aItemCount is the minimum number of items, 0 to always draw on the GUI thread.
+     */
+    void SetParallelCacheThreshold( size_t aItemCount )
+    {
+        m_parallelCacheThreshold = aItemCount;
+    }
+
+    /**
+     * Function SetLODScale()
+     * Sets the scale below which cached items are drawn using the simplified variants their
+     * painter provides (see PAINTER::HasLODVariant()), which are cached next to the full
+     * detail ones.  The simplification error is kept under a pixel at that scale.
+     * @param aScale is the threshold scale, 0 to always draw the full detail.
+     */
+    void SetLODScale( double aScale );
+
+    inline double GetLODScale() const
+    {
+        return m_lodScale;
+    }
+
+    /**
+     * Function SetTileSize()
+     * With a Cairo GAL drawing to an image, splits the screen in square tiles drawn on worker
+     * threads by copies of the painter (if it can be cloned).  Not meant for printing, the
+     * items would be rasterized.  The drawing calls of the items are recorded once and
+     * replayed until the items are updated (or the view is zoomed, for non-cached layers).
+     * @param aTileSize is the tile size in pixels, 0 to draw everything on the GUI thread.
+     */
+    void SetTileSize( int aTileSize )
+    {
+        m_tileSize = aTileSize;
+    }
+
+    ///> Timings and counters of the last UpdateItems() and Redraw() calls
+    struct DRAW_STATS
+    {
+        DRAW_STATS() :
+            m_updateTime( 0.0 ),
+            m_paintTime( 0.0 ),
+            m_uploadTime( 0.0 ),
+            m_updatedItems( 0 ),
+            m_drawTime( 0.0 ),
+            m_cacheHits( 0 ),
+            m_cacheMisses( 0 ),
+            m_recordedItems( 0 )
+        {}
+
+        double           m_updateTime;      ///< UpdateItems() bookkeeping [ms]
+        double           m_paintTime;       ///< UpdateItems() painting items to the GAL [ms]
+        double           m_uploadTime;      ///< UpdateItems() finishing the GAL update [ms]
+        int              m_updatedItems;    ///< Items redrawn by UpdateItems()
+        double           m_drawTime;        ///< Redraw() [ms]
+        int              m_cacheHits;       ///< Cached items drawn from their groups
+        int              m_cacheMisses;     ///< Cached items without a group when drawn
+        int              m_recordedItems;   ///< Items recorded again by a tiled Redraw()
+        std::vector<int> m_layerItems;      ///< Items drawn on each layer by Redraw()
+    };
+
+    /**
+     * Function GetDrawStats()
+     * Returns the timings and counters of the last UpdateItems() and Redraw() calls, to
+     * diagnose slow redraws.
+     */
+    const DRAW_STATS& GetDrawStats() const
+    {
+        return m_drawStats;
+    }
+
     /**
      * Updates all items in the view according to the given flags
      * @param aUpdateFlags is is according to KIGFX::VIEW_UPDATE_FLAGS
@@ -731,6 +832,14 @@ protected:
     ///* Redraws contents within rect aRect
     void redrawRect( const BOX2I& aRect );
 
+    /**
+     * Function redrawTiles()
+     * Redraws contents within rect aRect, splitting the screen in tiles drawn on worker
+     * threads (see SetTileSize()).
+     * @return false if nothing was drawn, because the GAL or the painter don't allow it.
+     */
+    bool redrawTiles( const BOX2I& aRect );
+
     inline void markTargetClean( int aTarget )
     {
         wxCHECK( aTarget < TARGETS_NUMBER, /* void */ );
@@ -790,6 +899,37 @@ protected:
     /// Updates all informations needed to draw an item
     void updateItemGeometry( VIEW_ITEM* aItem, int aLayer );
 
+    /// Drawing calls recorded on a worker thread for an item
+    struct RECORDED_ITEM;
+
+    /**
+     * Function recordItems()
+     * Runs copies of the painter on worker threads, drawing the layers of aItems accepted by
+     * aLayerFilter to RECORDING_GALs.  aRecorded is left empty if the painter can't be cloned.
+     */
+    void recordItems( const std::vector<VIEW_ITEM*>& aItems,
+                      std::vector<RECORDED_ITEM>& aRecorded,
+                      const std::function<bool( VIEW_ITEM*, int )>& aLayerFilter );
+
+    ///> Returns true if items are drawn using their simplified variants at the current scale
+    bool useLODGroups() const
+    {
+        return m_lodScale > 0.0 && m_scale < m_lodScale;
+    }
+
+    /// Deletes the cached simplified variant of an item on a layer
+    void deleteLODGroup( VIEW_ITEM* aItem, int aLayer );
+
+    /// Queues an item whose simplified variants have to be cached again
+    void markLODPending( VIEW_ITEM* aItem );
+
+    /// Caches the simplified variants missing for the pending items (or all of them after
+    /// the cache was cleared)
+    void updateLODGroups();
+
+    /// Caches the simplified variants missing for the cached layers of an item
+    void cacheLODGroups( VIEW_ITEM* aItem );
+
     /// Updates bounding box of an item
     void updateBbox( VIEW_ITEM* aItem );
 
@@ -871,6 +1011,30 @@ protected:
     /// m_printMode > 0 is a printing mode (currently means "we are in printing mode")
     int m_printMode;
 
+    /// Minimum number of items to redraw for UpdateItems() to record them in parallel
+    size_t m_parallelCacheThreshold;
+
+    /// Recorded drawing calls of the item being updated, if any
+    const RECORDED_ITEM* m_replayItem;
+
+    /// Scale below which the simplified variants of items are drawn (0 to disable them)
+    double m_lodScale;
+
+    /// True if the simplified variants of all items may be missing from the cache
+    bool m_lodDirty;
+
+    /// Items whose simplified variants may be missing from the cache
+    std::unordered_set<VIEW_ITEM*> m_lodPending;
+
+    /// Size of the tiles drawn on worker threads, in pixels (0 to draw on the GUI thread)
+    int m_tileSize;
+
+    /// Bumped whenever the layer colors change, to drop the recordings drawn with the old ones
+    int m_colorGeneration;
+
+    /// Timings and counters of the last update and redraw
+    DRAW_STATS m_drawStats;
+
     VIEW( const VIEW& ) = delete;
 };
 } // namespace KIGFX
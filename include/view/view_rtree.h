@@ -29,6 +29,9 @@
 
 #include <geometry/rtree.h>
 
+#include <unordered_set>
+#include <vector>
+
 namespace KIGFX
 {
 typedef RTree<VIEW_ITEM*, int, 2, double> VIEW_RTREE_BASE;
@@ -53,6 +56,42 @@ public:
         const int       mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
 
         VIEW_RTREE_BASE::Insert( mmin, mmax, aItem );
+        m_count++;
+    }
+
+    /**
+     * Function Insert()
+     * Inserts many items into the tree.  Unless they are few compared to the items already
+     * in the tree, the tree is rebuilt packed (see RTree::BulkInsert()).
+     */
+    void Insert( const std::vector<VIEW_ITEM*>& aItems )
+    {
+        // Rebuilding sorts all the items: inserting a handful in a large tree is cheaper
+        if( aItems.size() * 8 < m_count )
+        {
+            for( VIEW_ITEM* item : aItems )
+                Insert( item );
+
+            return;
+        }
+
+        std::vector<std::pair<Rect, VIEW_ITEM*>> entries;
+        entries.reserve( aItems.size() );
+
+        for( VIEW_ITEM* item : aItems )
+        {
+            const BOX2I& bbox = item->ViewBBox();
+            Rect         rect;
+
+            rect.m_min[0] = bbox.GetX();
+            rect.m_min[1] = bbox.GetY();
+            rect.m_max[0] = bbox.GetRight();
+            rect.m_max[1] = bbox.GetBottom();
+            entries.emplace_back( rect, item );
+        }
+
+        VIEW_RTREE_BASE::BulkInsert( entries );
+        m_count += aItems.size();
     }
 
     /**
@@ -68,7 +107,48 @@ public:
         const int       mmin[2] = { INT_MIN, INT_MIN };
         const int       mmax[2] = { INT_MAX, INT_MAX };
 
-        VIEW_RTREE_BASE::Remove( mmin, mmax, aItem );
+        if( !VIEW_RTREE_BASE::Remove( mmin, mmax, aItem ) )
+            m_count--;
+    }
+
+    /**
+     * Function Remove()
+     * Removes many items from the tree.  Unless they are only a few, this is done in a single
+     * pass over the tree, which is rebuilt packed (see RTree::BulkRemove()).
+     */
+    void Remove( const std::vector<VIEW_ITEM*>& aItems )
+    {
+        // Each single removal searches the whole tree
+        if( aItems.size() < 16 )
+        {
+            for( VIEW_ITEM* item : aItems )
+                Remove( item );
+
+            return;
+        }
+
+        std::unordered_set<VIEW_ITEM*> removed( aItems.begin(), aItems.end() );
+
+        m_count -= VIEW_RTREE_BASE::BulkRemove( [&removed]( VIEW_ITEM* const& aItem )
+                                                {
+                                                    return removed.count( aItem ) > 0;
+                                                } );
+    }
+
+    /**
+     * Function RemoveAll()
+     * Removes all items from the tree.
+     */
+    void RemoveAll()
+    {
+        VIEW_RTREE_BASE::RemoveAll();
+        m_count = 0;
+    }
+
+    ///> Returns the number of items in the tree
+    size_t Size() const
+    {
+        return m_count;
     }
 
     /**
@@ -99,6 +179,7 @@ public:
     }
 
 private:
+    size_t m_count = 0;
 };
 } // namespace KIGFX
 
@@ -0,0 +1,282 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __FAST_HASH_H
+#define __FAST_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+/**
+ * HASH_128
+ *
+ * A 128-bit hash value, as returned by FAST_HASH::Digest128().  A default constructed
+ * HASH_128 is all zeroes.
+ */
+struct HASH_128
+{
+    uint64_t Value64[2] = { 0, 0 };
+
+    bool operator==( const HASH_128& aOther ) const
+    {
+        return Value64[0] == aOther.Value64[0] && Value64[1] == aOther.Value64[1];
+    }
+
+    bool operator!=( const HASH_128& aOther ) const
+    {
+        return !( *this == aOther );
+    }
+
+    ///> Hexadecimal representation, mainly for debug purposes
+    std::string ToString() const
+    {
+        char buf[33];
+        snprintf( buf, sizeof( buf ), "%016llx%016llx", (unsigned long long) Value64[1],
+                  (unsigned long long) Value64[0] );
+        return buf;
+    }
+};
+
+
+/**
+ * FAST_HASH
+ *
+ * Incremental non-cryptographic hash, for change detection and cache keys (use MD5_HASH
+ * where a cryptographic hash is needed).
+ *
+ * The data is consumed in 32 byte stripes by four independent 64-bit accumulators, which the
+ * compiler can keep in registers (and interleave, or vectorize) while streaming large
+ * buffers.  Digest64() is the XXH64 hash of everything added since the last Reset();
+ * Digest128() adds a second, differently mixed, 64-bit half to it.
+ *
+ * The digest only depends on the bytes added, not on how they were split between calls to
+ * Add().  Values are hashed in the byte order of the machine: hashes are not meant to be
+ * stored in files.
+ */
+class FAST_HASH
+{
+public:
+    FAST_HASH( uint64_t aSeed = 0 )
+    {
+        Reset( aSeed );
+    }
+
+    void Reset( uint64_t aSeed = 0 )
+    {
+        m_seed = aSeed;
+        m_acc[0] = aSeed + PRIME1 + PRIME2;
+        m_acc[1] = aSeed + PRIME2;
+        m_acc[2] = aSeed;
+        m_acc[3] = aSeed - PRIME1;
+        m_length = 0;
+        m_bufferSize = 0;
+    }
+
+    void Add( const void* aData, size_t aLength )
+    {
+        const uint8_t* p = static_cast<const uint8_t*>( aData );
+
+        m_length += aLength;
+
+        if( m_bufferSize + aLength < STRIPE )
+        {
+            if( aLength )
+                memcpy( m_buffer + m_bufferSize, p, aLength );
+
+            m_bufferSize += aLength;
+            return;
+        }
+
+        if( m_bufferSize )
+        {
+            size_t fill = STRIPE - m_bufferSize;
+
+            memcpy( m_buffer + m_bufferSize, p, fill );
+            stripe( m_buffer );
+            p += fill;
+            aLength -= fill;
+            m_bufferSize = 0;
+        }
+
+        for( ; aLength >= STRIPE; p += STRIPE, aLength -= STRIPE )
+            stripe( p );
+
+        if( aLength )
+            memcpy( m_buffer, p, aLength );
+
+        m_bufferSize = aLength;
+    }
+
+    ///> Adds the bytes of a number or enum value
+    template <typename T>
+    void Add( const T& aValue )
+    {
+        static_assert( std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                       "FAST_HASH::Add( value ) only takes numbers and enums" );
+        Add( &aValue, sizeof( T ) );
+    }
+
+    ///> Adds the length and the characters of a string
+    void Add( const std::string& aString )
+    {
+        Add( aString.size() );
+        Add( aString.data(), aString.size() );
+    }
+
+    uint64_t Digest64() const
+    {
+        uint64_t h;
+
+        if( m_length >= STRIPE )
+        {
+            h = rotl( m_acc[0], 1 ) + rotl( m_acc[1], 7 ) + rotl( m_acc[2], 12 )
+                + rotl( m_acc[3], 18 );
+
+            for( int i = 0; i < 4; i++ )
+                h = ( h ^ round( 0, m_acc[i] ) ) * PRIME1 + PRIME4;
+        }
+        else
+        {
+            h = m_seed + PRIME5;
+        }
+
+        h += m_length;
+
+        return avalanche( tail( h, PRIME1, PRIME2 ) );
+    }
+
+    HASH_128 Digest128() const
+    {
+        HASH_128 result;
+        uint64_t h;
+
+        result.Value64[0] = Digest64();
+
+        // Second half: the accumulators merged the other way round, and different tail
+        // multipliers, so it is not a function of the first half
+        if( m_length >= STRIPE )
+        {
+            h = rotl( m_acc[3], 3 ) + rotl( m_acc[2], 11 ) + rotl( m_acc[1], 23 )
+                + rotl( m_acc[0], 29 );
+
+            for( int i = 3; i >= 0; i-- )
+                h = ( h ^ round( 0, m_acc[i] ) ) * PRIME2 + PRIME5;
+        }
+        else
+        {
+            h = m_seed + PRIME4;
+        }
+
+        h ^= m_length * PRIME3;
+
+        result.Value64[1] = avalanche( tail( h, PRIME2, PRIME1 ) );
+
+        return result;
+    }
+
+private:
+    static const size_t   STRIPE = 32;
+
+    static const uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+    static const uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+    static const uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+    static const uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+    static const uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+    static uint64_t rotl( uint64_t aValue, int aBits )
+    {
+        return ( aValue << aBits ) | ( aValue >> ( 64 - aBits ) );
+    }
+
+    static uint64_t read64( const uint8_t* aData )
+    {
+        uint64_t value;
+        memcpy( &value, aData, sizeof( value ) );
+        return value;
+    }
+
+    static uint32_t read32( const uint8_t* aData )
+    {
+        uint32_t value;
+        memcpy( &value, aData, sizeof( value ) );
+        return value;
+    }
+
+    static uint64_t round( uint64_t aAcc, uint64_t aInput )
+    {
+        aAcc += aInput * PRIME2;
+        aAcc = rotl( aAcc, 31 );
+        return aAcc * PRIME1;
+    }
+
+    static uint64_t avalanche( uint64_t aHash )
+    {
+        aHash ^= aHash >> 33;
+        aHash *= PRIME2;
+        aHash ^= aHash >> 29;
+        aHash *= PRIME3;
+        aHash ^= aHash >> 32;
+        return aHash;
+    }
+
+    void stripe( const uint8_t* aData )
+    {
+        // The four lanes are independent
+        m_acc[0] = round( m_acc[0], read64( aData ) );
+        m_acc[1] = round( m_acc[1], read64( aData + 8 ) );
+        m_acc[2] = round( m_acc[2], read64( aData + 16 ) );
+        m_acc[3] = round( m_acc[3], read64( aData + 24 ) );
+    }
+
+    ///> Mixes the bytes left in the buffer into aHash
+    uint64_t tail( uint64_t aHash, uint64_t aMulA, uint64_t aMulB ) const
+    {
+        const uint8_t* p = m_buffer;
+        const uint8_t* end = m_buffer + m_bufferSize;
+
+        for( ; p + 8 <= end; p += 8 )
+            aHash = rotl( aHash ^ round( 0, read64( p ) ), 27 ) * aMulA + PRIME4;
+
+        if( p + 4 <= end )
+        {
+            aHash = rotl( aHash ^ ( read32( p ) * aMulA ), 23 ) * aMulB + PRIME3;
+            p += 4;
+        }
+
+        for( ; p < end; p++ )
+            aHash = rotl( aHash ^ ( *p * PRIME5 ), 11 ) * aMulA;
+
+        return aHash;
+    }
+
+    uint64_t m_seed;
+    uint64_t m_acc[4];
+    uint64_t m_length;
+    uint8_t  m_buffer[STRIPE];
+    size_t   m_bufferSize;
+};
+
+#endif  // __FAST_HASH_H
@@ -0,0 +1,100 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __CONTOUR_SOA_H
+#define __CONTOUR_SOA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <math/box2.h>
+#include <math/vector2d.h>
+
+class SHAPE_LINE_CHAIN;
+
+/**
+ * CONTOUR_SOA
+ *
+ * Structure-of-arrays copy of the edges of a contour, used to answer point-in-polygon queries
+ * for many points at once.  The edge coordinates are stored as doubles in separate arrays so
+ * the kernels can test 2 (SSE2) or 4 (AVX2) edges per instruction; a scalar kernel is used on
+ * other CPUs.
+ *
+ * The vector kernels work in floating point and only decide the cases that are far from any
+ * rounding ambiguity.  Queries lying within a couple of units of an edge are re-evaluated
+ * with the exact integer code of SHAPE_LINE_CHAIN, so the results are always identical to the
+ * equivalent one-at-a-time queries whichever kernel is used.
+ *
+ * The contour is referenced, not copied: it must outlive the CONTOUR_SOA.
+ */
+class CONTOUR_SOA
+{
+public:
+    enum KERNEL
+    {
+        KERNEL_SCALAR = 0,
+        KERNEL_SSE2,
+        KERNEL_AVX2
+    };
+
+    CONTOUR_SOA( const SHAPE_LINE_CHAIN& aContour );
+
+    /**
+     * Function PointInside()
+     * Same as SHAPE_LINE_CHAIN::PointInside( aPoints[i], aAccuracy ) for each of the aCount
+     * points; aResults[i] is set to 1 if the point is inside, 0 otherwise.
+     */
+    void PointInside( const VECTOR2I* aPoints, size_t aCount, int aAccuracy,
+                      uint8_t* aResults ) const;
+
+    const BOX2I& BBox() const { return m_bbox; }
+
+    int EdgeCount() const { return m_edgeCount; }
+
+    ///> Best kernel supported by the CPU we are running on
+    static KERNEL BestKernel();
+
+    ///> Kernel used by all CONTOUR_SOA queries
+    static KERNEL GetKernel();
+
+    ///> Selects the kernel to use (mostly for testing); clamped to BestKernel()
+    static void SetKernel( KERNEL aKernel );
+
+    static const char* KernelName( KERNEL aKernel );
+
+private:
+    const SHAPE_LINE_CHAIN& m_contour;
+
+    ///> Edge i runs from ( m_x0[i], m_y0[i] ) to ( m_x1[i], m_y1[i] ).  The arrays are padded
+    ///> to a multiple of 4 with zero-length edges on the first vertex.
+    std::vector<double>     m_x0;
+    std::vector<double>     m_y0;
+    std::vector<double>     m_x1;
+    std::vector<double>     m_y1;
+
+    int                     m_edgeCount;
+    bool                    m_closed;
+    BOX2I                   m_bbox;
+};
+
+#endif
@@ -0,0 +1,142 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __POLY_EDGE_INDEX_H
+#define __POLY_EDGE_INDEX_H
+
+#include <vector>
+
+#include <geometry/seg.h>
+#include <math/box2.h>
+#include <math/vector2d.h>
+
+class SHAPE_LINE_CHAIN;
+
+/**
+ * POLY_EDGE_INDEX
+ *
+ * Spatial index of the edges of a contour (usually closed), speeding up point-in-polygon, edge
+ * distance and segment collision queries on contours with many vertices (typically filled
+ * zones).  The contour's bounding box is cut into horizontal slabs of equal height and each
+ * edge is listed in every slab its Y extent overlaps, so a query only visits the edges of the
+ * slabs its own Y extent (inflated by the clearance) covers.  Nearest-edge queries scan slabs
+ * outwards from the query and stop as soon as the remaining slabs are farther than the best
+ * edge found.
+ *
+ * The index keeps its own copy of the contour points: it stays valid (but stale) if the
+ * contour is modified or destroyed.  Results are identical to the equivalent linear queries
+ * of SHAPE_LINE_CHAIN and SEG.
+ */
+class POLY_EDGE_INDEX
+{
+public:
+    POLY_EDGE_INDEX( const SHAPE_LINE_CHAIN& aContour );
+
+    ///> Same as SHAPE_LINE_CHAIN::PointInside() on the closed contour
+    bool PointInside( const VECTOR2I& aP, int aAccuracy = 0 ) const;
+
+    ///> Same as SHAPE_LINE_CHAIN::EdgeContainingPoint(); returns -1 if no edge is close enough
+    int EdgeContainingPoint( const VECTOR2I& aP, int aAccuracy = 0 ) const;
+
+    bool PointOnEdge( const VECTOR2I& aP, int aAccuracy = 0 ) const
+    {
+        return EdgeContainingPoint( aP, aAccuracy ) >= 0;
+    }
+
+    ///> True if an edge lies strictly closer than aDist to aP (see SEG::PointCloserThan())
+    bool PointCloserThan( const VECTOR2I& aP, int aDist ) const;
+
+    ///> True if an edge lies at aDist or closer to aP
+    bool CheckClearance( const VECTOR2I& aP, int aDist ) const;
+
+    /**
+     * Function Collide()
+     * Checks whether an edge comes closer than aClearance to aSeg (see SEG::Collide()).  With
+     * a zero clearance only proper crossings count (see SEG::Intersect() ignoring endpoints).
+     */
+    bool Collide( const SEG& aSeg, int aClearance ) const;
+
+    ///> Squared distance from aP to the closest edge
+    SEG::ecoord SquaredDistance( const VECTOR2I& aP ) const;
+
+    ///> Squared distance from aSeg to the closest edge; 0 when they intersect
+    SEG::ecoord SquaredDistance( const SEG& aSeg ) const;
+
+    /**
+     * Function NearestEdge()
+     * Finds the edge closest to aP among those not farther than aMaxDist (as measured by
+     * SEG::Distance()).  Ties go to the edge with the highest index.
+     * @param aDist receives the distance to the edge found.
+     * @return the index of the edge, or -1 if none is close enough.
+     */
+    int NearestEdge( const VECTOR2I& aP, int aMaxDist, int& aDist ) const;
+
+    const BOX2I& BBox() const { return m_bbox; }
+
+    int EdgeCount() const { return m_edgeCount; }
+
+    int PointCount() const { return (int) m_points.size(); }
+
+    const VECTOR2I& CPoint( int aIndex ) const { return m_points[aIndex]; }
+
+    const SEG Edge( int aIndex ) const
+    {
+        int next = aIndex + 1 < (int) m_points.size() ? aIndex + 1 : 0;
+        return SEG( m_points[aIndex], m_points[next] );
+    }
+
+private:
+    int slab( int64_t aY ) const;
+
+    ///> Y range (inclusive) of a slab
+    int64_t slabTop( int aSlab ) const { return (int64_t) m_bbox.GetY() + aSlab * m_slabHeight; }
+    int64_t slabBottom( int aSlab ) const { return slabTop( aSlab + 1 ) - 1; }
+
+    /**
+     * Calls aVisitor( edgeIndex ) for the edges listed in the slabs overlapping [aYMin, aYMax]
+     * until it returns false.  Edges spanning several slabs may be visited more than once.
+     * @return false if the visitor stopped the iteration.
+     */
+    template <class VISITOR>
+    bool visitSlabs( int64_t aYMin, int64_t aYMax, VISITOR aVisitor ) const;
+
+    /**
+     * Scans the slabs outwards from those overlapping [aYMin, aYMax], keeping the lowest value
+     * of aMetric( edgeIndex ) (a squared distance).  Stops when the Y gap to the next slab
+     * exceeds the best distance found.
+     */
+    template <class METRIC>
+    SEG::ecoord nearest( int64_t aYMin, int64_t aYMax, METRIC aMetric ) const;
+
+    std::vector<VECTOR2I> m_points;
+    bool                  m_closed;
+    int                   m_edgeCount;
+    BOX2I                 m_bbox;
+    int64_t               m_slabHeight;
+    int                   m_slabCount;
+
+    ///> Edge indices of slab i are m_slabEdges[m_slabStart[i]] .. m_slabEdges[m_slabStart[i+1]-1]
+    std::vector<int>      m_slabStart;
+    std::vector<int>      m_slabEdges;
+};
+
+#endif
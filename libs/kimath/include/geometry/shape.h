@@ -28,6 +28,7 @@
 #include <assert.h>         // for assert
 #include <sstream>
 #include <stddef.h>         // for NULL
+#include <stdint.h>
 
 #include <geometry/seg.h>
 
@@ -171,4 +172,28 @@ protected:
 bool CollideShapes( const SHAPE* aA, const SHAPE* aB, int aClearance,
                     bool aNeedMTV, VECTOR2I& aMTV );
 
+/**
+ * SHAPE_COLLISION_STATS
+ *
+ * Counts the calls to CollideShapes() per pair of shape types, for profiling the
+ * router and DRC.  Counting is off by default; when off, the only cost is a relaxed
+ * atomic load per call.  Counters are global and thread-safe.
+ */
+namespace SHAPE_COLLISION_STATS
+{
+    const int TYPE_COUNT = SH_ARC + 1;
+
+    void Enable( bool aEnable );
+    bool IsEnabled();
+
+    ///> Clears all counters
+    void Reset();
+
+    ///> Number of CollideShapes( a, b ) calls with aA of type aA and aB of type aB
+    uint64_t Count( SHAPE_TYPE aA, SHAPE_TYPE aB );
+
+    ///> Short lowercase name of a shape type, used in reports
+    const char* TypeName( SHAPE_TYPE aType );
+}
+
 #endif // __SHAPE_H
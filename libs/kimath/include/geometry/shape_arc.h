@@ -81,6 +81,22 @@ public:
     bool Collide( const SEG& aSeg, int aClearance = 0 ) const override;
     bool Collide( const VECTOR2I& aP, int aClearance = 0 ) const override;
 
+    /**
+     * Function Collide()
+     * Checks if the arc lies closer to another arc than aClearance, taking the widths of
+     * both arcs into account.
+     */
+    bool Collide( const SHAPE_ARC& aArc, int aClearance = 0 ) const;
+
+    /**
+     * Function SquaredDistance()
+     * Computes the squared distance between the true arc (not its polyline approximation)
+     * and a point, a segment or another arc.  The arc width is not taken into account.
+     */
+    ecoord SquaredDistance( const VECTOR2I& aP ) const;
+    ecoord SquaredDistance( const SEG& aSeg ) const;
+    ecoord SquaredDistance( const SHAPE_ARC& aArc ) const;
+
     void SetWidth( int aWidth )
     {
         m_width = aWidth;
@@ -186,6 +202,14 @@ private:
 
     void update_bbox();
 
+    ///> Returns true if the ray from the centre in direction aDir crosses the arc
+    bool sweepContains( const VECTOR2D& aDir ) const;
+
+    ///> Distances from the arc to a point, a segment and another arc, in floating point
+    double distance( const VECTOR2D& aP ) const;
+    double distance( const SEG& aSeg ) const;
+    double distance( const SHAPE_ARC& aArc ) const;
+
 
     VECTOR2I m_p0, m_pc;
     double m_centralAngle;
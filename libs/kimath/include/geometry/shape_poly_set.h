@@ -26,6 +26,8 @@
 #ifndef __SHAPE_POLY_SET_H
 #define __SHAPE_POLY_SET_H
 
+#include <atomic>
+#include <cstdint>
 #include <cstdio>
 #include <deque>                        // for deque
 #include <iosfwd>                       // for string, stringstream
@@ -33,15 +35,17 @@
 #include <set>                          // for set
 #include <stdexcept>                    // for out_of_range
 #include <stdlib.h>                     // for abs
+#include <unordered_map>
 #include <vector>
 
 #include <clipper.hpp>                  // for ClipType, PolyTree (ptr only)
+#include <fast_hash.h>
+#include <geometry/poly_edge_index.h>
 #include <geometry/seg.h>               // for SEG
 #include <geometry/shape.h>
 #include <geometry/shape_line_chain.h>
 #include <math/box2.h>                  // for BOX2I
 #include <math/vector2d.h>              // for VECTOR2I
-#include <md5_hash.h>
 
 
 /**
@@ -448,7 +452,9 @@ class SHAPE_POLY_SET : public SHAPE
          * Copy constructor SHAPE_POLY_SET
          * Performs a deep copy of \p aOther into \p this.
          * @param aOther is the SHAPE_POLY_SET object that will be copied.
-         * @param aDeepCopy if true, make new copies of the triangulated unique_ptr vector
+         * The triangulation, if up to date, is shared with \p aOther (it is never modified once
+         * built).
+         * @param aDeepCopy is unused, kept for compatibility
          */
         SHAPE_POLY_SET( const SHAPE_POLY_SET& aOther, bool aDeepCopy = false );
 
@@ -587,6 +593,7 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns the reference to aIndex-th outline in the set
         SHAPE_LINE_CHAIN& Outline( int aIndex )
         {
+            InvalidateEdgeIndex();
             return m_polys[aIndex][0];
         }
 
@@ -609,12 +616,14 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns the reference to aHole-th hole in the aIndex-th outline
         SHAPE_LINE_CHAIN& Hole( int aOutline, int aHole )
         {
+            InvalidateEdgeIndex();
             return m_polys[aOutline][aHole + 1];
         }
 
         ///> Returns the aIndex-th subpolygon in the set
         POLYGON& Polygon( int aIndex )
         {
+            InvalidateEdgeIndex();
             return m_polys[aIndex];
         }
 
@@ -657,6 +666,8 @@ class SHAPE_POLY_SET : public SHAPE
         {
             ITERATOR iter;
 
+            InvalidateEdgeIndex();
+
             iter.m_poly = this;
             iter.m_currentPolygon = aFirst;
             iter.m_lastPolygon = aLast < 0 ? OutlineCount() - 1 : aLast;
@@ -769,6 +780,8 @@ class SHAPE_POLY_SET : public SHAPE
         {
             SEGMENT_ITERATOR iter;
 
+            InvalidateEdgeIndex();
+
             iter.m_poly = this;
             iter.m_currentPolygon = aFirst;
             iter.m_lastPolygon = aLast < 0 ? OutlineCount() - 1 : aLast;
@@ -832,6 +845,12 @@ class SHAPE_POLY_SET : public SHAPE
             return CIterateSegments( aOutline, aOutline, true );
         }
 
+        ///> Returns an iterator object, for all outlines in the set (with holes)
+        CONST_SEGMENT_ITERATOR CIterateSegmentsWithHoles() const
+        {
+            return CIterateSegments( 0, OutlineCount() - 1, true );
+        }
+
         /** operations on polygons use a aFastMode param
          * if aFastMode is PM_FAST (true) the result can be a weak polygon
          * if aFastMode is PM_STRICTLY_SIMPLE (false) (default) the result is (theorically) a strictly
@@ -888,6 +907,7 @@ class SHAPE_POLY_SET : public SHAPE
          * Performs outline inflation/deflation.  Polygons can have holes, but not linked holes
          * with main outlines, if aFactor < 0.  For those use InflateWithLinkedHoles() to avoid
          * odd corners where the link segments meet the outline.
+         * Polygons of large sets which are too far apart to merge are offset separately.
          *
          * @param aAmount - number of units to offset edges
          * @param aCircleSegmentsCount - number of segments per 360° to use in curve approx
@@ -895,9 +915,12 @@ class SHAPE_POLY_SET : public SHAPE
          *                          CHOP_ACUTE_CORNERS to chop angles less than 90°,
          *                          ROUND_ACUTE_CORNERS to round off angles less than 90°,
          *                          ROUND_ALL_CORNERS to round regardless of angles
+         * @param aThreads - number of threads the separate groups may be offset on.  Leave it
+         *                   at 1 when the caller already runs on one of several worker threads,
+         *                   like the zone filler does.
          */
         void Inflate( int aAmount, int aCircleSegmentsCount,
-                      CORNER_STRATEGY aCornerStrategy = ROUND_ALL_CORNERS );
+                      CORNER_STRATEGY aCornerStrategy = ROUND_ALL_CORNERS, unsigned aThreads = 1 );
 
         void Deflate( int aAmount, int aCircleSegmentsCount,
                       CORNER_STRATEGY aCornerStrategy = ROUND_ALL_CORNERS )
@@ -905,6 +928,29 @@ class SHAPE_POLY_SET : public SHAPE
             Inflate( -aAmount, aCircleSegmentsCount, aCornerStrategy );
         }
 
+        /**
+         * Performs outline inflation/deflation, with the number of segments of the rounded
+         * corners derived from a maximum error rather than given by the caller: small amounts
+         * get few segments and large ones as many as needed.
+         *
+         * The offset is made a little larger (by at most aMaxError) so the chords of the
+         * rounded corners never cut into the exact offset: inflating gives a superset of the
+         * exact result and deflating a subset, so clearances are always met.
+         *
+         * @param aAmount - number of units to offset edges
+         * @param aCornerStrategy - see Inflate( int, int, CORNER_STRATEGY, unsigned )
+         * @param aMaxError - maximum distance between the result and the exact offset (for
+         *                    instance ARC_HIGH_DEF or the board's m_MaxError)
+         * @param aThreads - see Inflate( int, int, CORNER_STRATEGY, unsigned )
+         */
+        void Inflate( int aAmount, CORNER_STRATEGY aCornerStrategy, int aMaxError,
+                      unsigned aThreads = 1 );
+
+        void Deflate( int aAmount, CORNER_STRATEGY aCornerStrategy, int aMaxError )
+        {
+            Inflate( -aAmount, aCornerStrategy, aMaxError );
+        }
+
         /**
          * Performs outline inflation/deflation, using round corners.  Polygons can have holes,
          * and/or linked holes with main outlines.  The resulting polygons are laso polygons with
@@ -932,6 +978,22 @@ class SHAPE_POLY_SET : public SHAPE
         ///> For aFastMode meaning, see function booleanOp
         void Simplify( POLYGON_MODE aFastMode );
 
+        /**
+         * Function UnionAll
+         * Merges all the polygons of the set, which typically are many small overlapping
+         * operands (e.g. the knockouts of a zone fill).  The result is the same area as
+         * Simplify() gives, but the union is computed as a tree reduction: the operands are
+         * sorted along a Z-order curve so neighbours end up in the same leaves, the leaves are
+         * merged, then pairs of results are merged until one is left.  Even on a single thread
+         * this is much faster than Simplify() for thousands of operands, as most merges only
+         * involve nearby polygons.
+         * For aFastMode meaning, see function booleanOp
+         * @param aThreads is the number of threads each level of the tree may run on.  Leave it
+         *                 at 1 when the caller already runs on one of several worker threads,
+         *                 like the zone filler does.
+         */
+        void UnionAll( POLYGON_MODE aFastMode, unsigned aThreads = 1 );
+
         /**
          * Function NormalizeAreaOutlines
          * Convert a self-intersecting polygon to one (or more) non self-intersecting polygon(s)
@@ -1057,6 +1119,15 @@ class SHAPE_POLY_SET : public SHAPE
         bool Contains( const VECTOR2I& aP, int aSubpolyIndex = -1, int aAccuracy = 0,
                        bool aUseBBoxCaches = false ) const;
 
+        /**
+         * Batch version of Contains(): sets aResults[i] to true if aPoints[i] is inside the set
+         * (or the aSubpolyIndex-th polygon).  The contours are copied once to a CONTOUR_SOA
+         * and tested with vectorized kernels, which is much faster than testing the points one
+         * at a time.  The results are identical to those of Contains().
+         */
+        void Contains( const std::vector<VECTOR2I>& aPoints, std::vector<bool>& aResults,
+                       int aSubpolyIndex = -1, int aAccuracy = 0 ) const;
+
         ///> Returns true if the set is empty (no polygons at all)
         bool IsEmpty() const
         {
@@ -1238,6 +1309,13 @@ class SHAPE_POLY_SET : public SHAPE
         void booleanOp( ClipperLib::ClipType aType, const SHAPE_POLY_SET& aShape,
                         const SHAPE_POLY_SET& aOtherShape, POLYGON_MODE aFastMode );
 
+        ///> Offsets all the polygons with a single ClipperOffset (see Inflate())
+        void offsetPolygons( int aAmount, double aArcTolerance, CORNER_STRATEGY aCornerStrategy );
+
+        ///> Moves the polygons into groups of about aGroupSize polygons (or more, as polygons
+        ///> less than aMargin apart always go to the same group)
+        std::vector<SHAPE_POLY_SET> splitIndependent( int aMargin, size_t aGroupSize );
+
         /**
          * containsSingle function
          * Checks whether the point aP is inside the aSubpolyIndex-th polygon of the polyset. If
@@ -1256,6 +1334,10 @@ class SHAPE_POLY_SET : public SHAPE
         bool containsSingle( const VECTOR2I& aP, int aSubpolyIndex, int aAccuracy,
                              bool aUseBBoxCaches = false ) const;
 
+        ///> Batch version of containsSingle(): aResults[i] is set to 1 if aPoints[i] is inside
+        void containsSingle( const std::vector<VECTOR2I>& aPoints, int aSubpolyIndex,
+                             int aAccuracy, std::vector<uint8_t>& aResults ) const;
+
         /**
          * Operations ChamferPolygon and FilletPolygon are computed under the private chamferFillet
          * method; this enum is defined to make the necessary distinction when calling this method
@@ -1297,18 +1379,94 @@ class SHAPE_POLY_SET : public SHAPE
 
         SHAPE_POLY_SET& operator=( const SHAPE_POLY_SET& );
 
+        /**
+         * Function CacheTriangulation
+         * (re)builds the triangulation of the set, if it is not up to date.  Each polygon is
+         * triangulated on its own and its triangles are kept in a cache keyed by a hash of its
+         * contours: polygons which did not change since the last call, or which are shared
+         * with the set this one was assigned from, are not triangulated again.
+         */
         void CacheTriangulation();
         bool IsTriangulationUpToDate() const;
 
-        MD5_HASH GetHash() const;
+        HASH_128 GetHash() const;
+
+        /**
+         * Function SetEdgeIndexEnabled
+         * Enables or disables the edge index (enabled by default).  Once a set with enough
+         * vertices has been queried a few times, Contains(), Collide(), PointOnEdge(),
+         * CollideEdge() and the SquaredDistance() family build a POLY_EDGE_INDEX for each
+         * contour and use it instead of visiting every edge.
+         *
+         * The index is dropped by every modification made through the methods of this class,
+         * including the non-const accessors (Outline(), Polygon(), Iterate(), ...).  Changes
+         * made later through a reference or iterator obtained earlier are not detected: call
+         * InvalidateEdgeIndex() after such changes.
+         */
+        void SetEdgeIndexEnabled( bool aEnabled );
+
+        bool IsEdgeIndexEnabled() const { return m_edgeIndexEnabled; }
+
+        ///> Builds the edge index now instead of waiting for the set to be queried
+        void BuildEdgeIndex() const;
+
+        bool IsEdgeIndexBuilt() const
+        {
+            return m_edgeIndexBuilt.load( std::memory_order_acquire );
+        }
+
+        ///> Drops the edge index; it will be rebuilt if the set keeps being queried
+        void InvalidateEdgeIndex()
+        {
+            m_edgeIndexQueries.store( 0, std::memory_order_relaxed );
+
+            if( m_edgeIndexBuilt.load( std::memory_order_relaxed ) )
+                dropEdgeIndex();
+        }
 
     private:
 
-        MD5_HASH checksum() const;
+        HASH_128 checksum() const;
+
+        ///> One POLY_EDGE_INDEX per contour, laid out like m_polys
+        typedef std::vector<std::vector<POLY_EDGE_INDEX>> EDGE_INDEX;
+
+        ///> Returns the edge index, building it if the set is worth it; may return null
+        std::shared_ptr<const EDGE_INDEX> edgeIndex() const;
+
+        std::shared_ptr<const EDGE_INDEX> buildEdgeIndex() const;
+
+        void dropEdgeIndex();
+
+        ///> Checks that the edge index still matches the contours of the set
+        bool edgeIndexMatches( const EDGE_INDEX& aIndex ) const;
+
+        ///> Triangles of one polygon of the set (several if fracturing it split it)
+        typedef std::vector<std::shared_ptr<const TRIANGULATED_POLYGON>> TRIANGULATED_POLYGONS;
+
+        ///> Hash of the contours of a polygon, the key of m_triangulationCache
+        static uint64_t polygonHash( const POLYGON& aPolygon );
+
+        ///> Triangulates a single polygon, fracturing it first if it has holes
+        static TRIANGULATED_POLYGONS triangulatePolygon( const POLYGON& aPolygon );
+
+        std::vector<std::shared_ptr<const TRIANGULATED_POLYGON>> m_triangulatedPolys;
+
+        ///> Triangles of each polygon of the last triangulation, keyed by polygonHash().  Kept
+        ///> across modifications and assignments, so unchanged polygons are not triangulated
+        ///> again.
+        std::unordered_map<uint64_t, TRIANGULATED_POLYGONS> m_triangulationCache;
 
-        std::vector<std::unique_ptr<TRIANGULATED_POLYGON>> m_triangulatedPolys;
         bool m_triangulationValid = false;
-        MD5_HASH m_hash;
+        HASH_128 m_hash;
+        bool m_hashValid = false;
+
+        // The edge index is built lazily from const queries, possibly from several threads:
+        // the pointer is only accessed through std::atomic_load/atomic_store.
+        mutable std::shared_ptr<const EDGE_INDEX> m_edgeIndex;
+        mutable std::atomic<bool> m_edgeIndexBuilt{ false };
+        mutable std::atomic<int>  m_edgeIndexQueries{ 0 };
+        bool                      m_edgeIndexEnabled = true;
 
 };
 
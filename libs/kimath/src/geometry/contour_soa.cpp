@@ -0,0 +1,441 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#include <geometry/contour_soa.h>
+#include <geometry/shape_line_chain.h>
+
+#if defined( __x86_64__ ) || defined( _M_X64 ) || ( defined( __i386__ ) && defined( __SSE2__ ) )
+#define CONTOUR_SOA_SSE2
+#include <emmintrin.h>
+#endif
+
+// The AVX2 kernels are compiled with a per-function target attribute, so the rest of the
+// library does not need to be built for AVX2.  Only GCC and Clang support this.
+#if defined( CONTOUR_SOA_SSE2 ) && defined( __GNUC__ )
+#define CONTOUR_SOA_AVX2
+#define AVX2_TARGET __attribute__( ( target( "avx2" ) ) )
+#include <immintrin.h>
+#endif
+
+
+///> Crossings are counted exactly (in integers) when the ray passes closer than this to an
+///> edge, in internal units.  This covers both the floating point error of the kernels and the
+///> truncation of rescale() in SHAPE_LINE_CHAIN::PointInside()
+static const double CROSSING_BAND = 2.0;
+
+///> Beyond this, rescale() in SHAPE_LINE_CHAIN::PointInside() may overflow an int: let the
+///> exact code decide
+static const double CROSSING_MAX = 1073741824.0;
+
+///> Slack added to the on-edge distance of SHAPE_LINE_CHAIN::EdgeContainingPoint(), which
+///> truncates the distance and rounds the nearest point to integer coordinates
+static const double ON_EDGE_SLACK = 4.0;
+
+///> Number of bits set in a 4 bit lane mask
+static const int s_laneCount[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+static std::atomic<int> s_kernel( -1 );
+
+
+struct SOA_EDGES
+{
+    const double* x0;
+    const double* y0;
+    const double* x1;
+    const double* y1;
+    int           count;    ///< padded to a multiple of 4
+};
+
+
+static inline double pointSegDist2( double aPx, double aPy, double aX0, double aY0, double aX1,
+                                    double aY1 )
+{
+    double ex = aX1 - aX0;
+    double ey = aY1 - aY0;
+    double wx = aPx - aX0;
+    double wy = aPy - aY0;
+    double len2 = std::max( ex * ex + ey * ey, 1.0 );
+    double t = std::min( std::max( ( ex * wx + ey * wy ) / len2, 0.0 ), 1.0 );
+    double dx = wx - t * ex;
+    double dy = wy - t * ey;
+
+    return dx * dx + dy * dy;
+}
+
+
+/**
+ * Counts the edges crossed by the ray going right from ( aPx, aPy ).  Returns false if the
+ * count can't be trusted: the ray passes too close to an edge, or (when aNearDist2 > 0) the
+ * point is closer than sqrt( aNearDist2 ) to an edge.
+ */
+static bool insideScalar( const SOA_EDGES& aEdges, double aPx, double aPy, double aNearDist2,
+                          int& aCrossings )
+{
+    int crossings = 0;
+
+    for( int i = 0; i < aEdges.count; i++ )
+    {
+        double y0 = aEdges.y0[i];
+        double y1 = aEdges.y1[i];
+
+        if( ( y0 > aPy ) != ( y1 > aPy ) )
+        {
+            double q = ( aEdges.x1[i] - aEdges.x0[i] ) * ( aPy - y0 ) / ( y1 - y0 );
+            double k = aPx - aEdges.x0[i];
+
+            if( std::abs( q - k ) < CROSSING_BAND || std::abs( q ) > CROSSING_MAX )
+                return false;
+
+            if( k < q )
+                crossings++;
+        }
+
+        if( aNearDist2 > 0.0 && pointSegDist2( aPx, aPy, aEdges.x0[i], y0, aEdges.x1[i], y1 )
+                                        < aNearDist2 )
+            return false;
+    }
+
+    aCrossings = crossings;
+    return true;
+}
+
+
+#ifdef CONTOUR_SOA_SSE2
+
+static inline __m128d pointSegDist2SSE2( __m128d aPx, __m128d aPy, __m128d aX0, __m128d aY0,
+                                         __m128d aX1, __m128d aY1 )
+{
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d one = _mm_set1_pd( 1.0 );
+
+    __m128d ex = _mm_sub_pd( aX1, aX0 );
+    __m128d ey = _mm_sub_pd( aY1, aY0 );
+    __m128d wx = _mm_sub_pd( aPx, aX0 );
+    __m128d wy = _mm_sub_pd( aPy, aY0 );
+    __m128d len2 = _mm_max_pd( _mm_add_pd( _mm_mul_pd( ex, ex ), _mm_mul_pd( ey, ey ) ), one );
+    __m128d t = _mm_div_pd( _mm_add_pd( _mm_mul_pd( ex, wx ), _mm_mul_pd( ey, wy ) ), len2 );
+
+    t = _mm_min_pd( _mm_max_pd( t, zero ), one );
+
+    __m128d dx = _mm_sub_pd( wx, _mm_mul_pd( t, ex ) );
+    __m128d dy = _mm_sub_pd( wy, _mm_mul_pd( t, ey ) );
+
+    return _mm_add_pd( _mm_mul_pd( dx, dx ), _mm_mul_pd( dy, dy ) );
+}
+
+
+static bool insideSSE2( const SOA_EDGES& aEdges, double aPx, double aPy, double aNearDist2,
+                        int& aCrossings )
+{
+    const __m128d px = _mm_set1_pd( aPx );
+    const __m128d py = _mm_set1_pd( aPy );
+    const __m128d one = _mm_set1_pd( 1.0 );
+    const __m128d signBit = _mm_set1_pd( -0.0 );
+    const __m128d band = _mm_set1_pd( CROSSING_BAND );
+    const __m128d qMax = _mm_set1_pd( CROSSING_MAX );
+    const __m128d nearDist2 = _mm_set1_pd( aNearDist2 );
+
+    int crossings = 0;
+
+    for( int i = 0; i < aEdges.count; i += 2 )
+    {
+        __m128d x0 = _mm_loadu_pd( aEdges.x0 + i );
+        __m128d y0 = _mm_loadu_pd( aEdges.y0 + i );
+        __m128d x1 = _mm_loadu_pd( aEdges.x1 + i );
+        __m128d y1 = _mm_loadu_pd( aEdges.y1 + i );
+
+        __m128d straddle = _mm_xor_pd( _mm_cmpgt_pd( y0, py ), _mm_cmpgt_pd( y1, py ) );
+
+        if( _mm_movemask_pd( straddle ) )
+        {
+            // Horizontal edges never straddle; give them a harmless denominator
+            __m128d dy = _mm_or_pd( _mm_and_pd( straddle, _mm_sub_pd( y1, y0 ) ),
+                                    _mm_andnot_pd( straddle, one ) );
+            __m128d q = _mm_div_pd( _mm_mul_pd( _mm_sub_pd( x1, x0 ), _mm_sub_pd( py, y0 ) ),
+                                    dy );
+            __m128d k = _mm_sub_pd( px, x0 );
+
+            __m128d unsure = _mm_or_pd(
+                    _mm_cmplt_pd( _mm_andnot_pd( signBit, _mm_sub_pd( q, k ) ), band ),
+                    _mm_cmpgt_pd( _mm_andnot_pd( signBit, q ), qMax ) );
+
+            if( _mm_movemask_pd( _mm_and_pd( straddle, unsure ) ) )
+                return false;
+
+            crossings += s_laneCount[_mm_movemask_pd( _mm_and_pd( straddle,
+                                                                  _mm_cmplt_pd( k, q ) ) )];
+        }
+
+        if( aNearDist2 > 0.0 )
+        {
+            __m128d d2 = pointSegDist2SSE2( px, py, x0, y0, x1, y1 );
+
+            if( _mm_movemask_pd( _mm_cmplt_pd( d2, nearDist2 ) ) )
+                return false;
+        }
+    }
+
+    aCrossings = crossings;
+    return true;
+}
+
+#endif
+
+
+#ifdef CONTOUR_SOA_AVX2
+
+AVX2_TARGET
+static inline __m256d pointSegDist2AVX2( __m256d aPx, __m256d aPy, __m256d aX0, __m256d aY0,
+                                         __m256d aX1, __m256d aY1 )
+{
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd( 1.0 );
+
+    __m256d ex = _mm256_sub_pd( aX1, aX0 );
+    __m256d ey = _mm256_sub_pd( aY1, aY0 );
+    __m256d wx = _mm256_sub_pd( aPx, aX0 );
+    __m256d wy = _mm256_sub_pd( aPy, aY0 );
+    __m256d len2 = _mm256_max_pd( _mm256_add_pd( _mm256_mul_pd( ex, ex ),
+                                                 _mm256_mul_pd( ey, ey ) ), one );
+    __m256d t = _mm256_div_pd( _mm256_add_pd( _mm256_mul_pd( ex, wx ),
+                                              _mm256_mul_pd( ey, wy ) ), len2 );
+
+    t = _mm256_min_pd( _mm256_max_pd( t, zero ), one );
+
+    __m256d dx = _mm256_sub_pd( wx, _mm256_mul_pd( t, ex ) );
+    __m256d dy = _mm256_sub_pd( wy, _mm256_mul_pd( t, ey ) );
+
+    return _mm256_add_pd( _mm256_mul_pd( dx, dx ), _mm256_mul_pd( dy, dy ) );
+}
+
+
+AVX2_TARGET
+static bool insideAVX2( const SOA_EDGES& aEdges, double aPx, double aPy, double aNearDist2,
+                        int& aCrossings )
+{
+    const __m256d px = _mm256_set1_pd( aPx );
+    const __m256d py = _mm256_set1_pd( aPy );
+    const __m256d one = _mm256_set1_pd( 1.0 );
+    const __m256d signBit = _mm256_set1_pd( -0.0 );
+    const __m256d band = _mm256_set1_pd( CROSSING_BAND );
+    const __m256d qMax = _mm256_set1_pd( CROSSING_MAX );
+    const __m256d nearDist2 = _mm256_set1_pd( aNearDist2 );
+
+    int crossings = 0;
+
+    for( int i = 0; i < aEdges.count; i += 4 )
+    {
+        __m256d x0 = _mm256_loadu_pd( aEdges.x0 + i );
+        __m256d y0 = _mm256_loadu_pd( aEdges.y0 + i );
+        __m256d x1 = _mm256_loadu_pd( aEdges.x1 + i );
+        __m256d y1 = _mm256_loadu_pd( aEdges.y1 + i );
+
+        __m256d straddle = _mm256_xor_pd( _mm256_cmp_pd( y0, py, _CMP_GT_OQ ),
+                                          _mm256_cmp_pd( y1, py, _CMP_GT_OQ ) );
+
+        if( _mm256_movemask_pd( straddle ) )
+        {
+            __m256d dy = _mm256_blendv_pd( one, _mm256_sub_pd( y1, y0 ), straddle );
+            __m256d q = _mm256_div_pd( _mm256_mul_pd( _mm256_sub_pd( x1, x0 ),
+                                                      _mm256_sub_pd( py, y0 ) ), dy );
+            __m256d k = _mm256_sub_pd( px, x0 );
+
+            __m256d unsure = _mm256_or_pd(
+                    _mm256_cmp_pd( _mm256_andnot_pd( signBit, _mm256_sub_pd( q, k ) ), band,
+                                   _CMP_LT_OQ ),
+                    _mm256_cmp_pd( _mm256_andnot_pd( signBit, q ), qMax, _CMP_GT_OQ ) );
+
+            if( _mm256_movemask_pd( _mm256_and_pd( straddle, unsure ) ) )
+                return false;
+
+            crossings += s_laneCount[_mm256_movemask_pd(
+                    _mm256_and_pd( straddle, _mm256_cmp_pd( k, q, _CMP_LT_OQ ) ) )];
+        }
+
+        if( aNearDist2 > 0.0 )
+        {
+            __m256d d2 = pointSegDist2AVX2( px, py, x0, y0, x1, y1 );
+
+            if( _mm256_movemask_pd( _mm256_cmp_pd( d2, nearDist2, _CMP_LT_OQ ) ) )
+                return false;
+        }
+    }
+
+    aCrossings = crossings;
+    return true;
+}
+
+#endif
+
+
+CONTOUR_SOA::KERNEL CONTOUR_SOA::BestKernel()
+{
+#ifdef CONTOUR_SOA_AVX2
+    __builtin_cpu_init();
+
+    if( __builtin_cpu_supports( "avx2" ) )
+        return KERNEL_AVX2;
+#endif
+
+#ifdef CONTOUR_SOA_SSE2
+    return KERNEL_SSE2;
+#else
+    return KERNEL_SCALAR;
+#endif
+}
+
+
+CONTOUR_SOA::KERNEL CONTOUR_SOA::GetKernel()
+{
+    int kernel = s_kernel.load( std::memory_order_relaxed );
+
+    if( kernel < 0 )
+    {
+        kernel = BestKernel();
+        s_kernel.store( kernel, std::memory_order_relaxed );
+    }
+
+    return (KERNEL) kernel;
+}
+
+
+void CONTOUR_SOA::SetKernel( KERNEL aKernel )
+{
+    s_kernel.store( std::min( aKernel, BestKernel() ), std::memory_order_relaxed );
+}
+
+
+const char* CONTOUR_SOA::KernelName( KERNEL aKernel )
+{
+    switch( aKernel )
+    {
+    case KERNEL_SSE2: return "sse2";
+    case KERNEL_AVX2: return "avx2";
+    default:          return "scalar";
+    }
+}
+
+
+CONTOUR_SOA::CONTOUR_SOA( const SHAPE_LINE_CHAIN& aContour ) :
+        m_contour( aContour ),
+        m_edgeCount( aContour.SegmentCount() ),
+        m_closed( aContour.IsClosed() )
+{
+    int padded = ( m_edgeCount + 3 ) & ~3;
+
+    m_x0.resize( padded );
+    m_y0.resize( padded );
+    m_x1.resize( padded );
+    m_y1.resize( padded );
+
+    for( int i = 0; i < m_edgeCount; i++ )
+    {
+        const SEG edge = aContour.CSegment( i );
+
+        m_x0[i] = edge.A.x;
+        m_y0[i] = edge.A.y;
+        m_x1[i] = edge.B.x;
+        m_y1[i] = edge.B.y;
+    }
+
+    // Zero-length padding edges never straddle a ray and are never closer than a real edge
+    VECTOR2I pad = aContour.PointCount() ? aContour.CPoint( 0 ) : VECTOR2I( 0, 0 );
+
+    for( int i = m_edgeCount; i < padded; i++ )
+    {
+        m_x0[i] = m_x1[i] = pad.x;
+        m_y0[i] = m_y1[i] = pad.y;
+    }
+
+    m_bbox = aContour.BBox();
+}
+
+
+void CONTOUR_SOA::PointInside( const VECTOR2I* aPoints, size_t aCount, int aAccuracy,
+                               uint8_t* aResults ) const
+{
+    if( !m_closed || m_contour.PointCount() < 3 )
+    {
+        memset( aResults, 0, aCount );
+        return;
+    }
+
+    const SOA_EDGES edges = { m_x0.data(), m_y0.data(), m_x1.data(), m_y1.data(),
+                              (int) m_x0.size() };
+    const KERNEL    kernel = GetKernel();
+
+    // With an accuracy of 1 PointInside() ignores the edges, otherwise points on (or near,
+    // depending on the accuracy) an edge must be checked exactly
+    double nearDist2 = 0.0;
+
+    if( aAccuracy != 1 )
+    {
+        nearDist2 = std::max( aAccuracy, 0 ) + ON_EDGE_SLACK;
+        nearDist2 *= nearDist2;
+    }
+
+    // A point outside the box can't be inside, nor on an edge
+    BOX2I bbox = m_bbox;
+    bbox.Inflate( std::max( aAccuracy, 0 ) + 1 );
+
+    for( size_t i = 0; i < aCount; i++ )
+    {
+        const VECTOR2I& p = aPoints[i];
+
+        if( !bbox.Contains( p ) )
+        {
+            aResults[i] = 0;
+            continue;
+        }
+
+        int  crossings = 0;
+        bool sure;
+
+        switch( kernel )
+        {
+#ifdef CONTOUR_SOA_AVX2
+        case KERNEL_AVX2:
+            sure = insideAVX2( edges, p.x, p.y, nearDist2, crossings );
+            break;
+#endif
+#ifdef CONTOUR_SOA_SSE2
+        case KERNEL_SSE2:
+            sure = insideSSE2( edges, p.x, p.y, nearDist2, crossings );
+            break;
+#endif
+        default:
+            sure = insideScalar( edges, p.x, p.y, nearDist2, crossings );
+            break;
+        }
+
+        if( sure )
+            aResults[i] = crossings & 1;
+        else
+            aResults[i] = m_contour.PointInside( p, aAccuracy ) ? 1 : 0;
+    }
+}
+
@@ -0,0 +1,372 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <geometry/poly_edge_index.h>
+#include <geometry/shape_line_chain.h>
+#include <math/util.h>
+
+
+// Average number of edges per slab.  Lower values speed up queries at the expense of
+// memory and build time.
+static const int EDGES_PER_SLAB = 4;
+
+static const int MAX_SLABS = 1 << 16;
+
+// Upper bound of slab entries per edge: contours with many long vertical edges (combs) get
+// fewer, taller slabs instead of a quadratic index.
+static const int MAX_ENTRIES_PER_EDGE = 8;
+
+
+POLY_EDGE_INDEX::POLY_EDGE_INDEX( const SHAPE_LINE_CHAIN& aContour ) :
+    m_points( aContour.CPoints() ),
+    m_closed( aContour.IsClosed() ),
+    m_edgeCount( aContour.SegmentCount() ),
+    m_slabHeight( 1 ),
+    m_slabCount( 1 )
+{
+    if( m_points.empty() )
+    {
+        m_slabStart.assign( 2, 0 );
+        return;
+    }
+
+    m_bbox.Compute( m_points );
+
+    const int64_t height = (int64_t) m_bbox.GetHeight() + 1;
+    const int64_t maxEntries = (int64_t) MAX_ENTRIES_PER_EDGE * m_edgeCount + MAX_SLABS;
+
+    int slabs = std::min( MAX_SLABS, std::max( 1, m_edgeCount / EDGES_PER_SLAB ) );
+
+    std::vector<int> counts;
+
+    while( true )
+    {
+        m_slabHeight = std::max<int64_t>( 1, ( height + slabs - 1 ) / slabs );
+        m_slabCount = (int) ( ( height + m_slabHeight - 1 ) / m_slabHeight );
+
+        counts.assign( m_slabCount + 1, 0 );
+
+        int64_t total = 0;
+
+        for( int i = 0; i < m_edgeCount; i++ )
+        {
+            const SEG edge = Edge( i );
+            const int s0 = slab( std::min( edge.A.y, edge.B.y ) );
+            const int s1 = slab( std::max( edge.A.y, edge.B.y ) );
+
+            for( int s = s0; s <= s1; s++ )
+                counts[s]++;
+
+            total += s1 - s0 + 1;
+        }
+
+        if( total <= maxEntries || m_slabCount == 1 )
+            break;
+
+        slabs = std::max( 1, m_slabCount / 2 );
+    }
+
+    m_slabStart.resize( m_slabCount + 1 );
+    m_slabStart[0] = 0;
+
+    for( int s = 0; s < m_slabCount; s++ )
+        m_slabStart[s + 1] = m_slabStart[s] + counts[s];
+
+    m_slabEdges.resize( m_slabStart[m_slabCount] );
+
+    std::vector<int> fill( m_slabStart.begin(), m_slabStart.end() - 1 );
+
+    for( int i = 0; i < m_edgeCount; i++ )
+    {
+        const SEG edge = Edge( i );
+        const int s0 = slab( std::min( edge.A.y, edge.B.y ) );
+        const int s1 = slab( std::max( edge.A.y, edge.B.y ) );
+
+        for( int s = s0; s <= s1; s++ )
+            m_slabEdges[fill[s]++] = i;
+    }
+}
+
+
+int POLY_EDGE_INDEX::slab( int64_t aY ) const
+{
+    int64_t s = ( aY - m_bbox.GetY() ) / m_slabHeight;
+
+    if( s < 0 )
+        return 0;
+
+    if( s >= m_slabCount )
+        return m_slabCount - 1;
+
+    return (int) s;
+}
+
+
+template <class VISITOR>
+bool POLY_EDGE_INDEX::visitSlabs( int64_t aYMin, int64_t aYMax, VISITOR aVisitor ) const
+{
+    if( m_edgeCount == 0 || aYMax < m_bbox.GetY() || aYMin > m_bbox.GetBottom() )
+        return true;
+
+    const int s0 = slab( aYMin );
+    const int s1 = slab( aYMax );
+
+    for( int i = m_slabStart[s0]; i < m_slabStart[s1 + 1]; i++ )
+    {
+        if( !aVisitor( m_slabEdges[i] ) )
+            return false;
+    }
+
+    return true;
+}
+
+
+template <class METRIC>
+SEG::ecoord POLY_EDGE_INDEX::nearest( int64_t aYMin, int64_t aYMax, METRIC aMetric ) const
+{
+    SEG::ecoord best = VECTOR2I::ECOORD_MAX;
+
+    if( m_edgeCount == 0 )
+        return best;
+
+    auto scan =
+            [&]( int aSlab )
+            {
+                for( int i = m_slabStart[aSlab]; i < m_slabStart[aSlab + 1] && best > 0; i++ )
+                    best = std::min( best, aMetric( m_slabEdges[i] ) );
+            };
+
+    // Squared Y gap, saturated to avoid overflowing for far away slabs
+    auto squaredGap =
+            []( int64_t aGap ) -> SEG::ecoord
+            {
+                if( aGap >= 3000000000LL )
+                    return VECTOR2I::ECOORD_MAX;
+
+                return (SEG::ecoord) aGap * aGap;
+            };
+
+    const int s0 = slab( aYMin );
+    const int s1 = slab( aYMax );
+
+    for( int s = s0; s <= s1; s++ )
+        scan( s );
+
+    int lo = s0 - 1;
+    int hi = s1 + 1;
+
+    while( best > 0 && ( lo >= 0 || hi < m_slabCount ) )
+    {
+        SEG::ecoord gapLo = lo >= 0 ? squaredGap( aYMin - slabBottom( lo ) )
+                                    : VECTOR2I::ECOORD_MAX;
+        SEG::ecoord gapHi = hi < m_slabCount ? squaredGap( slabTop( hi ) - aYMax )
+                                             : VECTOR2I::ECOORD_MAX;
+
+        if( std::min( gapLo, gapHi ) >= best )
+            break;
+
+        if( gapLo <= gapHi )
+            scan( lo-- );
+        else
+            scan( hi++ );
+    }
+
+    return best;
+}
+
+
+bool POLY_EDGE_INDEX::PointInside( const VECTOR2I& aP, int aAccuracy ) const
+{
+    if( !m_closed || m_points.size() < 3 )
+        return false;
+
+    bool inside = false;
+
+    // Same ray casting as SHAPE_LINE_CHAIN::PointInside(), restricted to the edges listed in
+    // the point's slab.  Every edge crossing the ray's line is listed there exactly once.
+    visitSlabs( aP.y, aP.y,
+            [&]( int aEdge )
+            {
+                const SEG  edge = Edge( aEdge );
+                const auto diff = edge.B - edge.A;
+
+                if( diff.y != 0 )
+                {
+                    const int d = rescale( diff.x, ( aP.y - edge.A.y ), diff.y );
+
+                    if( ( ( edge.A.y > aP.y ) != ( edge.B.y > aP.y ) ) && ( aP.x - edge.A.x < d ) )
+                        inside = !inside;
+                }
+
+                return true;
+            } );
+
+    if( aAccuracy == 0 )
+        return inside && !PointOnEdge( aP );
+    else if( aAccuracy == 1 )
+        return inside;
+    else
+        return inside || PointOnEdge( aP, aAccuracy - 1 );
+}
+
+
+int POLY_EDGE_INDEX::EdgeContainingPoint( const VECTOR2I& aP, int aAccuracy ) const
+{
+    if( m_points.empty() )
+        return -1;
+
+    if( m_points.size() == 1 )
+    {
+        VECTOR2I dist = m_points[0] - aP;
+        return ( hypot( dist.x, dist.y ) <= aAccuracy + 1 ) ? 0 : -1;
+    }
+
+    // SEG::Distance() truncates, so edges up to aAccuracy + 2 away may match
+    const int64_t margin = (int64_t) aAccuracy + 2;
+    int           found = -1;
+
+    // SHAPE_LINE_CHAIN::EdgeContainingPoint() returns the first matching edge
+    visitSlabs( aP.y - margin, aP.y + margin,
+            [&]( int aEdge )
+            {
+                if( found >= 0 && aEdge >= found )
+                    return true;
+
+                const SEG edge = Edge( aEdge );
+
+                if( edge.A == aP || edge.B == aP || edge.Distance( aP ) <= aAccuracy + 1 )
+                    found = aEdge;
+
+                return true;
+            } );
+
+    return found;
+}
+
+
+bool POLY_EDGE_INDEX::PointCloserThan( const VECTOR2I& aP, int aDist ) const
+{
+    const int64_t margin = (int64_t) aDist + 2;
+
+    return !visitSlabs( aP.y - margin, aP.y + margin,
+            [&]( int aEdge )
+            {
+                const SEG edge = Edge( aEdge );
+
+                if( std::min( edge.A.x, edge.B.x ) - aP.x > margin
+                        || aP.x - std::max( edge.A.x, edge.B.x ) > margin )
+                    return true;
+
+                return !edge.PointCloserThan( aP, aDist );
+            } );
+}
+
+
+bool POLY_EDGE_INDEX::CheckClearance( const VECTOR2I& aP, int aDist ) const
+{
+    const SEG::ecoord distSq = (SEG::ecoord) aDist * aDist;
+
+    return !visitSlabs( aP.y - (int64_t) aDist, aP.y + (int64_t) aDist,
+            [&]( int aEdge )
+            {
+                return Edge( aEdge ).SquaredDistance( aP ) > distSq;
+            } );
+}
+
+
+bool POLY_EDGE_INDEX::Collide( const SEG& aSeg, int aClearance ) const
+{
+    const int64_t margin = (int64_t) std::max( aClearance, 0 ) + 2;
+    const int64_t xMin = std::min( aSeg.A.x, aSeg.B.x ) - margin;
+    const int64_t xMax = std::max( aSeg.A.x, aSeg.B.x ) + margin;
+    const int64_t yMin = std::min( aSeg.A.y, aSeg.B.y ) - margin;
+    const int64_t yMax = std::max( aSeg.A.y, aSeg.B.y ) + margin;
+
+    return !visitSlabs( yMin, yMax,
+            [&]( int aEdge )
+            {
+                const SEG edge = Edge( aEdge );
+
+                if( std::max( edge.A.x, edge.B.x ) < xMin || std::min( edge.A.x, edge.B.x ) > xMax
+                        || std::max( edge.A.y, edge.B.y ) < yMin
+                        || std::min( edge.A.y, edge.B.y ) > yMax )
+                {
+                    return true;
+                }
+
+                if( aClearance > 0 )
+                    return !edge.Collide( aSeg, aClearance );
+
+                return !edge.Intersect( aSeg, true );
+            } );
+}
+
+
+SEG::ecoord POLY_EDGE_INDEX::SquaredDistance( const VECTOR2I& aP ) const
+{
+    return nearest( aP.y, aP.y,
+            [&]( int aEdge )
+            {
+                return Edge( aEdge ).SquaredDistance( aP );
+            } );
+}
+
+
+SEG::ecoord POLY_EDGE_INDEX::SquaredDistance( const SEG& aSeg ) const
+{
+    return nearest( std::min( aSeg.A.y, aSeg.B.y ), std::max( aSeg.A.y, aSeg.B.y ),
+            [&]( int aEdge )
+            {
+                return Edge( aEdge ).SquaredDistance( aSeg );
+            } );
+}
+
+
+int POLY_EDGE_INDEX::NearestEdge( const VECTOR2I& aP, int aMaxDist, int& aDist ) const
+{
+    const int64_t margin = (int64_t) aMaxDist + 2;
+    int           found = -1;
+    int           bestDist = aMaxDist;
+
+    visitSlabs( aP.y - margin, aP.y + margin,
+            [&]( int aEdge )
+            {
+                int dist = Edge( aEdge ).Distance( aP );
+
+                if( dist < bestDist || ( dist == bestDist && aEdge > found ) )
+                {
+                    bestDist = dist;
+                    found = aEdge;
+                }
+
+                return true;
+            } );
+
+    if( found >= 0 )
+        aDist = bestDist;
+
+    return found;
+}
@@ -24,6 +24,7 @@
  */
 
 #include <algorithm>
+#include <cmath>
 #include <math.h>
 #include <vector>
 
@@ -40,50 +41,184 @@
 bool SHAPE_ARC::Collide( const SEG& aSeg, int aClearance ) const
 {
     int minDist = aClearance + m_width / 2;
-    auto centerDist = aSeg.Distance( m_pc );
-    auto p1 = GetP1();
 
-    if( centerDist < minDist )
+    if( !BBox( minDist + 1 ).Intersects( BOX2I( aSeg.A, aSeg.B - aSeg.A ).Normalize() ) )
+        return false;
+
+    double dist = distance( aSeg );
+
+    return dist == 0.0 || dist < minDist;
+}
+
+
+bool SHAPE_ARC::Collide( const SHAPE_ARC& aArc, int aClearance ) const
+{
+    int minDist = aClearance + m_width / 2 + aArc.m_width / 2;
+
+    if( !BBox( minDist + 1 ).Intersects( aArc.BBox() ) )
+        return false;
+
+    double dist = distance( aArc );
+
+    return dist == 0.0 || dist < minDist;
+}
+
+
+SHAPE::ecoord SHAPE_ARC::SquaredDistance( const VECTOR2I& aP ) const
+{
+    double dist = distance( VECTOR2D( aP ) );
+    return (ecoord) std::llround( dist * dist );
+}
+
+
+SHAPE::ecoord SHAPE_ARC::SquaredDistance( const SEG& aSeg ) const
+{
+    double dist = distance( aSeg );
+    return (ecoord) std::llround( dist * dist );
+}
+
+
+SHAPE::ecoord SHAPE_ARC::SquaredDistance( const SHAPE_ARC& aArc ) const
+{
+    double dist = distance( aArc );
+    return (ecoord) std::llround( dist * dist );
+}
+
+
+bool SHAPE_ARC::sweepContains( const VECTOR2D& aDir ) const
+{
+    if( std::abs( m_centralAngle ) >= 360.0 )
         return true;
 
-    auto ab = (aSeg.B - aSeg.A );
-    auto ac = ( m_pc - aSeg.A );
+    double a = std::fmod( 180.0 / M_PI * atan2( aDir.y, aDir.x ) - GetStartAngle(), 360.0 );
+
+    if( m_centralAngle >= 0.0 )
+        return ( a < 0.0 ? a + 360.0 : a ) <= m_centralAngle;
+    else
+        return ( a > 0.0 ? a - 360.0 : a ) >= m_centralAngle;
+}
+
 
-    auto lenAbSq = ab.SquaredEuclideanNorm();
+static double segmentDistance( const VECTOR2D& aA, const VECTOR2D& aB, const VECTOR2D& aP )
+{
+    VECTOR2D ab = aB - aA;
+    double   len2 = ab.x * ab.x + ab.y * ab.y;
+    double   t = 0.0;
 
-    auto lambda = (double) ac.Dot( ab ) / (double) lenAbSq;
+    if( len2 > 0.0 )
+        t = std::max( 0.0, std::min( 1.0, ( ( aP.x - aA.x ) * ab.x + ( aP.y - aA.y ) * ab.y ) / len2 ) );
 
+    return ( aA + ab * t - aP ).EuclideanNorm();
+}
 
-    if( lambda >= 0.0 && lambda <= 1.0 )
-    {
-        VECTOR2I p;
 
-        p.x = (double) aSeg.A.x * lambda + (double) aSeg.B.x * (1.0 - lambda);
-        p.y = (double) aSeg.A.y * lambda + (double) aSeg.B.y * (1.0 - lambda);
+double SHAPE_ARC::distance( const VECTOR2D& aP ) const
+{
+    VECTOR2D c( m_pc );
+    VECTOR2D d = aP - c;
+    double   r = ( VECTOR2D( m_p0 ) - c ).EuclideanNorm();
+
+    if( d.x == 0.0 && d.y == 0.0 )
+        return r;
+
+    if( sweepContains( d ) )
+        return std::abs( d.EuclideanNorm() - r );
+
+    return std::min( ( aP - VECTOR2D( m_p0 ) ).EuclideanNorm(),
+                     ( aP - VECTOR2D( GetP1() ) ).EuclideanNorm() );
+}
+
+
+double SHAPE_ARC::distance( const SEG& aSeg ) const
+{
+    VECTOR2D a( aSeg.A );
+    VECTOR2D b( aSeg.B );
+    VECTOR2D c( m_pc );
+    VECTOR2D ab = b - a;
+    double   r = ( VECTOR2D( m_p0 ) - c ).EuclideanNorm();
+    double   len2 = ab.x * ab.x + ab.y * ab.y;
+
+    // The closest points are either ends of the segment or of the arc, the foot of the normal
+    // from the centre to the segment or an intersection
+    double dist = std::min( distance( a ), distance( b ) );
 
-        auto p0pdist = ( m_p0 - p ).EuclideanNorm();
+    dist = std::min( dist, segmentDistance( a, b, VECTOR2D( m_p0 ) ) );
+    dist = std::min( dist, segmentDistance( a, b, VECTOR2D( GetP1() ) ) );
 
-        if( p0pdist < minDist )
-            return true;
+    if( len2 == 0.0 )
+        return dist;
 
-        auto p1pdist = ( p1 - p ).EuclideanNorm();
+    double   t = ( ( c.x - a.x ) * ab.x + ( c.y - a.y ) * ab.y ) / len2;
+    VECTOR2D normal = a + ab * t - c;
+    double   h2 = normal.x * normal.x + normal.y * normal.y;
 
-        if( p1pdist < minDist )
-            return true;
+    if( h2 <= r * r )
+    {
+        double dt = sqrt( ( r * r - h2 ) / len2 );
+
+        for( double ti : { t - dt, t + dt } )
+        {
+            if( ti >= 0.0 && ti <= 1.0 && sweepContains( a + ab * ti - c ) )
+                return 0.0;
+        }
+    }
+    else if( t > 0.0 && t < 1.0 && sweepContains( normal ) )
+    {
+        dist = std::min( dist, sqrt( h2 ) - r );
     }
 
-    auto p0dist = aSeg.Distance( m_p0 );
+    return dist;
+}
 
-    if( p0dist > minDist )
-        return true;
 
-    auto p1dist = aSeg.Distance( p1 );
+double SHAPE_ARC::distance( const SHAPE_ARC& aArc ) const
+{
+    VECTOR2D c1( m_pc );
+    VECTOR2D c2( aArc.m_pc );
+    double   r1 = ( VECTOR2D( m_p0 ) - c1 ).EuclideanNorm();
+    double   r2 = ( VECTOR2D( aArc.m_p0 ) - c2 ).EuclideanNorm();
 
-    if( p1dist > minDist )
-        return false;
+    // The closest points are either ends of one of the arcs, on the line joining the centres
+    // or an intersection.  For concentric arcs the ends cover all the cases.
+    double dist = std::min( distance( VECTOR2D( aArc.m_p0 ) ),
+                            distance( VECTOR2D( aArc.GetP1() ) ) );
 
+    dist = std::min( dist, aArc.distance( VECTOR2D( m_p0 ) ) );
+    dist = std::min( dist, aArc.distance( VECTOR2D( GetP1() ) ) );
 
-    return true;
+    VECTOR2D d = c2 - c1;
+    double   centreDist = d.EuclideanNorm();
+
+    if( centreDist == 0.0 )
+        return dist;
+
+    VECTOR2D u = d / centreDist;
+
+    if( centreDist <= r1 + r2 && centreDist >= std::abs( r1 - r2 ) )
+    {
+        double   x = ( centreDist * centreDist + r1 * r1 - r2 * r2 ) / ( 2.0 * centreDist );
+        double   y = sqrt( std::max( 0.0, r1 * r1 - x * x ) );
+        VECTOR2D n( -u.y, u.x );
+
+        for( double side : { -y, y } )
+        {
+            VECTOR2D p = c1 + u * x + n * side;
+
+            if( sweepContains( p - c1 ) && aArc.sweepContains( p - c2 ) )
+                return 0.0;
+        }
+    }
+
+    for( double side : { -1.0, 1.0 } )
+    {
+        if( sweepContains( u * side ) )
+            dist = std::min( dist, aArc.distance( c1 + u * ( side * r1 ) ) );
+
+        if( aArc.sweepContains( u * side ) )
+            dist = std::min( dist, distance( c2 + u * ( side * r2 ) ) );
+    }
+
+    return dist;
 }
 
 #if 0
@@ -229,14 +364,13 @@ const BOX2I SHAPE_ARC::BBox( int aClearance ) const
 bool SHAPE_ARC::Collide( const VECTOR2I& aP, int aClearance ) const
 {
     int minDist = aClearance + m_width / 2;
-    auto bbox = BBox( minDist );
 
-    if( !bbox.Contains( aP ) )
+    if( !BBox( minDist + 1 ).Contains( aP ) )
         return false;
 
-    auto dist =  ( aP - GetCenter() ).SquaredEuclideanNorm();
+    double dist = distance( VECTOR2D( aP ) );
 
-    return dist <= ( GetRadius() + minDist ) && dist >= ( GetRadius() - minDist );
+    return dist == 0.0 || dist < minDist;
 }
 
 
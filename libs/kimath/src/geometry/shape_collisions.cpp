@@ -24,6 +24,7 @@
 
 
 #include <assert.h>                               // for assert
+#include <atomic>
 #include <cmath>
 #include <limits.h>                               // for INT_MAX
 #include <stdlib.h>                               // for abs
@@ -305,9 +306,28 @@ static inline bool Collide( const SHAPE_RECT& aA, const SHAPE_RECT& aB, int aCle
     return Collide( aA.Outline(), aB.Outline(), aClearance, aNeedMTV, aMTV );
 }
 
+// Arcs are tested exactly when no MTV is needed; the MTV is computed on their polyline
+// approximation.
+
 static inline bool Collide( const SHAPE_ARC& aA, const SHAPE_RECT& aB, int aClearance,
                             bool aNeedMTV, VECTOR2I& aMTV )
 {
+    if( !aNeedMTV )
+    {
+        if( aB.BBox().Contains( aA.GetP0() ) )
+            return true;
+
+        const SHAPE_LINE_CHAIN outline = aB.Outline();
+
+        for( int i = 0; i < outline.SegmentCount(); i++ )
+        {
+            if( aA.Collide( outline.CSegment( i ), aClearance ) )
+                return true;
+        }
+
+        return false;
+    }
+
     const auto lc = aA.ConvertToPolyline();
     return Collide( lc, aB.Outline(), aClearance, aNeedMTV, aMTV );
 }
@@ -315,6 +335,9 @@ static inline bool Collide( const SHAPE_ARC& aA, const SHAPE_RECT& aB, int aClea
 static inline bool Collide( const SHAPE_ARC& aA, const SHAPE_CIRCLE& aB, int aClearance,
                             bool aNeedMTV, VECTOR2I& aMTV )
 {
+    if( !aNeedMTV )
+        return aA.Collide( aB.GetCenter(), aClearance + aB.GetRadius() );
+
     const auto lc = aA.ConvertToPolyline();
     bool rv = Collide( aB, lc, aClearance, aNeedMTV, aMTV );
 
@@ -327,6 +350,31 @@ static inline bool Collide( const SHAPE_ARC& aA, const SHAPE_CIRCLE& aB, int aCl
 static inline bool Collide( const SHAPE_ARC& aA, const SHAPE_LINE_CHAIN& aB, int aClearance,
                             bool aNeedMTV, VECTOR2I& aMTV )
 {
+    if( !aNeedMTV )
+    {
+        // The chain has no width, only the arc has
+        for( int i = 0; i < aB.SegmentCount(); i++ )
+        {
+            ssize_t arc = aB.ArcIndex( i );
+
+            // The closing segment of a closed chain is a plain segment
+            if( arc >= 0 && i + 1 < aB.PointCount() && aB.ArcIndex( i + 1 ) == arc )
+            {
+                SHAPE_ARC chainArc( aB.Arc( arc ) );
+                chainArc.SetWidth( 0 );
+
+                if( aA.Collide( chainArc, aClearance ) )
+                    return true;
+            }
+            else if( aA.Collide( aB.CSegment( i ), aClearance ) )
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
     const auto lc = aA.ConvertToPolyline();
     return Collide( lc, aB, aClearance, aNeedMTV, aMTV );
 }
@@ -334,6 +382,9 @@ static inline bool Collide( const SHAPE_ARC& aA, const SHAPE_LINE_CHAIN& aB, int
 static inline bool Collide( const SHAPE_ARC& aA, const SHAPE_SEGMENT& aB, int aClearance,
                             bool aNeedMTV, VECTOR2I& aMTV )
 {
+    if( !aNeedMTV )
+        return aA.Collide( aB.GetSeg(), aClearance + aB.GetWidth() / 2 );
+
     const auto lc = aA.ConvertToPolyline();
     return Collide( lc, aB, aClearance, aNeedMTV, aMTV );
 }
@@ -341,6 +392,9 @@ static inline bool Collide( const SHAPE_ARC& aA, const SHAPE_SEGMENT& aB, int aC
 static inline bool Collide( const SHAPE_ARC& aA, const SHAPE_SIMPLE& aB, int aClearance,
                             bool aNeedMTV, VECTOR2I& aMTV )
 {
+    if( !aNeedMTV )
+        return Collide( aA, aB.Vertices(), aClearance, aNeedMTV, aMTV );
+
     const auto lc = aA.ConvertToPolyline();
     return Collide( lc, aB.Vertices(), aClearance, aNeedMTV, aMTV );
 }
@@ -348,6 +402,9 @@ static inline bool Collide( const SHAPE_ARC& aA, const SHAPE_SIMPLE& aB, int aCl
 static inline bool Collide( const SHAPE_ARC& aA, const SHAPE_ARC& aB, int aClearance,
                             bool aNeedMTV, VECTOR2I& aMTV )
 {
+    if( !aNeedMTV )
+        return aA.Collide( aB, aClearance );
+
     const auto lcA = aA.ConvertToPolyline();
     const auto lcB = aB.ConvertToPolyline();
     return Collide( lcA, lcB, aClearance, aNeedMTV, aMTV );
@@ -373,8 +430,71 @@ inline bool CollCaseReversed ( const SHAPE* aA, const SHAPE* aB, int aClearance,
 }
 
 
+static std::atomic<bool> s_collisionStatsEnabled( false );
+static std::atomic<uint64_t> s_collisionStats[SHAPE_COLLISION_STATS::TYPE_COUNT]
+                                             [SHAPE_COLLISION_STATS::TYPE_COUNT];
+
+
+void SHAPE_COLLISION_STATS::Enable( bool aEnable )
+{
+    s_collisionStatsEnabled.store( aEnable, std::memory_order_relaxed );
+}
+
+
+bool SHAPE_COLLISION_STATS::IsEnabled()
+{
+    return s_collisionStatsEnabled.load( std::memory_order_relaxed );
+}
+
+
+void SHAPE_COLLISION_STATS::Reset()
+{
+    for( int a = 0; a < TYPE_COUNT; a++ )
+    {
+        for( int b = 0; b < TYPE_COUNT; b++ )
+            s_collisionStats[a][b].store( 0, std::memory_order_relaxed );
+    }
+}
+
+
+uint64_t SHAPE_COLLISION_STATS::Count( SHAPE_TYPE aA, SHAPE_TYPE aB )
+{
+    if( aA < 0 || aA >= TYPE_COUNT || aB < 0 || aB >= TYPE_COUNT )
+        return 0;
+
+    return s_collisionStats[aA][aB].load( std::memory_order_relaxed );
+}
+
+
+const char* SHAPE_COLLISION_STATS::TypeName( SHAPE_TYPE aType )
+{
+    switch( aType )
+    {
+    case SH_RECT:       return "rect";
+    case SH_SEGMENT:    return "segment";
+    case SH_LINE_CHAIN: return "line_chain";
+    case SH_CIRCLE:     return "circle";
+    case SH_SIMPLE:     return "simple";
+    case SH_POLY_SET:   return "poly_set";
+    case SH_COMPOUND:   return "compound";
+    case SH_ARC:        return "arc";
+    default:            return "unknown";
+    }
+}
+
+
 bool CollideShapes( const SHAPE* aA, const SHAPE* aB, int aClearance, bool aNeedMTV, VECTOR2I& aMTV )
 {
+    if( s_collisionStatsEnabled.load( std::memory_order_relaxed ) )
+    {
+        int a = aA->Type();
+        int b = aB->Type();
+
+        if( a >= 0 && a < SHAPE_COLLISION_STATS::TYPE_COUNT
+                && b >= 0 && b < SHAPE_COLLISION_STATS::TYPE_COUNT )
+            s_collisionStats[a][b].fetch_add( 1, std::memory_order_relaxed );
+    }
+
     switch( aA->Type() )
     {
         case SH_RECT:
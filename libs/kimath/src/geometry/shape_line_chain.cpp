@@ -85,6 +85,40 @@ void SHAPE_LINE_CHAIN::convertArc( ssize_t aArcIndex )
 }
 
 
+/**
+ * Visits the edges of aChain, stopping as soon as a visitor returns true.  Runs of segments
+ * approximating an arc are passed once to aArcVisitor as the true SHAPE_ARC, the other
+ * segments to aSegVisitor.
+ */
+template <typename SEG_VISITOR, typename ARC_VISITOR>
+static bool visitEdges( const SHAPE_LINE_CHAIN& aChain, SEG_VISITOR aSegVisitor,
+                        ARC_VISITOR aArcVisitor )
+{
+    ssize_t lastArc = -1;
+
+    for( int i = 0; i < aChain.SegmentCount(); i++ )
+    {
+        ssize_t arc = aChain.ArcIndex( i );
+
+        // The closing segment of a closed chain is never part of an arc, even when the first
+        // and last points belong to the same one
+        if( arc >= 0 && i + 1 < aChain.PointCount() && aChain.ArcIndex( i + 1 ) == arc )
+        {
+            if( arc != lastArc && aArcVisitor( aChain.Arc( arc ) ) )
+                return true;
+
+            lastArc = arc;
+            continue;
+        }
+
+        if( aSegVisitor( aChain.CSegment( i ) ) )
+            return true;
+    }
+
+    return false;
+}
+
+
 bool SHAPE_LINE_CHAIN::Collide( const VECTOR2I& aP, int aClearance ) const
 {
     // fixme: ugly!
@@ -112,21 +146,21 @@ bool SHAPE_LINE_CHAIN::Collide( const SEG& aSeg, int aClearance ) const
     BOX2I box_a( aSeg.A, aSeg.B - aSeg.A );
     BOX2I::ecoord_type dist_sq = (BOX2I::ecoord_type) aClearance * aClearance;
 
-    for( int i = 0; i < SegmentCount(); i++ )
-    {
-        const SEG& s = CSegment( i );
-        BOX2I box_b( s.A, s.B - s.A );
-
-        BOX2I::ecoord_type d = box_a.SquaredDistance( box_b );
+    return visitEdges( *this,
+            [&]( const SEG& s )
+            {
+                BOX2I box_b( s.A, s.B - s.A );
 
-        if( d < dist_sq )
-        {
-            if( s.Collide( aSeg, aClearance ) )
-                return true;
-        }
-    }
+                BOX2I::ecoord_type d = box_a.SquaredDistance( box_b );
 
-    return false;
+                return d < dist_sq && s.Collide( aSeg, aClearance );
+            },
+            [&]( const SHAPE_ARC& aArc )
+            {
+                // Arcs in a chain have no width of their own
+                ecoord d = aArc.SquaredDistance( aSeg );
+                return d == 0 || d < dist_sq;
+            } );
 }
 
 
@@ -272,8 +306,17 @@ int SHAPE_LINE_CHAIN::Distance( const VECTOR2I& aP, bool aOutlineOnly ) const
     if( IsClosed() && PointInside( aP ) && !aOutlineOnly )
         return 0;
 
-    for( int s = 0; s < SegmentCount(); s++ )
-        d = std::min( d, CSegment( s ).Distance( aP ) );
+    visitEdges( *this,
+            [&]( const SEG& aSeg )
+            {
+                d = std::min( d, aSeg.Distance( aP ) );
+                return false;
+            },
+            [&]( const SHAPE_ARC& aArc )
+            {
+                d = std::min( d, KiROUND( sqrt( (double) aArc.SquaredDistance( aP ) ) ) );
+                return false;
+            } );
 
     return d;
 }
@@ -30,16 +30,21 @@
 #include <assert.h>                          // for assert
 #include <cmath>                             // for sqrt, cos, hypot, isinf
 #include <cstdio>
+#include <functional>
+#include <future>
 #include <istream>                           // for operator<<, operator>>
 #include <limits>                            // for numeric_limits
 #include <memory>
 #include <set>
 #include <string>                            // for char_traits, operator!=
+#include <thread>
 #include <type_traits>                       // for swap, move
 #include <unordered_set>
 #include <vector>
 
 #include <clipper.hpp>                       // for Clipper, PolyNode, Clipp...
+#include <fast_hash.h>
+#include <geometry/contour_soa.h>
 #include <geometry/geometry_utils.h>
 #include <geometry/polygon_triangulation.h>
 #include <geometry/seg.h>                    // for SEG, OPT_VECTOR2I
@@ -49,11 +54,40 @@
 #include <math/box2.h>                       // for BOX2I
 #include <math/util.h>                       // for KiROUND, rescale
 #include <math/vector2d.h>                   // for VECTOR2I, VECTOR2D, VECTOR2
-#include <md5_hash.h>
 
 
 using namespace ClipperLib;
 
+
+/**
+ * Runs aFunc( 0 ) .. aFunc( aCount - 1 ) on up to aThreads threads, the calling one included.
+ * With a single thread no thread is started.
+ */
+static void parallelFor( size_t aCount, unsigned aThreads,
+                         const std::function<void( size_t )>& aFunc )
+{
+    size_t threads = std::min<size_t>( aCount, std::max( aThreads, 1u ) );
+    std::atomic<size_t> next( 0 );
+
+    auto worker =
+            [&]()
+            {
+                for( size_t i = next++; i < aCount; i = next++ )
+                    aFunc( i );
+            };
+
+    std::vector<std::future<void>> returns;
+
+    for( size_t ii = 1; ii < threads; ++ii )
+        returns.emplace_back( std::async( std::launch::async, worker ) );
+
+    worker();
+
+    for( std::future<void>& ret : returns )
+        ret.get();
+}
+
+
 SHAPE_POLY_SET::SHAPE_POLY_SET() :
     SHAPE( SH_POLY_SET )
 {
@@ -68,15 +102,21 @@ SHAPE_POLY_SET::SHAPE_POLY_SET( const SHAPE_LINE_CHAIN& aOutline ) :
 
 
 SHAPE_POLY_SET::SHAPE_POLY_SET( const SHAPE_POLY_SET& aOther, bool aDeepCopy ) :
-    SHAPE( SH_POLY_SET ), m_polys( aOther.m_polys )
+    SHAPE( SH_POLY_SET ), m_polys( aOther.m_polys ),
+    m_edgeIndexEnabled( aOther.m_edgeIndexEnabled )
 {
+    // The edge index holds its own copy of the points: it can be shared with the copy
+    m_edgeIndex = std::atomic_load( &aOther.m_edgeIndex );
+    m_edgeIndexBuilt = m_edgeIndex != nullptr;
+
+    // Triangulations are never modified once built: they can be shared with the copy too
+    m_triangulationCache = aOther.m_triangulationCache;
+
     if( aOther.IsTriangulationUpToDate() )
     {
-        for( unsigned i = 0; i < aOther.TriangulatedPolyCount(); i++ )
-            m_triangulatedPolys.push_back(
-                    std::make_unique<TRIANGULATED_POLYGON>( *aOther.TriangulatedPolygon( i ) ) );
-
+        m_triangulatedPolys = aOther.m_triangulatedPolys;
         m_hash = aOther.GetHash();
+        m_hashValid = true;
         m_triangulationValid = true;
     }
 }
@@ -178,6 +218,8 @@ bool SHAPE_POLY_SET::GetGlobalIndex( SHAPE_POLY_SET::VERTEX_INDEX aRelativeIndic
 
 int SHAPE_POLY_SET::NewOutline()
 {
+    InvalidateEdgeIndex();
+
     SHAPE_LINE_CHAIN empty_path;
     POLYGON poly;
 
@@ -190,6 +232,8 @@ int SHAPE_POLY_SET::NewOutline()
 
 int SHAPE_POLY_SET::NewHole( int aOutline )
 {
+    InvalidateEdgeIndex();
+
     SHAPE_LINE_CHAIN empty_path;
 
     empty_path.SetClosed( true );
@@ -207,6 +251,8 @@ int SHAPE_POLY_SET::NewHole( int aOutline )
 
 int SHAPE_POLY_SET::Append( int x, int y, int aOutline, int aHole, bool aAllowDuplication )
 {
+    InvalidateEdgeIndex();
+
     assert( m_polys.size() );
 
     if( aOutline < 0 )
@@ -230,6 +276,8 @@ int SHAPE_POLY_SET::Append( int x, int y, int aOutline, int aHole, bool aAllowDu
 
 void SHAPE_POLY_SET::InsertVertex( int aGlobalIndex, VECTOR2I aNewVertex )
 {
+    InvalidateEdgeIndex();
+
     VERTEX_INDEX index;
 
     if( aGlobalIndex < 0 )
@@ -415,6 +463,8 @@ bool SHAPE_POLY_SET::IsSelfIntersecting() const
 
 int SHAPE_POLY_SET::AddOutline( const SHAPE_LINE_CHAIN& aOutline )
 {
+    InvalidateEdgeIndex();
+
     assert( aOutline.IsClosed() );
 
     POLYGON poly;
@@ -429,6 +479,8 @@ int SHAPE_POLY_SET::AddOutline( const SHAPE_LINE_CHAIN& aOutline )
 
 int SHAPE_POLY_SET::AddHole( const SHAPE_LINE_CHAIN& aHole, int aOutline )
 {
+    InvalidateEdgeIndex();
+
     assert( m_polys.size() );
 
     if( aOutline < 0 )
@@ -449,6 +501,8 @@ int SHAPE_POLY_SET::AddHole( const SHAPE_LINE_CHAIN& aHole, int aOutline )
 void SHAPE_POLY_SET::booleanOp( ClipperLib::ClipType aType, const SHAPE_POLY_SET& aOtherShape,
         POLYGON_MODE aFastMode )
 {
+    InvalidateEdgeIndex();
+
     booleanOp( aType, *this, aOtherShape, aFastMode );
 }
 
@@ -458,6 +512,8 @@ void SHAPE_POLY_SET::booleanOp( ClipperLib::ClipType aType,
         const SHAPE_POLY_SET& aOtherShape,
         POLYGON_MODE aFastMode )
 {
+    InvalidateEdgeIndex();
+
     Clipper c;
 
     c.StrictlySimple( aFastMode == PM_STRICTLY_SIMPLE );
@@ -534,14 +590,108 @@ void SHAPE_POLY_SET::InflateWithLinkedHoles( int aFactor, int aCircleSegmentsCou
 
 
 void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
-                              CORNER_STRATEGY aCornerStrategy )
+                              CORNER_STRATEGY aCornerStrategy, unsigned aThreads )
 {
+    // Sets with more polygons than this are offset by groups of this size
+    const size_t CHUNK_SIZE = 128;
+
+    InvalidateEdgeIndex();
+
     // A static table to avoid repetitive calculations of the coefficient
     // 1.0 - cos( M_PI / aCircleSegmentsCount )
     // aCircleSegmentsCount is most of time <= 64 and usually 8, 12, 16, 32
     #define SEG_CNT_MAX 64
     static double arc_tolerance_factor[SEG_CNT_MAX + 1];
 
+    // Calculate the arc tolerance (arc error) from the seg count by circle. The seg count is
+    // nn = M_PI / acos(1.0 - c.ArcTolerance / abs(aAmount))
+    // http://www.angusj.com/delphi/clipper/documentation/Docs/Units/ClipperLib/Classes/ClipperOffset/Properties/ArcTolerance.htm
+
+    if( aCircleSegmentsCount < 6 ) // avoid incorrect aCircleSegmentsCount values
+        aCircleSegmentsCount = 6;
+
+    double coeff;
+
+    if( aCircleSegmentsCount > SEG_CNT_MAX || arc_tolerance_factor[aCircleSegmentsCount] == 0 )
+    {
+        coeff = 1.0 - cos( M_PI / aCircleSegmentsCount );
+
+        if( aCircleSegmentsCount <= SEG_CNT_MAX )
+            arc_tolerance_factor[aCircleSegmentsCount] = coeff;
+    }
+    else
+        coeff = arc_tolerance_factor[aCircleSegmentsCount];
+
+    double arcTolerance = std::abs( aAmount ) * coeff;
+
+    // The offset of a polygon stays within its bounding box inflated by the miter limit
+    // (Clipper's MiterLimit is a multiple of the offset)
+    int reach = aAmount > 0 ? aAmount * ( aCornerStrategy == ALLOW_ACUTE_CORNERS ? 10 : 2 ) : 0;
+
+    std::vector<SHAPE_POLY_SET> groups;
+
+    if( m_polys.size() > 2 * CHUNK_SIZE )
+        groups = splitIndependent( reach + 1, CHUNK_SIZE );
+
+    if( groups.size() < 2 )
+    {
+        if( !groups.empty() )
+            m_polys.swap( groups[0].m_polys );
+
+        offsetPolygons( aAmount, arcTolerance, aCornerStrategy );
+        return;
+    }
+
+    // ClipperOffset offsets each contour then merges them all, so groups of polygons which
+    // are too far apart to merge can be offset separately, possibly in parallel
+    parallelFor( groups.size(), aThreads,
+                 [&]( size_t aGroup )
+                 {
+                     groups[aGroup].offsetPolygons( aAmount, arcTolerance, aCornerStrategy );
+                 } );
+
+    for( SHAPE_POLY_SET& group : groups )
+    {
+        for( POLYGON& poly : group.m_polys )
+            m_polys.push_back( std::move( poly ) );
+    }
+}
+
+
+void SHAPE_POLY_SET::Inflate( int aAmount, CORNER_STRATEGY aCornerStrategy, int aMaxError,
+                              unsigned aThreads )
+{
+    // Clipper puts the vertices of the rounded corners on the exact offset, so the chords are
+    // inside it.  It also rounds the step count of each corner to nearest with a fixed step
+    // angle of 2 * M_PI / segCount, so the last chord of a corner can span up to 1.5 steps.
+    // Offsetting by 1 / cos( 1.5 * M_PI / segCount ) times more moves the longest chords onto
+    // the exact offset, and the straight edges out by as much: segCount is the smallest count
+    // keeping that within aMaxError.
+    const double LONGEST_CHORD_STEPS = 1.5;
+
+    double amount = std::abs( aAmount );
+    double maxError = std::max( aMaxError, 1 );
+    int    segCount = 6;
+
+    if( amount > 0 )
+    {
+        double maxHalfChord = acos( amount / ( amount + maxError ) );
+
+        segCount = std::max( segCount,
+                             (int) std::ceil( LONGEST_CHORD_STEPS * M_PI / maxHalfChord ) );
+    }
+
+    double correction = 1.0 / cos( LONGEST_CHORD_STEPS * M_PI / segCount );
+
+    Inflate( KiROUND( aAmount * correction ), segCount, aCornerStrategy, aThreads );
+}
+
+
+void SHAPE_POLY_SET::offsetPolygons( int aAmount, double aArcTolerance,
+                                     CORNER_STRATEGY aCornerStrategy )
+{
+    InvalidateEdgeIndex();
+
     ClipperOffset c;
 
     // N.B. see the Clipper documentation for jtSquare/jtMiter/jtRound.  They are poorly named
@@ -588,36 +738,100 @@ void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
 
     PolyTree solution;
 
-    // Calculate the arc tolerance (arc error) from the seg count by circle. The seg count is
-    // nn = M_PI / acos(1.0 - c.ArcTolerance / abs(aAmount))
-    // http://www.angusj.com/delphi/clipper/documentation/Docs/Units/ClipperLib/Classes/ClipperOffset/Properties/ArcTolerance.htm
+    c.ArcTolerance = aArcTolerance;
+    c.MiterLimit = miterLimit;
+    c.MiterFallback = miterFallback;
+    c.Execute( solution, aAmount );
 
-    if( aCircleSegmentsCount < 6 ) // avoid incorrect aCircleSegmentsCount values
-        aCircleSegmentsCount = 6;
+    importTree( &solution );
+}
 
-    double coeff;
 
-    if( aCircleSegmentsCount > SEG_CNT_MAX || arc_tolerance_factor[aCircleSegmentsCount] == 0 )
+std::vector<SHAPE_POLY_SET> SHAPE_POLY_SET::splitIndependent( int aMargin, size_t aGroupSize )
+{
+    const size_t count = m_polys.size();
+
+    std::vector<BOX2I>  bboxes( count );
+    std::vector<size_t> order( count );
+    std::vector<size_t> parent( count );
+
+    for( size_t i = 0; i < count; i++ )
     {
-        coeff = 1.0 - cos( M_PI / aCircleSegmentsCount );
+        bboxes[i] = m_polys[i].empty() ? BOX2I() : m_polys[i][0].BBox( aMargin );
+        order[i] = i;
+        parent[i] = i;
+    }
 
-        if( aCircleSegmentsCount <= SEG_CNT_MAX )
-            arc_tolerance_factor[aCircleSegmentsCount] = coeff;
+    // Union-find of the polygons whose inflated bounding boxes overlap
+    auto find =
+            [&]( size_t aIdx )
+            {
+                while( parent[aIdx] != aIdx )
+                    aIdx = parent[aIdx] = parent[parent[aIdx]];
+
+                return aIdx;
+            };
+
+    std::sort( order.begin(), order.end(),
+               [&]( size_t a, size_t b )
+               {
+                   return bboxes[a].GetLeft() < bboxes[b].GetLeft();
+               } );
+
+    // Sweep along X, keeping the boxes which may still overlap the next ones
+    std::vector<size_t> active;
+
+    for( size_t i : order )
+    {
+        const BOX2I& bbox = bboxes[i];
+
+        active.erase( std::remove_if( active.begin(), active.end(),
+                                      [&]( size_t j )
+                                      {
+                                          return bboxes[j].GetRight() < bbox.GetLeft();
+                                      } ),
+                      active.end() );
+
+        for( size_t j : active )
+        {
+            if( bboxes[j].GetTop() <= bbox.GetBottom() && bbox.GetTop() <= bboxes[j].GetBottom() )
+                parent[find( i )] = find( j );
+        }
+
+        active.push_back( i );
     }
-    else
-        coeff = arc_tolerance_factor[aCircleSegmentsCount];
 
-    c.ArcTolerance = std::abs( aAmount ) * coeff;
-    c.MiterLimit = miterLimit;
-    c.MiterFallback = miterFallback;
-    c.Execute( solution, aAmount );
+    // Fill the groups with whole clusters, in the sweep order so they stay compact
+    std::vector<std::vector<size_t>> clusters( count );
 
-    importTree( &solution );
+    for( size_t i : order )
+        clusters[find( i )].push_back( i );
+
+    std::vector<SHAPE_POLY_SET> groups( 1 );
+
+    for( size_t i : order )
+    {
+        if( clusters[i].empty() )
+            continue;
+
+        if( groups.back().m_polys.size() >= aGroupSize )
+            groups.emplace_back();
+
+        for( size_t j : clusters[i] )
+            groups.back().m_polys.push_back( std::move( m_polys[j] ) );
+    }
+
+    InvalidateEdgeIndex();
+    m_polys.clear();
+
+    return groups;
 }
 
 
 void SHAPE_POLY_SET::importTree( PolyTree* tree )
 {
+    InvalidateEdgeIndex();
+
     m_polys.clear();
 
     for( PolyNode* n = tree->GetFirst(); n; n = n->GetNext() )
@@ -639,13 +853,6 @@ void SHAPE_POLY_SET::importTree( PolyTree* tree )
 
 struct FractureEdge
 {
-    FractureEdge( int y = 0 ) :
-        m_connected( false ),
-        m_next( NULL )
-    {
-        m_p1.x = m_p2.y = y;
-    }
-
     FractureEdge( bool connected, const VECTOR2I& p1, const VECTOR2I& p2 ) :
         m_connected( connected ),
         m_p1( p1 ),
@@ -665,59 +872,139 @@ struct FractureEdge
 };
 
 
-typedef std::vector<FractureEdge*> FractureEdgeSet;
+/**
+ * Edges of a polygon being fractured, with a bucketing of the connected edges in horizontal
+ * slabs so the edge a hole bridges to can be found without scanning all edges.
+ *
+ * The edges live in a single pool sized up front (so the m_next pointers stay valid), in
+ * creation order.  An edge is listed in every slab its Y extent overlaps at the time it
+ * becomes connected.  Edges are only ever shortened afterwards, so the slab of a given Y
+ * always lists (at least) all the connected edges crossing it.
+ */
+class FRACTURE_EDGES
+{
+public:
+    FRACTURE_EDGES( const SHAPE_POLY_SET::POLYGON& aPaths )
+    {
+        size_t count = 0;
 
+        for( const SHAPE_LINE_CHAIN& path : aPaths )
+            count += path.PointCount();
 
-static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
-{
-    int x   = edge->m_p1.x;
-    int y   = edge->m_p1.y;
-    int min_dist    = std::numeric_limits<int>::max();
-    int x_nearest   = 0;
+        // Each hole adds 3 edges when bridged to the outline
+        m_pool.reserve( count + 3 * ( aPaths.size() - 1 ) );
 
-    FractureEdge* e_nearest = NULL;
+        const BOX2I bbox = aPaths[0].BBox();
 
-    for( FractureEdgeSet::iterator i = edges.begin(); i != edges.end(); ++i )
+        m_yMin = bbox.GetY();
+        m_height = std::max<int64_t>( bbox.GetHeight(), 1 );
+        m_slabs.resize( Clamp<size_t>( 1, count / EDGES_PER_SLAB, MAX_SLABS ) );
+    }
+
+    FractureEdge* Add( bool aConnected, const VECTOR2I& aP1, const VECTOR2I& aP2 )
     {
-        if( !(*i)->matches( y ) )
-            continue;
+        m_pool.emplace_back( aConnected, aP1, aP2 );
 
-        int x_intersect;
+        FractureEdge* edge = &m_pool.back();
 
-        if( (*i)->m_p1.y == (*i)->m_p2.y ) // horizontal edge
-            x_intersect = std::max( (*i)->m_p1.x, (*i)->m_p2.x );
-        else
-            x_intersect = (*i)->m_p1.x + rescale( (*i)->m_p2.x - (*i)->m_p1.x, y - (*i)->m_p1.y,
-                    (*i)->m_p2.y - (*i)->m_p1.y );
+        if( aConnected )
+            Connect( edge );
+
+        return edge;
+    }
+
+    void Connect( FractureEdge* aEdge )
+    {
+        aEdge->m_connected = true;
 
-        int dist = ( x - x_intersect );
+        int index = aEdge - m_pool.data();
+        int first = slab( std::min( aEdge->m_p1.y, aEdge->m_p2.y ) );
+        int last = slab( std::max( aEdge->m_p1.y, aEdge->m_p2.y ) );
 
-        if( dist >= 0 && dist < min_dist && (*i)->m_connected )
+        for( int i = first; i <= last; i++ )
+            m_slabs[i].push_back( index );
+    }
+
+    /**
+     * Finds the connected edge crossing the horizontal line at aY closest to the left of aX
+     * (ties go to the edge created first).  Returns NULL if there is none.
+     */
+    FractureEdge* Nearest( int aX, int aY, int& aIntersectX )
+    {
+        int min_dist = std::numeric_limits<int>::max();
+        int nearest = -1;
+
+        for( int index : m_slabs[slab( aY )] )
         {
-            min_dist    = dist;
-            x_nearest   = x_intersect;
-            e_nearest   = (*i);
+            const FractureEdge& e = m_pool[index];
+
+            if( !e.matches( aY ) )
+                continue;
+
+            int x_intersect;
+
+            if( e.m_p1.y == e.m_p2.y ) // horizontal edge
+                x_intersect = std::max( e.m_p1.x, e.m_p2.x );
+            else
+                x_intersect = e.m_p1.x + rescale( e.m_p2.x - e.m_p1.x, aY - e.m_p1.y,
+                                                  e.m_p2.y - e.m_p1.y );
+
+            int dist = ( aX - x_intersect );
+
+            if( dist >= 0 && ( dist < min_dist || ( dist == min_dist && index < nearest ) ) )
+            {
+                min_dist = dist;
+                nearest = index;
+                aIntersectX = x_intersect;
+            }
         }
+
+        return nearest < 0 ? NULL : &m_pool[nearest];
+    }
+
+    FractureEdge* Root() { return m_pool.empty() ? NULL : &m_pool[0]; }
+
+private:
+    static const size_t EDGES_PER_SLAB = 8;
+    static const size_t MAX_SLABS = 16384;
+
+    int slab( int aY ) const
+    {
+        int64_t i = ( (int64_t) aY - m_yMin ) * (int64_t) m_slabs.size() / m_height;
+
+        return (int) Clamp<int64_t>( 0, i, m_slabs.size() - 1 );
     }
 
-    if( e_nearest && e_nearest->m_connected )
+    std::vector<FractureEdge>     m_pool;
+    std::vector<std::vector<int>> m_slabs;
+    int                           m_yMin;
+    int64_t                       m_height;
+};
+
+
+static int processEdge( FRACTURE_EDGES& edges, FractureEdge* edge )
+{
+    int x   = edge->m_p1.x;
+    int y   = edge->m_p1.y;
+    int x_nearest   = 0;
+
+    FractureEdge* e_nearest = edges.Nearest( x, y, x_nearest );
+
+    if( e_nearest )
     {
         int count = 0;
 
-        FractureEdge* lead1 =
-            new FractureEdge( true, VECTOR2I( x_nearest, y ), VECTOR2I( x, y ) );
-        FractureEdge* lead2 =
-            new FractureEdge( true, VECTOR2I( x, y ), VECTOR2I( x_nearest, y ) );
-        FractureEdge* split_2 =
-            new FractureEdge( true, VECTOR2I( x_nearest, y ), e_nearest->m_p2 );
+        VECTOR2I p2 = e_nearest->m_p2;
+
+        // The bridged edge only gets shorter, so it doesn't need to be re-bucketed
+        e_nearest->m_p2 = VECTOR2I( x_nearest, y );
 
-        edges.push_back( split_2 );
-        edges.push_back( lead1 );
-        edges.push_back( lead2 );
+        FractureEdge* split_2 = edges.Add( true, VECTOR2I( x_nearest, y ), p2 );
+        FractureEdge* lead1 = edges.Add( true, VECTOR2I( x_nearest, y ), VECTOR2I( x, y ) );
+        FractureEdge* lead2 = edges.Add( true, VECTOR2I( x, y ), VECTOR2I( x_nearest, y ) );
 
         FractureEdge* link = e_nearest->m_next;
 
-        e_nearest->m_p2 = VECTOR2I( x_nearest, y );
         e_nearest->m_next = lead1;
         lead1->m_next = edge;
 
@@ -725,11 +1012,11 @@ static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
 
         for( last = edge; last->m_next != edge; last = last->m_next )
         {
-            last->m_connected = true;
+            edges.Connect( last );
             count++;
         }
 
-        last->m_connected = true;
+        edges.Connect( last );
         last->m_next    = lead2;
         lead2->m_next   = split_2;
         split_2->m_next = link;
@@ -743,15 +1030,13 @@ static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
 
 void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 {
-    FractureEdgeSet edges;
-    FractureEdgeSet border_edges;
-    FractureEdge*   root = NULL;
-
-    bool first = true;
-
     if( paths.size() == 1 )
         return;
 
+    FRACTURE_EDGES             edges( paths );
+    std::vector<FractureEdge*> border_edges;
+
+    bool first = true;
     int num_unconnected = 0;
 
     for( const SHAPE_LINE_CHAIN& path : paths )
@@ -773,11 +1058,8 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
         {
             // Do not use path.CPoint() here; open-coding it using the local variables "points"
             // and "pointCount" gives a non-trivial performance boost to zone fill times.
-            FractureEdge* fe = new FractureEdge( first, points[ i ],
-                                                        points[ i+1 == pointCount ? 0 : i+1 ] );
-
-            if( !root )
-                root = fe;
+            FractureEdge* fe = edges.Add( first, points[ i ],
+                                          points[ i+1 == pointCount ? 0 : i+1 ] );
 
             if( !first_edge )
                 first_edge = fe;
@@ -789,7 +1071,6 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
                 fe->m_next = first_edge;
 
             prev = fe;
-            edges.push_back( fe );
 
             if( !first )
             {
@@ -804,26 +1085,31 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
         first = false;    // first path is always the outline
     }
 
+    // Holes are connected to the main outline left-most first: that's the order of their
+    // border edges, ties going to the first one
+    std::stable_sort( border_edges.begin(), border_edges.end(),
+                      []( const FractureEdge* aA, const FractureEdge* aB )
+                      {
+                          return aA->m_p1.x < aB->m_p1.x;
+                      } );
+
     // keep connecting holes to the main outline, until there's no holes left...
-    while( num_unconnected > 0 )
+    for( FractureEdge* border_edge : border_edges )
     {
-        int x_min = std::numeric_limits<int>::max();
+        if( num_unconnected <= 0 )
+            break;
 
-        FractureEdge* smallestX = NULL;
+        if( border_edge->m_connected )
+            continue;
 
-        // find the left-most hole edge and merge with the outline
-        for( FractureEdge* border_edge : border_edges )
-        {
-            int xt = border_edge->m_p1.x;
+        int connected = processEdge( edges, border_edge );
 
-            if( ( xt < x_min ) && !border_edge->m_connected )
-            {
-                x_min = xt;
-                smallestX = border_edge;
-            }
-        }
+        // A hole with nothing to its left (it would have to be outside the outline) can't be
+        // connected
+        if( connected == 0 )
+            break;
 
-        num_unconnected -= processEdge( edges, smallestX );
+        num_unconnected -= connected;
     }
 
     paths.clear();
@@ -831,6 +1117,7 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 
     newPath.SetClosed( true );
 
+    FractureEdge* root = edges.Root();
     FractureEdge* e;
 
     for( e = root; e->m_next != root; e = e->m_next )
@@ -838,15 +1125,14 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 
     newPath.Append( e->m_p1 );
 
-    for( FractureEdge* edge : edges )
-        delete edge;
-
     paths.push_back( std::move( newPath ) );
 }
 
 
 void SHAPE_POLY_SET::Fracture( POLYGON_MODE aFastMode )
 {
+    InvalidateEdgeIndex();
+
     Simplify( aFastMode );    // remove overlapping holes/degeneracy
 
     for( POLYGON& paths : m_polys )
@@ -1034,6 +1320,8 @@ bool SHAPE_POLY_SET::HasHoles() const
 
 void SHAPE_POLY_SET::Unfracture( POLYGON_MODE aFastMode )
 {
+    InvalidateEdgeIndex();
+
     for( POLYGON& path : m_polys )
     {
         unfractureSingle( path );
@@ -1045,14 +1333,103 @@ void SHAPE_POLY_SET::Unfracture( POLYGON_MODE aFastMode )
 
 void SHAPE_POLY_SET::Simplify( POLYGON_MODE aFastMode )
 {
+    InvalidateEdgeIndex();
+
     SHAPE_POLY_SET empty;
 
     booleanOp( ctUnion, empty, aFastMode );
 }
 
 
+///> Interleaves the bits of the low 16 bits of aX and aY (Z-order curve)
+static uint32_t mortonCode( uint32_t aX, uint32_t aY )
+{
+    auto spread =
+            []( uint32_t v )
+            {
+                v &= 0xFFFF;
+                v = ( v | ( v << 8 ) ) & 0x00FF00FF;
+                v = ( v | ( v << 4 ) ) & 0x0F0F0F0F;
+                v = ( v | ( v << 2 ) ) & 0x33333333;
+                v = ( v | ( v << 1 ) ) & 0x55555555;
+                return v;
+            };
+
+    return spread( aX ) | ( spread( aY ) << 1 );
+}
+
+
+void SHAPE_POLY_SET::UnionAll( POLYGON_MODE aFastMode, unsigned aThreads )
+{
+    // Number of operands merged by a single Clipper union at the bottom of the tree
+    const size_t LEAF_SIZE = 32;
+
+    const size_t count = m_polys.size();
+
+    if( count <= LEAF_SIZE )
+    {
+        Simplify( aFastMode );
+        return;
+    }
+
+    InvalidateEdgeIndex();
+
+    const BOX2I   bbox = BBox();
+    const int64_t w = std::max<int64_t>( bbox.GetWidth(), 1 );
+    const int64_t h = std::max<int64_t>( bbox.GetHeight(), 1 );
+
+    std::vector<std::pair<uint32_t, size_t>> order;
+    order.reserve( count );
+
+    for( size_t i = 0; i < count; i++ )
+    {
+        VECTOR2I centre = m_polys[i].empty() ? bbox.Centre() : m_polys[i][0].BBox().Centre();
+        uint32_t x = ( centre.x - (int64_t) bbox.GetX() ) * 0xFFFF / w;
+        uint32_t y = ( centre.y - (int64_t) bbox.GetY() ) * 0xFFFF / h;
+
+        order.emplace_back( mortonCode( x, y ), i );
+    }
+
+    std::sort( order.begin(), order.end() );
+
+    const size_t leafCount = ( count + LEAF_SIZE - 1 ) / LEAF_SIZE;
+    std::vector<SHAPE_POLY_SET> nodes( leafCount );
+
+    for( size_t i = 0; i < count; i++ )
+        nodes[i / LEAF_SIZE].m_polys.push_back( std::move( m_polys[order[i].second] ) );
+
+    m_polys.clear();
+
+    parallelFor( leafCount, aThreads,
+                 [&]( size_t aLeaf )
+                 {
+                     nodes[aLeaf].Simplify( aFastMode );
+                 } );
+
+    // Each pass merges node i + stride into node i, for every i multiple of 2 * stride
+    for( size_t stride = 1; stride < leafCount; stride *= 2 )
+    {
+        parallelFor( ( leafCount + 2 * stride - 1 ) / ( 2 * stride ), aThreads,
+                     [&]( size_t aMerge )
+                     {
+                         size_t i = aMerge * 2 * stride;
+
+                         if( i + stride < leafCount )
+                         {
+                             nodes[i].BooleanAdd( nodes[i + stride], aFastMode );
+                             nodes[i + stride].RemoveAllContours();
+                         }
+                     } );
+    }
+
+    m_polys.swap( nodes[0].m_polys );
+}
+
+
 int SHAPE_POLY_SET::NormalizeAreaOutlines()
 {
+    InvalidateEdgeIndex();
+
     // We are expecting only one main outline, but this main outline can have holes
     // if holes: combine holes and remove them from the main outline.
     // Note also we are using SHAPE_POLY_SET::PM_STRICTLY_SIMPLE in polygon
@@ -1111,6 +1488,8 @@ const std::string SHAPE_POLY_SET::Format() const
 
 bool SHAPE_POLY_SET::Parse( std::stringstream& aStream )
 {
+    InvalidateEdgeIndex();
+
     std::string tmp;
 
     aStream >> tmp;
@@ -1203,6 +1582,20 @@ const BOX2I SHAPE_POLY_SET::BBoxFromCaches() const
 
 bool SHAPE_POLY_SET::PointOnEdge( const VECTOR2I& aP ) const
 {
+    if( std::shared_ptr<const EDGE_INDEX> index = edgeIndex() )
+    {
+        for( const std::vector<POLY_EDGE_INDEX>& polygon : *index )
+        {
+            for( const POLY_EDGE_INDEX& contour : polygon )
+            {
+                if( contour.PointOnEdge( aP ) )
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
     // Iterate through all the polygons in the set
     for( const POLYGON& polygon : m_polys )
     {
@@ -1218,30 +1611,53 @@ bool SHAPE_POLY_SET::PointOnEdge( const VECTOR2I& aP ) const
 }
 
 
-bool SHAPE_POLY_SET::Collide( const SEG& aSeg, int aClearance ) const
+/**
+ * Tests whether any edge of a closed contour comes closer than aClearance to aSeg.  With a
+ * zero clearance only proper crossings count: touching an edge is not a collision.  Reads
+ * the points directly to avoid building a SEG through CSegment() for every edge.
+ */
+static bool contourEdgesCollide( const SHAPE_LINE_CHAIN& aContour, const SEG& aSeg,
+                                 int aClearance )
 {
+    const std::vector<VECTOR2I>& points = aContour.CPoints();
+    size_t                       count = points.size();
 
-    SHAPE_POLY_SET polySet = SHAPE_POLY_SET( *this );
+    if( count == 0 )
+        return false;
 
-    // Inflate the polygon if necessary.
-    if( aClearance > 0 )
+    for( size_t i = 0; i < count; i++ )
     {
-        // fixme: the number of arc segments should not be hardcoded
-        polySet.Inflate( aClearance, 8 );
+        const SEG edge( points[i], points[ i + 1 < count ? i + 1 : 0 ] );
+
+        if( aClearance > 0 )
+        {
+            if( edge.Collide( aSeg, aClearance ) )
+                return true;
+        }
+        else if( edge.Intersect( aSeg, true ) )
+        {
+            return true;
+        }
     }
 
-    // We are going to check to see if the segment crosses an external
-    // boundary.  However, if the full segment is inside the polyset, this
-    // will not be true.  So we first test to see if one of the points is
-    // inside.  If true, then we collide
-    if( polySet.Contains( aSeg.A ) )
-        return true;
+    return false;
+}
+
 
-    for( SEGMENT_ITERATOR it = ( (SHAPE_POLY_SET*) this )->IterateSegmentsWithHoles(); it; it++ )
+static bool contourEdgesCloserThan( const SHAPE_LINE_CHAIN& aContour, const VECTOR2I& aP,
+                                    int aClearance )
+{
+    const std::vector<VECTOR2I>& points = aContour.CPoints();
+    size_t                       count = points.size();
+
+    if( count == 0 )
+        return false;
+
+    for( size_t i = 0; i < count; i++ )
     {
-        SEG polygonEdge = *it;
+        const SEG edge( points[i], points[ i + 1 < count ? i + 1 : 0 ] );
 
-        if( polygonEdge.Intersect( aSeg, true ) )
+        if( edge.PointCloserThan( aP, aClearance ) )
             return true;
     }
 
@@ -1249,30 +1665,93 @@ bool SHAPE_POLY_SET::Collide( const SEG& aSeg, int aClearance ) const
 }
 
 
+bool SHAPE_POLY_SET::Collide( const SEG& aSeg, int aClearance ) const
+{
+    // The segment collides if it starts inside the set, or if it comes closer than the
+    // clearance to an outline or hole edge.  Measuring distances to the original edges is
+    // exact (the inflated copy this used to build approximated the corners with 8 segment
+    // arcs) and does not allocate, which matters for zones with many thousands of vertices.
+    if( aClearance < 0 )
+        aClearance = 0;
+
+    std::shared_ptr<const EDGE_INDEX> index = edgeIndex();
+
+    for( int polygonIdx = 0; polygonIdx < OutlineCount(); polygonIdx++ )
+    {
+        if( containsSingle( aSeg.A, polygonIdx, 0 ) )
+            return true;
+
+        if( index )
+        {
+            for( const POLY_EDGE_INDEX& contour : ( *index )[polygonIdx] )
+            {
+                if( contour.Collide( aSeg, aClearance ) )
+                    return true;
+            }
+        }
+        else
+        {
+            for( const SHAPE_LINE_CHAIN& contour : m_polys[polygonIdx] )
+            {
+                if( contourEdgesCollide( contour, aSeg, aClearance ) )
+                    return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
 bool SHAPE_POLY_SET::Collide( const VECTOR2I& aP, int aClearance ) const
 {
-    SHAPE_POLY_SET polySet = SHAPE_POLY_SET( *this );
+    // Points inside the set always collide; points outside collide only when closer than
+    // the clearance to one of the edges.
+    if( Contains( aP ) )
+        return true;
+
+    if( aClearance <= 0 )
+        return false;
+
+    if( std::shared_ptr<const EDGE_INDEX> index = edgeIndex() )
+    {
+        for( const std::vector<POLY_EDGE_INDEX>& polygon : *index )
+        {
+            for( const POLY_EDGE_INDEX& contour : polygon )
+            {
+                if( contour.PointCloserThan( aP, aClearance ) )
+                    return true;
+            }
+        }
 
-    // Inflate the polygon if necessary.
-    if( aClearance > 0 )
+        return false;
+    }
+
+    for( const POLYGON& polygon : m_polys )
     {
-        // fixme: the number of arc segments should not be hardcoded
-        polySet.Inflate( aClearance, 8 );
+        for( const SHAPE_LINE_CHAIN& contour : polygon )
+        {
+            if( contourEdgesCloserThan( contour, aP, aClearance ) )
+                return true;
+        }
     }
 
-    // There is a collision if and only if the point is inside of the polygon.
-    return polySet.Contains( aP );
+    return false;
 }
 
 
 void SHAPE_POLY_SET::RemoveAllContours()
 {
+    InvalidateEdgeIndex();
+
     m_polys.clear();
 }
 
 
 void SHAPE_POLY_SET::RemoveContour( int aContourIdx, int aPolygonIdx )
 {
+    InvalidateEdgeIndex();
+
     // Default polygon is the last one
     if( aPolygonIdx < 0 )
         aPolygonIdx += m_polys.size();
@@ -1336,12 +1815,16 @@ int SHAPE_POLY_SET::RemoveNullSegments()
 
 void SHAPE_POLY_SET::DeletePolygon( int aIdx )
 {
+    InvalidateEdgeIndex();
+
     m_polys.erase( m_polys.begin() + aIdx );
 }
 
 
 void SHAPE_POLY_SET::Append( const SHAPE_POLY_SET& aSet )
 {
+    InvalidateEdgeIndex();
+
     m_polys.insert( m_polys.end(), aSet.m_polys.begin(), aSet.m_polys.end() );
 }
 
@@ -1396,9 +1879,37 @@ bool SHAPE_POLY_SET::CollideEdge( const VECTOR2I& aPoint,
     // Shows whether there was a collision
     bool collision = false;
 
-    SEGMENT_ITERATOR iterator;
+    if( std::shared_ptr<const EDGE_INDEX> index = edgeIndex() )
+    {
+        // Same result as the scan below: the closest edge, the last one in iteration order
+        // among equally close edges.
+        for( size_t polygonIdx = 0; polygonIdx < index->size(); polygonIdx++ )
+        {
+            const std::vector<POLY_EDGE_INDEX>& polygon = ( *index )[polygonIdx];
+
+            for( size_t contourIdx = 0; contourIdx < polygon.size(); contourIdx++ )
+            {
+                int distance;
+                int edge = polygon[contourIdx].NearestEdge( aPoint, aClearance, distance );
 
-    for( iterator = IterateSegmentsWithHoles(); iterator; iterator++ )
+                if( edge >= 0 )
+                {
+                    collision = true;
+                    aClearance = distance;
+
+                    aClosestVertex.m_polygon = polygonIdx;
+                    aClosestVertex.m_contour = contourIdx;
+                    aClosestVertex.m_vertex = edge;
+                }
+            }
+        }
+
+        return collision;
+    }
+
+    CONST_SEGMENT_ITERATOR iterator;
+
+    for( iterator = CIterateSegmentsWithHoles(); iterator; iterator++ )
     {
         SEG currentSegment = *iterator;
         int distance = currentSegment.Distance( aPoint );
@@ -1453,6 +1964,47 @@ bool SHAPE_POLY_SET::Contains( const VECTOR2I& aP, int aSubpolyIndex, int aAccur
 }
 
 
+void SHAPE_POLY_SET::Contains( const std::vector<VECTOR2I>& aPoints, std::vector<bool>& aResults,
+                               int aSubpolyIndex, int aAccuracy ) const
+{
+    aResults.assign( aPoints.size(), false );
+
+    int first = aSubpolyIndex >= 0 ? aSubpolyIndex : 0;
+    int last = aSubpolyIndex >= 0 ? aSubpolyIndex + 1 : OutlineCount();
+
+    std::vector<VECTOR2I> pending;
+    std::vector<size_t>   pendingIdx;
+    std::vector<uint8_t>  inside;
+
+    for( int polygonIdx = first; polygonIdx < last; polygonIdx++ )
+    {
+        // Only test the points not already found inside a previous polygon
+        pending.clear();
+        pendingIdx.clear();
+
+        for( size_t i = 0; i < aPoints.size(); i++ )
+        {
+            if( !aResults[i] )
+            {
+                pending.push_back( aPoints[i] );
+                pendingIdx.push_back( i );
+            }
+        }
+
+        if( pending.empty() )
+            break;
+
+        containsSingle( pending, polygonIdx, aAccuracy, inside );
+
+        for( size_t i = 0; i < pending.size(); i++ )
+        {
+            if( inside[i] )
+                aResults[pendingIdx[i]] = true;
+        }
+    }
+}
+
+
 void SHAPE_POLY_SET::RemoveVertex( int aGlobalIndex )
 {
     VERTEX_INDEX index;
@@ -1467,6 +2019,8 @@ void SHAPE_POLY_SET::RemoveVertex( int aGlobalIndex )
 
 void SHAPE_POLY_SET::RemoveVertex( VERTEX_INDEX aIndex )
 {
+    InvalidateEdgeIndex();
+
     m_polys[aIndex.m_polygon][aIndex.m_contour].Remove( aIndex.m_vertex );
 }
 
@@ -1484,6 +2038,8 @@ void SHAPE_POLY_SET::SetVertex( int aGlobalIndex, const VECTOR2I& aPos )
 
 void SHAPE_POLY_SET::SetVertex( const VERTEX_INDEX& aIndex, const VECTOR2I& aPos )
 {
+    InvalidateEdgeIndex();
+
     m_polys[aIndex.m_polygon][aIndex.m_contour].SetPoint( aIndex.m_vertex, aPos );
 }
 
@@ -1491,6 +2047,22 @@ void SHAPE_POLY_SET::SetVertex( const VERTEX_INDEX& aIndex, const VECTOR2I& aPos
 bool SHAPE_POLY_SET::containsSingle( const VECTOR2I& aP, int aSubpolyIndex, int aAccuracy,
                                      bool aUseBBoxCaches ) const
 {
+    if( std::shared_ptr<const EDGE_INDEX> index = edgeIndex() )
+    {
+        const std::vector<POLY_EDGE_INDEX>& contours = ( *index )[aSubpolyIndex];
+
+        if( !contours[0].PointInside( aP, aAccuracy ) )
+            return false;
+
+        for( size_t holeIdx = 1; holeIdx < contours.size(); holeIdx++ )
+        {
+            if( contours[holeIdx].PointInside( aP, 1 ) )
+                return false;
+        }
+
+        return true;
+    }
+
     // Check that the point is inside the outline
     if( m_polys[aSubpolyIndex][0].PointInside( aP, aAccuracy ) )
     {
@@ -1512,8 +2084,54 @@ bool SHAPE_POLY_SET::containsSingle( const VECTOR2I& aP, int aSubpolyIndex, int
 }
 
 
+void SHAPE_POLY_SET::containsSingle( const std::vector<VECTOR2I>& aPoints, int aSubpolyIndex,
+                                     int aAccuracy, std::vector<uint8_t>& aResults ) const
+{
+    const POLYGON& polygon = m_polys[aSubpolyIndex];
+
+    aResults.resize( aPoints.size() );
+    CONTOUR_SOA( polygon[0] ).PointInside( aPoints.data(), aPoints.size(), aAccuracy,
+                                           aResults.data() );
+
+    std::vector<VECTOR2I> inside;
+    std::vector<size_t>   insideIdx;
+    std::vector<uint8_t>  inHole;
+
+    for( size_t holeIdx = 1; holeIdx < polygon.size(); holeIdx++ )
+    {
+        inside.clear();
+        insideIdx.clear();
+
+        for( size_t i = 0; i < aPoints.size(); i++ )
+        {
+            if( aResults[i] )
+            {
+                inside.push_back( aPoints[i] );
+                insideIdx.push_back( i );
+            }
+        }
+
+        if( inside.empty() )
+            return;
+
+        // As in the single point version, don't use aAccuracy for the holes
+        inHole.resize( inside.size() );
+        CONTOUR_SOA( polygon[holeIdx] ).PointInside( inside.data(), inside.size(), 1,
+                                                     inHole.data() );
+
+        for( size_t i = 0; i < inside.size(); i++ )
+        {
+            if( inHole[i] )
+                aResults[insideIdx[i]] = 0;
+        }
+    }
+}
+
+
 void SHAPE_POLY_SET::Move( const VECTOR2I& aVector )
 {
+    InvalidateEdgeIndex();
+
     for( POLYGON& poly : m_polys )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
@@ -1524,6 +2142,8 @@ void SHAPE_POLY_SET::Move( const VECTOR2I& aVector )
 
 void SHAPE_POLY_SET::Mirror( bool aX, bool aY, const VECTOR2I& aRef )
 {
+    InvalidateEdgeIndex();
+
     for( POLYGON& poly : m_polys )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
@@ -1536,6 +2156,8 @@ void SHAPE_POLY_SET::Mirror( bool aX, bool aY, const VECTOR2I& aRef )
 
 void SHAPE_POLY_SET::Rotate( double aAngle, const VECTOR2I& aCenter )
 {
+    InvalidateEdgeIndex();
+
     for( POLYGON& poly : m_polys )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
@@ -1582,7 +2204,17 @@ SEG::ecoord SHAPE_POLY_SET::SquaredDistanceToPolygon( VECTOR2I aPoint, int aPoly
     if( containsSingle( aPoint, aPolygonIndex, 1 ) )
         return 0;
 
-    SEGMENT_ITERATOR iterator = IterateSegmentsWithHoles( aPolygonIndex );
+    if( std::shared_ptr<const EDGE_INDEX> index = edgeIndex() )
+    {
+        SEG::ecoord minDistance = VECTOR2I::ECOORD_MAX;
+
+        for( const POLY_EDGE_INDEX& contour : ( *index )[aPolygonIndex] )
+            minDistance = std::min( minDistance, contour.SquaredDistance( aPoint ) );
+
+        return minDistance;
+    }
+
+    CONST_SEGMENT_ITERATOR iterator = CIterateSegmentsWithHoles( aPolygonIndex );
 
     SEG polygonEdge = *iterator;
     SEG::ecoord minDistance = polygonEdge.SquaredDistance( aPoint );
@@ -1610,7 +2242,17 @@ SEG::ecoord SHAPE_POLY_SET::SquaredDistanceToPolygon( const SEG& aSegment, int a
     if( containsSingle( aSegment.A, aPolygonIndex, 1 ) )
         return 0;
 
-    SEGMENT_ITERATOR iterator = IterateSegmentsWithHoles( aPolygonIndex );
+    if( std::shared_ptr<const EDGE_INDEX> index = edgeIndex() )
+    {
+        SEG::ecoord minDistance = VECTOR2I::ECOORD_MAX;
+
+        for( const POLY_EDGE_INDEX& contour : ( *index )[aPolygonIndex] )
+            minDistance = std::min( minDistance, contour.SquaredDistance( aSegment ) );
+
+        return minDistance < 0 ? 0 : minDistance;
+    }
+
+    CONST_SEGMENT_ITERATOR iterator = CIterateSegmentsWithHoles( aPolygonIndex );
     SEG              polygonEdge = *iterator;
     SEG::ecoord      minDistance = polygonEdge.SquaredDistance( aSegment );
 
@@ -1874,28 +2516,164 @@ SHAPE_POLY_SET &SHAPE_POLY_SET::operator=( const SHAPE_POLY_SET& aOther )
     static_cast<SHAPE&>(*this) = aOther;
     m_polys = aOther.m_polys;
 
-    // reset poly cache:
-    m_hash = MD5_HASH{};
+    // reset poly cache, but keep the triangles of the polygons of both sets: the polygons the
+    // sets have in common (e.g. the islands left untouched by a zone refill) won't need to be
+    // triangulated again.  Entries of a stale cache are dropped so the cache can't grow
+    // through a series of assignments.
+    if( &aOther != this )
+    {
+        if( !m_triangulationValid )
+            m_triangulationCache.clear();
+
+        for( const auto& entry : aOther.m_triangulationCache )
+            m_triangulationCache.insert( entry );
+    }
+
+    m_hashValid = false;
     m_triangulationValid = false;
     m_triangulatedPolys.clear();
+
+    m_edgeIndexEnabled = aOther.m_edgeIndexEnabled;
+    m_edgeIndexQueries = 0;
+    std::atomic_store( &m_edgeIndex, std::atomic_load( &aOther.m_edgeIndex ) );
+    m_edgeIndexBuilt = m_edgeIndex != nullptr;
+
     return *this;
 }
 
-MD5_HASH SHAPE_POLY_SET::GetHash() const
+HASH_128 SHAPE_POLY_SET::GetHash() const
 {
-    if( !m_hash.IsValid() )
+    if( !m_hashValid )
         return checksum();
 
     return m_hash;
 }
 
 
+// A set must have at least this many vertices, and have been queried this many times since
+// its last modification, before its edge index gets built.  Below that, scanning the edges
+// is about as fast as building the index.
+static const int EDGE_INDEX_MIN_VERTICES = 64;
+static const int EDGE_INDEX_MIN_QUERIES = 4;
+
+
+void SHAPE_POLY_SET::SetEdgeIndexEnabled( bool aEnabled )
+{
+    m_edgeIndexEnabled = aEnabled;
+
+    if( !aEnabled )
+        InvalidateEdgeIndex();
+}
+
+
+void SHAPE_POLY_SET::BuildEdgeIndex() const
+{
+    if( !IsEdgeIndexBuilt() )
+        buildEdgeIndex();
+}
+
+
+std::shared_ptr<const SHAPE_POLY_SET::EDGE_INDEX> SHAPE_POLY_SET::edgeIndex() const
+{
+    if( m_edgeIndexBuilt.load( std::memory_order_acquire ) )
+    {
+        std::shared_ptr<const EDGE_INDEX> index = std::atomic_load( &m_edgeIndex );
+
+        // Guard against an edit that was not detected
+        if( index && !edgeIndexMatches( *index ) )
+            return nullptr;
+
+        return index;
+    }
+
+    if( !m_edgeIndexEnabled )
+        return nullptr;
+
+    if( m_edgeIndexQueries.load( std::memory_order_relaxed ) < EDGE_INDEX_MIN_QUERIES )
+    {
+        m_edgeIndexQueries.fetch_add( 1, std::memory_order_relaxed );
+        return nullptr;
+    }
+
+    if( TotalVertices() < EDGE_INDEX_MIN_VERTICES )
+        return nullptr;
+
+    return buildEdgeIndex();
+}
+
+
+std::shared_ptr<const SHAPE_POLY_SET::EDGE_INDEX> SHAPE_POLY_SET::buildEdgeIndex() const
+{
+    // Several threads may build the index concurrently; they all produce the same result and
+    // the last one stored wins.
+    auto index = std::make_shared<EDGE_INDEX>();
+
+    index->resize( m_polys.size() );
+
+    for( size_t polygonIdx = 0; polygonIdx < m_polys.size(); polygonIdx++ )
+    {
+        std::vector<POLY_EDGE_INDEX>& polygon = ( *index )[polygonIdx];
+
+        polygon.reserve( m_polys[polygonIdx].size() );
+
+        for( const SHAPE_LINE_CHAIN& contour : m_polys[polygonIdx] )
+            polygon.emplace_back( contour );
+    }
+
+    std::shared_ptr<const EDGE_INDEX> result( std::move( index ) );
+
+    std::atomic_store( &m_edgeIndex, result );
+    m_edgeIndexBuilt.store( true, std::memory_order_release );
+
+    return result;
+}
+
+
+void SHAPE_POLY_SET::dropEdgeIndex()
+{
+    m_edgeIndexBuilt.store( false, std::memory_order_release );
+    std::atomic_store( &m_edgeIndex, std::shared_ptr<const EDGE_INDEX>() );
+}
+
+
+bool SHAPE_POLY_SET::edgeIndexMatches( const EDGE_INDEX& aIndex ) const
+{
+    // Cheap checks only (this runs on every query): the shape of the set, and the vertex
+    // count and first vertex of each contour
+    if( aIndex.size() != m_polys.size() )
+        return false;
+
+    for( size_t polygonIdx = 0; polygonIdx < m_polys.size(); polygonIdx++ )
+    {
+        const POLYGON&                      polygon = m_polys[polygonIdx];
+        const std::vector<POLY_EDGE_INDEX>& contours = aIndex[polygonIdx];
+
+        if( contours.size() != polygon.size() )
+            return false;
+
+        for( size_t contourIdx = 0; contourIdx < polygon.size(); contourIdx++ )
+        {
+            const SHAPE_LINE_CHAIN& contour = polygon[contourIdx];
+            const POLY_EDGE_INDEX&  index = contours[contourIdx];
+
+            if( index.PointCount() != contour.PointCount() )
+                return false;
+
+            if( index.PointCount() > 0 && index.CPoint( 0 ) != contour.CPoint( 0 ) )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
 bool SHAPE_POLY_SET::IsTriangulationUpToDate() const
 {
     if( !m_triangulationValid )
         return false;
 
-    if( !m_hash.IsValid() )
+    if( !m_hashValid )
         return false;
 
     auto hash = checksum();
@@ -1906,8 +2684,8 @@ bool SHAPE_POLY_SET::IsTriangulationUpToDate() const
 
 void SHAPE_POLY_SET::CacheTriangulation()
 {
-    bool recalculate = !m_hash.IsValid();
-    MD5_HASH hash;
+    bool recalculate = !m_hashValid;
+    HASH_128 hash;
 
     if( !m_triangulationValid )
         recalculate = true;
@@ -1926,18 +2704,82 @@ void SHAPE_POLY_SET::CacheTriangulation()
     if( !recalculate )
         return;
 
-    SHAPE_POLY_SET tmpSet = *this;
-
-    if( tmpSet.HasHoles() )
-        tmpSet.Fracture( PM_FAST );
+    std::unordered_map<uint64_t, TRIANGULATED_POLYGONS> cache;
 
     m_triangulatedPolys.clear();
+
+    for( const POLYGON& polygon : m_polys )
+    {
+        uint64_t key = polygonHash( polygon );
+        auto     cached = cache.find( key );
+
+        if( cached == cache.end() )
+        {
+            auto previous = m_triangulationCache.find( key );
+
+            if( previous != m_triangulationCache.end() )
+                cached = cache.emplace( key, std::move( previous->second ) ).first;
+            else
+                cached = cache.emplace( key, triangulatePolygon( polygon ) ).first;
+        }
+
+        m_triangulatedPolys.insert( m_triangulatedPolys.end(), cached->second.begin(),
+                                    cached->second.end() );
+    }
+
+    // Only keep the polygons of this triangulation
+    m_triangulationCache = std::move( cache );
     m_triangulationValid = true;
+    m_hash = checksum();
+    m_hashValid = true;
+}
+
+
+/**
+ * Adds the point count and the points of each contour of aPolygon to aHash.  The points are
+ * hashed straight from the vertex arrays, so FAST_HASH streams them in 32 byte stripes.
+ */
+static void hashPolygon( FAST_HASH& aHash, const SHAPE_POLY_SET::POLYGON& aPolygon )
+{
+    aHash.Add( aPolygon.size() );
+
+    for( const SHAPE_LINE_CHAIN& contour : aPolygon )
+    {
+        const std::vector<VECTOR2I>& points = contour.CPoints();
+
+        aHash.Add( points.size() );
+
+        if( !points.empty() )
+            aHash.Add( points.data(), points.size() * sizeof( VECTOR2I ) );
+    }
+}
+
+
+uint64_t SHAPE_POLY_SET::polygonHash( const POLYGON& aPolygon )
+{
+    FAST_HASH hash;
+
+    hashPolygon( hash, aPolygon );
+
+    return hash.Digest64();
+}
+
+
+SHAPE_POLY_SET::TRIANGULATED_POLYGONS SHAPE_POLY_SET::triangulatePolygon(
+        const POLYGON& aPolygon )
+{
+    TRIANGULATED_POLYGONS result;
+    SHAPE_POLY_SET        tmpSet;
+
+    tmpSet.m_polys.push_back( aPolygon );
+
+    if( tmpSet.HasHoles() )
+        tmpSet.Fracture( PM_FAST );
 
     while( tmpSet.OutlineCount() > 0 )
     {
-        m_triangulatedPolys.push_back( std::make_unique<TRIANGULATED_POLYGON>() );
-        PolygonTriangulation tess( *m_triangulatedPolys.back() );
+        auto                 triangulated = std::make_shared<TRIANGULATED_POLYGON>();
+        PolygonTriangulation tess( *triangulated );
 
         // If the tesselation fails, we re-fracture the polygon, which will
         // first simplify the system before fracturing and removing the holes
@@ -1945,44 +2787,27 @@ void SHAPE_POLY_SET::CacheTriangulation()
         if( !tess.TesselatePolygon( tmpSet.Polygon( 0 ).front() ) )
         {
             tmpSet.Fracture( PM_FAST );
-            m_triangulationValid = false;
             continue;
         }
 
+        result.push_back( std::move( triangulated ) );
         tmpSet.DeletePolygon( 0 );
-        m_triangulationValid = true;
     }
 
-    if( m_triangulationValid )
-        m_hash = checksum();
+    return result;
 }
 
 
-MD5_HASH SHAPE_POLY_SET::checksum() const
+HASH_128 SHAPE_POLY_SET::checksum() const
 {
-    MD5_HASH hash;
-
-    hash.Hash( m_polys.size() );
+    FAST_HASH hash;
 
-    for( const auto& outline : m_polys )
-    {
-        hash.Hash( outline.size() );
+    hash.Add( m_polys.size() );
 
-        for( const auto& lc : outline )
-        {
-            hash.Hash( lc.PointCount() );
-
-            for( int i = 0; i < lc.PointCount(); i++ )
-            {
-                hash.Hash( lc.CPoint( i ).x );
-                hash.Hash( lc.CPoint( i ).y );
-            }
-        }
-    }
-
-    hash.Finalize();
+    for( const POLYGON& polygon : m_polys )
+        hashPolygon( hash, polygon );
 
-    return hash;
+    return hash.Digest128();
 }
 
 
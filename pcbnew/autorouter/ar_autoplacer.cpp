@@ -45,7 +45,10 @@
 #include "ar_autoplacer.h"
 #include "ar_cell.h"
 #include "ar_matrix.h"
+#include <atomic>
+#include <future>
 #include <memory>
+#include <thread>
 
 #define AR_GAIN            16
 #define AR_KEEPOUT_MARGIN  500
@@ -424,6 +427,8 @@ void AR_AUTOPLACER::genModuleOnRoutingMatrix( MODULE* Module )
     // Substract the shape to free areas
     m_topFreeArea.BooleanSubtract( m_fpAreaTop, SHAPE_POLY_SET::PM_FAST );
     m_bottomFreeArea.BooleanSubtract( m_fpAreaBottom, SHAPE_POLY_SET::PM_FAST );
+
+    m_matrix.InvalidateOccupancyCache();
 }
 
 
@@ -433,7 +438,7 @@ void AR_AUTOPLACER::genModuleOnRoutingMatrix( MODULE* Module )
  *
  * Returns OUT_OF_BOARD, or OCCUPED_By_MODULE or FREE_CELL if OK
  */
-int AR_AUTOPLACER::testRectangle( const EDA_RECT& aRect, int side )
+int AR_AUTOPLACER::testRectangle( const EDA_RECT& aRect, int side ) const
 {
     EDA_RECT rect = aRect;
 
@@ -468,21 +473,12 @@ int AR_AUTOPLACER::testRectangle( const EDA_RECT& aRect, int side )
     if( col_max >= ( m_matrix.m_Ncols - 1 ) )
         col_max = m_matrix.m_Ncols - 1;
 
-    for( int row = row_min; row <= row_max; row++ )
+    switch( m_matrix.TestRectangleCells( row_min, row_max, col_min, col_max, side ) )
     {
-        for( int col = col_min; col <= col_max; col++ )
-        {
-            unsigned int data = m_matrix.GetCell( row, col, side );
-
-            if( ( data & CELL_IS_ZONE ) == 0 )
-                return AR_OUT_OF_BOARD;
-
-            if( (data & CELL_IS_MODULE) )
-                return AR_OCCUIPED_BY_MODULE;
-        }
+    case AR_MATRIX::OCC_OUT_OF_BOARD: return AR_OUT_OF_BOARD;
+    case AR_MATRIX::OCC_MODULE:       return AR_OCCUIPED_BY_MODULE;
+    default:                          return AR_FREE_CELL;
     }
-
-    return AR_FREE_CELL;
 }
 
 int AR_AUTOPLACER::testModuleByPolygon( MODULE* aModule, int aSide, const wxPoint& aOffset )
@@ -506,7 +502,7 @@ int AR_AUTOPLACER::testModuleByPolygon( MODULE* aModule, int aSide, const wxPoin
  * aRect):
  * (Sum of cells in terms of distance)
  */
-unsigned int AR_AUTOPLACER::calculateKeepOutArea( const EDA_RECT& aRect, int side )
+unsigned int AR_AUTOPLACER::calculateKeepOutArea( const EDA_RECT& aRect, int side ) const
 {
     wxPoint start   = aRect.GetOrigin();
     wxPoint end     = aRect.GetEnd();
@@ -537,62 +533,37 @@ unsigned int AR_AUTOPLACER::calculateKeepOutArea( const EDA_RECT& aRect, int sid
     if( col_max >= ( m_matrix.m_Ncols - 1 ) )
         col_max = m_matrix.m_Ncols - 1;
 
-    unsigned int keepOutCost = 0;
-
-    for( int row = row_min; row <= row_max; row++ )
-    {
-        for( int col = col_min; col <= col_max; col++ )
-        {
-            // m_matrix.GetDist returns the "cost" of the cell
-            // at position (row, col)
-            // in autoplace this is the cost of the cell, if it is
-            // inside aRect
-            keepOutCost += m_matrix.GetDist( row, col, side );
-        }
-    }
-
-    return keepOutCost;
+    // The distance map holds the "cost" of each cell; in autoplace this is the cost of
+    // the cell if it is inside aRect.  The sum is kept modulo 2^32 like the cell-by-cell
+    // accumulation it replaces.
+    return (unsigned int) m_matrix.SumDistRectangle( row_min, row_max, col_min, col_max, side );
 }
 
 
 /* Test if the module can be placed on the board.
  * Returns the value TstRectangle().
- * Module is known by its bounding box
+ * Module is known by its bounding box aFpBBox, at the position to test
  */
-int AR_AUTOPLACER::testModuleOnBoard( MODULE* aModule, bool TstOtherSide, const wxPoint& aOffset )
+int AR_AUTOPLACER::testModuleOnBoard( const EDA_RECT& aFpBBox, int aSide, int aOtherSide,
+                                      bool TstOtherSide, int aMargin ) const
 {
-    int side = AR_SIDE_TOP;
-    int otherside = AR_SIDE_BOTTOM;
-
-    if( aModule->GetLayer() == B_Cu )
-    {
-        side = AR_SIDE_BOTTOM; otherside = AR_SIDE_TOP;
-    }
-
-    EDA_RECT    fpBBox = aModule->GetFootprintRect();
-    fpBBox.Move( -aOffset );
-
-    buildFpAreas( aModule, 0 );
+    int diag = testRectangle( aFpBBox, aSide );
 
-    int diag = //testModuleByPolygon( aModule, side, aOffset );
-        testRectangle( fpBBox, side );
-//printf("test %p diag %d\n", aModule, diag);fflush(0);
     if( diag != AR_FREE_CELL )
         return diag;
 
     if( TstOtherSide )
     {
-        diag = //testModuleByPolygon( aModule, otherside, aOffset );
-                testRectangle( fpBBox, otherside );
+        diag = testRectangle( aFpBBox, aOtherSide );
 
         if( diag != AR_FREE_CELL )
             return diag;
     }
 
-    int marge = ( m_matrix.m_GridRouting * aModule->GetPadCount() ) / AR_GAIN;
+    EDA_RECT keepOutBBox = aFpBBox;
 
-    fpBBox.Inflate( marge );
-    return calculateKeepOutArea( fpBBox, side );
+    keepOutBBox.Inflate( aMargin );
+    return calculateKeepOutArea( keepOutBBox, aSide );
 }
 
 
@@ -600,7 +571,7 @@ int AR_AUTOPLACER::getOptimalModulePlacement(MODULE* aModule)
 {
     int     error = 1;
     wxPoint LastPosOK;
-    double  min_cost, curr_cost, Score;
+    double  min_cost;
     bool    TstOtherSide;
 
     aModule->CalculateBoundingBox();
@@ -624,9 +595,6 @@ int AR_AUTOPLACER::getOptimalModulePlacement(MODULE* aModule)
     initialPos.x    -= initialPos.x % m_matrix.m_GridRouting;
     initialPos.y    -= initialPos.y % m_matrix.m_GridRouting;
 
-    m_curPosition = initialPos;
-    auto moduleOffset = mod_pos - m_curPosition;
-
     /* Examine pads, and set TstOtherSide to true if a footprint
      * has at least 1 pad through.
      */
@@ -646,46 +614,109 @@ int AR_AUTOPLACER::getOptimalModulePlacement(MODULE* aModule)
         }
     }
 
-    fpBBox.SetOrigin( fpBBoxOrg + m_curPosition );
+    int side = AR_SIDE_TOP;
+    int otherside = AR_SIDE_BOTTOM;
 
-    min_cost = -1.0;
-//    m_frame->SetStatusText( wxT( "Score ??, pos ??" ) );
+    if( aModule->GetLayer() == B_Cu )
+    {
+        side = AR_SIDE_BOTTOM;
+        otherside = AR_SIDE_TOP;
+    }
+
+    int margin = ( m_matrix.m_GridRouting * aModule->GetPadCount() ) / AR_GAIN;
+
+    // Everything the position loop needs is gathered here, so that candidate positions can
+    // be evaluated concurrently without touching the board or the footprint.
+    if( !m_matrix.IsOccupancyCacheValid() )
+        m_matrix.BuildOccupancyCache();
 
+    std::vector<PAD_TARGETS> padTargets;
+    buildPadTargets( aModule, padTargets );
 
-    for( ; m_curPosition.x < xylimit.x; m_curPosition.x += m_matrix.m_GridRouting )
+    // Each x column of candidate positions is scanned by a single thread, and keeps the
+    // same "last best wins" rule as a serial scan.  Columns are then merged in scan
+    // order, so the result does not depend on the thread count.
+    struct COLUMN_BEST
     {
-        m_curPosition.y = initialPos.y;
+        double  m_cost = -1.0;
+        wxPoint m_pos;
+    };
 
-        for( ; m_curPosition.y < xylimit.y; m_curPosition.y += m_matrix.m_GridRouting )
-        {
+    const int grid = m_matrix.m_GridRouting;
+    int columnCount = 0;
+
+    if( xylimit.x > initialPos.x )
+        columnCount = ( xylimit.x - initialPos.x + grid - 1 ) / grid;
 
-            fpBBox.SetOrigin( fpBBoxOrg + m_curPosition );
-            moduleOffset = mod_pos - m_curPosition;
-            int keepOutCost = testModuleOnBoard( aModule, TstOtherSide, moduleOffset );
+    std::vector<COLUMN_BEST> columnBest( columnCount );
+    std::atomic<int> nextColumn( 0 );
 
-            if( keepOutCost >= 0 )    // i.e. if the module can be put here
+    auto evalColumns = [&]() -> size_t
+    {
+        for( int ii = nextColumn++; ii < columnCount; ii = nextColumn++ )
+        {
+            COLUMN_BEST& best = columnBest[ii];
+            wxPoint      pos( initialPos.x + ii * grid, initialPos.y );
+            EDA_RECT     bbox = fpBBox;
+
+            for( ; pos.y < xylimit.y; pos.y += grid )
             {
-                error = 0;
-                // m_frame->build_ratsnest_module( aModule ); // fixme
-                curr_cost   = computePlacementRatsnestCost( aModule, moduleOffset );
-                Score       = curr_cost + keepOutCost;
+                bbox.SetOrigin( fpBBoxOrg + pos );
+                int keepOutCost = testModuleOnBoard( bbox, side, otherside, TstOtherSide,
+                                                     margin );
 
-                if( (min_cost >= Score ) || (min_cost < 0 ) )
+                if( keepOutCost >= 0 )    // i.e. if the module can be put here
                 {
-                    LastPosOK   = m_curPosition;
-                    min_cost    = Score;
-                    wxString msg;
-/*                    msg.Printf( wxT( "Score %g, pos %s, %s" ),
-                                min_cost,
-                                GetChars( ::CoordinateToString( LastPosOK.x ) ),
-                                GetChars( ::CoordinateToString( LastPosOK.y ) ) );
-                    m_frame->SetStatusText( msg );*/
+                    double score = computePlacementRatsnestCost( padTargets, mod_pos - pos )
+                                   + keepOutCost;
+
+                    if( ( best.m_cost >= score ) || ( best.m_cost < 0 ) )
+                    {
+                        best.m_pos = pos;
+                        best.m_cost = score;
+                    }
                 }
             }
         }
+
+        return 1;
+    };
+
+    size_t parallelThreadCount = std::min<size_t>(
+            std::max<size_t>( std::thread::hardware_concurrency(), 1 ),
+            std::max<size_t>( columnCount, 1 ) );
+
+    if( parallelThreadCount <= 1 )
+    {
+        evalColumns();
+    }
+    else
+    {
+        std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, evalColumns );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].wait();
+    }
+
+    min_cost = -1.0;
+
+    for( const COLUMN_BEST& best : columnBest )
+    {
+        if( best.m_cost < 0 )
+            continue;
+
+        error = 0;
+
+        if( ( min_cost >= best.m_cost ) || ( min_cost < 0 ) )
+        {
+            LastPosOK   = best.m_pos;
+            min_cost    = best.m_cost;
+        }
     }
 
-    // Regeneration of the modified variable.
     m_curPosition = LastPosOK;
 
     m_minCost = min_cost;
@@ -693,39 +724,44 @@ int AR_AUTOPLACER::getOptimalModulePlacement(MODULE* aModule)
 }
 
 
-const D_PAD* AR_AUTOPLACER::nearestPad( MODULE *aRefModule, D_PAD* aRefPad, const wxPoint& aOffset)
+void AR_AUTOPLACER::buildPadTargets( MODULE* aModule, std::vector<PAD_TARGETS>& aTargets ) const
 {
-    const D_PAD* nearest = nullptr;
-    int64_t nearestDist = INT64_MAX;
+    // The candidate pads for a ratsnest do not depend on the position being tested:
+    // collect them once, in board order so that ties between equally near pads resolve
+    // to the same pad as before.
+    aTargets.clear();
 
-    for ( auto mod : m_board->Modules() )
+    for( auto pad : aModule->Pads() )
     {
-        if ( mod == aRefModule )
-            continue;
+        PAD_TARGETS item;
 
-        if( !m_matrix.m_BrdBox.Contains( mod->GetPosition() ) )
-            continue;
+        item.m_pos = pad->GetPosition();
 
-        for ( auto pad: mod->Pads() )
+        if( pad->GetNetCode() > 0 )
         {
-            if ( pad->GetNetCode() != aRefPad->GetNetCode() || pad->GetNetCode() <= 0 )
-                continue;
+            for( auto mod : m_board->Modules() )
+            {
+                if( mod == aModule )
+                    continue;
 
-            auto dist = (VECTOR2I( aRefPad->GetPosition() - aOffset ) - VECTOR2I( pad->GetPosition() ) ).EuclideanNorm();
+                if( !m_matrix.m_BrdBox.Contains( mod->GetPosition() ) )
+                    continue;
 
-            if ( dist < nearestDist )
-            {
-                nearestDist = dist;
-                nearest = pad;
+                for( auto candidate : mod->Pads() )
+                {
+                    if( candidate->GetNetCode() == pad->GetNetCode() )
+                        item.m_targets.push_back( candidate->GetPosition() );
+                }
             }
         }
-    }
 
-    return nearest;
+        aTargets.push_back( std::move( item ) );
+    }
 }
 
 
-double AR_AUTOPLACER::computePlacementRatsnestCost( MODULE *aModule, const wxPoint& aOffset )
+double AR_AUTOPLACER::computePlacementRatsnestCost( const std::vector<PAD_TARGETS>& aPads,
+                                                    const wxPoint& aOffset ) const
 {
     double  curr_cost;
     VECTOR2I start;      // start point of a ratsnest
@@ -734,21 +770,26 @@ double AR_AUTOPLACER::computePlacementRatsnestCost( MODULE *aModule, const wxPoi
 
     curr_cost = 0;
 
-    for ( auto pad : aModule->Pads() )
+    for( const PAD_TARGETS& pad : aPads )
     {
-        auto nearest = nearestPad( aModule, pad, aOffset );
-
-        if( !nearest )
+        if( pad.m_targets.empty() )
             continue;
 
-        //printf("pad %s nearest %s\n", (const char *)aModule->GetReference().c_str(), (const char *)nearest->GetParent()->GetReference().c_str());
+        start = pad.m_pos - VECTOR2I( aOffset );
 
-        start   = VECTOR2I( pad->GetPosition() ) - VECTOR2I(aOffset);
-        end     = VECTOR2I( nearest->GetPosition() );
+        // Nearest pad of the same net; the first one wins on ties
+        int64_t nearestDist = INT64_MAX;
+
+        for( const VECTOR2I& target : pad.m_targets )
+        {
+            int64_t dist = ( start - target ).EuclideanNorm();
 
-        //m_overlay->SetIsStroke( true );
-        //m_overlay->SetStrokeColor( COLOR4D(0.0, 1.0, 0.0, 1.0) );
-        //m_overlay->Line( start, end );
+            if( dist < nearestDist )
+            {
+                nearestDist = dist;
+                end = target;
+            }
+        }
 
         // Cost of the ratsnest.
         dx  = end.x - start.x;
@@ -103,12 +103,22 @@ private:
     bool         fillMatrix();
     void         genModuleOnRoutingMatrix( MODULE* Module );
 
-    int          testRectangle( const EDA_RECT& aRect, int side );
+    ///> A pad of the footprint being placed, and the same-net pads it can connect to
+    struct PAD_TARGETS
+    {
+        VECTOR2I              m_pos;
+        std::vector<VECTOR2I> m_targets;
+    };
+
+    int          testRectangle( const EDA_RECT& aRect, int side ) const;
     int          testModuleByPolygon( MODULE* aModule,int aSide, const wxPoint& aOffset );
-    unsigned int calculateKeepOutArea( const EDA_RECT& aRect, int side );
-    int          testModuleOnBoard( MODULE* aModule, bool TstOtherSide, const wxPoint& aOffset );
+    unsigned int calculateKeepOutArea( const EDA_RECT& aRect, int side ) const;
+    int          testModuleOnBoard( const EDA_RECT& aFpBBox, int aSide, int aOtherSide,
+                                    bool TstOtherSide, int aMargin ) const;
     int          getOptimalModulePlacement( MODULE* aModule );
-    double       computePlacementRatsnestCost( MODULE* aModule, const wxPoint& aOffset );
+    void         buildPadTargets( MODULE* aModule, std::vector<PAD_TARGETS>& aTargets ) const;
+    double       computePlacementRatsnestCost( const std::vector<PAD_TARGETS>& aPads,
+                                               const wxPoint& aOffset ) const;
 
     /**
      * Find the "best" module place. The criteria are:
@@ -118,7 +128,6 @@ private:
     MODULE*      pickModule();
 
     void         placeModule( MODULE* aModule, bool aDoNotRecreateRatsnest, const wxPoint& aPos );
-    const D_PAD* nearestPad( MODULE* aRefModule, D_PAD* aRefPad, const wxPoint& aOffset );
 
     // Add a polygonal shape (rectangle) to m_fpAreaFront and/or m_fpAreaBack
     void         addFpBody( wxPoint aStart, wxPoint aEnd, LSET aLayerMask );
@@ -46,6 +46,9 @@ AR_MATRIX::AR_MATRIX()
     m_DirSide[0]         = nullptr;
     m_DirSide[1]         = nullptr;
     m_opWriteCell        = nullptr;
+    m_cellOp             = WRITE_CELL;
+    m_occupancyCacheValid = false;
+    m_wordsPerRow        = 0;
     m_InitMatrixDone     = false;
     m_Nrows              = 0;
     m_Ncols              = 0;
@@ -171,14 +174,22 @@ void AR_MATRIX::UnInitRoutingMatrix()
             delete m_BoardSide[ii];
             m_BoardSide[ii] = nullptr;
         }
+
+        m_outOfBoardBits[ii].clear();
+        m_moduleBits[ii].clear();
+        m_distSum[ii].clear();
     }
 
+    m_occupancyCacheValid = false;
+    m_wordsPerRow = 0;
     m_Nrows = m_Ncols = 0;
 }
 
 // Initialize m_opWriteCell member to make the aLogicOp
 void AR_MATRIX::SetCellOperation( AR_MATRIX::CELL_OP aLogicOp )
 {
+    m_cellOp = aLogicOp;
+
     switch( aLogicOp )
     {
     default:
@@ -195,6 +206,167 @@ void AR_MATRIX::SetCellOperation( AR_MATRIX::CELL_OP aLogicOp )
 }
 
 
+void AR_MATRIX::writeCellSpan( int aRow, int aColMin, int aColMax, int aSide, MATRIX_CELL x )
+{
+    // Same result as calling WriteCell() for each column, but the operation is selected
+    // once per span and the inner loops run on contiguous memory (and are vectorized by
+    // the compiler).
+    MATRIX_CELL* p = m_BoardSide[aSide] + aRow * m_Ncols;
+
+    switch( m_cellOp )
+    {
+    default:
+    case WRITE_CELL:
+        for( int col = aColMin; col <= aColMax; col++ )
+            p[col] = x;
+        break;
+
+    case WRITE_OR_CELL:
+        for( int col = aColMin; col <= aColMax; col++ )
+            p[col] |= x;
+        break;
+
+    case WRITE_XOR_CELL:
+        for( int col = aColMin; col <= aColMax; col++ )
+            p[col] ^= x;
+        break;
+
+    case WRITE_AND_CELL:
+        for( int col = aColMin; col <= aColMax; col++ )
+            p[col] &= x;
+        break;
+
+    case WRITE_ADD_CELL:
+        for( int col = aColMin; col <= aColMax; col++ )
+            p[col] += x;
+        break;
+    }
+}
+
+
+void AR_MATRIX::BuildOccupancyCache()
+{
+    m_wordsPerRow = ( m_Ncols + 63 ) / 64;
+
+    const size_t bitCount = (size_t) m_Nrows * m_wordsPerRow;
+    const size_t satStride = m_Ncols + 1;
+
+    for( int side = 0; side < AR_MAX_ROUTING_LAYERS_COUNT; side++ )
+    {
+        if( !m_BoardSide[side] || !m_DistSide[side] )
+        {
+            m_outOfBoardBits[side].clear();
+            m_moduleBits[side].clear();
+            m_distSum[side].clear();
+            continue;
+        }
+
+        std::vector<uint64_t>& outBits = m_outOfBoardBits[side];
+        std::vector<uint64_t>& modBits = m_moduleBits[side];
+        std::vector<int64_t>&  sat     = m_distSum[side];
+
+        outBits.assign( bitCount, 0 );
+        modBits.assign( bitCount, 0 );
+        sat.assign( (size_t) ( m_Nrows + 1 ) * satStride, 0 );
+
+        for( int row = 0; row < m_Nrows; row++ )
+        {
+            const MATRIX_CELL* cells = m_BoardSide[side] + row * m_Ncols;
+            const DIST_CELL*   dist  = m_DistSide[side] + row * m_Ncols;
+            uint64_t*          outRow = &outBits[(size_t) row * m_wordsPerRow];
+            uint64_t*          modRow = &modBits[(size_t) row * m_wordsPerRow];
+            int64_t*           satPrev = &sat[(size_t) row * satStride];
+            int64_t*           satRow  = &sat[(size_t) ( row + 1 ) * satStride];
+            int64_t            rowSum = 0;
+
+            for( int col = 0; col < m_Ncols; col++ )
+            {
+                const uint64_t bit = uint64_t( 1 ) << ( col & 63 );
+
+                if( ( cells[col] & CELL_IS_ZONE ) == 0 )
+                    outRow[col >> 6] |= bit;
+
+                if( cells[col] & CELL_IS_MODULE )
+                    modRow[col >> 6] |= bit;
+
+                rowSum += dist[col];
+                satRow[col + 1] = satPrev[col + 1] + rowSum;
+            }
+        }
+    }
+
+    m_occupancyCacheValid = true;
+}
+
+
+static bool anyBitInRect( const std::vector<uint64_t>& aBits, int aWordsPerRow, int aRowMin,
+                          int aRowMax, int aColMin, int aColMax )
+{
+    const int      w0 = aColMin >> 6;
+    const int      w1 = aColMax >> 6;
+    const uint64_t firstMask = ~uint64_t( 0 ) << ( aColMin & 63 );
+    const uint64_t lastMask = ~uint64_t( 0 ) >> ( 63 - ( aColMax & 63 ) );
+
+    for( int row = aRowMin; row <= aRowMax; row++ )
+    {
+        const uint64_t* p = &aBits[(size_t) row * aWordsPerRow];
+
+        if( w0 == w1 )
+        {
+            if( p[w0] & firstMask & lastMask )
+                return true;
+
+            continue;
+        }
+
+        uint64_t acc = ( p[w0] & firstMask ) | ( p[w1] & lastMask );
+
+        for( int w = w0 + 1; w < w1; w++ )
+            acc |= p[w];
+
+        if( acc )
+            return true;
+    }
+
+    return false;
+}
+
+
+AR_MATRIX::OCCUPANCY AR_MATRIX::TestRectangleCells( int aRowMin, int aRowMax, int aColMin,
+                                                    int aColMax, int aSide ) const
+{
+    wxASSERT( m_occupancyCacheValid );
+
+    if( aRowMin > aRowMax || aColMin > aColMax || m_outOfBoardBits[aSide].empty() )
+        return OCC_FREE;
+
+    if( anyBitInRect( m_outOfBoardBits[aSide], m_wordsPerRow, aRowMin, aRowMax, aColMin,
+                      aColMax ) )
+        return OCC_OUT_OF_BOARD;
+
+    if( anyBitInRect( m_moduleBits[aSide], m_wordsPerRow, aRowMin, aRowMax, aColMin, aColMax ) )
+        return OCC_MODULE;
+
+    return OCC_FREE;
+}
+
+
+int64_t AR_MATRIX::SumDistRectangle( int aRowMin, int aRowMax, int aColMin, int aColMax,
+                                     int aSide ) const
+{
+    wxASSERT( m_occupancyCacheValid );
+
+    if( aRowMin > aRowMax || aColMin > aColMax || m_distSum[aSide].empty() )
+        return 0;
+
+    const std::vector<int64_t>& sat = m_distSum[aSide];
+    const size_t                stride = m_Ncols + 1;
+
+    return sat[( aRowMax + 1 ) * stride + aColMax + 1] - sat[aRowMin * stride + aColMax + 1]
+           - sat[( aRowMax + 1 ) * stride + aColMin] + sat[aRowMin * stride + aColMin];
+}
+
+
 /* return the value stored in a cell
  */
 AR_MATRIX::MATRIX_CELL AR_MATRIX::GetCell( int aRow, int aCol, int aSide )
@@ -635,12 +807,11 @@ void AR_MATRIX::traceCircle( int ux0, int uy0, int ux1, int uy1, int lg, LAYER_N
 void AR_MATRIX::traceFilledCircle(
         int cx, int cy, int radius, LSET aLayerMask, int color, AR_MATRIX::CELL_OP op_logic )
 {
-    int    row, col;
+    int    row;
     int    ux0, uy0, ux1, uy1;
     int    row_max, col_max, row_min, col_min;
     int    trace = 0;
     double fdistmin, fdistx, fdisty;
-    int    tstwrite = 0;
     int    distmin;
 
     if( aLayerMask[m_routeLayerBottom] )
@@ -691,32 +862,60 @@ void AR_MATRIX::traceFilledCircle(
     if( col_min > col_max )
         col_max = col_min;
 
-    fdistmin = (double) distmin * distmin;
-
-    for( row = row_min; row <= row_max; row++ )
+    // Cells inside the circle form a single contiguous span on each row: find its ends
+    // with the same test as a per-cell scan and write the whole span at once.
+    auto fillRows = [&]() -> bool
     {
-        fdisty = (double) ( cy - ( row * m_GridRouting ) );
-        fdisty *= fdisty;
+        bool written = false;
 
-        for( col = col_min; col <= col_max; col++ )
+        for( row = row_min; row <= row_max; row++ )
         {
-            fdistx = (double) ( cx - ( col * m_GridRouting ) );
-            fdistx *= fdistx;
+            fdisty = (double) ( cy - ( row * m_GridRouting ) );
+            fdisty *= fdisty;
+
+            if( fdistmin <= fdisty )
+                continue;
+
+            auto inside = [&]( int aCol ) -> bool
+            {
+                fdistx = (double) ( cx - ( aCol * m_GridRouting ) );
+                fdistx *= fdistx;
+                return fdistmin > ( fdistx + fdisty );
+            };
+
+            // Start from the analytic bounds widened by one cell, then narrow them with
+            // the exact test
+            double halfWidth = sqrt( fdistmin - fdisty );
+            int    first = KiROUND( ( cx - halfWidth ) / m_GridRouting ) - 1;
+            int    last = KiROUND( ( cx + halfWidth ) / m_GridRouting ) + 1;
+
+            first = std::max( col_min, first );
+            last = std::min( col_max, last );
+
+            while( first <= last && !inside( first ) )
+                first++;
 
-            if( fdistmin <= ( fdistx + fdisty ) )
+            while( last >= first && !inside( last ) )
+                last--;
+
+            if( first > last )
                 continue;
 
             if( trace & 1 )
-                WriteCell( row, col, AR_SIDE_BOTTOM, color );
+                writeCellSpan( row, first, last, AR_SIDE_BOTTOM, color );
 
             if( trace & 2 )
-                WriteCell( row, col, AR_SIDE_TOP, color );
+                writeCellSpan( row, first, last, AR_SIDE_TOP, color );
 
-            tstwrite = 1;
+            written = true;
         }
-    }
 
-    if( tstwrite )
+        return written;
+    };
+
+    fdistmin = (double) distmin * distmin;
+
+    if( fillRows() )
         return;
 
     /* If no cell has been written, it affects the 4 neighboring diagonal
@@ -725,26 +924,7 @@ void AR_MATRIX::traceFilledCircle(
     distmin = m_GridRouting / 2 + 1;
     fdistmin = ( (double) distmin * distmin ) * 2; // Distance to center point diagonally
 
-    for( row = row_min; row <= row_max; row++ )
-    {
-        fdisty = (double) ( cy - ( row * m_GridRouting ) );
-        fdisty *= fdisty;
-
-        for( col = col_min; col <= col_max; col++ )
-        {
-            fdistx = (double) ( cx - ( col * m_GridRouting ) );
-            fdistx *= fdistx;
-
-            if( fdistmin <= ( fdistx + fdisty ) )
-                continue;
-
-            if( trace & 1 )
-                WriteCell( row, col, AR_SIDE_BOTTOM, color );
-
-            if( trace & 2 )
-                WriteCell( row, col, AR_SIDE_TOP, color );
-        }
-    }
+    fillRows();
 }
 
 
@@ -933,16 +1113,16 @@ void AR_MATRIX::TraceFilledRectangle( int ux0, int uy0, int ux1, int uy1, LSET a
     if( col_max >= ( m_Ncols - 1 ) )
         col_max = m_Ncols - 1;
 
+    if( row_min > row_max || col_min > col_max )
+        return;
+
     for( row = row_min; row <= row_max; row++ )
     {
-        for( col = col_min; col <= col_max; col++ )
-        {
-            if( trace & 1 )
-                WriteCell( row, col, AR_SIDE_BOTTOM, color );
+        if( trace & 1 )
+            writeCellSpan( row, col_min, col_max, AR_SIDE_BOTTOM, color );
 
-            if( trace & 2 )
-                WriteCell( row, col, AR_SIDE_TOP, color );
-        }
+        if( trace & 2 )
+            writeCellSpan( row, col_min, col_max, AR_SIDE_TOP, color );
     }
 }
 
@@ -29,6 +29,9 @@
 #ifndef __AR_MATRIX_H
 #define __AR_MATRIX_H
 
+#include <cstdint>
+#include <vector>
+
 #include <eda_rect.h>
 #include <layers_id_colors_and_visibility.h>
 
@@ -83,6 +86,26 @@ public:
         WRITE_ADD_CELL = 4
     };
 
+    ///> Result of an occupancy test on a rectangle of cells
+    enum OCCUPANCY
+    {
+        OCC_FREE = 0,
+        OCC_OUT_OF_BOARD,   ///< at least one cell is outside the board (no CELL_IS_ZONE)
+        OCC_MODULE          ///< at least one cell is used by a footprint (CELL_IS_MODULE)
+    };
+
+private:
+    CELL_OP m_cellOp;       // the operation selected by SetCellOperation()
+
+    // Placement caches, see BuildOccupancyCache()
+    bool                  m_occupancyCacheValid;
+    int                   m_wordsPerRow;                                // uint64 words per bit row
+    std::vector<uint64_t> m_outOfBoardBits[AR_MAX_ROUTING_LAYERS_COUNT]; // 1 = no CELL_IS_ZONE
+    std::vector<uint64_t> m_moduleBits[AR_MAX_ROUTING_LAYERS_COUNT];     // 1 = CELL_IS_MODULE
+    std::vector<int64_t>  m_distSum[AR_MAX_ROUTING_LAYERS_COUNT];        // summed-area table
+
+public:
+
     AR_MATRIX();
     ~AR_MATRIX();
 
@@ -136,6 +159,35 @@ public:
     int         GetDir( int aRow, int aCol, int aSide );
     void        SetDir( int aRow, int aCol, int aSide, int aDir );
 
+    /**
+     * Function BuildOccupancyCache
+     * builds, for each allocated side, a bit-packed image of the cells outside the board
+     * and of the cells used by footprints, and a summed-area table of the distance map.
+     * These back TestRectangleCells() and SumDistRectangle(), which are read-only and can
+     * be called concurrently.  The cache must be rebuilt after the matrix is modified.
+     */
+    void BuildOccupancyCache();
+
+    void InvalidateOccupancyCache() { m_occupancyCacheValid = false; }
+    bool IsOccupancyCacheValid() const { return m_occupancyCacheValid; }
+
+    /**
+     * Function TestRectangleCells
+     * tests the cells aRowMin..aRowMax, aColMin..aColMax (inclusive, already clipped to the
+     * matrix) using whole 64-cell words.
+     * @return OCC_OUT_OF_BOARD, OCC_MODULE or OCC_FREE
+     */
+    OCCUPANCY TestRectangleCells( int aRowMin, int aRowMax, int aColMin, int aColMax,
+                                  int aSide ) const;
+
+    /**
+     * Function SumDistRectangle
+     * @return the sum of the distance cells aRowMin..aRowMax, aColMin..aColMax (inclusive,
+     * already clipped to the matrix), in constant time.
+     */
+    int64_t SumDistRectangle( int aRowMin, int aRowMax, int aColMin, int aColMax,
+                              int aSide ) const;
+
     // calculate distance (with penalty) of a trace through a cell
     int CalcDist( int x, int y, int z, int side );
 
@@ -155,6 +207,9 @@ public:
 
 private:
 
+    // Applies the current cell operation to the cells aColMin..aColMax of a row
+    void writeCellSpan( int aRow, int aColMin, int aColMax, int aSide, MATRIX_CELL aCell );
+
     void drawSegmentQcq( int ux0, int uy0, int ux1, int uy1, int lg, LAYER_NUM layer, int color,
             CELL_OP op_logic );
 
@@ -1273,8 +1273,7 @@ void ZONE_CONTAINER::TransformOutlinesShapeWithClearanceToPolygon( SHAPE_POLY_SE
         if( board )
             maxError = board->GetDesignSettings().m_MaxError;
 
-        int segCount = std::max( GetArcToSegmentCount( aClearance, maxError, 360.0 ), 3 );
-        polybuffer.Inflate( aClearance, segCount );
+        polybuffer.Inflate( aClearance, SHAPE_POLY_SET::ROUND_ALL_CORNERS, maxError );
     }
 
     polybuffer.Fracture( SHAPE_POLY_SET::PM_FAST );
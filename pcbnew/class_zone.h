@@ -729,7 +729,7 @@ public:
     /** @return the hash value previously calculated by BuildHashValue().
      * used in zone filling calculations
      */
-    MD5_HASH GetHashValue() { return m_filledPolysHash; }
+    HASH_128 GetHashValue() { return m_filledPolysHash; }
 
     /** Build the hash value of m_FilledPolysList, and store it internally
      *  in m_filledPolysHash.
@@ -843,7 +843,7 @@ protected:
      */
     SHAPE_POLY_SET        m_FilledPolysList;
     SHAPE_POLY_SET        m_RawPolysList;
-    MD5_HASH              m_filledPolysHash;    // A hash value used in zone filling calculations
+    HASH_128              m_filledPolysHash;    // A hash value used in zone filling calculations
                                                 // to see if the filled areas are up to date
 
     ZONE_HATCH_STYLE      m_hatchStyle;     // hatch style, see enum above
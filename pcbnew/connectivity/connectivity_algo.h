@@ -34,7 +34,6 @@
 #include <class_zone.h>
 
 #include <geometry/shape_poly_set.h>
-#include <geometry/poly_grid_partition.h>
 
 #include <memory>
 #include <algorithm>
@@ -36,7 +36,7 @@
 #include <class_zone.h>
 
 #include <geometry/shape_poly_set.h>
-#include <geometry/poly_grid_partition.h>
+#include <geometry/poly_edge_index.h>
 
 #include <memory>
 #include <algorithm>
@@ -356,7 +356,7 @@ public:
         outline.SetClosed( true );
         outline.Simplify();
 
-        m_cachedPoly = std::make_unique<POLY_GRID_PARTITION>( outline, 16 );
+        m_cachedPoly = std::make_unique<POLY_EDGE_INDEX>( outline );
     }
 
     int SubpolyIndex() const
@@ -373,7 +373,12 @@ public:
     {
         auto zone = static_cast<ZONE_CONTAINER*> ( Parent() );
         int clearance = zone->GetFilledPolysUseThickness() ? zone->GetMinThickness() / 2 : 0;
-        return m_cachedPoly->ContainsPoint( p, clearance );
+
+        if( m_cachedPoly->PointInside( p, 1 ) )
+            return true;
+
+        // Points on the fill outline itself count as inside, even without a clearance
+        return m_cachedPoly->CheckClearance( p, std::max( clearance, 1 ) );
     }
 
     const BOX2I& BBox()
@@ -389,7 +394,7 @@ public:
 
 private:
     std::vector<VECTOR2I> m_testOutlinePoints;
-    std::unique_ptr<POLY_GRID_PARTITION> m_cachedPoly;
+    std::unique_ptr<POLY_EDGE_INDEX> m_cachedPoly;
     int m_subpolyIndex;
 };
 
@@ -56,8 +56,7 @@ bool PANEL_MODEDIT_DISPLAY_OPTIONS::TransferDataFromWindow()
 {
     m_galOptsPanel->TransferDataFromWindow();
 
-    // refresh view
-    m_frame->GetCanvas()->GetView()->RecacheAllItems();
+    // The GAL options (grid and cursor) do not change the items, so there is nothing to recache
     m_frame->GetCanvas()->GetView()->MarkTargetDirty( KIGFX::TARGET_NONCACHED );
     m_frame->GetCanvas()->Refresh();
 
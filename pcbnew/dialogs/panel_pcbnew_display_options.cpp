@@ -90,18 +90,11 @@ bool PANEL_PCBNEW_DISPLAY_OPTIONS::TransferDataFromWindow()
 
     m_galOptsPanel->TransferDataFromWindow();
 
-    // Apply changes to the GAL
-    KIGFX::VIEW* view = m_frame->GetCanvas()->GetView();
-    KIGFX::PCB_PAINTER* painter = static_cast<KIGFX::PCB_PAINTER*>( view->GetPainter() );
-    KIGFX::PCB_RENDER_SETTINGS* settings = painter->GetSettings();
-
+    // Apply changes to the GAL, redrawing only the items affected by the changed options
     m_frame->SetDisplayOptions( displ_opts );
-    settings->LoadDisplayOptions( displ_opts, m_frame->ShowPageLimits() );
+    m_frame->GetCanvas()->GetView()->UpdateDisplayOptions( displ_opts, m_frame->ShowPageLimits() );
     m_frame->SetElementVisibility( LAYER_RATSNEST, displ_opts.m_ShowGlobalRatsnest );
 
-    view->RecacheAllItems();
-    view->MarkTargetDirty( KIGFX::TARGET_NONCACHED );
-
     return true;
 }
 
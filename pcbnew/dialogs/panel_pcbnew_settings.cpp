@@ -89,19 +89,14 @@ bool PANEL_PCBNEW_SETTINGS::TransferDataFromWindow()
     m_Frame->SetShowPageLimits( m_Show_Page_Limits->GetValue() );
 
     // Apply changes to the GAL
-    PCB_DISPLAY_OPTIONS         displ_opts = m_Frame->GetDisplayOptions();
-    KIGFX::VIEW*                view = m_Frame->GetCanvas()->GetView();
-    KIGFX::PCB_PAINTER*         painter = static_cast<KIGFX::PCB_PAINTER*>( view->GetPainter() );
-    KIGFX::PCB_RENDER_SETTINGS* settings = painter->GetSettings();
+    PCB_DISPLAY_OPTIONS displ_opts = m_Frame->GetDisplayOptions();
 
     displ_opts.m_DisplayRatsnestLinesCurved = m_OptDisplayCurvedRatsnestLines->GetValue();
     displ_opts.m_ShowGlobalRatsnest = m_showGlobalRatsnest->GetValue();
     displ_opts.m_ShowModuleRatsnest = m_showSelectedRatsnest->GetValue();
 
     m_Frame->SetDisplayOptions( displ_opts );
-    settings->LoadDisplayOptions( displ_opts, m_Frame->ShowPageLimits() );
-    view->RecacheAllItems();
-    view->MarkTargetDirty( KIGFX::TARGET_NONCACHED );
+    m_Frame->GetCanvas()->GetView()->UpdateDisplayOptions( displ_opts, m_Frame->ShowPageLimits() );
 
     m_Frame->GetCanvas()->Refresh();
 
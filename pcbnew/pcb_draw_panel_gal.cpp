@@ -117,6 +117,9 @@ PCB_DRAW_PANEL_GAL::PCB_DRAW_PANEL_GAL( wxWindow* aParentWindow, wxWindowID aWin
     m_painter = std::make_unique<KIGFX::PCB_PAINTER>( m_gal );
     m_view->SetPainter( m_painter.get() );
 
+    // Below this scale (about 0.15 mm per pixel), pads, texts and zones are drawn simplified
+    m_view->SetLODScale( 2.0 );
+
     setDefaultLayerOrder();
     setDefaultLayerDeps();
 
@@ -166,29 +169,33 @@ void PCB_DRAW_PANEL_GAL::DisplayBoard( BOARD* aBoard )
     if( m_worksheet )
         m_worksheet->SetFileName( TO_UTF8( aBoard->GetFileName() ) );
 
+    // Add all the board items at once, so each layer's R-tree is built in one go
+    std::vector<KIGFX::VIEW_ITEM*> items;
+
     // Load drawings
     for( auto drawing : const_cast<BOARD*>(aBoard)->Drawings() )
-        m_view->Add( drawing );
+        items.push_back( drawing );
 
     // Load tracks
     for( auto track : aBoard->Tracks() )
-        m_view->Add( track );
+        items.push_back( track );
 
     // Load modules and its additional elements
     for( auto module : aBoard->Modules() )
-        m_view->Add( module );
+        items.push_back( module );
 
     // DRC markers
     for( auto marker : aBoard->Markers() )
-        m_view->Add( marker );
+        items.push_back( marker );
+
+    m_view->BulkAdd( items );
 
     // Finalize the triangulation threads
     while( count_done < parallelThreadCount )
         std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
 
     // Load zones
-    for( auto zone : aBoard->Zones() )
-        m_view->Add( zone );
+    m_view->BulkAdd( std::vector<KIGFX::VIEW_ITEM*>( zones.begin(), zones.end() ) );
 
     // Ratsnest
     m_ratsnest = std::make_unique<KIGFX::RATSNEST_VIEWITEM>( aBoard->GetConnectivity() );
@@ -235,7 +242,7 @@ void PCB_DRAW_PANEL_GAL::UpdateColors()
 }
 
 
-void PCB_DRAW_PANEL_GAL::SetHighContrastLayer( PCB_LAYER_ID aLayer )
+void PCB_DRAW_PANEL_GAL::SetHighContrastLayer( PCB_LAYER_ID aLayer, bool aUpdateColors )
 {
     // Set display settings for high contrast mode
     KIGFX::RENDER_SETTINGS* rSettings = m_view->GetPainter()->GetSettings();
@@ -276,7 +283,8 @@ void PCB_DRAW_PANEL_GAL::SetHighContrastLayer( PCB_LAYER_ID aLayer )
         }
     }
 
-    m_view->UpdateAllLayersColor();
+    if( aUpdateColors )
+        m_view->UpdateAllLayersColor();
 }
 
 
@@ -440,6 +448,10 @@ bool PCB_DRAW_PANEL_GAL::SwitchBackend( GAL_TYPE aGalType )
     bool rv = EDA_DRAW_PANEL_GAL::SwitchBackend( aGalType );
     setDefaultLayerDeps();
     m_gal->SetWorldUnitLength( 1e-9 /* 1 nm */ / 0.0254 /* 1 inch in meters */ );
+
+    // Software rendering draws tiles of the screen on all the cores
+    bool tiled = m_backend == GAL_TYPE_CAIRO && std::thread::hardware_concurrency() > 1;
+    m_view->SetTileSize( tiled ? 256 : 0 );
     return rv;
 }
 
@@ -74,8 +74,9 @@ public:
         SetHighContrastLayer( static_cast< PCB_LAYER_ID >( aLayer ) );
     }
 
-    ///> SetHighContrastLayer(), with some extra smarts for PCB
-    void SetHighContrastLayer( PCB_LAYER_ID aLayer );
+    ///> SetHighContrastLayer(), with some extra smarts for PCB. aUpdateColors may be false if
+    ///> the caller updates the layer colors itself, e.g. with PCB_VIEW::UpdateDisplayOptions().
+    void SetHighContrastLayer( PCB_LAYER_ID aLayer, bool aUpdateColors = true );
 
     ///> @copydoc EDA_DRAW_PANEL_GAL::SetTopLayer()
     virtual void SetTopLayer( int aLayer ) override
@@ -41,6 +41,7 @@
 #include <settings/color_settings.h>
 
 #include <convert_basic_shapes_to_polygon.h>
+#include <fast_hash.h>
 #include <gal/graphics_abstraction_layer.h>
 #include <geometry/geometry_utils.h>
 #include <geometry/shape_line_chain.h>
@@ -48,6 +49,65 @@
 
 using namespace KIGFX;
 
+///> Zoomed out, items smaller than this many LOD tolerances (about pixels) are drawn as
+///> simple shapes
+static const double LOD_SIMPLE_SHAPE_SIZE = 8.0;
+
+
+/**
+ * Drops the vertices closer than aTolerance to the previous vertex kept, and the contours
+ * left with less than 3 vertices, for zone fills seen from afar.  The result is triangulated.
+ */
+static SHAPE_POLY_SET decimatedPolygons( const SHAPE_POLY_SET& aPolySet, double aTolerance )
+{
+    SHAPE_POLY_SET result;
+    double         minDistSq = aTolerance * aTolerance;
+
+    auto decimate = [minDistSq]( const SHAPE_LINE_CHAIN& aChain )
+    {
+        SHAPE_LINE_CHAIN chain;
+
+        for( int ii = 0; ii < aChain.PointCount(); ++ii )
+        {
+            const VECTOR2I& pt = aChain.CPoint( ii );
+
+            if( chain.PointCount() == 0
+                    || (double) ( pt - chain.CLastPoint() ).SquaredEuclideanNorm() >= minDistSq )
+            {
+                chain.Append( pt );
+            }
+        }
+
+        chain.SetClosed( true );
+        return chain;
+    };
+
+    for( int ii = 0; ii < aPolySet.OutlineCount(); ++ii )
+    {
+        SHAPE_LINE_CHAIN outline = decimate( aPolySet.COutline( ii ) );
+
+        if( outline.PointCount() < 3 )
+            continue;
+
+        result.AddOutline( outline );
+
+        for( int jj = 0; jj < aPolySet.HoleCount( ii ); ++jj )
+        {
+            SHAPE_LINE_CHAIN hole = decimate( aPolySet.CHole( ii, jj ) );
+
+            if( hole.PointCount() >= 3 )
+                result.AddHole( hole );
+        }
+    }
+
+    // Dropping vertices may have made contours cross each other
+    result.Simplify( SHAPE_POLY_SET::PM_FAST );
+    result.Fracture( SHAPE_POLY_SET::PM_FAST );
+    result.CacheTriangulation();
+
+    return result;
+}
+
 PCB_RENDER_SETTINGS::PCB_RENDER_SETTINGS()
 {
     m_backgroundColor = COLOR4D( 0.0, 0.0, 0.0, 1.0 );
@@ -216,6 +276,91 @@ void PCB_RENDER_SETTINGS::LoadDisplayOptions( const PCB_DISPLAY_OPTIONS& aOption
 }
 
 
+PCB_RENDER_SETTINGS::DISPLAY_CHANGES
+PCB_RENDER_SETTINGS::GetDisplayChanges( const PCB_RENDER_SETTINGS& aPrevious ) const
+{
+    DISPLAY_CHANGES changes;
+
+    // High-contrast mode is handled by GetColor()
+    changes.m_colors = m_hiContrastEnabled != aPrevious.m_hiContrastEnabled;
+
+    changes.m_ratsnest = m_curvedRatsnestlines != aPrevious.m_curvedRatsnestlines
+                         || m_globalRatsnestlines != aPrevious.m_globalRatsnestlines;
+
+    // Texts drawn on their own layers
+    if( m_padNumbers != aPrevious.m_padNumbers || m_netNamesOnPads != aPrevious.m_netNamesOnPads )
+    {
+        changes.m_layers.insert( LAYER_PADS_NETNAMES );
+        changes.m_layers.insert( LAYER_PAD_FR_NETNAMES );
+        changes.m_layers.insert( LAYER_PAD_BK_NETNAMES );
+    }
+
+    if( m_netNamesOnVias != aPrevious.m_netNamesOnVias )
+        changes.m_layers.insert( LAYER_VIAS_NETNAMES );
+
+    if( m_netNamesOnTracks != aPrevious.m_netNamesOnTracks )
+    {
+        for( PCB_LAYER_ID layer : LSET::AllCuMask().Seq() )
+            changes.m_layers.insert( GetNetnameLayer( layer ) );
+    }
+
+    if( m_showPageLimits != aPrevious.m_showPageLimits )
+        changes.m_layers.insert( LAYER_WORKSHEET );
+
+    // Filled or outline shapes
+    if( m_sketchMode[LAYER_PADS_TH] != aPrevious.m_sketchMode[LAYER_PADS_TH] )
+        changes.m_types.insert( PCB_PAD_T );
+
+    if( m_sketchMode[LAYER_VIA_THROUGH] != aPrevious.m_sketchMode[LAYER_VIA_THROUGH]
+            || m_sketchMode[LAYER_VIA_BBLIND] != aPrevious.m_sketchMode[LAYER_VIA_BBLIND]
+            || m_sketchMode[LAYER_VIA_MICROVIA] != aPrevious.m_sketchMode[LAYER_VIA_MICROVIA] )
+    {
+        changes.m_types.insert( PCB_VIA_T );
+    }
+
+    if( m_sketchMode[LAYER_TRACKS] != aPrevious.m_sketchMode[LAYER_TRACKS] )
+    {
+        changes.m_types.insert( PCB_TRACE_T );
+        changes.m_types.insert( PCB_ARC_T );
+    }
+
+    if( m_sketchGraphics != aPrevious.m_sketchGraphics )
+    {
+        changes.m_types.insert( PCB_LINE_T );
+        changes.m_types.insert( PCB_MODULE_EDGE_T );
+        changes.m_types.insert( PCB_DIMENSION_T );
+    }
+
+    if( m_sketchText != aPrevious.m_sketchText )
+    {
+        changes.m_types.insert( PCB_TEXT_T );
+        changes.m_types.insert( PCB_MODULE_TEXT_T );
+        changes.m_types.insert( PCB_DIMENSION_T );
+    }
+
+    if( m_displayZone != aPrevious.m_displayZone || m_zoneOutlines != aPrevious.m_zoneOutlines )
+    {
+        changes.m_types.insert( PCB_ZONE_AREA_T );
+        changes.m_types.insert( PCB_MODULE_ZONE_AREA_T );
+    }
+
+    // Clearance outlines
+    int clearanceChanges = m_clearance ^ aPrevious.m_clearance;
+
+    if( clearanceChanges & ~CL_PADS )
+    {
+        changes.m_types.insert( PCB_TRACE_T );
+        changes.m_types.insert( PCB_ARC_T );
+        changes.m_types.insert( PCB_VIA_T );
+    }
+
+    if( clearanceChanges & CL_PADS )
+        changes.m_types.insert( PCB_PAD_T );
+
+    return changes;
+}
+
+
 const COLOR4D& PCB_RENDER_SETTINGS::GetColor( const VIEW_ITEM* aItem, int aLayer ) const
 {
     int netCode = -1;
@@ -301,6 +446,42 @@ PCB_PAINTER::PCB_PAINTER( GAL* aGal ) :
 }
 
 
+PAINTER* PCB_PAINTER::Clone( GAL* aGal ) const
+{
+    PCB_PAINTER* painter = new PCB_PAINTER( *this );
+    painter->SetGAL( aGal );
+    return painter;
+}
+
+
+bool PCB_PAINTER::HasLODVariant( const VIEW_ITEM* aItem, int aLayer ) const
+{
+    const EDA_ITEM* item = dynamic_cast<const EDA_ITEM*>( aItem );
+
+    if( !item )
+        return false;
+
+    switch( item->Type() )
+    {
+    case PCB_ARC_T:
+        return IsCopperLayer( aLayer );
+
+    case PCB_PAD_T:
+        return !IsNetnameLayer( aLayer ) && aLayer != LAYER_PADS_PLATEDHOLES
+               && aLayer != LAYER_NON_PLATEDHOLES;
+
+    case PCB_TEXT_T:
+    case PCB_MODULE_TEXT_T:
+    case PCB_ZONE_AREA_T:
+    case PCB_MODULE_ZONE_AREA_T:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+
 int PCB_PAINTER::getLineThickness( int aActualThickness ) const
 {
     // if items have 0 thickness, draw them with the outline
@@ -496,6 +677,25 @@ void PCB_PAINTER::draw( const ARC* aArc, int aLayer )
         auto start_angle = DECIDEG2RAD( aArc->GetArcAngleStart() );
         auto angle = DECIDEG2RAD( aArc->GetAngle() );
 
+        if( m_lodTolerance > 0.0 )
+        {
+            // Zoomed out: a few straight segments, within the tolerance
+            int segCount = GetArcToSegmentCount( KiROUND( radius ), KiROUND( m_lodTolerance ),
+                                                 aArc->GetAngle() / 10.0 );
+            VECTOR2D prev = center + VECTOR2D( radius, 0.0 ).Rotate( start_angle );
+
+            for( int ii = 1; ii <= segCount; ++ii )
+            {
+                double   a = start_angle + angle * ii / segCount;
+                VECTOR2D next = center + VECTOR2D( radius, 0.0 ).Rotate( a );
+
+                m_gal->DrawSegment( prev, next, width );
+                prev = next;
+            }
+
+            return;
+        }
+
         m_gal->DrawArcSegment( center, radius, start_angle, start_angle + angle, width );
 
         // Clearance lines
@@ -637,7 +837,7 @@ void PCB_PAINTER::draw( const VIA* aVia, int aLayer )
     else
     {
         // Draw the outer circles of normal vias and the holes for all vias
-        m_gal->DrawCircle( center, radius );
+        drawCircleShape( center, radius, color, sketchMode );
     }
 
     // Clearance lines
@@ -845,6 +1045,16 @@ void PCB_PAINTER::draw( const D_PAD* aPad, int aLayer )
     else
     {
         SHAPE_POLY_SET polySet;
+        VECTOR2D       margin;
+        int            maxError = ARC_HIGH_DEF;
+
+        // Zoomed out, small pads are drawn as rectangles and the others with fewer segments
+        bool simplified = m_lodTolerance > 0.0 && aPad->GetShape() != PAD_SHAPE_CUSTOM
+                          && std::min( aPad->GetSize().x, aPad->GetSize().y )
+                                     < LOD_SIMPLE_SHAPE_SIZE * m_lodTolerance;
+
+        if( m_lodTolerance > 0.0 )
+            maxError = std::max( maxError, KiROUND( m_lodTolerance ) );
 
         switch( aLayer )
         {
@@ -852,7 +1062,10 @@ void PCB_PAINTER::draw( const D_PAD* aPad, int aLayer )
         case B_Mask:
             {
             int clearance = aPad->GetSolderMaskMargin();
-            aPad->TransformShapeWithClearanceToPolygon( polySet, clearance );
+            margin = VECTOR2D( clearance, clearance );
+
+            if( !simplified )
+                aPad->TransformShapeWithClearanceToPolygon( polySet, clearance, maxError );
             }
             break;
 
@@ -860,25 +1073,47 @@ void PCB_PAINTER::draw( const D_PAD* aPad, int aLayer )
         case B_Paste:
             {
             wxSize pad_size = aPad->GetSize();
-            wxSize margin = aPad->GetSolderPasteMargin();
-            const_cast<D_PAD*>(aPad)->SetSize( pad_size + margin + margin );
-            aPad->TransformShapeWithClearanceToPolygon( polySet, 0 );
-            const_cast<D_PAD*>(aPad)->SetSize( pad_size );
+            wxSize paste_margin = aPad->GetSolderPasteMargin();
+            margin = VECTOR2D( paste_margin );
+
+            if( !simplified )
+            {
+                const_cast<D_PAD*>(aPad)->SetSize( pad_size + paste_margin + paste_margin );
+                aPad->TransformShapeWithClearanceToPolygon( polySet, 0, maxError );
+                const_cast<D_PAD*>(aPad)->SetSize( pad_size );
+            }
             }
             break;
 
         default:
-            aPad->TransformShapeWithClearanceToPolygon( polySet, 0 );
+            if( !simplified )
+                aPad->TransformShapeWithClearanceToPolygon( polySet, 0, maxError );
+
             break;
         }
 
-        m_gal->DrawPolygon( polySet );
+        if( simplified )
+        {
+            VECTOR2D halfSize = VECTOR2D( aPad->GetSize() ) / 2.0 + margin;
+
+            m_gal->Save();
+            m_gal->Translate( VECTOR2D( aPad->ShapePos() ) );
+            m_gal->Rotate( -aPad->GetOrientationRadians() );
+            m_gal->DrawRectangle( -halfSize, halfSize );
+            m_gal->Restore();
+        }
+        else
+        {
+            drawPolygonShape( polySet, VECTOR2I( aPad->ShapePos() ), color,
+                              m_pcbSettings.m_sketchMode[LAYER_PADS_TH] );
+        }
     }
 
-    // Clearance lines
+    // Clearance lines (not drawn zoomed out)
     constexpr int clearanceFlags = PCB_RENDER_SETTINGS::CL_PADS;
 
     if( ( m_pcbSettings.m_clearance & clearanceFlags ) == clearanceFlags
+            && m_lodTolerance <= 0.0
             && ( aLayer == LAYER_PAD_FR
                 || aLayer == LAYER_PAD_BK
                 || aLayer == LAYER_PADS_TH ) )
@@ -997,6 +1232,116 @@ void PCB_PAINTER::draw( const DRAWSEGMENT* aSegment, int aLayer )
 }
 
 
+bool PCB_PAINTER::drawTextBar( const EDA_TEXT* aText, double aAngle, const COLOR4D& aColor )
+{
+    if( m_lodTolerance <= 0.0
+            || aText->GetTextHeight() >= LOD_SIMPLE_SHAPE_SIZE * m_lodTolerance )
+    {
+        return false;
+    }
+
+    EDA_RECT             box = aText->GetTextBox();
+    wxPoint              center = box.Centre();
+    int                  halfWidth = box.GetWidth() / 2;
+    int                  halfHeight = aText->GetTextHeight() / 4;
+    std::deque<VECTOR2D> corners;
+
+    for( const wxPoint& offset : { wxPoint( -halfWidth, -halfHeight ),
+                                   wxPoint( halfWidth, -halfHeight ),
+                                   wxPoint( halfWidth, halfHeight ),
+                                   wxPoint( -halfWidth, halfHeight ) } )
+    {
+        wxPoint corner = center + offset;
+        RotatePoint( &corner, aText->GetTextPos(), aAngle );
+        corners.emplace_back( corner );
+    }
+
+    m_gal->SetFillColor( aColor );
+    m_gal->SetIsFill( true );
+    m_gal->SetIsStroke( false );
+    m_gal->DrawPolygon( corners );
+
+    return true;
+}
+
+
+///> Kinds of shapes drawn as instances, a part of the shape keys
+enum INSTANCED_SHAPE
+{
+    INSTANCED_CIRCLE,
+    INSTANCED_POLYGONS
+};
+
+
+static uint64_t shapeKey( INSTANCED_SHAPE aShape, const HASH_128& aGeometry, bool aSketch,
+                          float aLineWidth )
+{
+    FAST_HASH hash;
+
+    hash.Add( aShape );
+    hash.Add( aGeometry.Value64[0] );
+    hash.Add( aGeometry.Value64[1] );
+    hash.Add( aSketch );
+
+    // Filled shapes don't depend on the line width
+    hash.Add( aSketch ? aLineWidth : 0.0f );
+
+    return hash.Digest64();
+}
+
+
+void PCB_PAINTER::drawCircleShape( const VECTOR2D& aCenter, double aRadius,
+                                   const COLOR4D& aColor, bool aSketch )
+{
+    if( !m_gal->IsInstancingEnabled() )
+    {
+        m_gal->DrawCircle( aCenter, aRadius );
+        return;
+    }
+
+    FAST_HASH geometry;
+    geometry.Add( aRadius );
+
+    uint64_t key = shapeKey( INSTANCED_CIRCLE, geometry.Digest128(), aSketch,
+                             m_gal->GetLineWidth() );
+
+    if( !m_gal->HasShape( key ) )
+    {
+        m_gal->BeginShape( key );
+        m_gal->DrawCircle( VECTOR2D( 0.0, 0.0 ), aRadius );
+        m_gal->EndShape();
+    }
+
+    m_gal->DrawShape( key, aCenter, aColor );
+}
+
+
+void PCB_PAINTER::drawPolygonShape( SHAPE_POLY_SET& aPolySet, const VECTOR2I& aOrigin,
+                                    const COLOR4D& aColor, bool aSketch )
+{
+    if( !m_gal->IsInstancingEnabled() )
+    {
+        m_gal->DrawPolygon( aPolySet );
+        return;
+    }
+
+    // Identical pads of all the footprints share their shape, unless rotated differently
+    aPolySet.Move( -aOrigin );
+
+    uint64_t key = shapeKey( INSTANCED_POLYGONS, aPolySet.GetHash(), aSketch,
+                             m_gal->GetLineWidth() );
+
+    if( !m_gal->HasShape( key ) )
+    {
+        m_gal->BeginShape( key );
+        m_gal->DrawPolygon( aPolySet );
+        m_gal->EndShape();
+    }
+
+    m_gal->DrawShape( key, VECTOR2D( aOrigin ), aColor );
+}
+
+
 void PCB_PAINTER::draw( const TEXTE_PCB* aText, int aLayer )
 {
     wxString shownText( aText->GetShownText() );
@@ -1018,6 +1363,9 @@ void PCB_PAINTER::draw( const TEXTE_PCB* aText, int aLayer )
         m_gal->SetLineWidth( getLineThickness( aText->GetEffectiveTextPenWidth() ) );
     }
 
+    if( drawTextBar( aText, aText->GetTextAngle(), color ) )
+        return;
+
     m_gal->SetStrokeColor( color );
     m_gal->SetIsFill( false );
     m_gal->SetIsStroke( true );
@@ -1047,6 +1395,9 @@ void PCB_PAINTER::draw( const TEXTE_MODULE* aText, int aLayer )
         m_gal->SetLineWidth( getLineThickness( aText->GetEffectiveTextPenWidth() ) );
     }
 
+    if( drawTextBar( aText, aText->GetDrawRotation(), color ) )
+        return;
+
     m_gal->SetStrokeColor( color );
     m_gal->SetIsFill( false );
     m_gal->SetIsStroke( true );
@@ -1149,6 +1500,16 @@ void PCB_PAINTER::draw( const ZONE_CONTAINER* aZone, int aLayer )
             m_gal->SetIsStroke( true );
         }
 
+        if( m_lodTolerance > 0.0 )
+        {
+            // Zoomed out: the outline thickness is below the tolerance, and so are the
+            // vertices dropped from the fill
+            m_gal->SetIsStroke( displayMode == PCB_RENDER_SETTINGS::DZ_SHOW_OUTLINED );
+            m_gal->SetLineWidth( m_pcbSettings.m_outlineWidth );
+            m_gal->DrawPolygon( decimatedPolygons( polySet, m_lodTolerance ) );
+            return;
+        }
+
         m_gal->DrawPolygon( polySet );
     }
 
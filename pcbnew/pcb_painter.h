@@ -28,11 +28,14 @@
 #define __CLASS_PCB_PAINTER_H
 
 #include <painter.h>
+#include <core/typeinfo.h>
 
 #include <memory>
+#include <set>
 
 
 class EDA_ITEM;
+class EDA_TEXT;
 class PCB_DISPLAY_OPTIONS;
 class BOARD_ITEM;
 class ARC;
@@ -48,6 +51,7 @@ class TEXTE_MODULE;
 class DIMENSION;
 class PCB_TARGET;
 class MARKER_PCB;
+class SHAPE_POLY_SET;
 
 namespace KIGFX
 {
@@ -96,6 +100,29 @@ public:
      */
     void LoadDisplayOptions( const PCB_DISPLAY_OPTIONS& aOptions, bool aShowPageLimits );
 
+    ///> What has to be redrawn after the display options have changed
+    struct DISPLAY_CHANGES
+    {
+        DISPLAY_CHANGES() :
+            m_colors( false ),
+            m_ratsnest( false )
+        {}
+
+        bool              m_colors;     ///< Only the item colors (e.g. high-contrast mode)
+        bool              m_ratsnest;   ///< The ratsnest, which is not cached
+        std::set<int>     m_layers;     ///< Layers whose items have to be redrawn on them
+        std::set<KICAD_T> m_types;      ///< Item types that have to be redrawn on all layers
+    };
+
+    /**
+     * Function GetDisplayChanges
+     * Classifies the differences between the current settings and the ones used before
+     * LoadDisplayOptions(), so the view can update only the colors, layers or items affected
+     * instead of recaching everything.
+     * @param aPrevious are the settings before the display options were loaded.
+     */
+    DISPLAY_CHANGES GetDisplayChanges( const PCB_RENDER_SETTINGS& aPrevious ) const;
+
     virtual void LoadColors( const COLOR_SETTINGS* aSettings ) override;
 
     /// @copydoc RENDER_SETTINGS::GetColor()
@@ -237,6 +264,12 @@ public:
     /// @copydoc PAINTER::Draw()
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) override;
 
+    /// @copydoc PAINTER::Clone()
+    virtual PAINTER* Clone( GAL* aGal ) const override;
+
+    /// @copydoc PAINTER::HasLODVariant()
+    virtual bool HasLODVariant( const VIEW_ITEM* aItem, int aLayer ) const override;
+
 protected:
     PCB_RENDER_SETTINGS m_pcbSettings;
 
@@ -254,6 +287,35 @@ protected:
     void draw( const PCB_TARGET* aTarget );
     void draw( const MARKER_PCB* aMarker );
 
+    /**
+     * Function drawTextBar()
+     * Draws a text as a bar over its glyphs when zoomed out, if they are too small to read.
+     * @param aAngle is the text orientation in tenths of degree.
+     * @return false if the text must be drawn normally.
+     */
+    bool drawTextBar( const EDA_TEXT* aText, double aAngle, const COLOR4D& aColor );
+
+    /**
+     * Function drawCircleShape()
+     * Draws a circle with the current fill, stroke and line width settings.  If the GAL
+     * supports it, the circle is an instance of a shape shared by all the identical circles.
+     * @param aSketch tells if the circle is stroked rather than filled.
+     */
+    void drawCircleShape( const VECTOR2D& aCenter, double aRadius, const COLOR4D& aColor,
+                          bool aSketch );
+
+    /**
+     * Function drawPolygonShape()
+     * Draws a polygon set with the current fill, stroke and line width settings.  If the GAL
+     * supports it, the polygon set is an instance of a shape shared by all the sets having the
+     * same outlines around their origin.
+     * @param aPolySet is the polygon set, it may be moved to aOrigin.
+     * @param aOrigin is the point the outlines are compared around (e.g. the pad center).
+     * @param aSketch tells if the outlines are stroked rather than filled.
+     */
+    void drawPolygonShape( SHAPE_POLY_SET& aPolySet, const VECTOR2I& aOrigin,
+                           const COLOR4D& aColor, bool aSketch );
+
     /**
      * Function getLineThickness()
      * Get the thickness to draw for a line (e.g. 0 thickness lines
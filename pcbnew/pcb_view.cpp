@@ -55,6 +55,33 @@ PCB_VIEW::~PCB_VIEW()
 }
 
 
+///> Returns aItems with the children of modules inserted before their parents, as
+///> PCB_VIEW::Add() adds them
+static std::vector<VIEW_ITEM*> withModuleChildren( const std::vector<VIEW_ITEM*>& aItems )
+{
+    std::vector<VIEW_ITEM*> items;
+
+    items.reserve( aItems.size() );
+
+    for( VIEW_ITEM* viewItem : aItems )
+    {
+        auto item = static_cast<BOARD_ITEM*>( viewItem );
+
+        if( item->Type() == PCB_MODULE_T )
+        {
+            auto mod = static_cast<MODULE*>( item );
+            mod->RunOnChildren([&items] ( BOARD_ITEM* aModItem ) {
+                    items.push_back( aModItem );
+                } );
+        }
+
+        items.push_back( item );
+    }
+
+    return items;
+}
+
+
 void PCB_VIEW::Add( KIGFX::VIEW_ITEM* aItem, int aDrawPriority )
 {
     auto item = static_cast<BOARD_ITEM*>( aItem );
@@ -75,16 +102,23 @@ void PCB_VIEW::Remove( KIGFX::VIEW_ITEM* aItem )
 {
     auto item = static_cast<BOARD_ITEM*>( aItem );
 
-
+    // Removing the children one by one would search all the view items for each of them
     if( item->Type() == PCB_MODULE_T )
-    {
-        auto mod = static_cast<MODULE*>( item );
-        mod->RunOnChildren([this] ( BOARD_ITEM* aModItem ) {
-                VIEW::Remove( aModItem );
-            } );
-    }
+        VIEW::BulkRemove( withModuleChildren( { aItem } ) );
+    else
+        VIEW::Remove( item );
+}
+
+
+void PCB_VIEW::BulkAdd( const std::vector<KIGFX::VIEW_ITEM*>& aItems )
+{
+    VIEW::BulkAdd( withModuleChildren( aItems ) );
+}
+
 
-    VIEW::Remove( item );
+void PCB_VIEW::BulkRemove( const std::vector<KIGFX::VIEW_ITEM*>& aItems )
+{
+    VIEW::BulkRemove( withModuleChildren( aItems ) );
 }
 
 
@@ -115,6 +149,40 @@ void PCB_VIEW::UpdateDisplayOptions( const PCB_DISPLAY_OPTIONS& aOptions )
     auto    painter     = static_cast<KIGFX::PCB_PAINTER*>( GetPainter() );
     auto    settings    = static_cast<KIGFX::PCB_RENDER_SETTINGS*>( painter->GetSettings() );
 
-    settings->LoadDisplayOptions( aOptions, settings->GetShowPageLimits() );
+    UpdateDisplayOptions( aOptions, settings->GetShowPageLimits() );
+}
+
+
+void PCB_VIEW::UpdateDisplayOptions( const PCB_DISPLAY_OPTIONS& aOptions, bool aShowPageLimits )
+{
+    auto    painter     = static_cast<KIGFX::PCB_PAINTER*>( GetPainter() );
+    auto    settings    = static_cast<KIGFX::PCB_RENDER_SETTINGS*>( painter->GetSettings() );
+
+    const PCB_RENDER_SETTINGS previous( *settings );
+
+    settings->LoadDisplayOptions( aOptions, aShowPageLimits );
+
+    const PCB_RENDER_SETTINGS::DISPLAY_CHANGES changes = settings->GetDisplayChanges( previous );
+
+    if( changes.m_colors )
+        UpdateAllLayersColor();
+
+    if( changes.m_ratsnest )
+        MarkTargetDirty( TARGET_NONCACHED );
+
+    for( int layer : changes.m_layers )
+        RecacheLayer( layer );
+
+    // Items keep their bounding boxes, they only have to be redrawn
+    if( !changes.m_types.empty() )
+    {
+        UpdateAllItemsConditionally( REPAINT,
+                [&changes]( VIEW_ITEM* aItem ) -> bool
+                {
+                    EDA_ITEM* item = dynamic_cast<EDA_ITEM*>( aItem );
+
+                    return item && changes.m_types.count( item->Type() );
+                } );
+    }
 }
 }
@@ -45,6 +45,12 @@ public:
 
     virtual void Remove( VIEW_ITEM* aItem ) override;
 
+    /// @copydoc VIEW::BulkAdd()
+    virtual void BulkAdd( const std::vector<VIEW_ITEM*>& aItems ) override;
+
+    /// @copydoc VIEW::BulkRemove()
+    virtual void BulkRemove( const std::vector<VIEW_ITEM*>& aItems ) override;
+
     /// @copydoc VIEW::Update()
     virtual void Update( VIEW_ITEM* aItem, int aUpdateFlags ) override;
 
@@ -52,6 +58,16 @@ public:
     virtual void Update( VIEW_ITEM* aItem ) override;
 
     void UpdateDisplayOptions( const PCB_DISPLAY_OPTIONS& aOptions );
+
+    /**
+     * Function UpdateDisplayOptions()
+     * Loads new display options and updates only what they affect: colors for high-contrast
+     * mode, the net name layers for net names, and only the item types whose shapes depend on
+     * a changed option otherwise.
+     * @param aOptions are the new display options.
+     * @param aShowPageLimits decides if the page limits are drawn.
+     */
+    void UpdateDisplayOptions( const PCB_DISPLAY_OPTIONS& aOptions, bool aShowPageLimits );
 };
 
 }
@@ -24,6 +24,8 @@
 #include "class_draw_panel_gal.h"
 #include "class_board.h"
 
+#include <class_track.h>
+#include <confirm.h>
 #include <pcb_edit_frame.h>
 #include <pcbnew_id.h>
 #include <view/view_controls.h>
@@ -33,6 +35,8 @@
 #include <tool/action_menu.h>
 #include <tool/tool_manager.h>
 #include <tools/pcb_actions.h>
+#include <tools/selection_tool.h>
+#include <widgets/progress_reporter.h>
 #include "pns_segment.h"
 #include "pns_router.h"
 #include "pns_meander_placer.h" // fixme: move settings to separate header
@@ -256,6 +260,7 @@ void LENGTH_TUNER_TOOL::setTransitions()
     Go( &LENGTH_TUNER_TOOL::MainLoop, PCB_ACTIONS::routerTuneSingleTrace.MakeEvent() );
     Go( &LENGTH_TUNER_TOOL::MainLoop, PCB_ACTIONS::routerTuneDiffPair.MakeEvent() );
     Go( &LENGTH_TUNER_TOOL::MainLoop, PCB_ACTIONS::routerTuneDiffPairSkew.MakeEvent() );
+    Go( &LENGTH_TUNER_TOOL::TuneSelected, PCB_ACTIONS::routerTuneSelected.MakeEvent() );
 }
 
 
@@ -311,6 +316,98 @@ int LENGTH_TUNER_TOOL::MainLoop( const TOOL_EVENT& aEvent )
     return 0;
 }
 
+int LENGTH_TUNER_TOOL::TuneSelected( const TOOL_EVENT& aEvent )
+{
+    if( m_router->RoutingInProgress() )
+        return 0;
+
+    // Each selected net is meandered along its longest selected segment
+    std::map<int, TRACK*> tuneSegments;
+
+    for( EDA_ITEM* item : m_toolMgr->GetTool<SELECTION_TOOL>()->GetSelection() )
+    {
+        if( item->Type() != PCB_TRACE_T )
+            continue;
+
+        TRACK* track = static_cast<TRACK*>( item );
+
+        if( track->GetNetCode() <= 0 )
+            continue;
+
+        TRACK*& longest = tuneSegments[track->GetNetCode()];
+
+        if( !longest || track->GetLength() > longest->GetLength() )
+            longest = track;
+    }
+
+    if( tuneSegments.empty() )
+    {
+        DisplayInfoMessage( frame(), _( "Select the tracks to tune first." ) );
+        return 0;
+    }
+
+    m_toolMgr->RunAction( PCB_ACTIONS::selectionClear, true );
+
+    m_router->SyncWorld();
+    m_router->SetMode( PNS::PNS_MODE_TUNE_SINGLE );
+
+    WX_PROGRESS_REPORTER reporter( frame(), _( "Tune Track Lengths" ), 1 );
+    reporter.SetMaxProgress( (int) tuneSegments.size() );
+
+    int      tuned = 0;
+    wxString details;
+
+    // The nets are tuned one after another: every net is committed to the router world
+    // before the next one starts, so later meanders avoid the earlier ones.
+    frame()->UndoRedoBlock( true );
+
+    for( const auto& entry : tuneSegments )
+    {
+        TRACK*      track = entry.second;
+        PNS::ITEM*  startItem = m_router->GetWorld()->FindItemByParent( track );
+        wxString    netName = track->GetNetname();
+
+        reporter.Report( wxString::Format( _( "Tuning %s" ), netName ) );
+
+        if( startItem && m_router->StartRouting( track->GetStart(), startItem, 0 ) )
+        {
+            auto placer = static_cast<PNS::MEANDER_PLACER_BASE*>( m_router->Placer() );
+
+            placer->UpdateSettings( m_savedMeanderSettings );
+            m_router->Move( track->GetEnd(), NULL );
+
+            if( placer->TuningStatus() == PNS::MEANDER_PLACER_BASE::TUNED )
+                tuned++;
+            else
+                details += netName + wxT( ": " ) + placer->TuningInfo( frame()->GetUserUnits() )
+                           + wxT( "\n" );
+
+            m_router->FixRoute( track->GetEnd(), NULL );
+            m_router->StopRouting();
+        }
+        else
+        {
+            details += netName + wxT( ": " ) + m_router->FailureReason() + wxT( "\n" );
+        }
+
+        reporter.AdvanceProgress();
+
+        if( !reporter.KeepRefreshing() )
+            break;
+    }
+
+    frame()->UndoRedoBlock( false );
+
+    DisplayInfoMessage( frame(), wxString::Format( _( "%d of %d nets tuned to target length." ),
+                                                   tuned, (int) tuneSegments.size() ),
+                        details );
+
+    canvas()->Refresh();
+
+    return 0;
+}
+
+
 int LENGTH_TUNER_TOOL::meanderSettingsDialog( const TOOL_EVENT& aEvent )
 {
     PNS::MEANDER_PLACER_BASE* placer = static_cast<PNS::MEANDER_PLACER_BASE*>( m_router->Placer() );
@@ -38,6 +38,9 @@ public:
 
     int MainLoop( const TOOL_EVENT& aEvent );
 
+    ///> Meanders every selected net to the target length of the saved tuning settings
+    int TuneSelected( const TOOL_EVENT& aEvent );
+
     void setTransitions() override;
 
 private:
@@ -0,0 +1,517 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+#include <wx/intl.h>
+
+#include <profile.h>
+#include <board_connected_item.h>
+#include <widgets/progress_reporter.h>
+
+#include "pns_batch_router.h"
+#include "pns_router.h"
+#include "pns_node.h"
+#include "pns_item.h"
+#include "pns_placement_algo.h"
+
+namespace PNS {
+
+/**
+ * Sits between the ROUTER and the host interface while a batch is running.  Board
+ * additions are held back until the batch is done, so that connections ripped up by
+ * later passes never reach the BOARD_COMMIT, and so the host sees a single commit.
+ */
+class BATCH_ROUTER::IFACE_PROXY : public ROUTER_IFACE
+{
+public:
+    IFACE_PROXY( ROUTER_IFACE* aHost ) :
+        m_host( aHost ),
+        m_serial( 0 ),
+        m_removedCount( 0 )
+    {}
+
+    void SetRouter( ROUTER* aRouter ) override { m_host->SetRouter( aRouter ); }
+    void SyncWorld( NODE* aNode ) override { m_host->SyncWorld( aNode ); }
+
+    void AddItem( ITEM* aItem ) override
+    {
+        m_added[ aItem ] = m_serial++;
+    }
+
+    void RemoveItem( ITEM* aItem ) override
+    {
+        // Items created by this batch never made it to the host, so just forget about them
+        if( m_added.erase( aItem ) )
+            return;
+
+        // Removing a pre-existing item (e.g. a shoved track): pass it on, and remember the
+        // net so we never rip it up afterwards and delete the user's copper with it.
+        m_touchedNets.insert( aItem->Net() );
+        m_host->RemoveItem( aItem );
+        m_removedCount++;
+    }
+
+    bool IsAnyLayerVisible( const LAYER_RANGE& aLayer ) override
+    {
+        return m_host->IsAnyLayerVisible( aLayer );
+    }
+
+    bool IsItemVisible( const ITEM* aItem ) override { return m_host->IsItemVisible( aItem ); }
+
+    // No previews while batch routing
+    void DisplayItem( const ITEM* aItem, int aColor, int aClearance, bool aEdit ) override {}
+    void HideItem( ITEM* aItem ) override {}
+    void EraseView() override {}
+    void Commit() override {}
+
+    void UpdateNet( int aNetCode ) override { m_updatedNets.insert( aNetCode ); }
+
+    RULE_RESOLVER* GetRuleResolver() override { return m_host->GetRuleResolver(); }
+    DEBUG_DECORATOR* GetDebugDecorator() override { return m_host->GetDebugDecorator(); }
+
+    const std::vector<ITEM*> AddedItems() const
+    {
+        std::vector<std::pair<int, ITEM*>> ordered;
+
+        for( const auto& ent : m_added )
+            ordered.emplace_back( ent.second, ent.first );
+
+        std::sort( ordered.begin(), ordered.end() );
+
+        std::vector<ITEM*> rv;
+
+        for( const auto& ent : ordered )
+            rv.push_back( ent.second );
+
+        return rv;
+    }
+
+    bool IsTouched( int aNet ) const { return m_touchedNets.count( aNet ) > 0; }
+
+    bool Flush()
+    {
+        if( m_added.empty() && !m_removedCount )
+            return false;
+
+        for( ITEM* item : AddedItems() )
+            m_host->AddItem( item );
+
+        m_host->Commit();
+
+        for( int net : m_updatedNets )
+            m_host->UpdateNet( net );
+
+        m_added.clear();
+        return true;
+    }
+
+private:
+    ROUTER_IFACE*                  m_host;
+    std::unordered_map<ITEM*, int> m_added;
+    std::set<int>                  m_touchedNets;
+    std::set<int>                  m_updatedNets;
+    int                            m_serial;
+    int                            m_removedCount;
+};
+
+
+int BATCH_ROUTER::REPORT::Count( STATUS aStatus ) const
+{
+    return std::count_if( m_connections.begin(), m_connections.end(),
+                          [aStatus]( const CONNECTION& c ) { return c.m_status == aStatus; } );
+}
+
+
+double BATCH_ROUTER::REPORT::Completion() const
+{
+    if( m_connections.empty() )
+        return 1.0;
+
+    return (double) Count( BR_ROUTED ) / (double) m_connections.size();
+}
+
+
+const wxString BATCH_ROUTER::REPORT::Format() const
+{
+    wxString msg = wxString::Format( _( "Routed %d of %d connections (%.1f%%) in %d pass(es), "
+                                        "%.2f s." ),
+                                     Count( BR_ROUTED ), Total(), Completion() * 100.0,
+                                     m_passes, m_totalTimeMs / 1000.0 );
+
+    if( m_cancelled )
+        msg += wxT( " " ) + _( "Cancelled by user." );
+
+    for( const CONNECTION& conn : m_connections )
+    {
+        wxString reason;
+
+        switch( conn.m_status )
+        {
+        case BR_ROUTED:           continue;
+        case BR_PENDING:          reason = _( "not attempted" );                  break;
+        case BR_FAILED:           reason = _( "no path found" );                  break;
+        case BR_TIMEOUT:          reason = _( "net time budget exceeded" );       break;
+        case BR_NO_COMMON_LAYER:  reason = _( "endpoints share no routing layer" ); break;
+        }
+
+        msg += wxString::Format( wxT( "\n%s: %s (%d attempts, %d rip-ups, %lld ms)" ),
+                                 conn.m_netName, reason, conn.m_attempts, conn.m_ripups,
+                                 (long long) conn.m_timeMs );
+    }
+
+    return msg;
+}
+
+
+BATCH_ROUTER::BATCH_ROUTER( ROUTER* aRouter ) :
+    ALGO_BASE( aRouter ),
+    m_netTimeBudget( 2000 ),
+    m_maxRipupPasses( 3 ),
+    m_maxRipupsPerConnection( 2 ),
+    m_proxy( nullptr ),
+    m_progressReporter( nullptr )
+{
+}
+
+
+BATCH_ROUTER::~BATCH_ROUTER()
+{
+}
+
+
+void BATCH_ROUTER::AddConnection( const CONNECTION& aConnection )
+{
+    m_connections.push_back( aConnection );
+}
+
+
+void BATCH_ROUTER::ClearConnections()
+{
+    m_connections.clear();
+    m_netTimeSpent.clear();
+}
+
+
+ITEM* BATCH_ROUTER::findAnchor( BOARD_CONNECTED_ITEM* aParent, int aNet,
+                                const VECTOR2I& aPos ) const
+{
+    NODE* world = Router()->GetWorld();
+
+    if( aParent )
+    {
+        ITEM* item = world->FindItemByParent( aParent );
+
+        if( item && item->Net() == aNet )
+            return item;
+    }
+
+    for( ITEM* item : world->HitTest( aPos ).Items() )
+    {
+        if( item->IsRoutable() && item->Net() == aNet
+                && item->OfKind( ITEM::SOLID_T | ITEM::VIA_T | ITEM::SEGMENT_T | ITEM::ARC_T ) )
+            return item;
+    }
+
+    return nullptr;
+}
+
+
+const std::vector<int> BATCH_ROUTER::candidateLayers( const ITEM* aFrom, const ITEM* aTo ) const
+{
+    std::vector<int> layers;
+
+    for( int layer : m_routingLayers )
+    {
+        if( aFrom->Layers().Overlaps( layer ) && aTo->Layers().Overlaps( layer ) )
+            layers.push_back( layer );
+    }
+
+    return layers;
+}
+
+
+bool BATCH_ROUTER::routeOnLayer( CONNECTION& aConn, ITEM* aFrom, ITEM* aTo, const VECTOR2I& aP0,
+                                 const VECTOR2I& aP1, int aLayer )
+{
+    ROUTER* router = Router();
+
+    aConn.m_attempts++;
+
+    router->SetMode( PNS_MODE_ROUTE_SINGLE );
+
+    if( !router->StartRouting( aP0, aFrom, aLayer ) )
+        return false;
+
+    router->Move( aP1, aTo );
+
+    // Walkaround/shove give up by stopping the head short of the target
+    PLACEMENT_ALGO* placer = router->Placer();
+
+    if( !placer || placer->CurrentEnd() != aP1 || !router->FixRoute( aP1, aTo, true ) )
+    {
+        router->StopRouting();
+        return false;
+    }
+
+    router->CommitRouting();
+    aConn.m_layer = aLayer;
+
+    return true;
+}
+
+
+bool BATCH_ROUTER::routeConnection( int aIndex )
+{
+    CONNECTION& conn = m_connections[ aIndex ];
+    int64_t&    spent = m_netTimeSpent[ conn.m_net ];
+
+    if( m_netTimeBudget > 0 && spent >= m_netTimeBudget )
+    {
+        conn.m_status = BR_TIMEOUT;
+        return false;
+    }
+
+    PROF_COUNTER timer;
+
+    ITEM* from = findAnchor( conn.m_startParent, conn.m_net, conn.m_start );
+    ITEM* to = findAnchor( conn.m_endParent, conn.m_net, conn.m_end );
+
+    if( !from || !to )
+    {
+        conn.m_status = BR_FAILED;
+        return false;
+    }
+
+    std::vector<int> layers = candidateLayers( from, to );
+
+    if( layers.empty() )
+    {
+        conn.m_status = BR_NO_COMMON_LAYER;
+        return false;
+    }
+
+    Router()->UpdateSizes( conn.m_sizes );
+
+    bool routed = false;
+    bool expired = false;
+
+    for( int layer : layers )
+    {
+        // Try both directions: walkaround is not symmetric, so approaching from the
+        // other end often finds a path around an obstacle cluster.
+        routed = routeOnLayer( conn, from, to, conn.m_start, conn.m_end, layer )
+                 || routeOnLayer( conn, to, from, conn.m_end, conn.m_start, layer );
+
+        expired = m_netTimeBudget > 0 && spent + timer.msecs() >= m_netTimeBudget;
+
+        if( routed || expired )
+            break;
+    }
+
+    timer.Stop();
+    spent += (int64_t) timer.msecs();
+    conn.m_timeMs += (int64_t) timer.msecs();
+
+    if( routed )
+        conn.m_status = BR_ROUTED;
+    else
+        conn.m_status = expired ? BR_TIMEOUT : BR_FAILED;
+
+    return routed;
+}
+
+
+bool BATCH_ROUTER::isRippable( int aNet ) const
+{
+    if( m_proxy->IsTouched( aNet ) )
+        return false;
+
+    for( const CONNECTION& conn : m_connections )
+    {
+        if( conn.m_net == aNet && conn.m_ripups >= m_maxRipupsPerConnection )
+            return false;
+    }
+
+    return true;
+}
+
+
+void BATCH_ROUTER::ripupNet( int aNet )
+{
+    NODE* branch = Router()->GetWorld()->Branch();
+
+    for( ITEM* item : m_proxy->AddedItems() )
+    {
+        if( item->Net() == aNet )
+            branch->Remove( item );
+    }
+
+    Router()->CommitRouting( branch );
+
+    for( CONNECTION& conn : m_connections )
+    {
+        if( conn.m_net == aNet && conn.m_status == BR_ROUTED )
+        {
+            conn.m_status = BR_PENDING;
+            conn.m_ripups++;
+        }
+    }
+}
+
+
+int BATCH_ROUTER::ripupBlockers( int aIndex )
+{
+    const CONNECTION& conn = m_connections[ aIndex ];
+    const SEG         corridor( conn.m_start, conn.m_end );
+    const int         clearance = conn.m_sizes.TrackWidth() / 2
+                                  + Router()->GetRuleResolver()->Clearance( conn.m_net );
+    std::set<int>     blockingNets;
+
+    for( ITEM* item : m_proxy->AddedItems() )
+    {
+        if( item->Net() == conn.m_net || blockingNets.count( item->Net() ) )
+            continue;
+
+        if( item->Shape() && item->Shape()->Collide( corridor, clearance ) )
+            blockingNets.insert( item->Net() );
+    }
+
+    int count = 0;
+
+    for( int net : blockingNets )
+    {
+        if( isRippable( net ) )
+        {
+            ripupNet( net );
+            count++;
+        }
+    }
+
+    return count;
+}
+
+
+bool BATCH_ROUTER::Run()
+{
+    PROF_COUNTER totalTimer;
+
+    m_report = REPORT();
+    m_netTimeSpent.clear();
+
+    if( m_connections.empty() )
+        return false;
+
+    ROUTER*       router = Router();
+    ROUTER_IFACE* host = router->GetInterface();
+    IFACE_PROXY   proxy( host );
+
+    m_proxy = &proxy;
+    router->SetInterface( &proxy );
+
+    for( CONNECTION& conn : m_connections )
+    {
+        conn.m_netName = router->GetRuleResolver()->NetName( conn.m_net );
+        conn.m_status = BR_PENDING;
+    }
+
+    // Most critical first, then shortest: short connections are the least flexible
+    // and the cheapest to route, and they leave long ones a better picture of the board.
+    std::vector<int> queue( m_connections.size() );
+    std::iota( queue.begin(), queue.end(), 0 );
+
+    std::stable_sort( queue.begin(), queue.end(),
+            [this]( int a, int b )
+            {
+                const CONNECTION& ca = m_connections[a];
+                const CONNECTION& cb = m_connections[b];
+
+                if( ca.m_priority != cb.m_priority )
+                    return ca.m_priority > cb.m_priority;
+
+                return ca.Length() < cb.Length();
+            } );
+
+    if( m_progressReporter )
+        m_progressReporter->SetMaxProgress( (int) queue.size() * ( m_maxRipupPasses + 1 ) );
+
+    for( int pass = 0; pass <= m_maxRipupPasses && !queue.empty(); pass++ )
+    {
+        std::vector<int> failed;
+
+        m_report.m_passes = pass + 1;
+
+        for( int idx : queue )
+        {
+            if( m_progressReporter )
+            {
+                m_progressReporter->AdvanceProgress();
+
+                if( !m_progressReporter->KeepRefreshing() )
+                {
+                    m_report.m_cancelled = true;
+                    break;
+                }
+            }
+
+            if( m_connections[idx].m_status == BR_ROUTED )
+                continue;
+
+            if( !routeConnection( idx ) && m_connections[idx].m_status == BR_FAILED )
+                failed.push_back( idx );
+        }
+
+        if( m_report.m_cancelled || failed.empty() || pass == m_maxRipupPasses )
+            break;
+
+        // Rip up whatever the batch has put in the way of the failed connections, then
+        // retry the failed ones first and the ripped-up ones after them.
+        int ripped = 0;
+
+        for( int idx : failed )
+            ripped += ripupBlockers( idx );
+
+        if( !ripped )
+            break;
+
+        queue = failed;
+
+        for( int idx = 0; idx < (int) m_connections.size(); idx++ )
+        {
+            if( m_connections[idx].m_status == BR_PENDING )
+                queue.push_back( idx );
+        }
+    }
+
+    router->SetInterface( host );
+    m_proxy = nullptr;
+
+    proxy.Flush();
+
+    totalTimer.Stop();
+
+    m_report.m_connections = m_connections;
+    m_report.m_totalTimeMs = (int64_t) totalTimer.msecs();
+
+    return m_report.Count( BR_ROUTED ) > 0;
+}
+
+}
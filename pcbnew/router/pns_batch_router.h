@@ -0,0 +1,169 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PNS_BATCH_ROUTER_H
+#define __PNS_BATCH_ROUTER_H
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include <wx/string.h>
+
+#include <math/vector2d.h>
+
+#include "pns_algo_base.h"
+#include "pns_sizes_settings.h"
+
+class BOARD_CONNECTED_ITEM;
+class PROGRESS_REPORTER;
+
+namespace PNS {
+
+class ROUTER;
+class ROUTER_IFACE;
+class ITEM;
+
+/**
+ * BATCH_ROUTER
+ *
+ * Routes a list of unrouted connections (typically the ratsnest edges reported by
+ * CONNECTIVITY_DATA) without user interaction, driving the regular LINE_PLACER through
+ * the ROUTER in the currently selected mode (walkaround or shove).
+ *
+ * Connections are routed shortest/most critical first.  A connection that cannot be
+ * completed causes the nets of previously batch-routed connections crossing its
+ * straight-line corridor to be ripped up and re-queued, up to a configurable number of
+ * passes.  Each net gets a wall-clock budget shared by all of its connections.
+ *
+ * Nothing is pushed to the host interface until Run() finishes: all surviving items are
+ * handed to the ROUTER_IFACE in one go, so the PCB interface produces a single BOARD_COMMIT.
+ */
+class BATCH_ROUTER : public ALGO_BASE
+{
+public:
+    enum STATUS
+    {
+        BR_PENDING = 0,
+        BR_ROUTED,
+        BR_FAILED,          ///< no path found within the attempts allowed
+        BR_TIMEOUT,         ///< net time budget exhausted
+        BR_NO_COMMON_LAYER  ///< endpoints share no routing layer (would need a via)
+    };
+
+    ///> A single point-to-point connection to route
+    struct CONNECTION
+    {
+        int                   m_net = -1;
+        BOARD_CONNECTED_ITEM* m_startParent = nullptr;
+        BOARD_CONNECTED_ITEM* m_endParent = nullptr;
+        VECTOR2I              m_start;
+        VECTOR2I              m_end;
+        int                   m_priority = 0;    ///< higher values are routed first
+        SIZES_SETTINGS        m_sizes;
+
+        // Filled in by the router
+        wxString              m_netName;
+        STATUS                m_status = BR_PENDING;
+        int                   m_attempts = 0;
+        int                   m_ripups = 0;
+        int                   m_layer = -1;
+        int64_t               m_timeMs = 0;
+
+        double Length() const { return ( m_end - m_start ).EuclideanNorm(); }
+    };
+
+    ///> Routing completion summary
+    struct REPORT
+    {
+        std::vector<CONNECTION> m_connections;
+        int                     m_passes = 0;
+        int64_t                 m_totalTimeMs = 0;
+        bool                    m_cancelled = false;
+
+        int Count( STATUS aStatus ) const;
+        int Total() const { return (int) m_connections.size(); }
+
+        ///> Fraction of connections routed, 0.0 .. 1.0
+        double Completion() const;
+
+        ///> Human-readable summary, one line per unrouted connection
+        const wxString Format() const;
+    };
+
+    BATCH_ROUTER( ROUTER* aRouter );
+    ~BATCH_ROUTER();
+
+    void AddConnection( const CONNECTION& aConnection );
+    void ClearConnections();
+
+    ///> Copper layers the router may use, in order of preference
+    void SetRoutingLayers( const std::vector<int>& aLayers ) { m_routingLayers = aLayers; }
+
+    ///> Wall-clock budget for all connections of a single net, in milliseconds
+    void SetNetTimeBudget( int aMilliseconds ) { m_netTimeBudget = aMilliseconds; }
+    int GetNetTimeBudget() const { return m_netTimeBudget; }
+
+    ///> Number of rip-up-and-retry passes after the initial one
+    void SetMaxRipupPasses( int aPasses ) { m_maxRipupPasses = aPasses; }
+    int GetMaxRipupPasses() const { return m_maxRipupPasses; }
+
+    ///> How many times a single connection may be ripped up before it is left alone
+    void SetMaxRipupsPerConnection( int aCount ) { m_maxRipupsPerConnection = aCount; }
+
+    void SetProgressReporter( PROGRESS_REPORTER* aReporter ) { m_progressReporter = aReporter; }
+
+    /**
+     * Function Run()
+     *
+     * Routes all queued connections and commits the result through the router interface.
+     * @return true if at least one connection was routed.
+     */
+    bool Run();
+
+    const REPORT& Report() const { return m_report; }
+
+private:
+    class IFACE_PROXY;
+
+    bool routeConnection( int aIndex );
+    bool routeOnLayer( CONNECTION& aConn, ITEM* aFrom, ITEM* aTo, const VECTOR2I& aP0,
+                       const VECTOR2I& aP1, int aLayer );
+    int ripupBlockers( int aIndex );
+    void ripupNet( int aNet );
+    bool isRippable( int aNet ) const;
+    const std::vector<int> candidateLayers( const ITEM* aFrom, const ITEM* aTo ) const;
+    ITEM* findAnchor( BOARD_CONNECTED_ITEM* aParent, int aNet, const VECTOR2I& aPos ) const;
+
+    std::vector<CONNECTION>   m_connections;
+    std::vector<int>          m_routingLayers;
+    std::map<int, int64_t>    m_netTimeSpent;
+
+    int                       m_netTimeBudget;
+    int                       m_maxRipupPasses;
+    int                       m_maxRipupsPerConnection;
+
+    IFACE_PROXY*              m_proxy;
+    PROGRESS_REPORTER*        m_progressReporter;
+    REPORT                    m_report;
+};
+
+}
+
+#endif
@@ -0,0 +1,206 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+
+#include "pns_counters.h"
+
+namespace PNS {
+
+COUNTERS* COUNTERS::s_active = nullptr;
+
+
+COUNTERS::COUNTERS() :
+    m_sessionTimer( std::string(), false )
+{
+    Reset();
+}
+
+
+void COUNTERS::Reset()
+{
+    m_queries = 0;
+    m_candidates = 0;
+    m_hits = 0;
+    m_maxBranchDepth = 0;
+    m_sessionUsecs = 0;
+    m_phases.clear();
+
+    for( int a = 0; a < SHAPE_COLLISION_STATS::TYPE_COUNT; a++ )
+    {
+        for( int b = 0; b < SHAPE_COLLISION_STATS::TYPE_COUNT; b++ )
+            m_shapeCollisions[a][b] = 0;
+    }
+}
+
+
+void COUNTERS::Begin()
+{
+    Reset();
+
+    s_active = this;
+
+    SHAPE_COLLISION_STATS::Reset();
+    SHAPE_COLLISION_STATS::Enable( true );
+
+    m_sessionTimer.Start();
+}
+
+
+void COUNTERS::End()
+{
+    if( !IsActive() )
+        return;
+
+    m_sessionTimer.Stop();
+    Sample();
+
+    SHAPE_COLLISION_STATS::Enable( false );
+
+    s_active = nullptr;
+}
+
+
+void COUNTERS::Sample()
+{
+    if( !IsActive() )
+        return;
+
+    m_sessionUsecs = m_sessionTimer.SinceStart<std::chrono::microseconds>().count();
+
+    for( int a = 0; a < SHAPE_COLLISION_STATS::TYPE_COUNT; a++ )
+    {
+        for( int b = 0; b < SHAPE_COLLISION_STATS::TYPE_COUNT; b++ )
+            m_shapeCollisions[a][b] = SHAPE_COLLISION_STATS::Count( (SHAPE_TYPE) a,
+                                                                    (SHAPE_TYPE) b );
+    }
+}
+
+
+void COUNTERS::AddPhase( const std::string& aName, int64_t aUsecs )
+{
+    PHASE& phase = m_phases[aName];
+
+    phase.m_calls++;
+    phase.m_usecs += aUsecs;
+}
+
+
+const std::string COUNTERS::FormatJSON() const
+{
+    std::stringstream ss;
+
+    ss << "{\"queries\":" << m_queries
+       << ",\"candidates\":" << m_candidates
+       << ",\"hits\":" << m_hits
+       << ",\"max_branch_depth\":" << m_maxBranchDepth
+       << ",\"session_us\":" << m_sessionUsecs;
+
+    ss << ",\"phases\":{";
+
+    bool first = true;
+
+    for( const auto& phase : m_phases )
+    {
+        ss << ( first ? "" : "," ) << "\"" << phase.first << "\":{\"calls\":"
+           << phase.second.m_calls << ",\"us\":" << phase.second.m_usecs << "}";
+        first = false;
+    }
+
+    ss << "},\"shape_collisions\":{";
+
+    first = true;
+
+    // Only the type pairs actually exercised, keyed as "typeA/typeB"
+    for( int a = 0; a < SHAPE_COLLISION_STATS::TYPE_COUNT; a++ )
+    {
+        for( int b = 0; b < SHAPE_COLLISION_STATS::TYPE_COUNT; b++ )
+        {
+            if( !m_shapeCollisions[a][b] )
+                continue;
+
+            ss << ( first ? "" : "," ) << "\""
+               << SHAPE_COLLISION_STATS::TypeName( (SHAPE_TYPE) a ) << "/"
+               << SHAPE_COLLISION_STATS::TypeName( (SHAPE_TYPE) b ) << "\":"
+               << m_shapeCollisions[a][b];
+            first = false;
+        }
+    }
+
+    ss << "}}";
+
+    return ss.str();
+}
+
+
+const std::vector<std::string> COUNTERS::FormatSummary() const
+{
+    std::vector<std::string> lines;
+    std::stringstream        ss;
+
+    ss << std::fixed << std::setprecision( 1 );
+
+    ss << "queries " << m_queries << "  candidates " << m_candidates << "  hits " << m_hits;
+    lines.push_back( ss.str() );
+    ss.str( "" );
+
+    ss << "branch depth " << m_maxBranchDepth << "  session " << m_sessionUsecs / 1000.0
+       << " ms";
+    lines.push_back( ss.str() );
+
+    for( const auto& phase : m_phases )
+    {
+        ss.str( "" );
+        ss << phase.first << ": " << phase.second.m_calls << " calls, "
+           << phase.second.m_usecs / 1000.0 << " ms";
+        lines.push_back( ss.str() );
+    }
+
+    // The most called shape type pairs
+    std::vector<std::pair<uint64_t, std::string>> pairs;
+
+    for( int a = 0; a < SHAPE_COLLISION_STATS::TYPE_COUNT; a++ )
+    {
+        for( int b = 0; b < SHAPE_COLLISION_STATS::TYPE_COUNT; b++ )
+        {
+            if( !m_shapeCollisions[a][b] )
+                continue;
+
+            pairs.emplace_back( m_shapeCollisions[a][b],
+                                std::string( SHAPE_COLLISION_STATS::TypeName( (SHAPE_TYPE) a ) )
+                                + "/" + SHAPE_COLLISION_STATS::TypeName( (SHAPE_TYPE) b ) );
+        }
+    }
+
+    std::sort( pairs.begin(), pairs.end(), std::greater<std::pair<uint64_t, std::string>>() );
+
+    for( size_t i = 0; i < pairs.size() && i < 3; i++ )
+    {
+        ss.str( "" );
+        ss << pairs[i].second << ": " << pairs[i].first;
+        lines.push_back( ss.str() );
+    }
+
+    return lines;
+}
+
+}
@@ -0,0 +1,137 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PNS_COUNTERS_H
+#define __PNS_COUNTERS_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <geometry/shape.h>
+#include <profile.h>
+
+namespace PNS {
+
+/**
+ * COUNTERS
+ *
+ * Collision query statistics of a single routing (or dragging) session: world queries
+ * issued, candidates tested against the query item, shape-vs-shape collision calls per
+ * type pair, the deepest NODE branch created and the time spent in each router phase.
+ *
+ * Only one set of counters is active at a time (the router is single-threaded); the
+ * instrumented code reaches it through Active(), which is null while counting is off.
+ */
+class COUNTERS
+{
+public:
+    ///> Accumulated time of a router phase (move, shove, optimize, ...)
+    struct PHASE
+    {
+        int     m_calls = 0;
+        int64_t m_usecs = 0;
+    };
+
+    COUNTERS();
+
+    void Reset();
+
+    ///> Starts counting: makes these counters the active ones and enables the
+    ///> kimath collision type counters.
+    void Begin();
+
+    ///> Stops counting and captures the collision type counters
+    void End();
+
+    ///> Updates the session time and the collision type counters while counting
+    void Sample();
+
+    bool IsActive() const { return s_active == this; }
+
+    static COUNTERS* Active() { return s_active; }
+
+    void AddPhase( const std::string& aName, int64_t aUsecs );
+
+    void UpdateBranchDepth( int aDepth )
+    {
+        if( aDepth > m_maxBranchDepth )
+            m_maxBranchDepth = aDepth;
+    }
+
+    ///> Serializes the counters as a single-line JSON object
+    const std::string FormatJSON() const;
+
+    ///> Short summary of the counters, one line per entry, for on-canvas display
+    const std::vector<std::string> FormatSummary() const;
+
+    uint64_t m_queries;         ///< NODE::QueryColliding() calls
+    uint64_t m_candidates;      ///< index candidates tested for collision
+    uint64_t m_hits;            ///< candidates found colliding
+    int      m_maxBranchDepth;  ///< deepest NODE created by Branch()
+    int64_t  m_sessionUsecs;    ///< time between Begin() and End()
+
+    std::map<std::string, PHASE> m_phases;
+
+    uint64_t m_shapeCollisions[SHAPE_COLLISION_STATS::TYPE_COUNT]
+                              [SHAPE_COLLISION_STATS::TYPE_COUNT];
+
+private:
+    static COUNTERS* s_active;
+
+    PROF_COUNTER m_sessionTimer;
+};
+
+
+/**
+ * PHASE_TIMER
+ *
+ * Scope guard adding the time spent in the enclosing block to the named phase of the
+ * active counters.  Does nothing when no counters are active.
+ */
+class PHASE_TIMER
+{
+public:
+    PHASE_TIMER( const char* aName ) :
+        m_counters( COUNTERS::Active() ),
+        m_name( aName ),
+        m_timer( std::string(), m_counters != nullptr )
+    {
+    }
+
+    ~PHASE_TIMER()
+    {
+        if( m_counters && m_counters->IsActive() )
+        {
+            m_timer.Stop();
+            m_counters->AddPhase( m_name,
+                                  m_timer.SinceStart<std::chrono::microseconds>().count() );
+        }
+    }
+
+private:
+    COUNTERS*    m_counters;
+    const char*  m_name;
+    PROF_COUNTER m_timer;
+};
+
+}
+
+#endif
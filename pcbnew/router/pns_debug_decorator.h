@@ -27,12 +27,15 @@
 #include <geometry/seg.h>
 #include <geometry/shape_line_chain.h>
 
+#include "pns_counters.h"
+
 namespace PNS {
 
 class DEBUG_DECORATOR
 {
 public:
-    DEBUG_DECORATOR()
+    DEBUG_DECORATOR() :
+        m_countersEnabled( false )
     {}
 
     virtual ~DEBUG_DECORATOR()
@@ -44,6 +47,23 @@ public:
     virtual void AddBox( BOX2I aB, int aColor, const std::string aName = "" ) {};
     virtual void AddDirections( VECTOR2D aP, int aMask, int aColor, const std::string aName = "" ) {};
     virtual void Clear() {};
+
+    ///> Enables collection of collision query counters in the following routing sessions
+    void SetCountersEnabled( bool aEnabled ) { m_countersEnabled = aEnabled; }
+    bool CountersEnabled() const { return m_countersEnabled; }
+
+    ///> Counters of the current (or last finished) routing session
+    COUNTERS& Counters() { return m_counters; }
+
+    ///> Called by the router after each move of a counted routing session
+    virtual void CountersUpdated( const COUNTERS& aCounters ) {};
+
+    ///> Called by the router at the end of each counted routing session
+    virtual void SessionFinished( const COUNTERS& aCounters ) {};
+
+private:
+    bool     m_countersEnabled;
+    COUNTERS m_counters;
 };
 
 }
@@ -19,6 +19,7 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
@@ -342,46 +343,63 @@ void DP_GATEWAYS::BuildOrthoProjections( DP_GATEWAYS& aEntries,
 bool DP_GATEWAYS::FitGateways( DP_GATEWAYS& aEntry, DP_GATEWAYS& aTarget,
         bool aPrefDiagonal, DIFF_PAIR& aDp )
 {
-    DP_CANDIDATE best;
+    // Scanning all (entry, target, attempt) combinations and keeping a candidate whenever its
+    // score is not below the best so far selects the last successful candidate of the highest
+    // score.  Building a candidate is expensive, so instead visit them by decreasing score,
+    // and in reverse scan order within a score: the first one that builds is the same one,
+    // and the lower scoring candidates are never built.
+    struct CANDIDATE_REF
+    {
+        int               score;
+        int               order;
+        const DP_GATEWAY* entry;
+        const DP_GATEWAY* target;
+        bool              altDiagonal;
+    };
+
+    const int minScore = -1000;
+    std::vector<CANDIDATE_REF> candidates;
+    int order = 0;
 
-    int n = 0;
-    int bestScore = -1000;
-    bool found = false;
+    candidates.reserve( 2 * aEntry.CGateways().size() * aTarget.CGateways().size() );
 
-    for( const DP_GATEWAY& g_entry : aEntry.Gateways() )
+    for( const DP_GATEWAY& g_entry : aEntry.CGateways() )
     {
-        for( const DP_GATEWAY& g_target : aTarget.Gateways() )
+        for( const DP_GATEWAY& g_target : aTarget.CGateways() )
         {
-            n++;
-
             for( int attempt = 0; attempt < 2; attempt++ )
             {
                 int score = ( attempt == 1 ? -3 : 0 );
                 score += g_entry.Priority();
                 score += g_target.Priority();
 
-                if( score < bestScore )
-                    continue;
+                if( score >= minScore )
+                    candidates.push_back( { score, order, &g_entry, &g_target, attempt == 1 } );
 
-                DIFF_PAIR l( m_gap );
-
-                if( l.BuildInitial( g_entry, g_target, aPrefDiagonal ^ ( attempt ? true : false ) ) )
-                {
-                    best.p = l.CP();
-                    best.n = l.CN();
-                    bestScore = score;
-                    found = true;
-                }
+                order++;
             }
         }
     }
 
+    std::sort( candidates.begin(), candidates.end(),
+               []( const CANDIDATE_REF& a, const CANDIDATE_REF& b )
+               {
+                   if( a.score != b.score )
+                       return a.score > b.score;
+
+                   return a.order > b.order;
+               } );
 
-    if( found )
+    for( const CANDIDATE_REF& c : candidates )
     {
-        aDp.SetGap( m_gap );
-        aDp.SetShape( best.p, best.n );
-        return true;
+        DIFF_PAIR l( m_gap );
+
+        if( l.BuildInitial( *c.entry, *c.target, aPrefDiagonal ^ c.altDiagonal ) )
+        {
+            aDp.SetGap( m_gap );
+            aDp.SetShape( l.CP(), l.CN() );
+            return true;
+        }
     }
 
     return false;
@@ -236,13 +236,6 @@ class DP_GATEWAYS
         void FilterByOrientation( int aAngleMask, DIRECTION_45 aRefOrientation );
 
     private:
-        struct DP_CANDIDATE
-        {
-            SHAPE_LINE_CHAIN p, n;
-            VECTOR2I gw_p, gw_n;
-            int score;
-        };
-
         bool checkDiagonalAlignment( const VECTOR2I& a, const VECTOR2I& b ) const;
         void buildDpContinuation( const DP_PRIMITIVE_PAIR& aPair, bool aIsDiagonal );
         void buildEntries( const VECTOR2I& p0_p, const VECTOR2I& p0_n );
@@ -619,6 +619,7 @@ void DIFF_PAIR_PLACER::initPlacement()
     m_lastNode = NULL;
     m_currentNode = rootNode;
     m_currentMode = Settings().Mode();
+    m_gatewayCache.clear();
 
     if( m_shove )
         delete m_shove;
@@ -632,6 +633,63 @@ void DIFF_PAIR_PLACER::initPlacement()
 }
 
 
+void DIFF_PAIR_PLACER::buildGateways( DP_GATEWAYS& aGateways, const DP_PRIMITIVE_PAIR& aPair,
+                                      bool aPreferDiagonal )
+{
+    // Enough for the pads of a dense connector the cursor sweeps over
+    const size_t maxCacheSize = 64;
+
+    // Items of the head nodes are recreated on every move: compare geometry, not only
+    // pointers
+    auto bbox = []( const ITEM* aItem ) -> BOX2I
+    {
+        return ( aItem && aItem->Shape() ) ? aItem->Shape()->BBox() : BOX2I();
+    };
+
+    auto kind = []( const ITEM* aItem ) -> int
+    {
+        return aItem ? (int) aItem->Kind() : -1;
+    };
+
+    const BOX2I bboxP = bbox( aPair.PrimP() );
+    const BOX2I bboxN = bbox( aPair.PrimN() );
+
+    for( auto it = m_gatewayCache.rbegin(); it != m_gatewayCache.rend(); ++it )
+    {
+        if( it->m_primP == aPair.PrimP() && it->m_primN == aPair.PrimN()
+                && it->m_kindP == kind( aPair.PrimP() ) && it->m_kindN == kind( aPair.PrimN() )
+                && it->m_anchorP == aPair.AnchorP() && it->m_anchorN == aPair.AnchorN()
+                && it->m_bboxP == bboxP && it->m_bboxN == bboxN
+                && it->m_gap == gap() && it->m_preferDiagonal == aPreferDiagonal )
+        {
+            aGateways.Gateways() = it->m_gateways;
+            return;
+        }
+    }
+
+    aGateways.BuildFromPrimitivePair( aPair, aPreferDiagonal );
+
+    if( m_gatewayCache.size() >= maxCacheSize )
+        m_gatewayCache.erase( m_gatewayCache.begin() );
+
+    GATEWAY_CACHE_ENTRY entry;
+
+    entry.m_primP = aPair.PrimP();
+    entry.m_primN = aPair.PrimN();
+    entry.m_kindP = kind( aPair.PrimP() );
+    entry.m_kindN = kind( aPair.PrimN() );
+    entry.m_anchorP = aPair.AnchorP();
+    entry.m_anchorN = aPair.AnchorN();
+    entry.m_bboxP = bboxP;
+    entry.m_bboxN = bboxN;
+    entry.m_gap = gap();
+    entry.m_preferDiagonal = aPreferDiagonal;
+    entry.m_gateways = aGateways.CGateways();
+
+    m_gatewayCache.push_back( std::move( entry ) );
+}
+
+
 bool DIFF_PAIR_PLACER::routeHead( const VECTOR2I& aP )
 {
     m_fitOk = false;
@@ -642,13 +700,13 @@ bool DIFF_PAIR_PLACER::routeHead( const VECTOR2I& aP )
     if( !m_prevPair )
         m_prevPair = m_start;
 
-    gwsEntry.BuildFromPrimitivePair( *m_prevPair, m_startDiagonal );
+    buildGateways( gwsEntry, *m_prevPair, m_startDiagonal );
 
     DP_PRIMITIVE_PAIR target;
 
     if( findDpPrimitivePair( aP, m_currentEndItem, target ) )
     {
-        gwsTarget.BuildFromPrimitivePair( target, m_startDiagonal );
+        buildGateways( gwsTarget, target, m_startDiagonal );
         m_snapOnTarget = true;
     }
     else
@@ -222,6 +222,16 @@ private:
 
 
     bool routeHead( const VECTOR2I& aP );
+
+    /**
+     * Function buildGateways()
+     *
+     * Builds the gateways of a primitive pair, reusing the ones built for a previous
+     * head position if the primitives (pads, vias or segments) have not moved.
+     */
+    void buildGateways( DP_GATEWAYS& aGateways, const DP_PRIMITIVE_PAIR& aPair,
+                        bool aPreferDiagonal );
+
     bool tryWalkDp( NODE* aNode, DIFF_PAIR& aPair, bool aSolidsOnly );
 
     ///> route step, walkaround mode
@@ -258,6 +268,24 @@ private:
     DP_PRIMITIVE_PAIR m_start;
     OPT<DP_PRIMITIVE_PAIR> m_prevPair;
 
+    ///> Gateways built for a primitive pair, valid while its items keep their geometry
+    struct GATEWAY_CACHE_ENTRY
+    {
+        const ITEM*             m_primP;
+        const ITEM*             m_primN;
+        int                     m_kindP;
+        int                     m_kindN;
+        VECTOR2I                m_anchorP;
+        VECTOR2I                m_anchorN;
+        BOX2I                   m_bboxP;
+        BOX2I                   m_bboxN;
+        int                     m_gap;
+        bool                    m_preferDiagonal;
+        std::vector<DP_GATEWAY> m_gateways;
+    };
+
+    std::vector<GATEWAY_CACHE_ENTRY> m_gatewayCache;
+
     ///> current algorithm iteration
     int m_iteration;
 
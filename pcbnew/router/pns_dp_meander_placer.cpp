@@ -117,6 +117,8 @@ bool DP_MEANDER_PLACER::Start( const VECTOR2I& aP, ITEM* aStartItem )
 
     m_currentWidth = m_originPair.Width();
 
+    resetTuningCache();
+
     return true;
 }
 
@@ -223,25 +225,51 @@ bool DP_MEANDER_PLACER::Move( const VECTOR2I& aP, ITEM* aEndItem )
 
     int curIndexP = 0, curIndexN = 0;
 
+    // Coupled segments near the tuning start usually stay the same while the cursor moves,
+    // only re-fit meanders from the first one that changed.
+    beginMeanderCache();
+
+    std::vector<std::pair<VECTOR2I, VECTOR2I>> corners;
+
     for( const DIFF_PAIR::COUPLED_SEGMENTS& sp : coupledSegments )
     {
         SEG base = baselineSegment( sp );
 
         Dbg()->AddSegment( base, 3 );
 
+        corners.clear();
+
         while( sp.indexP >= curIndexP )
         {
-            m_result.AddCorner( tunedP.CPoint( curIndexP ), tunedN.CPoint( curIndexN ) );
+            corners.emplace_back( tunedP.CPoint( curIndexP ), tunedN.CPoint( curIndexN ) );
             curIndexP++;
         }
 
         while( sp.indexN >= curIndexN )
         {
-            m_result.AddCorner( tunedP.CPoint( sp.indexP ), tunedN.CPoint( curIndexN ) );
+            corners.emplace_back( tunedP.CPoint( sp.indexP ), tunedN.CPoint( curIndexN ) );
             curIndexN++;
         }
 
+        std::vector<VECTOR2I> key = { VECTOR2I( tuned.Width(), offset ), base.A, base.B };
+
+        for( const auto& corner : corners )
+        {
+            key.push_back( corner.first );
+            key.push_back( corner.second );
+        }
+
+        if( restoreMeanders( m_result, key ) )
+            continue;
+
+        size_t first = m_result.Meanders().size();
+
+        for( const auto& corner : corners )
+            m_result.AddCorner( corner.first, corner.second );
+
         m_result.MeanderSegment( base );
+
+        storeMeanders( m_result, first, key );
     }
 
     while( curIndexP < tunedP.PointCount() )
@@ -250,7 +278,11 @@ bool DP_MEANDER_PLACER::Move( const VECTOR2I& aP, ITEM* aEndItem )
     while( curIndexN < tunedN.PointCount() )
         m_result.AddCorner( tunedP.CPoint( -1 ), tunedN.CPoint( curIndexN++ ) );
 
-    long long int dpLen = origPathLength();
+    // The tuned paths do not change during a tuning operation
+    if( m_cachedPathLength < 0 )
+        m_cachedPathLength = origPathLength();
+
+    long long int dpLen = m_cachedPathLength;
 
     m_lastStatus = TUNED;
 
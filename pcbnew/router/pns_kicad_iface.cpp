@@ -19,6 +19,7 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <advanced_config.h>
 #include <undo_redo_container.h>
 #include <class_board.h>
 #include <board_connected_item.h>
@@ -49,6 +50,7 @@
 #include <geometry/shape_simple.h>
 
 #include <memory>
+#include <wx/ffile.h>
 
 #include "tools/pcb_tool_base.h"
 
@@ -64,6 +66,7 @@
 #include "pns_router.h"
 #include "pns_debug_decorator.h"
 #include "router_preview_item.h"
+#include "router_stats_item.h"
 
 typedef VECTOR2I::extended_type ecoord;
 
@@ -413,20 +416,26 @@ class PNS_PCBNEW_DEBUG_DECORATOR: public PNS::DEBUG_DECORATOR
 {
 public:
     PNS_PCBNEW_DEBUG_DECORATOR( KIGFX::VIEW* aView = NULL ): PNS::DEBUG_DECORATOR(),
-        m_view( NULL ), m_items( NULL )
+        m_view( NULL ), m_items( NULL ), m_stats( NULL )
     {
+        m_statsFile = ADVANCED_CFG::GetCfg().m_RouterStatsFile;
+        m_showStats = ADVANCED_CFG::GetCfg().m_ShowRouterStats;
+        SetCountersEnabled( !m_statsFile.IsEmpty() || m_showStats );
+
         SetView( aView );
     }
 
     ~PNS_PCBNEW_DEBUG_DECORATOR()
     {
         Clear();
+        removeStats();
         delete m_items;
     }
 
     void SetView( KIGFX::VIEW* aView )
     {
         Clear();
+        removeStats();
         delete m_items;
         m_items = NULL;
         m_view = aView;
@@ -437,6 +446,12 @@ public:
         m_items = new KIGFX::VIEW_GROUP( m_view );
         m_items->SetLayer( LAYER_SELECT_OVERLAY ) ;
         m_view->Add( m_items );
+
+        if( m_showStats )
+        {
+            m_stats = new ROUTER_STATS_ITEM();
+            m_view->Add( m_stats );
+        }
     }
 
     void AddPoint( VECTOR2I aP, int aColor,  const std::string aName = "") override
@@ -514,9 +529,46 @@ public:
         }
     }
 
+    void CountersUpdated( const PNS::COUNTERS& aCounters ) override
+    {
+        if( m_stats )
+        {
+            m_stats->SetLines( aCounters.FormatSummary() );
+            m_view->Update( m_stats );
+        }
+    }
+
+    void SessionFinished( const PNS::COUNTERS& aCounters ) override
+    {
+        // The overlay keeps showing the last session until the next one starts
+        CountersUpdated( aCounters );
+
+        if( m_statsFile.IsEmpty() )
+            return;
+
+        wxFFile file( m_statsFile, "a" );
+
+        if( !file.IsOpened() )
+            return;
+
+        file.Write( wxString( aCounters.FormatJSON() + "\n" ) );
+    }
+
 private:
+    void removeStats()
+    {
+        if( m_view && m_stats )
+            m_view->Remove( m_stats );
+
+        delete m_stats;
+        m_stats = NULL;
+    }
+
     KIGFX::VIEW* m_view;
     KIGFX::VIEW_GROUP* m_items;
+    ROUTER_STATS_ITEM* m_stats;
+    wxString m_statsFile;
+    bool m_showStats;
 };
 
 
@@ -87,6 +87,8 @@ bool MEANDER_PLACER::Start( const VECTOR2I& aP, ITEM* aStartItem )
     m_currentWidth = m_originLine.Width();
     m_currentEnd = VECTOR2I( 0, 0 );
 
+    resetTuningCache();
+
     return true;
 }
 
@@ -127,15 +129,32 @@ bool MEANDER_PLACER::doMove( const VECTOR2I& aP, ITEM* aEndItem, long long int a
     m_result.SetWidth( m_originLine.Width() );
     m_result.SetBaselineOffset( 0 );
 
+    // Segments between the tuning start and the cursor usually stay the same while the
+    // cursor moves, only re-fit meanders from the first segment that changed.
+    beginMeanderCache();
+
     for( int i = 0; i < tuned.SegmentCount(); i++ )
     {
         const SEG s = tuned.CSegment( i );
+        const std::vector<VECTOR2I> key = { s.A, s.B };
+
+        if( restoreMeanders( m_result, key ) )
+            continue;
+
+        size_t first = m_result.Meanders().size();
+
         m_result.AddCorner( s.A );
         m_result.MeanderSegment( s );
         m_result.AddCorner( s.B );
+
+        storeMeanders( m_result, first, key );
     }
 
-    long long int lineLen = origPathLength();
+    // The tuned path does not change during a tuning operation
+    if( m_cachedPathLength < 0 )
+        m_cachedPathLength = origPathLength();
+
+    long long int lineLen = m_cachedPathLength;
 
     m_lastLength = lineLen;
     m_lastStatus = TUNED;
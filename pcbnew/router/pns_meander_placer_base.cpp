@@ -32,6 +32,9 @@ MEANDER_PLACER_BASE::MEANDER_PLACER_BASE( ROUTER* aRouter ) :
     m_world = NULL;
     m_currentWidth = 0;
     m_padToDieLenth = 0;
+    m_cachedPathLength = -1;
+    m_meanderCacheStep = 0;
+    m_meanderCacheHit = false;
 }
 
 
@@ -46,6 +49,7 @@ void MEANDER_PLACER_BASE::AmplitudeStep( int aSign )
     a = std::max( a,  m_settings.m_minAmplitude );
 
     m_settings.m_maxAmplitude = a;
+    m_meanderCache.clear();
 }
 
 
@@ -55,12 +59,14 @@ void MEANDER_PLACER_BASE::SpacingStep( int aSign )
     s = std::max( s, 2 * m_currentWidth );
 
     m_settings.m_spacing = s;
+    m_meanderCache.clear();
 }
 
 
 void MEANDER_PLACER_BASE::UpdateSettings( const MEANDER_SETTINGS& aSettings )
 {
     m_settings = aSettings;
+    m_meanderCache.clear();
 }
 
 
@@ -215,6 +221,58 @@ int MEANDER_PLACER_BASE::GetTotalPadToDieLength( const LINE& aLine ) const
 }
 
 
+void MEANDER_PLACER_BASE::resetTuningCache()
+{
+    m_cachedPathLength = -1;
+    m_meanderCache.clear();
+    m_meanderCacheStep = 0;
+    m_meanderCacheHit = false;
+}
+
+
+void MEANDER_PLACER_BASE::beginMeanderCache()
+{
+    m_meanderCacheStep = 0;
+    m_meanderCacheHit = true;
+}
+
+
+bool MEANDER_PLACER_BASE::restoreMeanders( MEANDERED_LINE& aLine,
+                                           const std::vector<VECTOR2I>& aKey )
+{
+    // Fitting a meander checks it against the meanders fitted before it, so a step can only
+    // be reused if all the previous ones were reused as well.
+    if( m_meanderCacheHit && m_meanderCacheStep < m_meanderCache.size()
+            && m_meanderCache[m_meanderCacheStep].m_key == aKey )
+    {
+        for( const MEANDER_SHAPE& shape : m_meanderCache[m_meanderCacheStep].m_shapes )
+            aLine.AddMeander( new MEANDER_SHAPE( shape ) );
+
+        m_meanderCacheStep++;
+        return true;
+    }
+
+    m_meanderCacheHit = false;
+    m_meanderCache.resize( m_meanderCacheStep );
+    return false;
+}
+
+
+void MEANDER_PLACER_BASE::storeMeanders( MEANDERED_LINE& aLine, size_t aFirst,
+                                         const std::vector<VECTOR2I>& aKey )
+{
+    MEANDER_CACHE_ENTRY entry;
+
+    entry.m_key = aKey;
+
+    for( size_t i = aFirst; i < aLine.Meanders().size(); i++ )
+        entry.m_shapes.push_back( *aLine.Meanders()[i] );
+
+    m_meanderCache.push_back( std::move( entry ) );
+    m_meanderCacheStep++;
+}
+
+
 const MEANDER_SETTINGS& MEANDER_PLACER_BASE::MeanderSettings() const
 {
     return m_settings;
@@ -159,6 +159,48 @@ protected:
     int compareWithTolerance(
             long long int aValue, long long int aExpected, long long int aTolerance = 0 ) const;
 
+    /**
+     * Function resetTuningCache()
+     *
+     * Forgets the path length and meanders cached by previous Move() calls. Must be
+     * called when a new tuning operation starts.
+     */
+    void resetTuningCache();
+
+    /**
+     * Function beginMeanderCache()
+     *
+     * Starts a lookup pass over the cached meanders. Called once per Move(), before
+     * the first restoreMeanders().
+     */
+    void beginMeanderCache();
+
+    /**
+     * Function restoreMeanders()
+     *
+     * If the previous Move() fitted meanders over the same geometry at this step (and
+     * all the steps before it matched too), appends copies of them to aLine.
+     * @param aLine the line being meandered
+     * @param aKey all the points (and parameters) the meanders of this step depend on
+     * @return true if the meanders were restored, false if they must be fitted again
+     */
+    bool restoreMeanders( MEANDERED_LINE& aLine, const std::vector<VECTOR2I>& aKey );
+
+    /**
+     * Function storeMeanders()
+     *
+     * Records the shapes appended to aLine since index aFirst as the result of the current
+     * step, before any length tuning is applied to them.
+     */
+    void storeMeanders( MEANDERED_LINE& aLine, size_t aFirst, const std::vector<VECTOR2I>& aKey );
+
+    ///> Meanders fitted over one base segment by a previous Move()
+    struct MEANDER_CACHE_ENTRY
+    {
+        std::vector<VECTOR2I>      m_key;
+        std::vector<MEANDER_SHAPE> m_shapes;
+    };
+
     ///> pointer to world to search colliding items
     NODE* m_world;
 
@@ -171,6 +213,14 @@ protected:
     MEANDER_SETTINGS m_settings;
     ///> current end point
     VECTOR2I m_currentEnd;
+
+    ///> length of the tuned path before meandering, -1 if not computed yet
+    long long int m_cachedPathLength;
+
+    ///> meanders fitted by the last Move(), one entry per base segment
+    std::vector<MEANDER_CACHE_ENTRY> m_meanderCache;
+    size_t                           m_meanderCacheStep;
+    bool                             m_meanderCacheHit;
 };
 
 }
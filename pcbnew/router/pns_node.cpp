@@ -36,6 +36,7 @@
 #include "pns_solid.h"
 #include "pns_joint.h"
 #include "pns_index.h"
+#include "pns_counters.h"
 
 
 namespace PNS {
@@ -112,6 +113,10 @@ NODE* NODE::Branch()
     m_children.insert( child );
 
     child->m_depth = m_depth + 1;
+
+    if( COUNTERS* counters = COUNTERS::Active() )
+        counters->UpdateBranchDepth( child->m_depth );
+
     child->m_parent = this;
     child->m_ruleResolver = m_ruleResolver;
     child->m_root = isRoot() ? this : m_root;
@@ -229,6 +234,11 @@ struct NODE::DEFAULT_OBSTACLE_VISITOR : public OBSTACLE_VISITOR
         if( visit( aCandidate ) )
             return true;
 
+        COUNTERS* counters = COUNTERS::Active();
+
+        if( counters )
+            counters->m_candidates++;
+
         int clearance = m_extraClearance + m_node->GetClearance( aCandidate, m_item );
 
         if( aCandidate->Kind() == ITEM::LINE_T ) // this should never happen.
@@ -243,6 +253,9 @@ struct NODE::DEFAULT_OBSTACLE_VISITOR : public OBSTACLE_VISITOR
         if( !aCandidate->Collide( m_item, clearance, false, nullptr, m_node, m_differentNetsOnly ) )
             return true;
 
+        if( counters )
+            counters->m_hits++;
+
         OBSTACLE obs;
 
         obs.m_item = aCandidate;
@@ -261,6 +274,9 @@ struct NODE::DEFAULT_OBSTACLE_VISITOR : public OBSTACLE_VISITOR
 
 int NODE::QueryColliding( const ITEM* aItem, OBSTACLE_VISITOR& aVisitor )
 {
+    if( COUNTERS* counters = COUNTERS::Active() )
+        counters->m_queries++;
+
     aVisitor.SetWorld( this, NULL );
     m_index->Query( aItem, m_maxClearance, aVisitor );
 
@@ -280,6 +296,9 @@ int NODE::QueryColliding( const ITEM* aItem, NODE::OBSTACLES& aObstacles, int aK
 {
     DEFAULT_OBSTACLE_VISITOR visitor( aObstacles, aItem, aKindMask, aDifferentNetsOnly );
 
+    if( COUNTERS* counters = COUNTERS::Active() )
+        counters->m_queries++;
+
 #ifdef DEBUG
     assert( allocNodes.find( this ) != allocNodes.end() );
 #endif
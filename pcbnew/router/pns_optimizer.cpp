@@ -36,6 +36,7 @@
 #include "pns_utils.h"
 #include "pns_router.h"
 #include "pns_debug_decorator.h"
+#include "pns_counters.h"
 
 
 namespace PNS {
@@ -599,6 +600,8 @@ bool OPTIMIZER::mergeFull( LINE* aLine )
 
 bool OPTIMIZER::Optimize( LINE* aLine, LINE* aResult )
 {
+    PHASE_TIMER timer( "optimize" );
+
     if( !aResult )
         aResult = aLine;
     else
@@ -55,6 +55,8 @@
 #include "pns_meander_placer.h"
 #include "pns_meander_skew_placer.h"
 #include "pns_dp_meander_placer.h"
+#include "pns_debug_decorator.h"
+#include "pns_counters.h"
 
 namespace PNS {
 
@@ -158,10 +160,20 @@ bool ROUTER::StartDragging( const VECTOR2I& aP, ITEM_SET aStartItems, int aDragM
     m_dragger->SetWorld( m_world.get() );
     m_dragger->SetDebugDecorator ( m_iface->GetDebugDecorator () );
 
-    if( m_dragger->Start ( aP, aStartItems ) )
+    beginCounters();
+
+    bool started;
+
+    {
+        PHASE_TIMER timer( "start" );
+        started = m_dragger->Start ( aP, aStartItems );
+    }
+
+    if( started )
         m_state = DRAG_SEGMENT;
     else
     {
+        endCounters( false );
         m_dragger.reset();
         m_state = IDLE;
         return false;
@@ -225,10 +237,20 @@ bool ROUTER::StartRouting( const VECTOR2I& aP, ITEM* aStartItem, int aLayer )
     m_placer->SetLayer( aLayer );
     m_placer->SetDebugDecorator ( m_iface->GetDebugDecorator () );
 
-    bool rv = m_placer->Start( aP, aStartItem );
+    beginCounters();
+
+    bool rv;
+
+    {
+        PHASE_TIMER timer( "start" );
+        rv = m_placer->Start( aP, aStartItem );
+    }
 
     if( !rv )
+    {
+        endCounters( false );
         return false;
+    }
 
     m_currentEnd = aP;
     m_state = ROUTE_TRACK;
@@ -247,19 +269,25 @@ void ROUTER::Move( const VECTOR2I& aP, ITEM* endItem )
 {
     m_currentEnd = aP;
 
-    switch( m_state )
     {
-    case ROUTE_TRACK:
-        movePlacing( aP, endItem );
-        break;
+        PHASE_TIMER timer( "move" );
 
-    case DRAG_SEGMENT:
-        moveDragging( aP, endItem );
-        break;
+        switch( m_state )
+        {
+        case ROUTE_TRACK:
+            movePlacing( aP, endItem );
+            break;
 
-    default:
-        break;
+        case DRAG_SEGMENT:
+            moveDragging( aP, endItem );
+            break;
+
+        default:
+            break;
+        }
     }
+
+    updateCounters();
 }
 
 
@@ -390,6 +418,7 @@ void ROUTER::CommitRouting( NODE* aNode )
 
 bool ROUTER::FixRoute( const VECTOR2I& aP, ITEM* aEndItem, bool aForceFinish )
 {
+    PHASE_TIMER timer( "fix" );
     bool rv = false;
 
     switch( m_state )
@@ -453,6 +482,43 @@ void ROUTER::StopRouting()
     m_state = IDLE;
     m_world->KillChildren();
     m_world->ClearRanks();
+
+    endCounters( true );
+}
+
+
+void ROUTER::beginCounters()
+{
+    DEBUG_DECORATOR* dbg = m_iface->GetDebugDecorator();
+
+    if( dbg && dbg->CountersEnabled() )
+        dbg->Counters().Begin();
+}
+
+
+void ROUTER::updateCounters()
+{
+    DEBUG_DECORATOR* dbg = m_iface->GetDebugDecorator();
+
+    if( !dbg || !dbg->Counters().IsActive() )
+        return;
+
+    dbg->Counters().Sample();
+    dbg->CountersUpdated( dbg->Counters() );
+}
+
+
+void ROUTER::endCounters( bool aReport )
+{
+    DEBUG_DECORATOR* dbg = m_iface->GetDebugDecorator();
+
+    if( !dbg || !dbg->Counters().IsActive() )
+        return;
+
+    dbg->Counters().End();
+
+    if( aReport )
+        dbg->SessionFinished( dbg->Counters() );
 }
 
 
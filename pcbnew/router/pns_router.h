@@ -259,6 +259,15 @@ private:
     void markViolations( NODE* aNode, ITEM_SET& aCurrent, NODE::ITEM_VECTOR& aRemoved );
     bool isStartingPointRoutable( const VECTOR2I& aWhere, int aLayer );
 
+    ///> Starts collecting collision counters if the debug decorator asks for them
+    void beginCounters();
+
+    ///> Hands the counters of the current session to the debug decorator
+    void updateCounters();
+
+    ///> Stops collecting counters, optionally handing them to the debug decorator
+    void endCounters( bool aReport );
+
     VECTOR2I m_currentEnd;
     RouterState m_state;
 
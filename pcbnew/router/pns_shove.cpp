@@ -35,6 +35,7 @@
 #include "pns_utils.h"
 #include "pns_router.h"
 #include "pns_topology.h"
+#include "pns_counters.h"
 
 #include "time_limit.h"
 
@@ -1245,6 +1246,7 @@ OPT_BOX2I SHOVE::totalAffectedArea() const
 
 SHOVE::SHOVE_STATUS SHOVE::ShoveLines( const LINE& aCurrentHead )
 {
+    PHASE_TIMER timer( "shove" );
     SHOVE_STATUS st = SH_OK;
 
     m_multiLineMode = false;
@@ -28,6 +28,7 @@
 #include "pns_utils.h"
 #include "pns_router.h"
 #include "pns_debug_decorator.h"
+#include "pns_counters.h"
 
 namespace PNS {
 
@@ -303,6 +304,7 @@ const WALKAROUND::RESULT WALKAROUND::Route( const LINE& aInitialPath )
 WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
         LINE& aWalkPath, bool aOptimize )
 {
+    PHASE_TIMER timer( "walkaround" );
     LINE path_cw( aInitialPath ), path_ccw( aInitialPath );
     WALKAROUND_STATUS s_cw = IN_PROGRESS, s_ccw = IN_PROGRESS;
     SHAPE_LINE_CHAIN best_path;
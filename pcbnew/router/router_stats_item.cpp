@@ -0,0 +1,69 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gal/graphics_abstraction_layer.h>
+#include <painter.h>
+
+#include "router_stats_item.h"
+
+using namespace KIGFX;
+
+ROUTER_STATS_ITEM::ROUTER_STATS_ITEM() :
+    EDA_ITEM( NOT_USED )
+{
+}
+
+
+void ROUTER_STATS_ITEM::SetLines( const std::vector<std::string>& aLines )
+{
+    m_lines.clear();
+
+    for( const std::string& line : aLines )
+        m_lines.emplace_back( line );
+}
+
+
+void ROUTER_STATS_ITEM::ViewDraw( int aLayer, KIGFX::VIEW* aView ) const
+{
+    // Sizes in pixels
+    const double margin = 8.0;
+    const double lineHeight = 16.0;
+
+    GAL*           gal = aView->GetGAL();
+    const VECTOR2D screenSize = gal->GetScreenPixelSize();
+
+    gal->SetIsFill( false );
+    gal->SetIsStroke( true );
+    gal->SetStrokeColor( aView->GetPainter()->GetSettings()->GetLayerColor( LAYER_AUX_ITEMS ) );
+    gal->SetLineWidth( aView->ToWorld( 1.0 ) );
+    gal->SetGlyphSize( VECTOR2D( aView->ToWorld( 9.0 ), aView->ToWorld( 9.0 ) ) );
+    gal->SetFontBold( false );
+    gal->SetFontItalic( false );
+    gal->SetTextMirrored( false );
+    gal->SetHorizontalJustify( GR_TEXT_HJUSTIFY_RIGHT );
+    gal->SetVerticalJustify( GR_TEXT_VJUSTIFY_CENTER );
+
+    double y = margin + lineHeight / 2.0;
+
+    for( const wxString& line : m_lines )
+    {
+        gal->BitmapText( line, aView->ToWorld( VECTOR2D( screenSize.x - margin, y ) ), 0.0 );
+        y += lineHeight;
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ROUTER_STATS_ITEM_H
+#define __ROUTER_STATS_ITEM_H
+
+#include <string>
+#include <vector>
+
+#include <base_struct.h>
+#include <view/view.h>
+#include <layers_id_colors_and_visibility.h>
+
+/**
+ * ROUTER_STATS_ITEM
+ *
+ * Overlay showing the collision query counters of the current (or last) routing session
+ * in the top right corner of the canvas.
+ */
+class ROUTER_STATS_ITEM : public EDA_ITEM
+{
+public:
+    ROUTER_STATS_ITEM();
+
+    void SetLines( const std::vector<std::string>& aLines );
+
+#if defined(DEBUG)
+    void Show( int aA, std::ostream& aB ) const override {}
+#endif
+
+    /** Get class name
+     * @return  string "ROUTER_STATS_ITEM"
+     */
+    virtual wxString GetClass() const override
+    {
+        return wxT( "ROUTER_STATS_ITEM" );
+    }
+
+    ///> Drawn in screen space, so it is visible whatever the viewport
+    const BOX2I ViewBBox() const override
+    {
+        BOX2I bbox;
+        bbox.SetMaximum();
+        return bbox;
+    }
+
+    virtual void ViewDraw( int aLayer, KIGFX::VIEW* aView ) const override;
+
+    virtual void ViewGetLayers( int aLayers[], int& aCount ) const override
+    {
+        aLayers[0] = LAYER_SELECT_OVERLAY;
+        aCount = 1;
+    }
+
+private:
+    std::vector<wxString> m_lines;
+};
+
+#endif
@@ -41,6 +41,9 @@ using namespace std::placeholders;
 #include <confirm.h>
 #include <bitmaps.h>
 #include <collectors.h>
+#include <connectivity/connectivity_data.h>
+#include <connectivity/connectivity_algo.h>
+#include <widgets/progress_reporter.h>
 #include <tool/action_menu.h>
 #include <tool/tool_manager.h>
 #include <tool/grid_menu.h>
@@ -53,6 +56,7 @@ using namespace std::placeholders;
 #include "pns_segment.h"
 #include "pns_router.h"
 #include "pns_itemset.h"
+#include "pns_batch_router.h"
 
 using namespace KIGFX;
 
@@ -1347,6 +1351,89 @@ int ROUTER_TOOL::CustomTrackWidthDialog( const TOOL_EVENT& aEvent )
 }
 
 
+int ROUTER_TOOL::AutorouteAll( const TOOL_EVENT& aEvent )
+{
+    if( m_router->RoutingInProgress() )
+        return 0;
+
+    std::shared_ptr<CONNECTIVITY_DATA> connectivity = board()->GetConnectivity();
+    std::vector<CN_EDGE> edges;
+
+    connectivity->RecalculateRatsnest();
+    connectivity->GetUnconnectedEdges( edges );
+
+    if( edges.empty() )
+    {
+        DisplayInfoMessage( frame(), _( "There are no unrouted connections." ) );
+        return 0;
+    }
+
+    // Nets of selected items are treated as critical and routed first
+    std::set<int> criticalNets;
+
+    for( EDA_ITEM* item : m_toolMgr->GetTool<SELECTION_TOOL>()->GetSelection() )
+    {
+        if( BOARD_CONNECTED_ITEM* bci = dynamic_cast<BOARD_CONNECTED_ITEM*>( item ) )
+            criticalNets.insert( bci->GetNetCode() );
+    }
+
+    m_toolMgr->RunAction( PCB_ACTIONS::selectionClear, true );
+
+    m_router->SyncWorld();
+
+    PNS::ROUTING_SETTINGS& settings = m_router->Settings();
+    PNS::PNS_MODE          savedMode = settings.Mode();
+
+    // Highlight mode would happily create DRC violations
+    if( savedMode == PNS::RM_MarkObstacles )
+        settings.SetMode( PNS::RM_Walkaround );
+
+    PNS::BATCH_ROUTER batch( m_router );
+    std::vector<int>  layers;
+
+    for( LSEQ cu = board()->GetEnabledLayers().CuStack(); cu; ++cu )
+        layers.push_back( *cu );
+
+    batch.SetRoutingLayers( layers );
+
+    for( const CN_EDGE& edge : edges )
+    {
+        PNS::BATCH_ROUTER::CONNECTION conn;
+
+        conn.m_startParent = edge.GetSourceNode()->Parent();
+        conn.m_endParent = edge.GetTargetNode()->Parent();
+        conn.m_net = conn.m_startParent->GetNetCode();
+        conn.m_start = edge.GetSourcePos();
+        conn.m_end = edge.GetTargetPos();
+        conn.m_priority = criticalNets.count( conn.m_net ) ? 1 : 0;
+        conn.m_sizes = m_router->Sizes();
+        conn.m_sizes.Init( board(), m_router->GetWorld()->FindItemByParent( conn.m_startParent ) );
+        conn.m_sizes.AddLayerPair( frame()->GetScreen()->m_Route_Layer_TOP,
+                                   frame()->GetScreen()->m_Route_Layer_BOTTOM );
+
+        batch.AddConnection( conn );
+    }
+
+    WX_PROGRESS_REPORTER reporter( frame(), _( "Autoroute" ), 1 );
+    batch.SetProgressReporter( &reporter );
+
+    frame()->UndoRedoBlock( true );
+    batch.Run();
+    frame()->UndoRedoBlock( false );
+
+    settings.SetMode( savedMode );
+
+    const PNS::BATCH_ROUTER::REPORT& report = batch.Report();
+    wxString                         details = report.Format();
+
+    DisplayInfoMessage( frame(), details.BeforeFirst( '\n' ), details.AfterFirst( '\n' ) );
+
+    canvas()->Refresh();
+
+    return 0;
+}
+
+
 int ROUTER_TOOL::onTrackViaSizeChanged( const TOOL_EVENT& aEvent )
 {
     PNS::SIZES_SETTINGS sizes( m_router->Sizes() );
@@ -1374,6 +1461,7 @@ void ROUTER_TOOL::setTransitions()
     Go( &ROUTER_TOOL::ChangeRouterMode,       PCB_ACTIONS::routerWalkaroundMode.MakeEvent() );
     Go( &ROUTER_TOOL::InlineDrag,             PCB_ACTIONS::routerInlineDrag.MakeEvent() );
     Go( &ROUTER_TOOL::InlineBreakTrack,       PCB_ACTIONS::inlineBreakTrack.MakeEvent() );
+    Go( &ROUTER_TOOL::AutorouteAll,           PCB_ACTIONS::routerAutorouteAll.MakeEvent() );
 
     Go( &ROUTER_TOOL::onViaCommand,           ACT_PlaceThroughVia.MakeEvent() );
     Go( &ROUTER_TOOL::onViaCommand,           ACT_PlaceBlindVia.MakeEvent() );
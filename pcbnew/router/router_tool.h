@@ -45,6 +45,7 @@ public:
     int SettingsDialog( const TOOL_EVENT& aEvent );
     int ChangeRouterMode( const TOOL_EVENT& aEvent );
     int CustomTrackWidthDialog( const TOOL_EVENT& aEvent );
+    int AutorouteAll( const TOOL_EVENT& aEvent );
 
     void setTransitions() override;
 
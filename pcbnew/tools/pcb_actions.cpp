@@ -1167,11 +1167,23 @@ TOOL_ACTION PCB_ACTIONS::routerTuneDiffPairSkew( "pcbnew.LengthTuner.TuneDiffPai
         _( "Tune skew of a differential pair" ), "",
         ps_diff_pair_tune_phase_xpm, AF_ACTIVATE, (void*) PNS::PNS_MODE_TUNE_DIFF_PAIR_SKEW );
 
+TOOL_ACTION PCB_ACTIONS::routerTuneSelected( "pcbnew.LengthTuner.TuneSelected",
+        AS_GLOBAL, 0, "",
+        _( "Tune Selected Tracks to Target Length" ),
+        _( "Add meanders to each selected net until it reaches the target length" ),
+        ps_tune_length_xpm );
+
 TOOL_ACTION PCB_ACTIONS::routerInlineDrag( "pcbnew.InteractiveRouter.InlineDrag",
         AS_CONTEXT, 0, "",
         _( "Drag Track/Via" ), _( "Drags tracks and vias without breaking connections" ),
         drag_xpm );
 
+TOOL_ACTION PCB_ACTIONS::routerAutorouteAll( "pcbnew.InteractiveRouter.AutorouteAll",
+        AS_GLOBAL, 0, "",
+        _( "Autoroute Unrouted Connections" ),
+        _( "Route all unrouted connections using the current router mode" ),
+        add_tracks_xpm );
+
 TOOL_ACTION PCB_ACTIONS::inlineBreakTrack( "pcbnew.InteractiveRouter.InlineBreakTrack",
         AS_GLOBAL, 0, "",
         _( "Break Track" ),
@@ -178,6 +178,9 @@ public:
     /// Activation of the Push and Shove router (skew tuning mode)
     static TOOL_ACTION routerTuneDiffPairSkew;
 
+    /// Tunes the length of all selected nets to the target length
+    static TOOL_ACTION routerTuneSelected;
+
     static TOOL_ACTION routerUndoLastSegment;
 
     /// Activation of the Push and Shove settings dialogs
@@ -192,6 +195,9 @@ public:
     /// Activation of the Push and Shove router (inline dragging mode)
     static TOOL_ACTION routerInlineDrag;
 
+    /// Routes all unrouted ratsnest connections using the Push and Shove engine
+    static TOOL_ACTION routerAutorouteAll;
+
     // Point Editor
     /// Break outline (insert additional points to an edge)
     static TOOL_ACTION pointEditorAddCorner;
@@ -102,13 +102,6 @@ int PCB_VIEWER_TOOLS::ShowPadNumbers( const TOOL_EVENT& aEvent )
     Flip( opts.m_DisplayPadNum );
     frame()->SetDisplayOptions( opts );
     view()->UpdateDisplayOptions( opts );
-
-    for( auto module : board()->Modules() )
-    {
-        for( auto pad : module->Pads() )
-            view()->Update( pad, KIGFX::GEOMETRY );
-    }
-
     canvas()->Refresh();
 
     return 0;
@@ -122,13 +115,6 @@ int PCB_VIEWER_TOOLS::PadDisplayMode( const TOOL_EVENT& aEvent )
     Flip( opts.m_DisplayPadFill );
     frame()->SetDisplayOptions( opts );
     view()->UpdateDisplayOptions( opts );
-
-    for( auto module : board()->Modules() )
-    {
-        for( auto pad : module->Pads() )
-            view()->Update( pad, KIGFX::GEOMETRY );
-    }
-
     canvas()->Refresh();
 
     return 0;
@@ -142,24 +128,6 @@ int PCB_VIEWER_TOOLS::GraphicOutlines( const TOOL_EVENT& aEvent )
     Flip( opts.m_DisplayGraphicsFill );
     frame()->SetDisplayOptions( opts );
     view()->UpdateDisplayOptions( opts );
-
-    for( MODULE* module : board()->Modules() )
-    {
-        for( BOARD_ITEM* item : module->GraphicalItems() )
-        {
-            if( item->Type() == PCB_MODULE_EDGE_T )
-                view()->Update( item, KIGFX::GEOMETRY );
-        }
-    }
-
-    for( BOARD_ITEM* item : board()->Drawings() )
-    {
-        KICAD_T t = item->Type();
-
-        if( t == PCB_LINE_T || t == PCB_DIMENSION_T || t == PCB_TARGET_T )
-            view()->Update( item, KIGFX::GEOMETRY );
-    }
-
     canvas()->Refresh();
 
     return 0;
@@ -173,27 +141,6 @@ int PCB_VIEWER_TOOLS::TextOutlines( const TOOL_EVENT& aEvent )
     Flip( opts.m_DisplayTextFill );
     frame()->SetDisplayOptions( opts );
     view()->UpdateDisplayOptions( opts );
-
-    for( MODULE* module : board()->Modules() )
-    {
-        view()->Update( &module->Reference(), KIGFX::GEOMETRY );
-        view()->Update( &module->Value(), KIGFX::GEOMETRY );
-
-        for( BOARD_ITEM* item : module->GraphicalItems() )
-        {
-            if( item->Type() == PCB_MODULE_TEXT_T )
-                view()->Update( item, KIGFX::GEOMETRY );
-        }
-    }
-
-    for( BOARD_ITEM* item : board()->Drawings() )
-    {
-        KICAD_T t = item->Type();
-
-        if( t == PCB_TEXT_T || t == PCB_DIMENSION_T )
-            view()->Update( item, KIGFX::GEOMETRY );
-    }
-
     canvas()->Refresh();
 
     return 0;
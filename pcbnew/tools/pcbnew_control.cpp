@@ -128,13 +128,6 @@ int PCBNEW_CONTROL::TrackDisplayMode( const TOOL_EVENT& aEvent )
     Flip( opts.m_DisplayPcbTrackFill );
     m_frame->SetDisplayOptions( opts );
     view()->UpdateDisplayOptions( opts );
-
-    for( auto track : board()->Tracks() )
-    {
-        if( track->Type() == PCB_TRACE_T )
-            view()->Update( track, KIGFX::GEOMETRY );
-    }
-
     canvas()->Refresh();
 
     return 0;
@@ -176,13 +169,6 @@ int PCBNEW_CONTROL::ViaDisplayMode( const TOOL_EVENT& aEvent )
     Flip( opts.m_DisplayViaFill );
     view()->UpdateDisplayOptions( opts );
     m_frame->SetDisplayOptions( opts );
-
-    for( auto track : board()->Tracks() )
-    {
-        if( track->Type() == PCB_TRACE_T || track->Type() == PCB_VIA_T )
-            view()->Update( track, KIGFX::GEOMETRY );
-    }
-
     canvas()->Refresh();
 
     return 0;
@@ -207,10 +193,6 @@ int PCBNEW_CONTROL::ZoneDisplayMode( const TOOL_EVENT& aEvent )
 
     m_frame->SetDisplayOptions( opts );
     view()->UpdateDisplayOptions( opts );
-
-    for( int i = 0; i < board()->GetAreaCount(); ++i )
-        view()->Update( board()->GetArea( i ), KIGFX::GEOMETRY );
-
     canvas()->Refresh();
 
     return 0;
@@ -223,8 +205,10 @@ int PCBNEW_CONTROL::HighContrastMode( const TOOL_EVENT& aEvent )
 
     Flip( opts.m_ContrastModeDisplay );
     m_frame->SetDisplayOptions( opts );
+
+    // The colors are updated once, when the display options are applied
+    canvas()->SetHighContrastLayer( m_frame->GetActiveLayer(), false );
     view()->UpdateDisplayOptions( opts );
-    canvas()->SetHighContrastLayer( m_frame->GetActiveLayer() );
 
     return 0;
 }
@@ -229,15 +229,21 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
         // Note also non copper zones are already clipped
         else if( m_brdOutlinesValid && zone.m_zone->IsOnCopperLayer() )
         {
-            for( int idx = 0; idx < poly.OutlineCount(); )
+            std::vector<VECTOR2I> firstPoints;
+            std::vector<bool>     insideBoard;
+
+            for( int idx = 0; idx < poly.OutlineCount(); idx++ )
             {
-                if( poly.Polygon( idx ).empty() ||
-                    !m_boardOutline.Contains( poly.Polygon( idx ).front().CPoint( 0 ) ) )
-                {
+                const SHAPE_POLY_SET::POLYGON& polygon = poly.CPolygon( idx );
+                firstPoints.push_back( polygon.empty() ? VECTOR2I() : polygon.front().CPoint( 0 ) );
+            }
+
+            m_boardOutline.Contains( firstPoints, insideBoard );
+
+            for( int idx = poly.OutlineCount() - 1; idx >= 0; idx-- )
+            {
+                if( poly.CPolygon( idx ).empty() || !insideBoard[idx] )
                     poly.DeletePolygon( idx );
-                }
-                else
-                     idx++;
             }
         }
 
@@ -393,9 +399,7 @@ void ZONE_FILLER::addKnockout( D_PAD* aPad, int aGap, SHAPE_POLY_SET& aHoles )
     {
         // the pad shape in zone can be its convex hull or the shape itself
         SHAPE_POLY_SET outline( aPad->GetCustomShapeAsPolygon() );
-        int numSegs = std::max( GetArcToSegmentCount( aGap, m_high_def, 360.0 ), 6 );
-        double correction = GetCircletoPolyCorrectionFactor( numSegs );
-        outline.Inflate( KiROUND( aGap * correction ), numSegs );
+        outline.Inflate( aGap, SHAPE_POLY_SET::ROUND_ALL_CORNERS, m_high_def );
         aPad->CustomShapeAsPolygonToBoardPosition( &outline, aPad->GetPosition(),
                                                    aPad->GetOrientation() );
 
@@ -505,7 +509,7 @@ void ZONE_FILLER::knockoutThermalReliefs( const ZONE_CONTAINER* aZone, SHAPE_POL
         }
     }
 
-    holes.Simplify( SHAPE_POLY_SET::PM_FAST );
+    holes.UnionAll( SHAPE_POLY_SET::PM_FAST );
     aFill.BooleanSubtract( holes, SHAPE_POLY_SET::PM_FAST );
 }
 
@@ -657,7 +661,7 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
         }
     }
 
-    aHoles.Simplify( SHAPE_POLY_SET::PM_FAST );
+    aHoles.UnionAll( SHAPE_POLY_SET::PM_FAST );
 }
 
 
@@ -0,0 +1,240 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * Tests for the free space of CACHED_CONTAINER_RAM, reused by items of any size and released
+ * once it is not needed anymore
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <gal/opengl/cached_container_ram.h>
+#include <gal/opengl/vertex_item.h>
+#include <gal/opengl/vertex_manager.h>
+
+#include <memory>
+#include <random>
+
+using namespace KIGFX;
+
+
+///> Size of a page of the container, in vertices
+static const unsigned int PAGE = CACHED_CONTAINER_RAM::PAGE_SIZE;
+
+
+/*
+ * There is no OpenGL context in the tests.  The container only needs names for the vertex
+ * buffers of its segments, and does not upload anything unless it is unmapped.
+ */
+static void GLAPIENTRY genBuffers( GLsizei aCount, GLuint* aBuffers )
+{
+    static GLuint next = 1;
+
+    for( GLsizei i = 0; i < aCount; ++i )
+        aBuffers[i] = next++;
+}
+
+
+static void GLAPIENTRY deleteBuffers( GLsizei, const GLuint* )
+{
+}
+
+
+struct CACHED_CONTAINER_RAM_FIXTURE
+{
+    CACHED_CONTAINER_RAM_FIXTURE() :
+            m_manager( false )
+    {
+        __glewGenBuffers = genBuffers;
+        __glewDeleteBuffers = deleteBuffers;
+
+        m_container.reset( new CACHED_CONTAINER_RAM( PAGE ) );
+    }
+
+    /**
+     * Stores a new item of aSize vertices, each one holding the item index and its own index
+     */
+    VERTEX_ITEM* add( unsigned int aSize )
+    {
+        m_items.emplace_back( new VERTEX_ITEM( m_manager ) );
+
+        VERTEX_ITEM* item = m_items.back().get();
+
+        m_container->SetItem( item );
+        VERTEX* vertices = m_container->Allocate( aSize );
+        BOOST_REQUIRE( vertices );
+
+        for( unsigned int i = 0; i < aSize; ++i )
+        {
+            vertices[i].x = m_items.size() - 1;
+            vertices[i].y = i;
+        }
+
+        m_container->FinishItem();
+
+        return item;
+    }
+
+    void remove( size_t aIndex )
+    {
+        m_container->Delete( m_items[aIndex].get() );
+        m_items[aIndex].reset();
+    }
+
+    void removeAll()
+    {
+        for( size_t i = 0; i < m_items.size(); ++i )
+        {
+            if( m_items[i] )
+                remove( i );
+        }
+    }
+
+    /**
+     * Checks that the stored items still hold the vertices they were added with
+     */
+    void checkData() const
+    {
+        for( size_t i = 0; i < m_items.size(); ++i )
+        {
+            const VERTEX_ITEM* item = m_items[i].get();
+
+            if( !item )
+                continue;
+
+            const VERTEX* vertices = m_container->GetVertices( item->GetOffset() );
+            bool          intact = true;
+
+            for( unsigned int j = 0; j < item->GetSize() && intact; ++j )
+                intact = vertices[j].x == i && vertices[j].y == j;
+
+            BOOST_CHECK_MESSAGE( intact, "Item " << i );
+        }
+    }
+
+    ///> Owner of the items, its container is not used
+    VERTEX_MANAGER m_manager;
+
+    std::unique_ptr<CACHED_CONTAINER_RAM>     m_container;
+    std::vector<std::unique_ptr<VERTEX_ITEM>> m_items;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( CachedContainerRam, CACHED_CONTAINER_RAM_FIXTURE )
+
+
+/**
+ * The space freed by small items is merged, so larger items fit in it later
+ */
+BOOST_AUTO_TEST_CASE( MergedFreeSpace )
+{
+    for( unsigned int size = 500; size <= 5000; size += 250 )
+    {
+        m_container->Map();
+
+        for( unsigned int used = 0; used + size <= PAGE / 2; used += size )
+            add( size );
+
+        checkData();
+        BOOST_CHECK_EQUAL( m_container->GetSize(), PAGE );
+
+        removeAll();
+    }
+
+    // The whole segment is a single free chunk again
+    m_container->Map();
+    add( PAGE );
+    BOOST_CHECK_EQUAL( m_container->GetSize(), PAGE );
+}
+
+
+/**
+ * The items of a sparse segment are moved with their data, and empty segments are released
+ */
+BOOST_AUTO_TEST_CASE( Compaction )
+{
+    m_container->Map();
+
+    // The first segment stores 262 items, the second one the rest
+    for( int i = 0; i < 400; ++i )
+        add( 1000 );
+
+    BOOST_CHECK_EQUAL( m_container->GetSize(), 2 * PAGE );
+
+    for( int i = 0; i < 250; ++i )
+        remove( i );
+
+    m_container->Map();
+    checkData();
+
+    for( const std::unique_ptr<VERTEX_ITEM>& item : m_items )
+    {
+        if( item )
+            BOOST_CHECK_GE( item->GetOffset(), PAGE );
+    }
+
+    // One empty segment is kept
+    BOOST_CHECK_EQUAL( m_container->GetSize(), 2 * PAGE );
+
+    removeAll();
+    m_container->Map();
+    BOOST_CHECK_EQUAL( m_container->GetSize(), PAGE );
+
+    add( PAGE );
+    BOOST_CHECK_EQUAL( m_container->GetSize(), PAGE );
+}
+
+
+/**
+ * Items of random sizes added and removed between updates don't make the container grow
+ */
+BOOST_AUTO_TEST_CASE( BoundedSize )
+{
+    std::mt19937                                rng( 0 );
+    std::uniform_int_distribution<unsigned int> sizes( 10, 4000 );
+    unsigned int                                used = 0;
+
+    for( int update = 0; update < 200; ++update )
+    {
+        m_container->Map();
+
+        while( used < PAGE / 4 )
+            used += add( sizes( rng ) )->GetSize();
+
+        // Remove a half of the items
+        for( size_t i = 0; i < m_items.size(); ++i )
+        {
+            if( m_items[i] && rng() % 2 )
+            {
+                used -= m_items[i]->GetSize();
+                remove( i );
+            }
+        }
+
+        checkData();
+        BOOST_CHECK_LE( m_container->GetSize(), 2 * PAGE );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -192,18 +192,36 @@ inline SHAPE_LINE_CHAIN MakeSquarePolyLine( int aSize, const VECTOR2I& aCentre )
 {
     SHAPE_LINE_CHAIN polyLine;
 
-    const VECTOR2I corner = aCentre + aSize / 2;
+    const int half = aSize / 2;
 
-    polyLine.Append( VECTOR2I( corner.x, corner.y ) );
-    polyLine.Append( VECTOR2I( -corner.x, corner.y ) ) ;
-    polyLine.Append( VECTOR2I( -corner.x, -corner.y ) );
-    polyLine.Append( VECTOR2I( corner.x, -corner.y ) );
+    polyLine.Append( aCentre + VECTOR2I( half, half ) );
+    polyLine.Append( aCentre + VECTOR2I( -half, half ) );
+    polyLine.Append( aCentre + VECTOR2I( -half, -half ) );
+    polyLine.Append( aCentre + VECTOR2I( half, -half ) );
 
     polyLine.SetClosed( true );
 
     return polyLine;
 }
 
+/**
+ * @brief Area of a polygon set: the area of the outlines less the area of their holes
+ */
+inline double PolySetArea( const SHAPE_POLY_SET& aPolySet )
+{
+    double area = 0.0;
+
+    for( int i = 0; i < aPolySet.OutlineCount(); i++ )
+    {
+        area += std::abs( aPolySet.COutline( i ).Area() );
+
+        for( int j = 0; j < aPolySet.HoleCount( i ); j++ )
+            area -= std::abs( aPolySet.CHole( i, j ).Area() );
+    }
+
+    return area;
+}
+
 /*
  * @brief Fillet every polygon in a set and return a new set
  */
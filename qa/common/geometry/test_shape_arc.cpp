@@ -24,6 +24,7 @@
 #include <geometry/shape_arc.h>
 
 #include <geometry/shape_line_chain.h>
+#include <geometry/shape_segment.h>
 
 #include <unit_test_utils/geometry.h>
 #include <unit_test_utils/numeric.h>
@@ -424,4 +425,188 @@ BOOST_AUTO_TEST_CASE( ArcToPolyline )
 }
 
 
+/**
+ * Points sampled along an arc, for brute force reference distances
+ */
+static std::vector<VECTOR2D> sampleArc( const SHAPE_ARC& aArc, int aCount )
+{
+    std::vector<VECTOR2D> points;
+    const VECTOR2D        c( aArc.GetCenter() );
+    const double          r = ( VECTOR2D( aArc.GetP0() ) - c ).EuclideanNorm();
+
+    for( int i = 0; i <= aCount; i++ )
+    {
+        double a = ( aArc.GetStartAngle() + aArc.GetCentralAngle() * i / aCount ) * M_PI / 180.0;
+        points.emplace_back( c.x + r * cos( a ), c.y + r * sin( a ) );
+    }
+
+    return points;
+}
+
+
+static double segDistance( const SEG& aSeg, const VECTOR2D& aP )
+{
+    const VECTOR2D a( aSeg.A );
+    const VECTOR2D ab = VECTOR2D( aSeg.B ) - a;
+    const double   len2 = ab.x * ab.x + ab.y * ab.y;
+    double         t = 0.0;
+
+    if( len2 > 0.0 )
+        t = std::max( 0.0, std::min( 1.0, ( ( aP.x - a.x ) * ab.x + ( aP.y - a.y ) * ab.y ) / len2 ) );
+
+    return ( a + ab * t - aP ).EuclideanNorm();
+}
+
+
+/**
+ * Distances to points, segments and other arcs are computed on the true arc
+ */
+BOOST_AUTO_TEST_CASE( ExactDistance )
+{
+    const std::vector<SHAPE_ARC> arcs = {
+        SHAPE_ARC( { 0, 0 }, { 10000, 0 }, 90 ),
+        SHAPE_ARC( { 1000, -500 }, { -9000, 2000 }, -135 ),
+        SHAPE_ARC( { 0, 0 }, { 0, 7000 }, 300 ),
+    };
+
+    const std::vector<SHAPE_ARC> others = {
+        SHAPE_ARC( { 15000, 15000 }, { 5000, 15000 }, 90 ),
+        SHAPE_ARC( { 0, 0 }, { 5000, 5000 }, -45 ),
+        SHAPE_ARC( { 3000, 3000 }, { 3000, -8000 }, 180 ),
+    };
+
+    const int samples = 20000;
+
+    for( size_t i = 0; i < arcs.size(); i++ )
+    {
+        BOOST_TEST_CONTEXT( "Arc " << i )
+        {
+            const SHAPE_ARC&            arc = arcs[i];
+            const std::vector<VECTOR2D> pts = sampleArc( arc, samples );
+
+            for( int x = -15000; x <= 15000; x += 2500 )
+            {
+                for( int y = -15000; y <= 15000; y += 2500 )
+                {
+                    const VECTOR2D p( x, y );
+                    const SEG      seg( VECTOR2I( x, y ), VECTOR2I( x + 3000, y - 7000 ) );
+
+                    double refPt = std::numeric_limits<double>::max();
+                    double refSeg = std::numeric_limits<double>::max();
+
+                    for( const VECTOR2D& q : pts )
+                    {
+                        refPt = std::min( refPt, ( q - p ).EuclideanNorm() );
+                        refSeg = std::min( refSeg, segDistance( seg, q ) );
+                    }
+
+                    BOOST_CHECK_SMALL( sqrt( arc.SquaredDistance( VECTOR2I( x, y ) ) ) - refPt,
+                                       2.0 );
+
+                    // A segment crossing the arc gives exactly 0, the sampled reference a bit
+                    // more
+                    BOOST_CHECK_SMALL( sqrt( arc.SquaredDistance( seg ) ) - refSeg, 3.0 );
+                    BOOST_CHECK_GE( sqrt( arc.SquaredDistance( seg ) ), refSeg - 3.0 );
+                }
+            }
+
+            for( size_t j = 0; j < others.size(); j++ )
+            {
+                const std::vector<VECTOR2D> otherPts = sampleArc( others[j], 3000 );
+                const std::vector<VECTOR2D> coarse = sampleArc( arc, 3000 );
+                double                      ref = std::numeric_limits<double>::max();
+
+                for( const VECTOR2D& p : coarse )
+                {
+                    for( const VECTOR2D& q : otherPts )
+                        ref = std::min( ref, ( q - p ).EuclideanNorm() );
+                }
+
+                BOOST_TEST_CONTEXT( "Other arc " << j )
+                {
+                    double dist = sqrt( arc.SquaredDistance( others[j] ) );
+
+                    BOOST_CHECK_LE( dist, ref + 1.0 );
+                    BOOST_CHECK_GE( dist, ref - 15.0 );
+                    BOOST_CHECK_EQUAL( dist, sqrt( others[j].SquaredDistance( arc ) ) );
+                }
+            }
+        }
+    }
+}
+
+
+/**
+ * A line chain containing an arc collides with the true arc, not with its polyline
+ */
+BOOST_AUTO_TEST_CASE( ChainCollidesWithTrueArc )
+{
+    const SHAPE_ARC  arc( { 0, 0 }, { 100000, 0 }, 90 );
+    SHAPE_LINE_CHAIN chain;
+
+    chain.Append( -100000, 0 );
+    chain.Append( arc );
+
+    // Half way between two vertices of the polyline, where it is furthest from the arc
+    const SHAPE_LINE_CHAIN& poly = arc.ConvertToPolyline();
+    const VECTOR2I          mid = ( poly.CPoint( 0 ) + poly.CPoint( 1 ) ) / 2;
+    const VECTOR2D          dir = VECTOR2D( mid ).Resize( 1.0 );
+
+    const VECTOR2I onArc( KiROUND( dir.x * 100000 ), KiROUND( dir.y * 100000 ) );
+    const VECTOR2I outside( KiROUND( dir.x * 100020 ), KiROUND( dir.y * 100020 ) );
+
+    BOOST_REQUIRE_GT( SEG( poly.CPoint( 0 ), poly.CPoint( 1 ) ).Distance( onArc ), 20 );
+
+    BOOST_CHECK( chain.Collide( onArc, 2 ) );
+    BOOST_CHECK( chain.Collide( outside, 25 ) );
+    BOOST_CHECK( !chain.Collide( outside, 15 ) );
+    BOOST_CHECK_LE( chain.Distance( onArc ), 1 );
+
+    // And the plain segment is still there
+    BOOST_CHECK( chain.Collide( VECTOR2I( -50000, 10 ), 11 ) );
+    BOOST_CHECK( !chain.Collide( VECTOR2I( -50000, 10 ), 9 ) );
+
+    // Collisions between shapes use the true arc too
+    const SEG           away( outside, outside + VECTOR2I( 1000, 1000 ) );
+    const SHAPE_SEGMENT wide( away, 40 );
+    const SHAPE_SEGMENT narrow( away, 20 );
+    const SHAPE*        wideShape = &wide;
+    const SHAPE*        narrowShape = &narrow;
+
+    BOOST_CHECK( wideShape->Collide( &arc, 5 ) );
+    BOOST_CHECK( !narrowShape->Collide( &arc, 5 ) );
+}
+
+
+/**
+ * The closing segment of a closed chain made of a single arc is the chord of the arc: the
+ * first and last points belong to the same arc, but the chord is not part of it
+ */
+BOOST_AUTO_TEST_CASE( ClosedSingleArcKeepsChord )
+{
+    // Half circle above the X axis, the chord runs along the axis through the center
+    const SHAPE_ARC        arc( { 0, 0 }, { 1000000, 0 }, 180 );
+    const SHAPE_LINE_CHAIN chain( arc, true );
+
+    BOOST_REQUIRE( chain.IsClosed() );
+    BOOST_REQUIRE_EQUAL( chain.ArcIndex( 0 ), chain.ArcIndex( chain.PointCount() - 1 ) );
+
+    // Crosses the chord, far from the arc
+    const SEG crossing( { 0, -1000 }, { 0, 1000 } );
+
+    BOOST_CHECK( chain.Collide( crossing, 1 ) );
+    BOOST_CHECK_EQUAL( chain.Distance( VECTOR2I( 0, 0 ), true ), 0 );
+    BOOST_CHECK_LE( chain.Distance( VECTOR2I( 0, 100 ), true ), 100 );
+
+    // The arc itself is still tested as a true arc
+    BOOST_CHECK( chain.Collide( VECTOR2I( 0, 1000000 ), 1 ) );
+
+    // Arc to chain collisions see the chord too
+    const SHAPE_ARC small( { 0, 0 }, { 0, 1000 }, 180 );
+    const SHAPE*    smallShape = &small;
+
+    BOOST_CHECK( smallShape->Collide( &chain, 1 ) );
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
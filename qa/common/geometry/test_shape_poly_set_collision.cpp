@@ -160,6 +160,38 @@ BOOST_AUTO_TEST_CASE( Collide )
     BOOST_CHECK( common.holeyPolySet.Collide( VECTOR2I( 11, 11 ), 5 ) );
 }
 
+/**
+ * This test checks the behaviour of the Collide (with a segment) method.
+ */
+BOOST_AUTO_TEST_CASE( CollideSegment )
+{
+    const SHAPE_POLY_SET& polySet = common.holeyPolySet;
+
+    // Segment far away from the set
+    const SEG outside( VECTOR2I( 200, 200 ), VECTOR2I( 300, 300 ) );
+    BOOST_CHECK( !polySet.Collide( outside, 0 ) );
+    BOOST_CHECK( !polySet.Collide( outside, 5 ) );
+
+    // Segment crossing the outline
+    BOOST_CHECK( polySet.Collide( SEG( VECTOR2I( -10, 50 ), VECTOR2I( 10, 50 ) ), 0 ) );
+
+    // Segment running along the outline, 3 units outside of it: collides only when the
+    // clearance is larger than the gap, even though none of its ends is near a corner
+    const SEG alongOutline( VECTOR2I( -3, 10 ), VECTOR2I( -3, 90 ) );
+    BOOST_CHECK( !polySet.Collide( alongOutline, 0 ) );
+    BOOST_CHECK( !polySet.Collide( alongOutline, 2 ) );
+    BOOST_CHECK( polySet.Collide( alongOutline, 5 ) );
+
+    // Segment inside the triangular hole, 2 units away from its closest edge
+    const SEG inHole( VECTOR2I( 44, 12 ), VECTOR2I( 46, 12 ) );
+    BOOST_CHECK( !polySet.Collide( inHole, 0 ) );
+    BOOST_CHECK( !polySet.Collide( inHole, 1 ) );
+    BOOST_CHECK( polySet.Collide( inHole, 5 ) );
+
+    // Segment fully inside the polygon
+    BOOST_CHECK( polySet.Collide( SEG( VECTOR2I( 70, 70 ), VECTOR2I( 80, 80 ) ), 0 ) );
+}
+
 /**
  * This test checks the behaviour of the CollideVertex method, testing whether the collision with
  * vertices is well detected
@@ -193,4 +225,107 @@ BOOST_AUTO_TEST_CASE( CollideVertexWithClearance )
     }
 }
 
+/**
+ * Checks that queries answered through the edge index match the linear ones, and that the
+ * index is dropped when the set is modified
+ */
+BOOST_AUTO_TEST_CASE( EdgeIndex )
+{
+    SHAPE_POLY_SET   indexed;
+    SHAPE_LINE_CHAIN outline;
+    SHAPE_LINE_CHAIN hole;
+
+    // A wavy outline with enough vertices to be worth indexing
+    for( int i = 0; i < 360; i++ )
+    {
+        double a = 2.0 * M_PI * i / 360;
+        double r = 1000.0 * ( 1.0 + 0.2 * sin( 7.0 * a ) );
+        outline.Append( KiROUND( r * cos( a ) ), KiROUND( r * sin( a ) ) );
+    }
+
+    outline.SetClosed( true );
+    indexed.AddOutline( outline );
+
+    hole.Append( -100, -100 );
+    hole.Append( 100, -100 );
+    hole.Append( 100, 100 );
+    hole.Append( -100, 100 );
+    hole.SetClosed( true );
+    indexed.AddHole( hole );
+
+    SHAPE_POLY_SET linear( indexed );
+    linear.SetEdgeIndexEnabled( false );
+
+    indexed.BuildEdgeIndex();
+    BOOST_CHECK( indexed.IsEdgeIndexBuilt() );
+
+    for( int x = -1300; x <= 1300; x += 37 )
+    {
+        for( int y = -1300; y <= 1300; y += 41 )
+        {
+            const VECTOR2I p( x, y );
+            const SEG      s( p, p + VECTOR2I( 60, -25 ) );
+
+            BOOST_CHECK_EQUAL( indexed.Contains( p ), linear.Contains( p ) );
+            BOOST_CHECK_EQUAL( indexed.Collide( p, 20 ), linear.Collide( p, 20 ) );
+            BOOST_CHECK_EQUAL( indexed.Collide( s, 0 ), linear.Collide( s, 0 ) );
+            BOOST_CHECK_EQUAL( indexed.Collide( s, 20 ), linear.Collide( s, 20 ) );
+            BOOST_CHECK_EQUAL( indexed.SquaredDistance( p ), linear.SquaredDistance( p ) );
+            BOOST_CHECK_EQUAL( indexed.SquaredDistance( s ), linear.SquaredDistance( s ) );
+        }
+    }
+
+    for( int i = 0; i < outline.PointCount(); i += 13 )
+        BOOST_CHECK( indexed.PointOnEdge( outline.CPoint( i ) ) );
+
+    indexed.Move( VECTOR2I( 5, 5 ) );
+    BOOST_CHECK( !indexed.IsEdgeIndexBuilt() );
+    BOOST_CHECK( !indexed.Contains( VECTOR2I( 103, 103 ) ) );
+    BOOST_CHECK( indexed.Contains( VECTOR2I( 106, 106 ) ) );
+}
+
+/**
+ * Checks that an index left stale by an edit made through an earlier reference to a contour
+ * is not used
+ */
+BOOST_AUTO_TEST_CASE( EdgeIndexStaleContour )
+{
+    SHAPE_POLY_SET   set;
+    SHAPE_LINE_CHAIN square;
+
+    // A square with 25 vertices per side
+    for( int i = 0; i < 25; i++ )
+        square.Append( i * 40, 0 );
+
+    for( int i = 0; i < 25; i++ )
+        square.Append( 1000, i * 40 );
+
+    for( int i = 0; i < 25; i++ )
+        square.Append( 1000 - i * 40, 1000 );
+
+    for( int i = 0; i < 25; i++ )
+        square.Append( 0, 1000 - i * 40 );
+
+    square.SetClosed( true );
+    set.AddOutline( square );
+
+    SHAPE_LINE_CHAIN& contour = set.Outline( 0 );
+
+    set.BuildEdgeIndex();
+    BOOST_CHECK( set.Contains( VECTOR2I( 500, 500 ) ) );
+
+    // Moved contour: different first vertex
+    contour.Move( VECTOR2I( 5000, 0 ) );
+    BOOST_CHECK( !set.Contains( VECTOR2I( 500, 500 ) ) );
+    BOOST_CHECK( set.Contains( VECTOR2I( 5500, 500 ) ) );
+
+    set.InvalidateEdgeIndex();
+    set.BuildEdgeIndex();
+
+    // Same first vertex, one vertex less: the corner at (6000, 1000) is cut off
+    contour.Remove( 50 );
+    BOOST_CHECK( !set.Contains( VECTOR2I( 5990, 990 ) ) );
+    BOOST_CHECK( set.Contains( VECTOR2I( 5500, 500 ) ) );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,115 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_poly_set.h>
+
+#include "geom_test_utils.h"
+
+
+BOOST_AUTO_TEST_SUITE( SPSFracture )
+
+
+/**
+ * A single hole is bridged to the outline edge on its left
+ */
+BOOST_AUTO_TEST_CASE( SingleHole )
+{
+    SHAPE_POLY_SET polySet;
+
+    polySet.AddOutline( GEOM_TEST::MakeSquarePolyLine( 100, VECTOR2I( 0, 0 ) ) );
+    polySet.AddHole( GEOM_TEST::MakeSquarePolyLine( 20, VECTOR2I( 0, 0 ) ) );
+    polySet.Fracture( SHAPE_POLY_SET::PM_FAST );
+
+    BOOST_REQUIRE_EQUAL( polySet.OutlineCount(), 1 );
+    BOOST_CHECK_EQUAL( polySet.HoleCount( 0 ), 0 );
+
+    // 4 outline corners, 4 hole corners and the 3 edges added by the bridge
+    BOOST_CHECK_EQUAL( polySet.COutline( 0 ).PointCount(), 11 );
+    BOOST_CHECK_EQUAL( std::abs( polySet.COutline( 0 ).Area() ), 100.0 * 100.0 - 20.0 * 20.0 );
+
+    // The bridge runs horizontally from the hole's left edge to the outline's left edge
+    const SHAPE_LINE_CHAIN& outline = polySet.COutline( 0 );
+    int                     bridgePoints = 0;
+
+    for( int i = 0; i < outline.PointCount(); i++ )
+    {
+        if( outline.CPoint( i ).x == -50 && outline.CPoint( i ).y != -50
+                && outline.CPoint( i ).y != 50 )
+        {
+            bridgePoints++;
+        }
+    }
+
+    BOOST_CHECK_EQUAL( bridgePoints, 2 );
+}
+
+
+/**
+ * A grid of holes (as in a zone with many thermal reliefs) gives a single outline with the
+ * right area, whatever the bridging order
+ */
+BOOST_AUTO_TEST_CASE( HoleGrid )
+{
+    const int size = 10000;
+    const int pitch = 500;
+
+    const int holeSize = pitch / 5;
+
+    SHAPE_POLY_SET polySet;
+    polySet.AddOutline( GEOM_TEST::MakeSquarePolyLine( size, VECTOR2I( 0, 0 ) ) );
+
+    int holes = 0;
+
+    // Holes in a column are bridged at the same X: check the ties are handled.  Columns are
+    // shifted a little so bridges don't land exactly on the corners of the next hole, which
+    // would merge points.
+    for( int x = -size / 2 + pitch; x < size / 2; x += pitch )
+    {
+        for( int y = -size / 2 + pitch; y < size / 2; y += pitch )
+        {
+            const VECTOR2I centre( x, y + ( x / pitch ) * 7 );
+
+            polySet.AddHole( GEOM_TEST::MakeSquarePolyLine( holeSize, centre ) );
+            holes++;
+        }
+    }
+
+    double area = (double) size * size - (double) holes * holeSize * holeSize;
+
+    polySet.Fracture( SHAPE_POLY_SET::PM_FAST );
+
+    BOOST_REQUIRE_EQUAL( polySet.OutlineCount(), 1 );
+    BOOST_CHECK_EQUAL( polySet.HoleCount( 0 ), 0 );
+    BOOST_CHECK_EQUAL( polySet.COutline( 0 ).PointCount(), 4 + holes * 7 );
+    BOOST_CHECK_CLOSE( std::abs( polySet.COutline( 0 ).Area() ), area, 1e-6 );
+
+    // Unfracturing gives back the holes
+    polySet.Unfracture( SHAPE_POLY_SET::PM_FAST );
+
+    BOOST_REQUIRE_EQUAL( polySet.OutlineCount(), 1 );
+    BOOST_CHECK_EQUAL( polySet.HoleCount( 0 ), holes );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
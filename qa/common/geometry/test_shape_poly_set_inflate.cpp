@@ -0,0 +1,175 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_poly_set.h>
+
+#include "geom_test_utils.h"
+
+
+BOOST_AUTO_TEST_SUITE( SPSInflate )
+
+
+/**
+ * Inflating with a maximum error must contain the exact offset, and not go further than the
+ * error beyond it
+ */
+BOOST_AUTO_TEST_CASE( MaxErrorIsConservative )
+{
+    const int              size = 1000000;
+    const int              maxError = 5000;
+    const SHAPE_LINE_CHAIN original = GEOM_TEST::MakeSquarePolyLine( size, VECTOR2I( 0, 0 ) );
+
+    for( int amount : { 20000, 200000, 2000000 } )
+    {
+        BOOST_TEST_CONTEXT( "Amount " << amount )
+        {
+            SHAPE_POLY_SET polySet( original );
+            polySet.Inflate( amount, SHAPE_POLY_SET::ROUND_ALL_CORNERS, maxError );
+
+            BOOST_REQUIRE_EQUAL( polySet.OutlineCount(), 1 );
+
+            // Points of the exact offset around a corner, which is where the arc is (a unit
+            // inside it, as the chords can touch it)
+            const VECTOR2I corner( size / 2, size / 2 );
+
+            for( int i = 0; i <= 90; i++ )
+            {
+                double   a = M_PI / 180.0 * i;
+                VECTOR2I p( corner.x + (int) ( ( amount - 2 ) * cos( a ) ),
+                            corner.y + (int) ( ( amount - 2 ) * sin( a ) ) );
+
+                BOOST_CHECK_MESSAGE( polySet.Contains( p ), "Point " << p );
+            }
+
+            // And no vertex further than the error from it
+            const SHAPE_LINE_CHAIN& outline = polySet.COutline( 0 );
+
+            for( int i = 0; i < outline.PointCount(); i++ )
+            {
+                int dist = original.Distance( outline.CPoint( i ), true );
+                BOOST_CHECK_LE( dist, amount + maxError + 2 );
+            }
+        }
+    }
+
+    // The segment count follows the amount: a small offset needs fewer vertices
+    SHAPE_POLY_SET smallOffset( original );
+    SHAPE_POLY_SET largeOffset( original );
+
+    smallOffset.Inflate( 20000, SHAPE_POLY_SET::ROUND_ALL_CORNERS, maxError );
+    largeOffset.Inflate( 2000000, SHAPE_POLY_SET::ROUND_ALL_CORNERS, maxError );
+
+    BOOST_CHECK_LT( smallOffset.TotalVertices(), largeOffset.TotalVertices() );
+}
+
+
+/**
+ * Deflating with a maximum error must stay inside the exact offset
+ */
+BOOST_AUTO_TEST_CASE( MaxErrorDeflate )
+{
+    const int size = 1000000;
+    const int amount = 100000;
+
+    // An L shape: deflating rounds its inner corner
+    SHAPE_LINE_CHAIN outline;
+
+    outline.Append( 0, 0 );
+    outline.Append( size, 0 );
+    outline.Append( size, size / 2 );
+    outline.Append( size / 2, size / 2 );
+    outline.Append( size / 2, size );
+    outline.Append( 0, size );
+    outline.SetClosed( true );
+
+    SHAPE_POLY_SET polySet( outline );
+    polySet.Deflate( amount, SHAPE_POLY_SET::ROUND_ALL_CORNERS, 1000 );
+
+    BOOST_REQUIRE_EQUAL( polySet.OutlineCount(), 1 );
+
+    const SHAPE_LINE_CHAIN& result = polySet.COutline( 0 );
+
+    for( int i = 0; i < result.PointCount(); i++ )
+        BOOST_CHECK_GE( outline.Distance( result.CPoint( i ), true ), amount );
+}
+
+
+/**
+ * Large sets are offset by groups of polygons: the result must be the same area as a single
+ * offset, which offsets each contour then merges them all
+ */
+BOOST_AUTO_TEST_CASE( LargeSetMatchesSingleOffset )
+{
+    // Rows of overlapping squares: 600 operands in all, 40 per row
+    std::vector<SHAPE_POLY_SET> rows( 15 );
+    SHAPE_POLY_SET              operands;
+
+    for( int row = 0; row < 15; row++ )
+    {
+        for( int col = 0; col < 40; col++ )
+        {
+            const VECTOR2I centre( col * 700, row * 3000 );
+
+            rows[row].AddOutline( GEOM_TEST::MakeSquarePolyLine( 1000, centre ) );
+            operands.AddOutline( GEOM_TEST::MakeSquarePolyLine( 1000, centre ) );
+        }
+    }
+
+    for( int amount : { 300, -200 } )
+    {
+        SHAPE_POLY_SET reference;
+
+        // Each row is small enough to be offset in one go
+        for( const SHAPE_POLY_SET& row : rows )
+        {
+            SHAPE_POLY_SET offset( row );
+            offset.Inflate( amount, 16 );
+            reference.Append( offset );
+        }
+
+        reference.Simplify( SHAPE_POLY_SET::PM_FAST );
+
+        // Serial, as in the zone filler, and on several threads
+        for( unsigned threads : { 1u, 4u } )
+        {
+            BOOST_TEST_CONTEXT( "Amount " << amount << ", " << threads << " threads" )
+            {
+                SHAPE_POLY_SET grouped( operands );
+                grouped.Inflate( amount, 16, SHAPE_POLY_SET::ROUND_ALL_CORNERS, threads );
+
+                BOOST_CHECK_EQUAL( grouped.OutlineCount(), reference.OutlineCount() );
+                BOOST_CHECK_CLOSE( GEOM_TEST::PolySetArea( grouped ),
+                                   GEOM_TEST::PolySetArea( reference ), 1e-6 );
+
+                SHAPE_POLY_SET diff( grouped );
+                diff.BooleanSubtract( reference, SHAPE_POLY_SET::PM_FAST );
+                BOOST_CHECK_SMALL( GEOM_TEST::PolySetArea( diff ), 1.0 );
+            }
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,143 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_poly_set.h>
+
+
+/**
+ * Builds a set of aCount square islands, the one at aMoved shifted by aShift
+ */
+static SHAPE_POLY_SET islands( int aCount, int aMoved = -1, int aShift = 0 )
+{
+    SHAPE_POLY_SET polySet;
+
+    for( int i = 0; i < aCount; i++ )
+    {
+        SHAPE_LINE_CHAIN chain;
+        int              x = i * 1000 + ( i == aMoved ? aShift : 0 );
+
+        chain.Append( x, 0 );
+        chain.Append( x + 500, 0 );
+        chain.Append( x + 500, 500 );
+        chain.Append( x, 500 );
+        chain.SetClosed( true );
+        polySet.AddOutline( chain );
+    }
+
+    return polySet;
+}
+
+
+static int triangleCount( const SHAPE_POLY_SET& aPolySet )
+{
+    int count = 0;
+
+    for( unsigned i = 0; i < aPolySet.TriangulatedPolyCount(); i++ )
+        count += aPolySet.TriangulatedPolygon( i )->GetTriangleCount();
+
+    return count;
+}
+
+
+BOOST_AUTO_TEST_SUITE( SPSTriangulation )
+
+
+/**
+ * Assigning a set with one changed island (as a zone refill does) only triangulates that
+ * island again
+ */
+BOOST_AUTO_TEST_CASE( ReuseUnchangedIslands )
+{
+    SHAPE_POLY_SET fill = islands( 10 );
+    fill.CacheTriangulation();
+
+    BOOST_REQUIRE( fill.IsTriangulationUpToDate() );
+    BOOST_REQUIRE_EQUAL( fill.TriangulatedPolyCount(), 10 );
+    BOOST_CHECK_EQUAL( triangleCount( fill ), 20 );
+
+    std::vector<const SHAPE_POLY_SET::TRIANGULATED_POLYGON*> before;
+
+    for( unsigned i = 0; i < fill.TriangulatedPolyCount(); i++ )
+        before.push_back( fill.TriangulatedPolygon( i ) );
+
+    SHAPE_POLY_SET refill = islands( 10, 3, 100 );
+    fill = refill;
+
+    BOOST_CHECK( !fill.IsTriangulationUpToDate() );
+
+    fill.CacheTriangulation();
+
+    BOOST_REQUIRE( fill.IsTriangulationUpToDate() );
+    BOOST_REQUIRE_EQUAL( fill.TriangulatedPolyCount(), 10 );
+    BOOST_CHECK_EQUAL( triangleCount( fill ), 20 );
+
+    for( unsigned i = 0; i < fill.TriangulatedPolyCount(); i++ )
+    {
+        if( i == 3 )
+            BOOST_CHECK( fill.TriangulatedPolygon( i ) != before[i] );
+        else
+            BOOST_CHECK( fill.TriangulatedPolygon( i ) == before[i] );
+    }
+}
+
+
+/**
+ * Copies share the triangles of an up to date set; polygons with holes are triangulated
+ */
+BOOST_AUTO_TEST_CASE( CopySharesTriangles )
+{
+    SHAPE_POLY_SET polySet = islands( 3 );
+    SHAPE_LINE_CHAIN hole;
+
+    hole.Append( 100, 100 );
+    hole.Append( 200, 100 );
+    hole.Append( 200, 200 );
+    hole.Append( 100, 200 );
+    hole.SetClosed( true );
+    polySet.AddHole( hole, 0 );
+
+    polySet.CacheTriangulation();
+
+    BOOST_REQUIRE_EQUAL( polySet.TriangulatedPolyCount(), 3 );
+    BOOST_CHECK_GT( polySet.TriangulatedPolygon( 0 )->GetTriangleCount(), 2 );
+
+    SHAPE_POLY_SET copy( polySet );
+
+    BOOST_REQUIRE( copy.IsTriangulationUpToDate() );
+
+    for( unsigned i = 0; i < copy.TriangulatedPolyCount(); i++ )
+        BOOST_CHECK( copy.TriangulatedPolygon( i ) == polySet.TriangulatedPolygon( i ) );
+
+    // Changing the copy in place only triangulates the changed polygon
+    copy.Outline( 2 ).Move( VECTOR2I( 0, 50 ) );
+    copy.CacheTriangulation();
+
+    BOOST_CHECK( copy.TriangulatedPolygon( 0 ) == polySet.TriangulatedPolygon( 0 ) );
+    BOOST_CHECK( copy.TriangulatedPolygon( 1 ) == polySet.TriangulatedPolygon( 1 ) );
+    BOOST_CHECK( copy.TriangulatedPolygon( 2 ) != polySet.TriangulatedPolygon( 2 ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,98 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_poly_set.h>
+
+#include "geom_test_utils.h"
+
+
+BOOST_AUTO_TEST_SUITE( SPSUnion )
+
+
+/**
+ * UnionAll() must cover the same area as Simplify() on many overlapping operands
+ */
+BOOST_AUTO_TEST_CASE( UnionAllMatchesSimplify )
+{
+    SHAPE_POLY_SET operands;
+
+    // Overlapping diamonds along a few rows, plus long bars crossing the rows (like pads and
+    // tracks knocked out of a zone)
+    for( int row = 0; row < 10; row++ )
+    {
+        for( int col = 0; col < 40; col++ )
+        {
+            VECTOR2I         c( col * 700 + ( row % 2 ) * 350, row * 900 );
+            SHAPE_LINE_CHAIN diamond;
+
+            diamond.Append( c + VECTOR2I( -500, 0 ) );
+            diamond.Append( c + VECTOR2I( 0, -500 ) );
+            diamond.Append( c + VECTOR2I( 500, 0 ) );
+            diamond.Append( c + VECTOR2I( 0, 500 ) );
+            diamond.SetClosed( true );
+            operands.AddOutline( diamond );
+        }
+    }
+
+    for( int col = 0; col < 40; col += 3 )
+    {
+        SHAPE_LINE_CHAIN bar;
+
+        bar.Append( col * 700, -1000 );
+        bar.Append( col * 700 + 100, -1000 );
+        bar.Append( col * 700 + 100, 10000 );
+        bar.Append( col * 700, 10000 );
+        bar.SetClosed( true );
+        operands.AddOutline( bar );
+    }
+
+    SHAPE_POLY_SET simplified( operands );
+    simplified.Simplify( SHAPE_POLY_SET::PM_FAST );
+
+    // Serial, as in the zone filler, and on several threads
+    for( unsigned threads : { 1u, 4u } )
+    {
+        BOOST_TEST_CONTEXT( threads << " threads" )
+        {
+            SHAPE_POLY_SET united( operands );
+            united.UnionAll( SHAPE_POLY_SET::PM_FAST, threads );
+
+            BOOST_CHECK_EQUAL( united.OutlineCount(), simplified.OutlineCount() );
+            BOOST_CHECK_CLOSE( GEOM_TEST::PolySetArea( united ),
+                               GEOM_TEST::PolySetArea( simplified ), 1e-6 );
+
+            // Nothing of one is outside the other
+            SHAPE_POLY_SET diff( simplified );
+            diff.BooleanSubtract( united, SHAPE_POLY_SET::PM_FAST );
+            BOOST_CHECK_SMALL( GEOM_TEST::PolySetArea( diff ), 1.0 );
+
+            diff = united;
+            diff.BooleanSubtract( simplified, SHAPE_POLY_SET::PM_FAST );
+            BOOST_CHECK_SMALL( GEOM_TEST::PolySetArea( diff ), 1.0 );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,161 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * Tests for the texts laid out by the stroke font and kept in its cache
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <gal/gal_display_options.h>
+#include <gal/recording_gal.h>
+#include <gal/stroke_font.h>
+
+using namespace KIGFX;
+
+
+///> The text attributes a layout may depend on
+struct TEXT_ATTRIBUTES
+{
+    EDA_TEXT_HJUSTIFY_T m_hJustify;
+    EDA_TEXT_VJUSTIFY_T m_vJustify;
+    bool                m_mirrored;
+    bool                m_italic;
+    bool                m_bold;
+    double              m_lineWidth;
+};
+
+
+static const std::vector<TEXT_ATTRIBUTES> textAttributes = {
+    { GR_TEXT_HJUSTIFY_LEFT,  GR_TEXT_VJUSTIFY_CENTER, false, false, false, 150 },
+    { GR_TEXT_HJUSTIFY_RIGHT, GR_TEXT_VJUSTIFY_CENTER, false, false, false, 150 },
+    { GR_TEXT_HJUSTIFY_LEFT,  GR_TEXT_VJUSTIFY_BOTTOM, false, false, false, 150 },
+    { GR_TEXT_HJUSTIFY_LEFT,  GR_TEXT_VJUSTIFY_CENTER, true,  false, false, 150 },
+    { GR_TEXT_HJUSTIFY_LEFT,  GR_TEXT_VJUSTIFY_CENTER, false, true,  false, 150 },
+    // Bold is not in the layout key, it only changes the line width the text is laid out with
+    { GR_TEXT_HJUSTIFY_LEFT,  GR_TEXT_VJUSTIFY_CENTER, false, false, true,  150 },
+    // The line width moves the strokes by half of it
+    { GR_TEXT_HJUSTIFY_LEFT,  GR_TEXT_VJUSTIFY_CENTER, false, false, false, 200 },
+};
+
+
+/**
+ * Returns the commands recorded for a text drawn with the given attributes
+ */
+static RECORDING_GAL::COMMANDS drawText( RECORDING_GAL& aGal, const TEXT_ATTRIBUTES& aAttributes )
+{
+    aGal.SetGlyphSize( VECTOR2D( 1000, 1000 ) );
+    aGal.SetHorizontalJustify( aAttributes.m_hJustify );
+    aGal.SetVerticalJustify( aAttributes.m_vJustify );
+    aGal.SetTextMirrored( aAttributes.m_mirrored );
+    aGal.SetFontItalic( aAttributes.m_italic );
+    aGal.SetFontBold( aAttributes.m_bold );
+    aGal.SetLineWidth( aAttributes.m_lineWidth );
+
+    int group = aGal.BeginGroup();
+    aGal.StrokeText( wxT( "~RESET~ V_{CC}\tx\n2" ), VECTOR2D( 1000, 2000 ), 0.5 );
+    aGal.EndGroup();
+
+    return aGal.TakeGroup( group );
+}
+
+
+BOOST_AUTO_TEST_SUITE( StrokeFont )
+
+
+/**
+ * Texts taken from the layout cache are drawn like texts laid out from scratch, and only
+ * with the attributes they were laid out with
+ */
+BOOST_AUTO_TEST_CASE( CachedLayouts )
+{
+    GAL_DISPLAY_OPTIONS options;
+    RECORDING_GAL       gal( options );
+
+    std::vector<RECORDING_GAL::COMMANDS> fresh;
+
+    for( const TEXT_ATTRIBUTES& attributes : textAttributes )
+    {
+        STROKE_FONT::ClearLayoutCache();
+        fresh.push_back( drawText( gal, attributes ) );
+        BOOST_CHECK( !fresh.back().empty() );
+    }
+
+    for( size_t i = 0; i < fresh.size(); i++ )
+    {
+        for( size_t j = i + 1; j < fresh.size(); j++ )
+            BOOST_CHECK_MESSAGE( fresh[i] != fresh[j], "Attributes " << i << " and " << j );
+    }
+
+    // Lay out every variant once, then draw them all again from the cache
+    STROKE_FONT::ClearLayoutCache();
+
+    for( const TEXT_ATTRIBUTES& attributes : textAttributes )
+        drawText( gal, attributes );
+
+    for( size_t i = 0; i < textAttributes.size(); i++ )
+        BOOST_CHECK_MESSAGE( drawText( gal, textAttributes[i] ) == fresh[i], "Attributes " << i );
+}
+
+
+/**
+ * The texts drawn over and over again stay in the cache while many other texts go through it
+ */
+BOOST_AUTO_TEST_CASE( RecentlyUsedLayouts )
+{
+    GAL_DISPLAY_OPTIONS options;
+    RECORDING_GAL       gal( options );
+    const size_t        count = 3 * STROKE_FONT::LAYOUT_CACHE_SIZE;
+
+    gal.SetGlyphSize( VECTOR2D( 1000, 1000 ) );
+    gal.SetLineWidth( 150 );
+
+    STROKE_FONT::ClearLayoutCache();
+
+    for( size_t i = 0; i < count; i++ )
+    {
+        gal.StrokeText( wxString::Format( "U%d", (int) i ), VECTOR2D( 0, 0 ), 0.0 );
+
+        if( i % 100 == 0 )
+            gal.StrokeText( wxT( "GND" ), VECTOR2D( 0, 0 ), 0.0 );
+    }
+
+    // Only the first drawing of each text laid it out
+    BOOST_CHECK_EQUAL( STROKE_FONT::GetLayoutCount(), count + 1 );
+
+    // The last texts drawn are still cached
+    for( size_t i = count - 100; i < count; i++ )
+        gal.StrokeText( wxString::Format( "U%d", (int) i ), VECTOR2D( 0, 0 ), 0.0 );
+
+    gal.StrokeText( wxT( "GND" ), VECTOR2D( 0, 0 ), 0.0 );
+
+    BOOST_CHECK_EQUAL( STROKE_FONT::GetLayoutCount(), count + 1 );
+
+    // The first ones were dropped
+    gal.StrokeText( wxT( "U1" ), VECTOR2D( 0, 0 ), 0.0 );
+
+    BOOST_CHECK_EQUAL( STROKE_FONT::GetLayoutCount(), count + 2 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
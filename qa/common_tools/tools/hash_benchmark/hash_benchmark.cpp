@@ -0,0 +1,192 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * Compares the speed of MD5_HASH and FAST_HASH, on raw buffers and on the vertices of a large
+ * polygon set (the workload of SHAPE_POLY_SET::GetHash() on a big zone fill).
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fast_hash.h>
+#include <md5_hash.h>
+#include <geometry/shape_poly_set.h>
+
+#include <qa_utils/utility_registry.h>
+
+
+using CLOCK = std::chrono::steady_clock;
+
+
+struct HASH_BENCHMARK
+{
+    std::string                       name;
+    std::function<uint64_t()> func;      ///< Runs one repetition, returns a check value
+};
+
+
+static SHAPE_POLY_SET makePolySet( int aVertices )
+{
+    SHAPE_POLY_SET   polySet;
+    SHAPE_LINE_CHAIN chain;
+
+    // Islands of 1000 vertices, like the fill of a zone with many thermal reliefs
+    for( int i = 0; i < aVertices; i++ )
+    {
+        double a = 2.0 * M_PI * ( i % 1000 ) / 1000;
+        int    x = ( i / 1000 ) * 300000;
+
+        chain.Append( x + (int) ( 100000 * cos( a ) ), (int) ( 100000 * sin( a ) ) );
+
+        if( i % 1000 == 999 || i == aVertices - 1 )
+        {
+            chain.SetClosed( true );
+            polySet.AddOutline( chain );
+            chain.Clear();
+        }
+    }
+
+    return polySet;
+}
+
+
+/**
+ * The checksum SHAPE_POLY_SET used to compute, with MD5_HASH
+ */
+static uint64_t md5PolySetHash( const SHAPE_POLY_SET& aPolySet )
+{
+    MD5_HASH hash;
+
+    hash.Hash( aPolySet.OutlineCount() );
+
+    for( int i = 0; i < aPolySet.OutlineCount(); i++ )
+    {
+        const SHAPE_POLY_SET::POLYGON& polygon = aPolySet.CPolygon( i );
+
+        hash.Hash( (int) polygon.size() );
+
+        for( const SHAPE_LINE_CHAIN& lc : polygon )
+        {
+            hash.Hash( lc.PointCount() );
+
+            for( int j = 0; j < lc.PointCount(); j++ )
+            {
+                hash.Hash( lc.CPoint( j ).x );
+                hash.Hash( lc.CPoint( j ).y );
+            }
+        }
+    }
+
+    hash.Finalize();
+
+    return hash.Format().size();
+}
+
+
+int hash_benchmark_func( int argc, char* argv[] )
+{
+    auto& os = std::cout;
+
+    if( argc > 3 )
+    {
+        os << "Usage: " << argv[0] << " [VERTICES] [REPS]\n";
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    int vertices = argc > 1 ? std::atoi( argv[1] ) : 1000000;
+    int reps = argc > 2 ? std::atoi( argv[2] ) : 10;
+
+    if( vertices <= 0 || reps <= 0 )
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    const SHAPE_POLY_SET polySet = makePolySet( vertices );
+    std::vector<uint8_t> buffer( vertices * sizeof( VECTOR2I ) );
+
+    for( size_t i = 0; i < buffer.size(); i++ )
+        buffer[i] = (uint8_t) ( i * 7 );
+
+    std::vector<HASH_BENCHMARK> benchmarks = {
+        { "MD5_HASH, buffer",
+          [&]() -> uint64_t
+          {
+              MD5_HASH hash;
+              hash.Hash( buffer.data(), buffer.size() );
+              hash.Finalize();
+              return hash.Format().size();
+          } },
+        { "FAST_HASH, buffer",
+          [&]() -> uint64_t
+          {
+              FAST_HASH hash;
+              hash.Add( buffer.data(), buffer.size() );
+              return hash.Digest128().Value64[0];
+          } },
+        { "MD5_HASH, poly set vertices",
+          [&]() -> uint64_t
+          {
+              return md5PolySetHash( polySet );
+          } },
+        { "SHAPE_POLY_SET::GetHash()",
+          [&]() -> uint64_t
+          {
+              return polySet.GetHash().Value64[0];
+          } },
+    };
+
+    double bytes = (double) buffer.size() * reps;
+
+    os << vertices << " vertices (" << buffer.size() / 1024 << " kB), " << reps << " reps"
+       << std::endl;
+
+    for( const HASH_BENCHMARK& bench : benchmarks )
+    {
+        uint64_t check = 0;
+        auto     start = CLOCK::now();
+
+        for( int i = 0; i < reps; i++ )
+            check += bench.func();
+
+        std::chrono::duration<double> elapsed = CLOCK::now() - start;
+
+        os << std::left << std::setw( 30 ) << bench.name << std::right << std::fixed
+           << std::setprecision( 2 ) << std::setw( 10 ) << elapsed.count() * 1000 / reps
+           << " ms/rep " << std::setw( 10 ) << bytes / elapsed.count() / 1e6 << " MB/s"
+           << "  (check " << std::hex << ( check & 0xFFFF ) << std::dec << ")" << std::endl;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "hash_benchmark",
+        "Benchmark MD5_HASH against FAST_HASH",
+        hash_benchmark_func,
+} );
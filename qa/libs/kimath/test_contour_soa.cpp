@@ -0,0 +1,151 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * Tests for the batch point-in-polygon kernels
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <geometry/contour_soa.h>
+#include <geometry/shape_poly_set.h>
+
+
+struct CONTOUR_SOA_FIXTURE
+{
+    CONTOUR_SOA_FIXTURE()
+    {
+        SHAPE_LINE_CHAIN outline;
+        SHAPE_LINE_CHAIN hole;
+
+        // A wavy outline, so most edges are neither horizontal nor vertical
+        for( int i = 0; i < 200; i++ )
+        {
+            double a = 2.0 * M_PI * i / 200;
+            double r = 100000.0 * ( 1.0 + 0.2 * sin( 5.0 * a ) );
+            outline.Append( KiROUND( r * cos( a ) ), KiROUND( r * sin( a ) ) );
+        }
+
+        outline.SetClosed( true );
+        m_polySet.AddOutline( outline );
+
+        hole.Append( -20000, -20000 );
+        hole.Append( 20000, -20000 );
+        hole.Append( 20000, 20000 );
+        hole.Append( -20000, 20000 );
+        hole.SetClosed( true );
+        m_polySet.AddHole( hole );
+
+        // The reference results don't use the edge index
+        m_polySet.SetEdgeIndexEnabled( false );
+
+        for( int x = -130000; x <= 130000; x += 1733 )
+        {
+            for( int y = -130000; y <= 130000; y += 1871 )
+                m_points.emplace_back( x, y );
+        }
+
+        // Points exactly on, and right next to, the edges and vertices
+        for( int i = 0; i < outline.PointCount(); i++ )
+        {
+            const SEG edge = outline.CSegment( i );
+
+            m_points.push_back( edge.A );
+            m_points.push_back( edge.A + VECTOR2I( 1, 0 ) );
+            m_points.push_back( ( edge.A + edge.B ) / 2 );
+        }
+
+        for( int i = -20000; i <= 20000; i += 5000 )
+        {
+            m_points.emplace_back( i, 20000 );
+            m_points.emplace_back( 20000, i );
+            m_points.emplace_back( 20001, i );
+        }
+    }
+
+    ~CONTOUR_SOA_FIXTURE()
+    {
+        CONTOUR_SOA::SetKernel( CONTOUR_SOA::BestKernel() );
+    }
+
+    SHAPE_POLY_SET        m_polySet;
+    std::vector<VECTOR2I> m_points;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ContourSoa, CONTOUR_SOA_FIXTURE )
+
+
+/**
+ * The batch Contains() must give the same answers as Contains() on each point, with all the
+ * kernels the CPU supports
+ */
+BOOST_AUTO_TEST_CASE( BatchContains )
+{
+    for( int kernel = CONTOUR_SOA::KERNEL_SCALAR; kernel <= CONTOUR_SOA::BestKernel(); kernel++ )
+    {
+        CONTOUR_SOA::SetKernel( (CONTOUR_SOA::KERNEL) kernel );
+        BOOST_TEST_CONTEXT( "Kernel " << CONTOUR_SOA::KernelName( CONTOUR_SOA::GetKernel() ) )
+        {
+            for( int accuracy : { 0, 1, 3 } )
+            {
+                std::vector<bool> results;
+                m_polySet.Contains( m_points, results, -1, accuracy );
+
+                BOOST_REQUIRE_EQUAL( results.size(), m_points.size() );
+
+                for( size_t i = 0; i < m_points.size(); i++ )
+                {
+                    BOOST_CHECK_MESSAGE(
+                            results[i] == m_polySet.Contains( m_points[i], -1, accuracy ),
+                            "Point " << m_points[i] << " accuracy " << accuracy );
+                }
+            }
+        }
+    }
+}
+
+
+/**
+ * Open or degenerate contours contain nothing
+ */
+BOOST_AUTO_TEST_CASE( OpenContour )
+{
+    const std::vector<VECTOR2I> corners = { VECTOR2I( 0, 0 ), VECTOR2I( 100, 0 ),
+                                            VECTOR2I( 100, 100 ) };
+
+    SHAPE_LINE_CHAIN chain( corners );
+    CONTOUR_SOA      soa( chain );
+
+    const VECTOR2I points[] = { VECTOR2I( 90, 10 ), VECTOR2I( 50, 50 ) };
+    uint8_t        results[] = { 1, 1 };
+
+    soa.PointInside( points, 2, 0, results );
+
+    BOOST_CHECK_EQUAL( results[0], 0 );
+    BOOST_CHECK_EQUAL( results[1], 0 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,131 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * Tests for the FAST_HASH incremental hash
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <fast_hash.h>
+
+#include <cstring>
+#include <vector>
+
+
+BOOST_AUTO_TEST_SUITE( FastHash )
+
+
+/**
+ * Digest64() is XXH64: check the reference values
+ */
+BOOST_AUTO_TEST_CASE( Xxh64Reference )
+{
+    const std::vector<std::pair<std::string, uint64_t>> cases = {
+        { "", 0xEF46DB3751D8E999ULL },
+        { "a", 0xD24EC4F1A98C6E5BULL },
+        { "abc", 0x44BC2CF5AD770999ULL },
+        { "Nobody inspects the spammish repetition", 0xFBCEA83C8A378BF1ULL },
+    };
+
+    for( const auto& c : cases )
+    {
+        FAST_HASH hash;
+        hash.Add( c.first.data(), c.first.size() );
+
+        BOOST_CHECK_MESSAGE( hash.Digest64() == c.second, "Hash of \"" << c.first << "\"" );
+        BOOST_CHECK_EQUAL( hash.Digest128().Value64[0], c.second );
+    }
+}
+
+
+/**
+ * The digest doesn't depend on how the data is split between calls to Add()
+ */
+BOOST_AUTO_TEST_CASE( Incremental )
+{
+    std::vector<uint8_t> data( 1000 );
+
+    for( size_t i = 0; i < data.size(); i++ )
+        data[i] = (uint8_t) ( i * 131 + 7 );
+
+    for( size_t length : { 0, 1, 7, 31, 32, 33, 64, 100, 1000 } )
+    {
+        FAST_HASH whole;
+        whole.Add( data.data(), length );
+
+        for( size_t chunk : { 1, 3, 8, 13, 32, 45 } )
+        {
+            FAST_HASH split;
+
+            for( size_t i = 0; i < length; i += chunk )
+                split.Add( data.data() + i, std::min( chunk, length - i ) );
+
+            BOOST_CHECK_MESSAGE( split.Digest128() == whole.Digest128(),
+                                 "Length " << length << " chunk " << chunk );
+        }
+    }
+}
+
+
+/**
+ * Any change to the data, the seed or the length changes both halves of the digest
+ */
+BOOST_AUTO_TEST_CASE( Sensitivity )
+{
+    std::vector<int> values( 50 );
+
+    for( size_t i = 0; i < values.size(); i++ )
+        values[i] = (int) ( i * 1000 );
+
+    FAST_HASH ref;
+    ref.Add( values.data(), values.size() * sizeof( int ) );
+
+    for( size_t i = 0; i < values.size(); i++ )
+    {
+        std::vector<int> changed( values );
+        changed[i] += 1;
+
+        FAST_HASH hash;
+        hash.Add( changed.data(), changed.size() * sizeof( int ) );
+
+        BOOST_CHECK( hash.Digest128().Value64[0] != ref.Digest128().Value64[0] );
+        BOOST_CHECK( hash.Digest128().Value64[1] != ref.Digest128().Value64[1] );
+    }
+
+    FAST_HASH seeded( 1 );
+    seeded.Add( values.data(), values.size() * sizeof( int ) );
+    BOOST_CHECK( seeded.Digest128() != ref.Digest128() );
+
+    FAST_HASH shorter;
+    shorter.Add( values.data(), ( values.size() - 1 ) * sizeof( int ) );
+    BOOST_CHECK( shorter.Digest128() != ref.Digest128() );
+
+    // Reset() starts over
+    ref.Reset();
+    BOOST_CHECK( ref.Digest128() == FAST_HASH().Digest128() );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,83 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_zone.h>
+#include <connectivity/connectivity_items.h>
+
+
+BOOST_AUTO_TEST_SUITE( ConnectivityZone )
+
+
+/**
+ * Anchors lying exactly on the outline of a zone fill are connected to the zone, whether the
+ * fill is drawn with a thickness or not
+ */
+BOOST_AUTO_TEST_CASE( FillOutlineContainsEdgePoints )
+{
+    BOARD            board;
+    ZONE_CONTAINER   zone( &board );
+    SHAPE_POLY_SET   fill;
+    SHAPE_LINE_CHAIN outline;
+
+    // One sloped edge, from (1000000, 1000000) to (0, 500000)
+    outline.Append( 0, 0 );
+    outline.Append( 1000000, 0 );
+    outline.Append( 1000000, 1000000 );
+    outline.Append( 0, 500000 );
+    outline.SetClosed( true );
+    fill.AddOutline( outline );
+
+    zone.SetFilledPolysList( fill );
+    zone.SetMinThickness( 254000 );
+
+    const std::vector<VECTOR2I> onOutline = {
+        { 0, 0 }, { 1000000, 1000000 }, { 500000, 0 }, { 1000000, 300000 },
+        { 500000, 750000 }, { 0, 250000 }
+    };
+
+    for( bool useThickness : { false, true } )
+    {
+        BOOST_TEST_CONTEXT( "Use thickness: " << useThickness )
+        {
+            zone.SetFilledPolysUseThickness( useThickness );
+
+            CN_ZONE cnZone( &zone, false, 0 );
+
+            BOOST_CHECK( cnZone.ContainsPoint( VECTOR2I( 500000, 250000 ) ) );
+
+            for( const VECTOR2I& p : onOutline )
+                BOOST_CHECK_MESSAGE( cnZone.ContainsPoint( p ), "Point " << p );
+
+            // Half the fill thickness away from the outline
+            BOOST_CHECK_EQUAL( cnZone.ContainsPoint( VECTOR2I( -100000, 250000 ) ),
+                               useThickness );
+            BOOST_CHECK( !cnZone.ContainsPoint( VECTOR2I( -200000, 250000 ) ) );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,223 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * Tests for PCB_RENDER_SETTINGS::GetDisplayChanges(), which decides what PCB_VIEW redraws
+ * when the display options change
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <pcb_display_options.h>
+#include <pcb_painter.h>
+
+#include <functional>
+
+using namespace KIGFX;
+
+typedef PCB_RENDER_SETTINGS::DISPLAY_CHANGES DISPLAY_CHANGES;
+
+
+/**
+ * Returns the changes reported after loading the default display options, then the default
+ * options modified by aChange
+ */
+static DISPLAY_CHANGES getChanges( const std::function<void( PCB_DISPLAY_OPTIONS& )>& aChange,
+                                   bool aShowPageLimits = false )
+{
+    PCB_RENDER_SETTINGS settings;
+    PCB_DISPLAY_OPTIONS options;
+
+    settings.LoadDisplayOptions( options, false );
+
+    const PCB_RENDER_SETTINGS previous( settings );
+
+    aChange( options );
+    settings.LoadDisplayOptions( options, aShowPageLimits );
+
+    return settings.GetDisplayChanges( previous );
+}
+
+
+static bool isEmpty( const DISPLAY_CHANGES& aChanges )
+{
+    return !aChanges.m_colors && !aChanges.m_ratsnest && aChanges.m_layers.empty()
+           && aChanges.m_types.empty();
+}
+
+
+BOOST_AUTO_TEST_SUITE( PcbRenderSettings )
+
+
+BOOST_AUTO_TEST_CASE( NoChanges )
+{
+    BOOST_CHECK( isEmpty( getChanges( []( PCB_DISPLAY_OPTIONS& ) {} ) ) );
+
+    // Options the painter does not use
+    BOOST_CHECK( isEmpty( getChanges( []( PCB_DISPLAY_OPTIONS& aOpts )
+                                      {
+                                          aOpts.m_MaxLinksShowed = 10;
+                                          aOpts.m_ShowModuleRatsnest = false;
+                                      } ) ) );
+}
+
+
+BOOST_AUTO_TEST_CASE( HighContrastColors )
+{
+    DISPLAY_CHANGES changes = getChanges( []( PCB_DISPLAY_OPTIONS& aOpts )
+                                          {
+                                              aOpts.m_ContrastModeDisplay = true;
+                                          } );
+
+    BOOST_CHECK( changes.m_colors );
+    BOOST_CHECK( !changes.m_ratsnest );
+    BOOST_CHECK( changes.m_layers.empty() );
+    BOOST_CHECK( changes.m_types.empty() );
+}
+
+
+BOOST_AUTO_TEST_CASE( Ratsnest )
+{
+    DISPLAY_CHANGES curved = getChanges( []( PCB_DISPLAY_OPTIONS& aOpts )
+                                         {
+                                             aOpts.m_DisplayRatsnestLinesCurved = true;
+                                         } );
+
+    DISPLAY_CHANGES global = getChanges( []( PCB_DISPLAY_OPTIONS& aOpts )
+                                         {
+                                             aOpts.m_ShowGlobalRatsnest = false;
+                                         } );
+
+    for( const DISPLAY_CHANGES& changes : { curved, global } )
+    {
+        BOOST_CHECK( changes.m_ratsnest );
+        BOOST_CHECK( !changes.m_colors );
+        BOOST_CHECK( changes.m_layers.empty() );
+        BOOST_CHECK( changes.m_types.empty() );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( TextLayers )
+{
+    const std::set<int> padNetnames = { LAYER_PADS_NETNAMES, LAYER_PAD_FR_NETNAMES,
+                                        LAYER_PAD_BK_NETNAMES };
+
+    DISPLAY_CHANGES padNumbers = getChanges( []( PCB_DISPLAY_OPTIONS& aOpts )
+                                             {
+                                                 aOpts.m_DisplayPadNum = false;
+                                             } );
+
+    BOOST_CHECK( padNumbers.m_layers == padNetnames );
+    BOOST_CHECK( padNumbers.m_types.empty() );
+
+    // Net names on tracks only: the pad and via net names are hidden
+    DISPLAY_CHANGES tracksOnly = getChanges( []( PCB_DISPLAY_OPTIONS& aOpts )
+                                             {
+                                                 aOpts.m_DisplayNetNamesMode = 2;
+                                             } );
+
+    std::set<int> expected = padNetnames;
+    expected.insert( LAYER_VIAS_NETNAMES );
+
+    BOOST_CHECK( tracksOnly.m_layers == expected );
+    BOOST_CHECK( tracksOnly.m_types.empty() );
+
+    // Net names on pads only: the track net names are hidden on every copper layer
+    DISPLAY_CHANGES padsOnly = getChanges( []( PCB_DISPLAY_OPTIONS& aOpts )
+                                           {
+                                               aOpts.m_DisplayNetNamesMode = 1;
+                                           } );
+
+    expected.clear();
+
+    for( PCB_LAYER_ID layer : LSET::AllCuMask().Seq() )
+        expected.insert( GetNetnameLayer( layer ) );
+
+    BOOST_CHECK( padsOnly.m_layers == expected );
+    BOOST_CHECK( padsOnly.m_types.empty() );
+
+    DISPLAY_CHANGES pageLimits = getChanges( []( PCB_DISPLAY_OPTIONS& ) {}, true );
+
+    BOOST_CHECK( pageLimits.m_layers == std::set<int>( { LAYER_WORKSHEET } ) );
+    BOOST_CHECK( pageLimits.m_types.empty() );
+}
+
+
+BOOST_AUTO_TEST_CASE( FillModes )
+{
+    struct FILL_CASE
+    {
+        std::function<void( PCB_DISPLAY_OPTIONS& )> m_change;
+        std::set<KICAD_T>                           m_types;
+    };
+
+    const std::vector<FILL_CASE> cases = {
+        { []( PCB_DISPLAY_OPTIONS& aOpts ) { aOpts.m_DisplayPadFill = false; },
+          { PCB_PAD_T } },
+        { []( PCB_DISPLAY_OPTIONS& aOpts ) { aOpts.m_DisplayViaFill = false; },
+          { PCB_VIA_T } },
+        { []( PCB_DISPLAY_OPTIONS& aOpts ) { aOpts.m_DisplayPcbTrackFill = false; },
+          { PCB_TRACE_T, PCB_ARC_T } },
+        { []( PCB_DISPLAY_OPTIONS& aOpts ) { aOpts.m_DisplayGraphicsFill = false; },
+          { PCB_LINE_T, PCB_MODULE_EDGE_T, PCB_DIMENSION_T } },
+        { []( PCB_DISPLAY_OPTIONS& aOpts ) { aOpts.m_DisplayTextFill = false; },
+          { PCB_TEXT_T, PCB_MODULE_TEXT_T, PCB_DIMENSION_T } },
+        { []( PCB_DISPLAY_OPTIONS& aOpts ) { aOpts.m_DisplayZonesMode = 2; },
+          { PCB_ZONE_AREA_T, PCB_MODULE_ZONE_AREA_T } },
+    };
+
+    for( const FILL_CASE& c : cases )
+    {
+        DISPLAY_CHANGES changes = getChanges( c.m_change );
+
+        BOOST_CHECK( changes.m_types == c.m_types );
+        BOOST_CHECK( changes.m_layers.empty() );
+        BOOST_CHECK( !changes.m_colors );
+        BOOST_CHECK( !changes.m_ratsnest );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( Clearances )
+{
+    DISPLAY_CHANGES tracks = getChanges( []( PCB_DISPLAY_OPTIONS& aOpts )
+                                         {
+                                             aOpts.m_ShowTrackClearanceMode =
+                                                     PCB_DISPLAY_OPTIONS::SHOW_CLEARANCE_ALWAYS;
+                                         } );
+
+    BOOST_CHECK( tracks.m_types == std::set<KICAD_T>( { PCB_TRACE_T, PCB_ARC_T, PCB_VIA_T } ) );
+    BOOST_CHECK( tracks.m_layers.empty() );
+
+    DISPLAY_CHANGES pads = getChanges( []( PCB_DISPLAY_OPTIONS& aOpts )
+                                       {
+                                           aOpts.m_DisplayPadIsol = false;
+                                       } );
+
+    BOOST_CHECK( pads.m_types == std::set<KICAD_T>( { PCB_PAD_T } ) );
+    BOOST_CHECK( pads.m_layers.empty() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
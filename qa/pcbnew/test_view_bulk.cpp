@@ -0,0 +1,250 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * Tests for adding and removing items in bulk with VIEW::BulkAdd() and VIEW::BulkRemove()
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <pcbnew_utils/board_construction_utils.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <pcb_view.h>
+
+#include <algorithm>
+#include <set>
+
+using namespace KIGFX;
+
+
+struct VIEW_BULK_FIXTURE
+{
+    VIEW_BULK_FIXTURE()
+    {
+        for( int i = 0; i < 40; i++ )
+        {
+            MODULE* module = new MODULE( &m_board );
+
+            for( int j = 0; j < 4; j++ )
+            {
+                D_PAD* pad = new D_PAD( module );
+
+                pad->SetSize( wxSize( 1000000, 600000 ) );
+                pad->SetAttribute( PAD_ATTRIB_SMD );
+                pad->SetLayerSet( D_PAD::SMDMask() );
+                pad->SetName( wxString::Format( "%d", j + 1 ) );
+                pad->SetPosition( wxPoint( j * 1500000, 0 ) );
+                module->Add( pad );
+            }
+
+            KI_TEST::DrawSegment( *module, SEG( VECTOR2I( -500000, -1000000 ),
+                                                VECTOR2I( 5000000, -1000000 ) ),
+                                  150000, F_SilkS );
+
+            module->SetReference( wxString::Format( "U%d", i + 1 ) );
+            module->SetPosition( wxPoint( ( i % 8 ) * 8000000, ( i / 8 ) * 5000000 ) );
+            m_board.Add( module );
+        }
+
+        for( int i = 0; i < 200; i++ )
+        {
+            TRACK* track = new TRACK( &m_board );
+
+            track->SetStart( wxPoint( i * 300000, -3000000 ) );
+            track->SetEnd( wxPoint( i * 300000 + 2000000, -8000000 - i * 10000 ) );
+            track->SetWidth( 250000 );
+            track->SetLayer( i % 2 ? F_Cu : B_Cu );
+            m_board.Add( track );
+        }
+
+        for( TRACK* track : m_board.Tracks() )
+            m_items.push_back( track );
+
+        for( MODULE* module : m_board.Modules() )
+        {
+            m_items.push_back( module );
+            module->RunOnChildren( [&]( BOARD_ITEM* aItem ) { m_items.push_back( aItem ); } );
+        }
+    }
+
+    /**
+     * Returns the results of queries over a grid of boxes covering the board
+     */
+    static std::vector<std::vector<VIEW::LAYER_ITEM_PAIR>> queryGrid( VIEW& aView )
+    {
+        std::vector<std::vector<VIEW::LAYER_ITEM_PAIR>> results;
+
+        for( int x = -5000000; x < 70000000; x += 7000000 )
+        {
+            for( int y = -10000000; y < 35000000; y += 4000000 )
+            {
+                std::vector<VIEW::LAYER_ITEM_PAIR> found;
+
+                aView.Query( BOX2I( VECTOR2I( x, y ), VECTOR2I( 9000000, 6000000 ) ), found );
+                std::sort( found.begin(), found.end() );
+                results.push_back( found );
+            }
+        }
+
+        return results;
+    }
+
+    /**
+     * Returns the items found anywhere in a view
+     */
+    static std::set<VIEW_ITEM*> queryAll( VIEW& aView )
+    {
+        std::vector<VIEW::LAYER_ITEM_PAIR> found;
+        std::set<VIEW_ITEM*>               items;
+        BOX2I                              everything;
+
+        everything.SetMaximum();
+        aView.Query( everything, found );
+
+        for( const VIEW::LAYER_ITEM_PAIR& entry : found )
+            items.insert( entry.first );
+
+        return items;
+    }
+
+    BOARD                    m_board;
+    std::vector<BOARD_ITEM*> m_items;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ViewBulk, VIEW_BULK_FIXTURE )
+
+
+/**
+ * Items added with BulkAdd() (in packed R-trees) are found by the same queries as items
+ * added one by one, and so are the items left after a BulkRemove()
+ */
+BOOST_AUTO_TEST_CASE( BulkAddRemove )
+{
+    // Items can only be in one view at a time
+    VIEW single;
+    VIEW bulk;
+
+    // Remove the tracks and every other item
+    std::vector<VIEW_ITEM*> removed;
+    std::vector<VIEW_ITEM*> kept;
+
+    for( size_t i = 0; i < m_items.size(); i++ )
+    {
+        if( m_items[i]->Type() == PCB_TRACE_T || i % 2 )
+            removed.push_back( m_items[i] );
+        else
+            kept.push_back( m_items[i] );
+    }
+
+    for( BOARD_ITEM* item : m_items )
+        single.Add( item );
+
+    auto expectedAll = queryGrid( single );
+
+    for( VIEW_ITEM* item : removed )
+        single.Remove( item );
+
+    auto expectedKept = queryGrid( single );
+
+    for( VIEW_ITEM* item : kept )
+        single.Remove( item );
+
+    bulk.BulkAdd( std::vector<VIEW_ITEM*>( m_items.begin(), m_items.end() ) );
+    BOOST_CHECK( queryGrid( bulk ) == expectedAll );
+
+    bulk.BulkRemove( removed );
+    BOOST_CHECK( queryGrid( bulk ) == expectedKept );
+
+    bulk.BulkRemove( kept );
+    BOOST_CHECK( queryAll( bulk ).empty() );
+}
+
+
+/**
+ * PCB_VIEW adds and removes the children of modules with their modules, whether they are
+ * added or removed one by one or in bulk
+ */
+BOOST_AUTO_TEST_CASE( PcbViewModuleChildren )
+{
+    PCB_VIEW             view;
+    std::vector<MODULE*> modules( m_board.Modules().begin(), m_board.Modules().end() );
+
+    auto children = []( MODULE* aModule )
+    {
+        std::set<VIEW_ITEM*> items;
+
+        aModule->RunOnChildren( [&]( BOARD_ITEM* aItem ) { items.insert( aItem ); } );
+        return items;
+    };
+
+    auto inView = [&]( MODULE* aModule )
+    {
+        std::set<VIEW_ITEM*> found = queryAll( view );
+        size_t               count = found.count( aModule );
+
+        for( VIEW_ITEM* child : children( aModule ) )
+            count += found.count( child );
+
+        return count;
+    };
+
+    // Modules only, half of them in bulk
+    std::vector<VIEW_ITEM*> bulk( modules.begin(), modules.begin() + modules.size() / 2 );
+
+    view.BulkAdd( bulk );
+
+    for( size_t i = modules.size() / 2; i < modules.size(); i++ )
+        view.Add( modules[i] );
+
+    for( MODULE* module : modules )
+        BOOST_CHECK_EQUAL( inView( module ), children( module ).size() + 1 );
+
+    // Every other module in bulk, then one by one
+    std::vector<VIEW_ITEM*> removed;
+
+    for( size_t i = 0; i < modules.size(); i += 2 )
+        removed.push_back( modules[i] );
+
+    view.BulkRemove( removed );
+    view.Remove( modules[1] );
+
+    for( size_t i = 0; i < modules.size(); i++ )
+    {
+        size_t expected = ( i % 2 == 0 || i == 1 ) ? 0 : children( modules[i] ).size() + 1;
+
+        BOOST_CHECK_EQUAL( inView( modules[i] ), expected );
+    }
+
+    for( size_t i = 3; i < modules.size(); i += 2 )
+        view.Remove( modules[i] );
+
+    BOOST_CHECK( queryAll( view ).empty() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
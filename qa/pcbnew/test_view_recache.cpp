@@ -0,0 +1,582 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * Tests for the items drawn on worker threads by VIEW::UpdateItems() and by tiled Cairo
+ * redraws
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <pcbnew_utils/board_construction_utils.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_pcb_text.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <gal/cairo/cairo_image_gal.h>
+#include <gal/recording_gal.h>
+#include <pcb_display_options.h>
+#include <pcb_painter.h>
+#include <pcb_view.h>
+#include <view/view.h>
+
+#include <algorithm>
+
+using namespace KIGFX;
+
+
+struct VIEW_RECACHE_FIXTURE
+{
+    VIEW_RECACHE_FIXTURE()
+    {
+        const PAD_SHAPE_T shapes[] = { PAD_SHAPE_RECT, PAD_SHAPE_ROUNDRECT, PAD_SHAPE_CIRCLE,
+                                       PAD_SHAPE_OVAL };
+
+        for( int i = 0; i < 40; i++ )
+        {
+            MODULE* module = new MODULE( &m_board );
+
+            for( int j = 0; j < 4; j++ )
+            {
+                D_PAD* pad = new D_PAD( module );
+
+                pad->SetShape( shapes[j] );
+                pad->SetSize( wxSize( 1000000, 600000 + j * 100000 ) );
+                pad->SetRoundRectRadiusRatio( 0.25 );
+                pad->SetAttribute( j == 2 ? PAD_ATTRIB_STANDARD : PAD_ATTRIB_SMD );
+                pad->SetLayerSet( j == 2 ? D_PAD::StandardMask() : D_PAD::SMDMask() );
+                pad->SetDrillSize( wxSize( 400000, 400000 ) );
+                pad->SetName( wxString::Format( "%d", j + 1 ) );
+                pad->SetPosition( wxPoint( j * 1500000, 0 ) );
+                module->Add( pad );
+            }
+
+            KI_TEST::DrawSegment( *module, SEG( VECTOR2I( -500000, -1000000 ),
+                                                VECTOR2I( 5000000, -1000000 ) ),
+                                  150000, F_SilkS );
+
+            module->SetReference( wxString::Format( "U%d", i + 1 ) );
+            module->SetPosition( wxPoint( ( i % 8 ) * 8000000, ( i / 8 ) * 5000000 ) );
+            m_board.Add( module );
+        }
+
+        for( int i = 0; i < 200; i++ )
+        {
+            TRACK* track = new TRACK( &m_board );
+
+            track->SetStart( wxPoint( i * 300000, -3000000 ) );
+            track->SetEnd( wxPoint( i * 300000 + 2000000, -8000000 - i * 10000 ) );
+            track->SetWidth( 250000 );
+            track->SetLayer( i % 2 ? F_Cu : B_Cu );
+            m_board.Add( track );
+
+            if( i % 10 == 0 )
+            {
+                VIA* via = new VIA( &m_board );
+
+                via->SetPosition( track->GetEnd() );
+                via->SetWidth( 800000 );
+                via->SetDrill( 400000 );
+                via->SetLayerPair( F_Cu, B_Cu );
+                m_board.Add( via );
+            }
+        }
+
+        TEXTE_PCB* text = new TEXTE_PCB( &m_board );
+
+        text->SetText( wxT( "Recorded text" ) );
+        text->SetTextPos( wxPoint( 0, 30000000 ) );
+        text->SetLayer( F_SilkS );
+        m_board.Add( text );
+
+        ZONE_CONTAINER* zone = new ZONE_CONTAINER( &m_board );
+        SHAPE_POLY_SET  fill;
+
+        zone->SetLayer( B_Cu );
+        zone->Outline()->NewOutline();
+        zone->Outline()->Append( -1000000, -1000000 );
+        zone->Outline()->Append( 60000000, -1000000 );
+        zone->Outline()->Append( 60000000, 25000000 );
+        zone->Outline()->Append( -1000000, 25000000 );
+
+        fill = *zone->Outline();
+        fill.Deflate( 200000, 16 );
+        zone->SetFilledPolysList( fill );
+        zone->SetIsFilled( true );
+        zone->CacheTriangulation();
+        m_board.Add( zone );
+
+        for( TRACK* track : m_board.Tracks() )
+            m_items.push_back( track );
+
+        for( MODULE* module : m_board.Modules() )
+        {
+            m_items.push_back( module );
+            module->RunOnChildren( [&]( BOARD_ITEM* aItem ) { m_items.push_back( aItem ); } );
+        }
+
+        for( BOARD_ITEM* item : m_board.Drawings() )
+            m_items.push_back( item );
+
+        for( ZONE_CONTAINER* item : m_board.Zones() )
+            m_items.push_back( item );
+    }
+
+    /**
+     * Caches the items in a new VIEW drawing to a RECORDING_GAL, and returns the groups it
+     * made, in the order they were made
+     */
+    std::vector<RECORDING_GAL::COMMANDS> cacheItems( size_t aParallelThreshold,
+                                                     bool aRecache = false )
+    {
+        GAL_DISPLAY_OPTIONS options;
+        RECORDING_GAL       gal( options );
+        PCB_PAINTER         painter( &gal );
+        VIEW                view;
+
+        view.SetGAL( &gal );
+        view.SetPainter( &painter );
+        view.SetParallelCacheThreshold( aParallelThreshold );
+
+        for( BOARD_ITEM* item : m_items )
+            view.Add( item );
+
+        view.UpdateItems();
+
+        if( aRecache )
+        {
+            view.RecacheAllItems();
+            view.UpdateItems();
+        }
+
+        std::vector<RECORDING_GAL::COMMANDS> groups;
+
+        for( const auto& group : gal.GetGroups() )
+            groups.push_back( group.second );
+
+        for( BOARD_ITEM* item : m_items )
+            view.Remove( item );
+
+        return groups;
+    }
+
+    BOARD                    m_board;
+    std::vector<BOARD_ITEM*> m_items;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ViewRecache, VIEW_RECACHE_FIXTURE )
+
+
+/**
+ * Items drawn on worker threads and replayed must give exactly the groups drawn on the GUI
+ * thread
+ */
+BOOST_AUTO_TEST_CASE( ParallelMatchesSerial )
+{
+    std::vector<RECORDING_GAL::COMMANDS> serial = cacheItems( 0 );
+    std::vector<RECORDING_GAL::COMMANDS> parallel = cacheItems( 1 );
+
+    // Pads are on several layers, so there are more groups than items
+    BOOST_CHECK_GT( serial.size(), m_items.size() );
+    BOOST_REQUIRE_EQUAL( parallel.size(), serial.size() );
+
+    for( size_t i = 0; i < serial.size(); i++ )
+    {
+        BOOST_CHECK_MESSAGE( parallel[i] == serial[i], "Group " << i );
+    }
+}
+
+
+/**
+ * RecacheAllItems() gives the same groups as the first caching
+ */
+BOOST_AUTO_TEST_CASE( Recache )
+{
+    std::vector<RECORDING_GAL::COMMANDS> serial = cacheItems( 0 );
+    std::vector<RECORDING_GAL::COMMANDS> recached = cacheItems( 1, true );
+
+    BOOST_REQUIRE_EQUAL( recached.size(), serial.size() );
+
+    for( size_t i = 0; i < serial.size(); i++ )
+    {
+        BOOST_CHECK_MESSAGE( recached[i] == serial[i], "Group " << i );
+    }
+}
+
+
+/**
+ * Instanced shapes are recorded in every group drawing them, and stored only once by a target
+ * which already has them
+ */
+BOOST_AUTO_TEST_CASE( InstancedShapes )
+{
+    struct INSTANCING_GAL : public RECORDING_GAL
+    {
+        INSTANCING_GAL( GAL_DISPLAY_OPTIONS& aOptions ) : RECORDING_GAL( aOptions ) {}
+
+        bool IsInstancingSupported() const override { return true; }
+    };
+
+    GAL_DISPLAY_OPTIONS options;
+    INSTANCING_GAL      target( options );
+    RECORDING_GAL       gal( options );
+    PCB_PAINTER         painter( &gal );
+    std::vector<VIA*>   vias;
+
+    gal.CopyViewSettings( target );
+
+    for( BOARD_ITEM* item : m_items )
+    {
+        if( item->Type() == PCB_VIA_T )
+            vias.push_back( static_cast<VIA*>( item ) );
+    }
+
+    BOOST_REQUIRE_GE( vias.size(), 2 );
+
+    auto count = []( const RECORDING_GAL::COMMANDS& aCommands,
+                     RECORDING_GAL::COMMAND_TYPE aType )
+    {
+        return std::count_if( aCommands.begin(), aCommands.end(),
+                              [aType]( const RECORDING_GAL::COMMAND& aCommand )
+                              {
+                                  return aCommand.m_type == aType;
+                              } );
+    };
+
+    // The vias have the same size, so they share their shape
+    std::vector<RECORDING_GAL::COMMANDS> recorded;
+
+    for( int i = 0; i < 2; i++ )
+    {
+        int group = gal.BeginGroup();
+        painter.Draw( vias[i], LAYER_VIA_THROUGH );
+        gal.EndGroup();
+
+        recorded.push_back( gal.TakeGroup( group ) );
+        BOOST_CHECK_EQUAL( count( recorded.back(), RECORDING_GAL::CMD_BEGIN_SHAPE ), 1 );
+        BOOST_CHECK_EQUAL( count( recorded.back(), RECORDING_GAL::CMD_DRAW_SHAPE ), 1 );
+    }
+
+    BOOST_CHECK( recorded[0] != recorded[1] );
+
+    int group = target.BeginGroup();
+    RECORDING_GAL::Replay( recorded[0], target );
+    RECORDING_GAL::Replay( recorded[1], target );
+    target.EndGroup();
+
+    const RECORDING_GAL::COMMANDS& replayed = target.GetGroups().at( group );
+
+    BOOST_CHECK_EQUAL( count( replayed, RECORDING_GAL::CMD_BEGIN_SHAPE ), 1 );
+    BOOST_CHECK_EQUAL( count( replayed, RECORDING_GAL::CMD_END_SHAPE ), 1 );
+    BOOST_CHECK_EQUAL( count( replayed, RECORDING_GAL::CMD_DRAW_SHAPE ), 2 );
+}
+
+
+/**
+ * Zoomed out, simplified variants are cached next to the full detail groups of the items
+ * having one, and deleted with them
+ */
+BOOST_AUTO_TEST_CASE( LODVariants )
+{
+    GAL_DISPLAY_OPTIONS options;
+    RECORDING_GAL       gal( options );
+    PCB_PAINTER         painter( &gal );
+    VIEW                view;
+
+    view.SetGAL( &gal );
+    view.SetPainter( &painter );
+
+    for( BOARD_ITEM* item : m_items )
+        view.Add( item );
+
+    view.UpdateItems();
+
+    const size_t fullDetail = gal.GetGroups().size();
+
+    view.SetLODScale( view.GetScale() * 2.0 );
+    view.UpdateItems();
+
+    const size_t withLOD = gal.GetGroups().size();
+
+    // Pads, texts and the zone have simplified variants, tracks and vias don't
+    BOOST_CHECK_GT( withLOD, fullDetail );
+    BOOST_CHECK_LT( withLOD, 2 * fullDetail );
+
+    // Changing the threshold drops them, and they are not cached again above it
+    view.SetLODScale( view.GetScale() / 2.0 );
+    view.UpdateItems();
+    BOOST_CHECK_EQUAL( gal.GetGroups().size(), fullDetail );
+
+    view.SetLODScale( view.GetScale() * 2.0 );
+    view.UpdateItems();
+    BOOST_CHECK_EQUAL( gal.GetGroups().size(), withLOD );
+
+    // Redrawing an item (the zone) redraws its variants
+    view.Update( m_items.back(), GEOMETRY );
+    view.UpdateItems();
+    BOOST_CHECK_EQUAL( gal.GetGroups().size(), withLOD );
+
+    // Items redrawn while zoomed in get their variants back once zoomed out, unless they were
+    // removed in between
+    BOARD_ITEM* pad = *std::find_if( m_items.begin(), m_items.end(),
+                                     []( BOARD_ITEM* aItem )
+                                     {
+                                         return aItem->Type() == PCB_PAD_T;
+                                     } );
+    const double scale = view.GetScale();
+
+    view.SetScale( scale * 4.0 );
+    view.Update( pad, GEOMETRY );
+    view.Update( m_items.back(), GEOMETRY );
+    view.UpdateItems();
+    view.Remove( m_items.back() );
+
+    view.SetScale( scale );
+    view.UpdateItems();
+    BOOST_CHECK_LT( gal.GetGroups().size(), withLOD );
+
+    view.Add( m_items.back() );
+    view.UpdateItems();
+    BOOST_CHECK_EQUAL( gal.GetGroups().size(), withLOD );
+
+    for( BOARD_ITEM* item : m_items )
+        view.Remove( item );
+
+    BOOST_CHECK_EQUAL( gal.GetGroups().size(), 0 );
+}
+
+
+/**
+ * Redraws the whole view in aTileSize tiles (0 to draw on the GUI thread), and returns the
+ * pixels of the image
+ */
+static std::vector<uint32_t> renderCairo( CAIRO_IMAGE_GAL& aGal, VIEW& aView, int aTileSize,
+                                          int aWidth, int aHeight )
+{
+    aView.SetTileSize( aTileSize );
+    aView.MarkDirty();
+
+    {
+        GAL_DRAWING_CONTEXT ctx( &aGal );
+        aView.UpdateItems();
+        aView.Redraw();
+    }
+
+    cairo_surface_t*      surface = aGal.GetSurface();
+    const uint32_t*       data = (const uint32_t*) cairo_image_surface_get_data( surface );
+    int                   stride = cairo_image_surface_get_stride( surface ) / 4;
+    std::vector<uint32_t> pixels;
+
+    for( int y = 0; y < aHeight; y++ )
+        pixels.insert( pixels.end(), data + y * stride, data + y * stride + aWidth );
+
+    return pixels;
+}
+
+
+/**
+ * Drawing the screen in tiles on worker threads gives the image drawn on the GUI thread
+ */
+BOOST_AUTO_TEST_CASE( TiledCairo )
+{
+    const int width = 700;
+    const int height = 500;
+
+    GAL_DISPLAY_OPTIONS options;
+    CAIRO_IMAGE_GAL     gal( options, width, height );
+    PCB_PAINTER         painter( &gal );
+    VIEW                view;
+
+    // Black items on white, everything drawn immediately, as PCB_DRAW_PANEL_GAL does it
+    gal.SetWorldUnitLength( 1e-9 / 0.0254 );
+    gal.SetClearColor( COLOR4D::WHITE );
+    view.SetGAL( &gal );
+    view.SetPainter( &painter );
+
+    for( int i = 0; i < VIEW::VIEW_MAX_LAYERS; i++ )
+        view.SetLayerTarget( i, TARGET_NONCACHED );
+
+    for( BOARD_ITEM* item : m_items )
+        view.Add( item );
+
+    view.SetViewport( BOX2D( VECTOR2D( -2000000, -10000000 ), VECTOR2D( 66000000, 42000000 ) ) );
+
+    auto render =
+            [&]( int aTileSize )
+            {
+                return renderCairo( gal, view, aTileSize, width, height );
+            };
+
+    std::vector<uint32_t> serial = render( 0 );
+
+    // Tiles smaller than the screen, which don't divide it evenly
+    std::vector<uint32_t> tiled = render( 64 );
+
+    BOOST_REQUIRE_EQUAL( tiled.size(), serial.size() );
+
+    int drawn = 0;
+    int different = 0;
+
+    for( size_t i = 0; i < serial.size(); i++ )
+    {
+        if( serial[i] != 0xFFFFFFFF )
+            drawn++;
+
+        // Paths are placed on a shifted tile, which may round some edge pixels differently
+        for( int shift = 0; shift < 32; shift += 8 )
+        {
+            int a = ( serial[i] >> shift ) & 0xFF;
+            int b = ( tiled[i] >> shift ) & 0xFF;
+
+            if( std::abs( a - b ) > 2 )
+            {
+                different++;
+                break;
+            }
+        }
+    }
+
+    BOOST_CHECK_GT( drawn, width * height / 20 );
+    BOOST_CHECK_LT( different, width * height / 1000 );
+
+    // The recordings are replayed until the items are updated or the view is zoomed
+    BOOST_CHECK_GT( view.GetDrawStats().m_recordedItems, 0 );
+    BOOST_CHECK( render( 64 ) == tiled );
+    BOOST_CHECK_EQUAL( view.GetDrawStats().m_recordedItems, 0 );
+
+    view.Update( m_items.back(), GEOMETRY );
+    BOOST_CHECK( render( 64 ) == tiled );
+    BOOST_CHECK_EQUAL( view.GetDrawStats().m_recordedItems, 1 );
+
+    // The recordings have their colors baked in, they are dropped when the colors change
+    painter.GetSettings()->SetHighlight( true, 0 );
+    view.UpdateAllLayersColor();
+    BOOST_CHECK( render( 64 ) != tiled );
+    BOOST_CHECK_GT( view.GetDrawStats().m_recordedItems, 1 );
+
+    painter.GetSettings()->SetHighlight( false );
+    view.UpdateAllLayersColor();
+    BOOST_CHECK( render( 64 ) == tiled );
+    BOOST_CHECK_GT( view.GetDrawStats().m_recordedItems, 1 );
+
+    view.SetScale( view.GetScale() * 1.5 );
+    render( 64 );
+    BOOST_CHECK_GT( view.GetDrawStats().m_recordedItems, 1 );
+
+    for( BOARD_ITEM* item : m_items )
+        view.Remove( item );
+}
+
+
+/**
+ * The display options which redraw layers or change the colors show up in tiled redraws
+ */
+BOOST_AUTO_TEST_CASE( TiledCairoDisplayOptions )
+{
+    const int width = 700;
+    const int height = 500;
+
+    NETINFO_ITEM* net = new NETINFO_ITEM( &m_board, wxT( "GND" ), 1 );
+
+    m_board.Add( net );
+
+    for( MODULE* module : m_board.Modules() )
+    {
+        for( D_PAD* pad : module->Pads() )
+            pad->SetNet( net );
+    }
+
+    GAL_DISPLAY_OPTIONS options;
+    CAIRO_IMAGE_GAL     gal( options, width, height );
+    PCB_PAINTER         painter( &gal );
+    PCB_VIEW            view;
+    RENDER_SETTINGS*    settings = painter.GetSettings();
+
+    // Black items with white pad labels, on white
+    gal.SetWorldUnitLength( 1e-9 / 0.0254 );
+    gal.SetClearColor( COLOR4D::WHITE );
+    view.SetGAL( &gal );
+    view.SetPainter( &painter );
+
+    settings->SetLayerColor( LAYER_PCB_BACKGROUND, COLOR4D::WHITE );
+
+    for( int layer : { LAYER_PADS_NETNAMES, LAYER_PAD_FR_NETNAMES, LAYER_PAD_BK_NETNAMES } )
+        settings->SetLayerColor( layer, COLOR4D::WHITE );
+
+    for( int i = 0; i < VIEW::VIEW_MAX_LAYERS; i++ )
+        view.SetLayerTarget( i, TARGET_NONCACHED );
+
+    // PCB_VIEW adds the children of modules with them
+    for( BOARD_ITEM* item : m_items )
+    {
+        if( item->GetParent() == &m_board )
+            view.Add( item );
+    }
+
+    // Close enough to the pads of a module to draw their labels
+    view.SetViewport( BOX2D( VECTOR2D( -1500000, -1000000 ), VECTOR2D( 3000000, 2000000 ) ) );
+
+    PCB_DISPLAY_OPTIONS displayOptions;
+
+    view.UpdateDisplayOptions( displayOptions, false );
+
+    std::vector<uint32_t> labels = renderCairo( gal, view, 64, width, height );
+
+    // Pad numbers without net names
+    displayOptions.m_DisplayNetNamesMode = 2;
+    view.UpdateDisplayOptions( displayOptions, false );
+
+    std::vector<uint32_t> numbers = renderCairo( gal, view, 64, width, height );
+
+    BOOST_CHECK( numbers != labels );
+    BOOST_CHECK_GT( view.GetDrawStats().m_recordedItems, 0 );
+
+    displayOptions.m_DisplayPadNum = false;
+    view.UpdateDisplayOptions( displayOptions, false );
+    BOOST_CHECK( renderCairo( gal, view, 64, width, height ) != numbers );
+
+    displayOptions.m_DisplayNetNamesMode = 3;
+    displayOptions.m_DisplayPadNum = true;
+    view.UpdateDisplayOptions( displayOptions, false );
+    BOOST_CHECK( renderCairo( gal, view, 64, width, height ) == labels );
+
+    displayOptions.m_ContrastModeDisplay = true;
+    view.UpdateDisplayOptions( displayOptions, false );
+    BOOST_CHECK( renderCairo( gal, view, 64, width, height ) != labels );
+
+    displayOptions.m_ContrastModeDisplay = false;
+    view.UpdateDisplayOptions( displayOptions, false );
+    BOOST_CHECK( renderCairo( gal, view, 64, width, height ) == labels );
+
+    for( BOARD_ITEM* item : m_items )
+    {
+        if( item->GetParent() == &m_board )
+            view.Remove( item );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
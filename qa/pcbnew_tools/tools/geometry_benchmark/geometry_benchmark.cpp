@@ -0,0 +1,660 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * Micro-benchmarks of the kimath geometry kernels (SEG, SHAPE_LINE_CHAIN, SHAPE_POLY_SET and
+ * the shape collision functions), run on generated inputs and, if a board is given, on
+ * inputs taken from that board.  The results can be written as JSON, to be tracked over time.
+ */
+
+#include <geometry/seg.h>
+#include <geometry/shape_circle.h>
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+#include <geometry/shape_rect.h>
+#include <geometry/shape_segment.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <class_zone.h>
+
+#include <convert_to_biu.h>
+
+#include <wx/cmdline.h>
+#include <wx/filename.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/**
+ * The data the benchmarks run on
+ */
+struct GEOM_INPUT
+{
+    std::string                         m_name;
+
+    ///> Filled areas, as in a zone fill (fractured, no holes)
+    SHAPE_POLY_SET                      m_polys;
+
+    ///> Obstacles to knock out of m_polys, one outline per item
+    SHAPE_POLY_SET                      m_obstacles;
+
+    std::vector<SEG>                    m_segs;
+    std::vector<VECTOR2I>               m_points;
+    std::vector<std::unique_ptr<SHAPE>> m_shapes;
+    int                                 m_clearance = 0;
+};
+
+
+struct BENCH_CASE
+{
+    std::string                  m_name;
+
+    ///> Run before each repetition, not timed
+    std::function<void()>        m_setup;
+
+    ///> The timed code; returns a value depending on the results, so they are not optimised
+    ///> away
+    std::function<size_t()>      m_run;
+};
+
+
+struct BENCH_RESULT
+{
+    std::string         m_name;
+    std::string         m_input;
+    std::vector<double> m_timesMs;
+    size_t              m_check = 0;
+};
+
+
+static SHAPE_LINE_CHAIN rectChain( const VECTOR2I& aCentre, int aHalfW, int aHalfH )
+{
+    SHAPE_LINE_CHAIN chain;
+
+    chain.Append( aCentre + VECTOR2I( -aHalfW, -aHalfH ) );
+    chain.Append( aCentre + VECTOR2I( aHalfW, -aHalfH ) );
+    chain.Append( aCentre + VECTOR2I( aHalfW, aHalfH ) );
+    chain.Append( aCentre + VECTOR2I( -aHalfW, aHalfH ) );
+    chain.SetClosed( true );
+
+    return chain;
+}
+
+
+/**
+ * A wavy 100 mm board-sized area with round holes, knocked out by random tracks and pads
+ */
+static std::unique_ptr<GEOM_INPUT> generatedInput()
+{
+    auto               input = std::make_unique<GEOM_INPUT>();
+    std::mt19937       rng( 1234 );
+    const int          size = 100000000;
+    SHAPE_LINE_CHAIN   outline;
+
+    input->m_name = "generated";
+    input->m_clearance = 200000;
+
+    std::uniform_int_distribution<int> coord( -size / 2, size / 2 );
+    std::uniform_int_distribution<int> step( -3000000, 3000000 );
+
+    for( int i = 0; i < 2000; i++ )
+    {
+        double a = 2.0 * M_PI * i / 2000;
+        double r = size / 2 * ( 1.0 + 0.05 * sin( 17.0 * a ) );
+        outline.Append( (int) ( r * cos( a ) ), (int) ( r * sin( a ) ) );
+    }
+
+    outline.SetClosed( true );
+    input->m_polys.AddOutline( outline );
+
+    for( int i = 0; i < 200; i++ )
+    {
+        SHAPE_LINE_CHAIN hole;
+        VECTOR2I         c( coord( rng ) / 2, coord( rng ) / 2 );
+
+        for( int j = 0; j < 32; j++ )
+        {
+            double a = 2.0 * M_PI * j / 32;
+            hole.Append( c.x + (int) ( 500000 * cos( a ) ), c.y + (int) ( 500000 * sin( a ) ) );
+        }
+
+        hole.SetClosed( true );
+        input->m_polys.AddHole( hole );
+    }
+
+    input->m_polys.Simplify( SHAPE_POLY_SET::PM_FAST );
+    input->m_polys.Fracture( SHAPE_POLY_SET::PM_FAST );
+
+    for( int i = 0; i < 5000; i++ )
+    {
+        VECTOR2I a( coord( rng ), coord( rng ) );
+        VECTOR2I b = a + VECTOR2I( step( rng ), step( rng ) );
+        int      width = 250000;
+
+        input->m_segs.emplace_back( a, b );
+        input->m_points.push_back( a );
+        input->m_shapes.push_back( std::make_unique<SHAPE_SEGMENT>( a, b, width ) );
+
+        if( i % 4 == 0 )
+        {
+            input->m_shapes.push_back( std::make_unique<SHAPE_CIRCLE>( b, 400000 ) );
+            input->m_obstacles.AddOutline( rectChain( b, 600000, 400000 ) );
+        }
+        else if( i % 4 == 1 )
+        {
+            input->m_shapes.push_back( std::make_unique<SHAPE_RECT>( b, 1200000, 800000 ) );
+            input->m_obstacles.AddOutline( rectChain( b, 400000, 400000 ) );
+        }
+    }
+
+    return input;
+}
+
+
+/**
+ * The zone fills, tracks, vias and pads of a board
+ */
+static std::unique_ptr<GEOM_INPUT> boardInput( const std::string& aFilename )
+{
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( aFilename );
+
+    if( !board )
+        return nullptr;
+
+    auto input = std::make_unique<GEOM_INPUT>();
+
+    input->m_name = "board:" + wxFileName( aFilename ).GetName().ToStdString();
+    input->m_clearance = board->GetDesignSettings().GetDefault()->GetClearance();
+
+    for( ZONE_CONTAINER* zone : board->Zones() )
+        input->m_polys.Append( zone->GetFilledPolysList() );
+
+    for( TRACK* track : board->Tracks() )
+    {
+        if( track->Type() == PCB_VIA_T )
+        {
+            VECTOR2I pos( track->GetPosition() );
+
+            input->m_points.push_back( pos );
+            input->m_shapes.push_back(
+                    std::make_unique<SHAPE_CIRCLE>( pos, track->GetWidth() / 2 ) );
+        }
+        else if( track->Type() == PCB_TRACE_T )
+        {
+            SEG seg( track->GetStart(), track->GetEnd() );
+
+            input->m_segs.push_back( seg );
+            input->m_shapes.push_back(
+                    std::make_unique<SHAPE_SEGMENT>( seg, track->GetWidth() ) );
+        }
+        else
+        {
+            continue;
+        }
+
+        track->TransformShapeWithClearanceToPolygon( input->m_obstacles, input->m_clearance,
+                                                     ARC_HIGH_DEF );
+    }
+
+    for( MODULE* module : board->Modules() )
+    {
+        for( D_PAD* pad : module->Pads() )
+        {
+            EDA_RECT bbox = pad->GetBoundingBox();
+
+            input->m_points.push_back( pad->GetPosition() );
+            input->m_shapes.push_back( std::make_unique<SHAPE_RECT>(
+                    bbox.GetPosition(), bbox.GetWidth(), bbox.GetHeight() ) );
+            pad->TransformShapeWithClearanceToPolygon( input->m_obstacles, input->m_clearance,
+                                                       ARC_HIGH_DEF );
+        }
+    }
+
+    return input;
+}
+
+
+/**
+ * The benchmarks run on each input
+ */
+static std::vector<BENCH_CASE> benchCases( const GEOM_INPUT& aInput )
+{
+    // Each item is tested against the next ones in the list, as a stand-in for the candidates
+    // a spatial index would return
+    const size_t window = 32;
+
+    // Scratch sets for the benchmarks modifying a polygon set, rebuilt before each run
+    auto scratch = std::make_shared<SHAPE_POLY_SET>();
+    auto largest = std::make_shared<SHAPE_LINE_CHAIN>();
+
+    for( int i = 0; i < aInput.m_polys.OutlineCount(); i++ )
+    {
+        if( aInput.m_polys.COutline( i ).PointCount() > largest->PointCount() )
+            *largest = aInput.m_polys.COutline( i );
+    }
+
+    const GEOM_INPUT& in = aInput;
+
+    // A copy without a triangulation cache: copies and assignments share the cache, so the
+    // set is rebuilt from scratch, point by point
+    auto fresh = std::make_shared<std::unique_ptr<SHAPE_POLY_SET>>();
+
+    auto freshCopy = [fresh]( const SHAPE_POLY_SET& aSource )
+    {
+        fresh->reset( new SHAPE_POLY_SET );
+
+        SHAPE_POLY_SET& copy = **fresh;
+
+        for( int i = 0; i < aSource.OutlineCount(); i++ )
+        {
+            copy.NewOutline();
+
+            for( int j = 0; j <= aSource.HoleCount( i ); j++ )
+            {
+                if( j > 0 )
+                    copy.NewHole( i );
+
+                const SHAPE_LINE_CHAIN& contour = j == 0 ? aSource.COutline( i )
+                                                         : aSource.CHole( i, j - 1 );
+
+                for( int k = 0; k < contour.PointCount(); k++ )
+                    copy.Append( contour.CPoint( k ), i, j - 1 );
+            }
+        }
+    };
+
+    auto copyPolys = [&in, scratch]()
+    {
+        *scratch = in.m_polys;
+    };
+
+    std::vector<BENCH_CASE> cases = {
+        { "seg_intersect", nullptr,
+          [&in, window]() -> size_t
+          {
+              size_t hits = 0;
+
+              for( size_t i = 0; i < in.m_segs.size(); i++ )
+              {
+                  for( size_t j = i + 1; j < std::min( in.m_segs.size(), i + window ); j++ )
+                      hits += in.m_segs[i].Intersect( in.m_segs[j] ) ? 1 : 0;
+              }
+
+              return hits;
+          } },
+        { "seg_distance", nullptr,
+          [&in, window]() -> size_t
+          {
+              SEG::ecoord acc = 0;
+
+              for( size_t i = 0; i < in.m_segs.size(); i++ )
+              {
+                  for( size_t j = i + 1; j < std::min( in.m_segs.size(), i + window ); j++ )
+                      acc += in.m_segs[i].SquaredDistance( in.m_segs[j] ) & 0xFF;
+              }
+
+              return (size_t) acc;
+          } },
+        { "chain_collide", nullptr,
+          [&in, largest]() -> size_t
+          {
+              size_t hits = 0;
+
+              for( const SEG& seg : in.m_segs )
+                  hits += largest->Collide( seg, in.m_clearance ) ? 1 : 0;
+
+              return hits;
+          } },
+        { "poly_contains", nullptr,
+          [&in]() -> size_t
+          {
+              size_t hits = 0;
+
+              for( const VECTOR2I& p : in.m_points )
+                  hits += in.m_polys.Contains( p ) ? 1 : 0;
+
+              return hits;
+          } },
+        { "poly_contains_batch", nullptr,
+          [&in]() -> size_t
+          {
+              std::vector<bool> results;
+              in.m_polys.Contains( in.m_points, results );
+              return std::count( results.begin(), results.end(), true );
+          } },
+        { "poly_collide_seg", nullptr,
+          [&in]() -> size_t
+          {
+              size_t hits = 0;
+
+              for( const SEG& seg : in.m_segs )
+                  hits += in.m_polys.Collide( seg, in.m_clearance ) ? 1 : 0;
+
+              return hits;
+          } },
+        { "poly_boolean_subtract", copyPolys,
+          [&in, scratch]() -> size_t
+          {
+              scratch->BooleanSubtract( in.m_obstacles, SHAPE_POLY_SET::PM_FAST );
+              return scratch->OutlineCount();
+          } },
+        { "poly_boolean_intersect", copyPolys,
+          [&in, scratch]() -> size_t
+          {
+              scratch->BooleanIntersection( in.m_obstacles, SHAPE_POLY_SET::PM_FAST );
+              return scratch->OutlineCount();
+          } },
+        { "poly_simplify_obstacles",
+          [&in, scratch]()
+          {
+              *scratch = in.m_obstacles;
+          },
+          [scratch]() -> size_t
+          {
+              scratch->Simplify( SHAPE_POLY_SET::PM_FAST );
+              return scratch->OutlineCount();
+          } },
+        { "poly_union_all_obstacles",
+          [&in, scratch]()
+          {
+              *scratch = in.m_obstacles;
+          },
+          [scratch]() -> size_t
+          {
+              scratch->UnionAll( SHAPE_POLY_SET::PM_FAST );
+              return scratch->OutlineCount();
+          } },
+        { "poly_inflate", copyPolys,
+          [&in, scratch]() -> size_t
+          {
+              scratch->Inflate( -in.m_clearance, 16 );
+              return scratch->TotalVertices();
+          } },
+        { "poly_inflate_max_error",
+          [&in, scratch]()
+          {
+              *scratch = in.m_obstacles;
+          },
+          [&in, scratch]() -> size_t
+          {
+              scratch->Inflate( in.m_clearance, SHAPE_POLY_SET::ROUND_ALL_CORNERS, ARC_HIGH_DEF );
+              return scratch->TotalVertices();
+          } },
+        { "poly_inflate_obstacles",
+          [&in, scratch]()
+          {
+              *scratch = in.m_obstacles;
+          },
+          [&in, scratch]() -> size_t
+          {
+              scratch->Inflate( in.m_clearance, 32 );
+              return scratch->TotalVertices();
+          } },
+        { "poly_fracture",
+          [copyPolys, scratch]()
+          {
+              copyPolys();
+              scratch->Unfracture( SHAPE_POLY_SET::PM_FAST );
+          },
+          [scratch]() -> size_t
+          {
+              scratch->Fracture( SHAPE_POLY_SET::PM_FAST );
+              return scratch->TotalVertices();
+          } },
+        { "poly_triangulate",
+          [&in, freshCopy]()
+          {
+              freshCopy( in.m_polys );
+          },
+          [fresh]() -> size_t
+          {
+              ( *fresh )->CacheTriangulation();
+              return ( *fresh )->TriangulatedPolyCount();
+          } },
+        { "shape_collide", nullptr,
+          [&in, window]() -> size_t
+          {
+              size_t hits = 0;
+
+              for( size_t i = 0; i < in.m_shapes.size(); i++ )
+              {
+                  for( size_t j = i + 1; j < std::min( in.m_shapes.size(), i + window ); j++ )
+                      hits += in.m_shapes[i]->Collide( in.m_shapes[j].get(), in.m_clearance );
+              }
+
+              return hits;
+          } },
+    };
+
+    return cases;
+}
+
+
+static double median( std::vector<double> aValues )
+{
+    std::sort( aValues.begin(), aValues.end() );
+
+    size_t n = aValues.size();
+
+    return n % 2 ? aValues[n / 2] : ( aValues[n / 2 - 1] + aValues[n / 2] ) / 2.0;
+}
+
+
+static std::string jsonEscape( const std::string& aString )
+{
+    std::string out;
+
+    for( char c : aString )
+    {
+        if( c == '"' || c == '\\' )
+            out += '\\';
+
+        if( (unsigned char) c < 0x20 )
+            continue;
+
+        out += c;
+    }
+
+    return out;
+}
+
+
+static void writeJson( std::ostream& aStream, const std::vector<BENCH_RESULT>& aResults,
+                       int aReps )
+{
+    aStream << std::setprecision( 6 );
+    aStream << "{\n";
+    aStream << "  \"reps\": " << aReps << ",\n";
+    aStream << "  \"threads\": " << std::thread::hardware_concurrency() << ",\n";
+    aStream << "  \"results\": [\n";
+
+    for( size_t i = 0; i < aResults.size(); i++ )
+    {
+        const BENCH_RESULT& r = aResults[i];
+        const auto          minmax = std::minmax_element( r.m_timesMs.begin(), r.m_timesMs.end() );
+
+        aStream << "    { \"name\": \"" << jsonEscape( r.m_name ) << "\", \"input\": \""
+                << jsonEscape( r.m_input ) << "\", \"min_ms\": " << *minmax.first
+                << ", \"median_ms\": " << median( r.m_timesMs ) << ", \"max_ms\": "
+                << *minmax.second << ", \"check\": " << r.m_check << " }"
+                << ( i + 1 < aResults.size() ? "," : "" ) << "\n";
+    }
+
+    aStream << "  ]\n";
+    aStream << "}\n";
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "b",
+            "board",
+            _( "also run the benchmarks on the geometry of this board" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "r",
+            "reps",
+            _( "repetitions of each benchmark (default 5)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "f",
+            "filter",
+            _( "only run the benchmarks whose name contains this string" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "j",
+            "json",
+            _( "write the results to this JSON file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum GEOM_BENCH_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+int geometry_benchmark_main( int argc, char* argv[] )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( _( "Benchmarks the geometry kernels of kimath." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    long     reps = 5;
+    wxString filter;
+    wxString boardFile;
+    wxString jsonFile;
+
+    cl_parser.Found( "reps", &reps );
+    cl_parser.Found( "filter", &filter );
+
+    if( reps < 1 )
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    std::vector<std::unique_ptr<GEOM_INPUT>> inputs;
+    inputs.push_back( generatedInput() );
+
+    if( cl_parser.Found( "board", &boardFile ) )
+    {
+        inputs.push_back( boardInput( boardFile.ToStdString() ) );
+
+        if( !inputs.back() )
+            return GEOM_BENCH_RET_CODES::LOAD_FAILED;
+    }
+
+    std::vector<BENCH_RESULT> results;
+
+    for( const auto& input : inputs )
+    {
+        std::cout << input->m_name << ": " << input->m_polys.TotalVertices() << " vertices, "
+                  << input->m_obstacles.OutlineCount() << " obstacles, " << input->m_segs.size()
+                  << " segments, " << input->m_shapes.size() << " shapes" << std::endl;
+
+        for( const BENCH_CASE& bench : benchCases( *input ) )
+        {
+            if( !filter.IsEmpty() && bench.m_name.find( filter.ToStdString() ) == std::string::npos )
+                continue;
+
+            BENCH_RESULT result;
+            result.m_name = bench.m_name;
+            result.m_input = input->m_name;
+
+            for( long i = 0; i < reps; i++ )
+            {
+                if( bench.m_setup )
+                    bench.m_setup();
+
+                auto start = std::chrono::steady_clock::now();
+                result.m_check = bench.m_run();
+                std::chrono::duration<double, std::milli> elapsed =
+                        std::chrono::steady_clock::now() - start;
+
+                result.m_timesMs.push_back( elapsed.count() );
+            }
+
+            std::cout << "  " << std::left << std::setw( 28 ) << bench.m_name << std::right
+                      << std::fixed << std::setprecision( 3 ) << std::setw( 12 )
+                      << median( result.m_timesMs ) << " ms" << std::endl;
+
+            results.push_back( std::move( result ) );
+        }
+    }
+
+    if( cl_parser.Found( "json", &jsonFile ) )
+    {
+        std::ofstream out( jsonFile.ToStdString() );
+        writeJson( out, results, reps );
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "geometry_benchmark",
+        "Benchmark the kimath geometry kernels",
+        geometry_benchmark_main,
+} );
@@ -0,0 +1,478 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * Headless render benchmark: a board is drawn by PCB_PAINTER to a RECORDING_GAL at a few
+ * scripted viewports and zoom levels, and the recorded calls are tessellated to triangles.
+ * Reports per layer item, call and vertex counts and the time taken by the painter and the
+ * tessellation, so painter changes can be benchmarked without a GPU.  The calls can also be
+ * rasterized by Cairo into an image.
+ */
+
+#include "render_tessellator.h"
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <gal/cairo/cairo_image_gal.h>
+#include <gal/gal_display_options.h>
+#include <gal/recording_gal.h>
+#include <pcb_painter.h>
+#include <pcb_view.h>
+
+#include <wx/cmdline.h>
+#include <wx/filename.h>
+#include <wx/tokenzr.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace KIGFX;
+
+
+struct LAYER_RESULT
+{
+    int    m_layer = 0;
+    size_t m_items = 0;
+    size_t m_commands = 0;
+    size_t m_vertices = 0;
+    double m_recordMs = 0.0;
+    double m_tessellateMs = 0.0;
+    double m_rasterMs = 0.0;
+};
+
+
+struct VIEWPORT_RESULT
+{
+    double                    m_zoom = 1.0;
+    double                    m_scale = 1.0;
+    std::vector<LAYER_RESULT> m_layers;
+};
+
+
+/**
+ * Minimum of the times measured over the repetitions of each step, as the noise on a shared
+ * CI machine only ever adds time
+ */
+static void keepFastest( LAYER_RESULT& aBest, const LAYER_RESULT& aRun, bool aFirst )
+{
+    if( aFirst )
+    {
+        aBest = aRun;
+        return;
+    }
+
+    aBest.m_recordMs = std::min( aBest.m_recordMs, aRun.m_recordMs );
+    aBest.m_tessellateMs = std::min( aBest.m_tessellateMs, aRun.m_tessellateMs );
+    aBest.m_rasterMs = std::min( aBest.m_rasterMs, aRun.m_rasterMs );
+}
+
+
+static double msSince( const std::chrono::steady_clock::time_point& aStart )
+{
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - aStart;
+    return elapsed.count();
+}
+
+
+/**
+ * Draws the items of the current viewport that are visible at its scale, a group per layer
+ * (in the order of the layer IDs, not of the view).
+ * @param aRaster is the GAL to replay the calls on, or nullptr
+ */
+static std::vector<LAYER_RESULT> renderViewport( PCB_VIEW& aView, PAINTER& aPainter,
+                                                 RECORDING_GAL& aGal, CAIRO_IMAGE_GAL* aRaster,
+                                                 double aMaxError )
+{
+    std::vector<VIEW::LAYER_ITEM_PAIR> visible;
+    std::map<int, std::vector<VIEW_ITEM*>> layerItems;
+
+    BOX2D viewport = aView.GetViewport();
+    BOX2I rect( VECTOR2I( viewport.GetOrigin() ), VECTOR2I( viewport.GetSize() ) );
+
+    aView.Query( rect, visible );
+
+    for( const VIEW::LAYER_ITEM_PAIR& pair : visible )
+    {
+        if( pair.first->ViewGetLOD( pair.second, &aView ) < aView.GetScale() )
+            layerItems[pair.second].push_back( pair.first );
+    }
+
+    if( aRaster )
+    {
+        aRaster->SetLookAtPoint( aGal.GetLookAtPoint() );
+        aRaster->SetZoomFactor( aGal.GetZoomFactor() );
+        aRaster->SetFlip( aGal.IsFlippedX(), aGal.IsFlippedY() );
+    }
+
+    std::vector<LAYER_RESULT>            results;
+    std::vector<TESSELLATED_VERTEX>      vertices;
+    std::unique_ptr<GAL_DRAWING_CONTEXT> rasterContext;
+
+    if( aRaster )
+        rasterContext = std::make_unique<GAL_DRAWING_CONTEXT>( aRaster );
+
+    for( const auto& layer : layerItems )
+    {
+        LAYER_RESULT result;
+        result.m_layer = layer.first;
+        result.m_items = layer.second.size();
+
+        // Recording
+        auto start = std::chrono::steady_clock::now();
+        int  group = aGal.BeginGroup();
+
+        for( VIEW_ITEM* item : layer.second )
+        {
+            if( !aPainter.Draw( item, layer.first ) )
+                item->ViewDraw( layer.first, &aView );
+        }
+
+        aGal.EndGroup();
+        result.m_recordMs = msSince( start );
+
+        RECORDING_GAL::COMMANDS commands = aGal.TakeGroup( group );
+        result.m_commands = commands.size();
+
+        // Tessellation
+        vertices.clear();
+        start = std::chrono::steady_clock::now();
+        result.m_vertices = TessellateCommands( commands, vertices, aMaxError );
+        result.m_tessellateMs = msSince( start );
+
+        // Rasterization
+        if( aRaster )
+        {
+            start = std::chrono::steady_clock::now();
+            RECORDING_GAL::Replay( commands, *aRaster );
+            aRaster->Flush();
+            result.m_rasterMs = msSince( start );
+        }
+
+        results.push_back( result );
+    }
+
+    return results;
+}
+
+
+static void writeJson( std::ostream& aStream, const std::string& aBoard,
+                       const std::vector<VIEWPORT_RESULT>& aResults, int aReps, bool aRaster )
+{
+    aStream << std::setprecision( 6 );
+    aStream << "{\n";
+    aStream << "  \"board\": \"" << aBoard << "\",\n";
+    aStream << "  \"reps\": " << aReps << ",\n";
+    aStream << "  \"viewports\": [\n";
+
+    for( size_t i = 0; i < aResults.size(); i++ )
+    {
+        const VIEWPORT_RESULT& vp = aResults[i];
+
+        aStream << "    { \"zoom\": " << vp.m_zoom << ", \"scale\": " << vp.m_scale
+                << ", \"layers\": [\n";
+
+        for( size_t j = 0; j < vp.m_layers.size(); j++ )
+        {
+            const LAYER_RESULT& r = vp.m_layers[j];
+
+            aStream << "        { \"layer\": " << r.m_layer << ", \"name\": \""
+                    << LayerName( r.m_layer ).ToStdString() << "\", \"items\": " << r.m_items
+                    << ", \"commands\": " << r.m_commands << ", \"vertices\": " << r.m_vertices
+                    << ", \"record_ms\": " << r.m_recordMs << ", \"tessellate_ms\": "
+                    << r.m_tessellateMs;
+
+            if( aRaster )
+                aStream << ", \"raster_ms\": " << r.m_rasterMs;
+
+            aStream << " }" << ( j + 1 < vp.m_layers.size() ? "," : "" ) << "\n";
+        }
+
+        aStream << "      ] }" << ( i + 1 < aResults.size() ? "," : "" ) << "\n";
+    }
+
+    aStream << "  ]\n";
+    aStream << "}\n";
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "r",
+            "reps",
+            _( "repetitions of each viewport (default 3)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "z",
+            "zoom",
+            _( "comma separated zoom levels, relative to the whole board (default 1,4,16)" )
+                    .mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "s",
+            "size",
+            _( "viewport size in pixels, as WIDTHxHEIGHT (default 1920x1080)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "c",
+            "cairo",
+            _( "also rasterize the calls with Cairo" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "p",
+            "png",
+            _( "with --cairo, write the image of each viewport to PREFIX_<zoom>.png" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "j",
+            "json",
+            _( "write the results to this JSON file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "input file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum RENDER_BENCH_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+int render_benchmark_main( int argc, char* argv[] )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( _( "Benchmarks drawing a board with PCB_PAINTER, without a GPU." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    long                reps = 3;
+    wxString            zoomList = "1,4,16";
+    wxString            sizeString = "1920x1080";
+    wxString            pngPrefix;
+    wxString            jsonFile;
+    std::vector<double> zooms;
+    long                width = 0;
+    long                height = 0;
+
+    cl_parser.Found( "reps", &reps );
+    cl_parser.Found( "zoom", &zoomList );
+    cl_parser.Found( "size", &sizeString );
+
+    wxStringTokenizer zoomTokens( zoomList, "," );
+
+    while( zoomTokens.HasMoreTokens() )
+    {
+        double zoom;
+
+        if( !zoomTokens.GetNextToken().ToDouble( &zoom ) || zoom <= 0.0 )
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+        zooms.push_back( zoom );
+    }
+
+    if( reps < 1 || zooms.empty() || !sizeString.BeforeFirst( 'x' ).ToLong( &width )
+            || !sizeString.AfterFirst( 'x' ).ToLong( &height ) || width < 1 || height < 1 )
+    {
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const std::string filename = cl_parser.GetParam( 0 ).ToStdString();
+
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !board )
+        return RENDER_BENCH_RET_CODES::LOAD_FAILED;
+
+    // Zone fills are triangulated when they are filled or loaded, not when they are drawn
+    for( ZONE_CONTAINER* zone : board->Zones() )
+        zone->CacheTriangulation();
+
+    GAL_DISPLAY_OPTIONS options;
+    RECORDING_GAL       gal( options );
+    PCB_PAINTER         painter( &gal );
+    PCB_VIEW            view;
+
+    // As set up by PCB_DRAW_PANEL_GAL
+    gal.SetWorldUnitLength( 1e-9 /* 1 nm */ / 0.0254 /* 1 inch in meters */ );
+    gal.SetScreenSize( VECTOR2I( width, height ) );
+    view.SetGAL( &gal );
+    view.SetPainter( &painter );
+    view.SetScaleLimits( 1e6, 1e-6 );
+
+    std::unique_ptr<CAIRO_IMAGE_GAL> raster;
+
+    if( cl_parser.Found( "cairo" ) )
+    {
+        raster = std::make_unique<CAIRO_IMAGE_GAL>( options, width, height );
+        raster->SetWorldUnitLength( 1e-9 / 0.0254 );
+    }
+
+    for( TRACK* track : board->Tracks() )
+        view.Add( track );
+
+    for( MODULE* module : board->Modules() )
+        view.Add( module );
+
+    for( BOARD_ITEM* drawing : board->Drawings() )
+        view.Add( drawing );
+
+    for( ZONE_CONTAINER* zone : board->Zones() )
+        view.Add( zone );
+
+    EDA_RECT bbox = board->ComputeBoundingBox();
+    view.SetViewport( BOX2D( bbox.GetOrigin(), bbox.GetSize() ) );
+
+    const double fitScale = view.GetScale();
+    const double maxError = board->GetDesignSettings().m_MaxError;
+
+    std::vector<VIEWPORT_RESULT> results;
+
+    for( double zoom : zooms )
+    {
+        VIEWPORT_RESULT vp;
+
+        view.SetScale( fitScale * zoom );
+        view.SetCenter( VECTOR2D( bbox.Centre() ) );
+
+        vp.m_zoom = zoom;
+        vp.m_scale = view.GetScale();
+
+        // Curves are split finer as the view zooms in, as a renderer does
+        double error = std::max( (double) maxError / zoom, 1.0 );
+
+        for( long i = 0; i < reps; i++ )
+        {
+            std::vector<LAYER_RESULT> run = renderViewport( view, painter, gal, raster.get(),
+                                                            error );
+
+            vp.m_layers.resize( run.size() );
+
+            for( size_t j = 0; j < run.size(); j++ )
+                keepFastest( vp.m_layers[j], run[j], i == 0 );
+        }
+
+        if( raster && cl_parser.Found( "png", &pngPrefix ) )
+            raster->WritePng( pngPrefix.ToStdString() + "_" + std::to_string( zoom ) + ".png" );
+
+        LAYER_RESULT total;
+
+        for( const LAYER_RESULT& r : vp.m_layers )
+        {
+            total.m_items += r.m_items;
+            total.m_commands += r.m_commands;
+            total.m_vertices += r.m_vertices;
+            total.m_recordMs += r.m_recordMs;
+            total.m_tessellateMs += r.m_tessellateMs;
+            total.m_rasterMs += r.m_rasterMs;
+        }
+
+        std::cout << "zoom " << zoom << ": " << vp.m_layers.size() << " layers, " << total.m_items
+                  << " items, " << total.m_commands << " calls, " << total.m_vertices
+                  << " vertices" << std::endl;
+
+        for( const LAYER_RESULT& r : vp.m_layers )
+        {
+            std::cout << "  " << std::left << std::setw( 24 ) << LayerName( r.m_layer )
+                      << std::right << std::setw( 8 ) << r.m_items << std::setw( 10 )
+                      << r.m_vertices << std::fixed << std::setprecision( 3 ) << std::setw( 10 )
+                      << r.m_recordMs << " ms" << std::setw( 10 ) << r.m_tessellateMs << " ms";
+
+            if( raster )
+                std::cout << std::setw( 10 ) << r.m_rasterMs << " ms";
+
+            std::cout << std::defaultfloat << std::endl;
+        }
+
+        results.push_back( std::move( vp ) );
+    }
+
+    if( cl_parser.Found( "json", &jsonFile ) )
+    {
+        std::ofstream out( jsonFile.ToStdString() );
+        writeJson( out, wxFileName( filename ).GetName().ToStdString(), results, reps,
+                   raster != nullptr );
+    }
+
+    for( TRACK* track : board->Tracks() )
+        view.Remove( track );
+
+    for( MODULE* module : board->Modules() )
+        view.Remove( module );
+
+    for( BOARD_ITEM* drawing : board->Drawings() )
+        view.Remove( drawing );
+
+    for( ZONE_CONTAINER* zone : board->Zones() )
+        view.Remove( zone );
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "render_benchmark",
+        "Benchmark drawing a board with PCB_PAINTER, without a GPU",
+        render_benchmark_main,
+} );
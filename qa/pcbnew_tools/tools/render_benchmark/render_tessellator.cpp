@@ -0,0 +1,533 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "render_tessellator.h"
+
+#include <bezier_curves.h>
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+#include <math/util.h>
+
+using namespace KIGFX;
+
+
+namespace
+{
+
+/**
+ * TESSELLATOR
+ *
+ * Keeps the GAL state (colors, line width, depth and transform) while recorded calls are
+ * converted to triangles.  Shapes are built in the coordinates of the call, and transformed
+ * when their vertices are emitted.
+ */
+class TESSELLATOR
+{
+public:
+    typedef TESSELLATED_VERTEX VERTEX;
+
+    TESSELLATOR( std::vector<VERTEX>& aVertices, double aMaxError ) :
+            m_vertices( aVertices ),
+            m_maxError( std::max( aMaxError, 1e-6 ) ),
+            m_isFill( false ),
+            m_isStroke( true ),
+            m_lineWidth( 1.0 ),
+            m_depth( 0.0 )
+    {
+        m_transform.SetIdentity();
+    }
+
+    void Run( const RECORDING_GAL::COMMANDS& aCommands );
+
+private:
+    void vertex( const VECTOR2D& aPoint, const COLOR4D& aColor );
+    void triangle( const VECTOR2D& aA, const VECTOR2D& aB, const VECTOR2D& aC,
+                   const COLOR4D& aColor );
+
+    ///> Number of segments approximating an arc within the maximum error
+    int arcSegments( double aRadius, double aAngle ) const;
+
+    void line( const VECTOR2D& aA, const VECTOR2D& aB, double aWidth, const COLOR4D& aColor );
+    void polyline( const std::vector<VECTOR2D>& aPoints, bool aClosed, double aWidth,
+                   const COLOR4D& aColor );
+    void pie( const VECTOR2D& aCenter, double aRadius, double aStartAngle, double aEndAngle,
+              const COLOR4D& aColor );
+    void ring( const VECTOR2D& aCenter, double aRadius, double aStartAngle, double aEndAngle,
+               double aWidth, const COLOR4D& aColor );
+    void polySet( const SHAPE_POLY_SET& aPolySet );
+    void polygon( const std::vector<VECTOR2D>& aPoints );
+
+    std::vector<VERTEX>&    m_vertices;
+    double                  m_maxError;
+
+    bool                    m_isFill;
+    bool                    m_isStroke;
+    COLOR4D                 m_fillColor;
+    COLOR4D                 m_strokeColor;
+    double                  m_lineWidth;
+    double                  m_depth;
+
+    MATRIX3x3D              m_transform;
+    std::vector<MATRIX3x3D> m_transformStack;
+};
+
+
+void TESSELLATOR::vertex( const VECTOR2D& aPoint, const COLOR4D& aColor )
+{
+    VECTOR2D p = m_transform * aPoint;
+    VERTEX   v;
+
+    v.x = (float) p.x;
+    v.y = (float) p.y;
+    v.z = (float) m_depth;
+    v.r = (uint8_t) KiROUND( aColor.r * 255.0 );
+    v.g = (uint8_t) KiROUND( aColor.g * 255.0 );
+    v.b = (uint8_t) KiROUND( aColor.b * 255.0 );
+    v.a = (uint8_t) KiROUND( aColor.a * 255.0 );
+
+    m_vertices.push_back( v );
+}
+
+
+void TESSELLATOR::triangle( const VECTOR2D& aA, const VECTOR2D& aB, const VECTOR2D& aC,
+                            const COLOR4D& aColor )
+{
+    vertex( aA, aColor );
+    vertex( aB, aColor );
+    vertex( aC, aColor );
+}
+
+
+int TESSELLATOR::arcSegments( double aRadius, double aAngle ) const
+{
+    aAngle = std::abs( aAngle );
+
+    if( aRadius <= m_maxError )
+        return std::max( 1, KiROUND( aAngle / ( 2.0 * M_PI / 3.0 ) ) );
+
+    double step = 2.0 * acos( 1.0 - m_maxError / aRadius );
+
+    return std::max( 1, (int) ceil( aAngle / step ) );
+}
+
+
+void TESSELLATOR::line( const VECTOR2D& aA, const VECTOR2D& aB, double aWidth,
+                        const COLOR4D& aColor )
+{
+    VECTOR2D dir = aB - aA;
+
+    if( dir.x == 0.0 && dir.y == 0.0 )
+        return;
+
+    VECTOR2D n = dir.Perpendicular().Resize( std::max( aWidth, 0.0 ) / 2.0 );
+
+    triangle( aA + n, aA - n, aB + n, aColor );
+    triangle( aA - n, aB - n, aB + n, aColor );
+}
+
+
+void TESSELLATOR::polyline( const std::vector<VECTOR2D>& aPoints, bool aClosed, double aWidth,
+                            const COLOR4D& aColor )
+{
+    for( size_t i = 1; i < aPoints.size(); i++ )
+        line( aPoints[i - 1], aPoints[i], aWidth, aColor );
+
+    if( aClosed && aPoints.size() > 2 )
+        line( aPoints.back(), aPoints.front(), aWidth, aColor );
+}
+
+
+void TESSELLATOR::pie( const VECTOR2D& aCenter, double aRadius, double aStartAngle,
+                       double aEndAngle, const COLOR4D& aColor )
+{
+    if( aRadius <= 0.0 )
+        return;
+
+    int      count = std::max( arcSegments( aRadius, aEndAngle - aStartAngle ), 3 );
+    double   step = ( aEndAngle - aStartAngle ) / count;
+    VECTOR2D prev = aCenter + VECTOR2D( cos( aStartAngle ), sin( aStartAngle ) ) * aRadius;
+
+    for( int i = 1; i <= count; i++ )
+    {
+        double   a = aStartAngle + step * i;
+        VECTOR2D next = aCenter + VECTOR2D( cos( a ), sin( a ) ) * aRadius;
+
+        triangle( aCenter, prev, next, aColor );
+        prev = next;
+    }
+}
+
+
+void TESSELLATOR::ring( const VECTOR2D& aCenter, double aRadius, double aStartAngle,
+                        double aEndAngle, double aWidth, const COLOR4D& aColor )
+{
+    double inner = std::max( aRadius - aWidth / 2.0, 0.0 );
+    double outer = aRadius + aWidth / 2.0;
+    int    count = std::max( arcSegments( outer, aEndAngle - aStartAngle ), 3 );
+    double step = ( aEndAngle - aStartAngle ) / count;
+
+    for( int i = 0; i < count; i++ )
+    {
+        VECTOR2D u0( cos( aStartAngle + step * i ), sin( aStartAngle + step * i ) );
+        VECTOR2D u1( cos( aStartAngle + step * ( i + 1 ) ), sin( aStartAngle + step * ( i + 1 ) ) );
+
+        triangle( aCenter + u0 * inner, aCenter + u0 * outer, aCenter + u1 * outer, aColor );
+        triangle( aCenter + u0 * inner, aCenter + u1 * outer, aCenter + u1 * inner, aColor );
+    }
+}
+
+
+void TESSELLATOR::polySet( const SHAPE_POLY_SET& aPolySet )
+{
+    if( m_isFill )
+    {
+        // Fills are usually triangulated already (the copy shares the cached triangles)
+        const SHAPE_POLY_SET* triangulated = &aPolySet;
+        SHAPE_POLY_SET        copy;
+
+        if( !aPolySet.IsTriangulationUpToDate() )
+        {
+            copy = aPolySet;
+            copy.CacheTriangulation();
+            triangulated = &copy;
+        }
+
+        for( unsigned int j = 0; j < triangulated->TriangulatedPolyCount(); j++ )
+        {
+            auto triPoly = triangulated->TriangulatedPolygon( j );
+
+            for( size_t i = 0; i < triPoly->GetTriangleCount(); i++ )
+            {
+                VECTOR2I a, b, c;
+                triPoly->GetTriangle( i, a, b, c );
+                triangle( a, b, c, m_fillColor );
+            }
+        }
+    }
+
+    if( m_isStroke )
+    {
+        auto strokeChain = [&]( const SHAPE_LINE_CHAIN& aChain )
+        {
+            std::vector<VECTOR2D> points;
+
+            for( int i = 0; i < aChain.PointCount(); i++ )
+                points.emplace_back( aChain.CPoint( i ) );
+
+            polyline( points, true, m_lineWidth, m_strokeColor );
+        };
+
+        for( int i = 0; i < aPolySet.OutlineCount(); i++ )
+        {
+            strokeChain( aPolySet.COutline( i ) );
+
+            for( int j = 0; j < aPolySet.HoleCount( i ); j++ )
+                strokeChain( aPolySet.CHole( i, j ) );
+        }
+    }
+}
+
+
+void TESSELLATOR::polygon( const std::vector<VECTOR2D>& aPoints )
+{
+    if( aPoints.size() < 3 )
+        return;
+
+    SHAPE_POLY_SET   shape;
+    SHAPE_LINE_CHAIN chain;
+
+    for( const VECTOR2D& p : aPoints )
+        chain.Append( KiROUND( p.x ), KiROUND( p.y ) );
+
+    chain.SetClosed( true );
+    shape.AddOutline( chain );
+
+    polySet( shape );
+}
+
+
+void TESSELLATOR::Run( const RECORDING_GAL::COMMANDS& aCommands )
+{
+    for( const RECORDING_GAL::COMMAND& cmd : aCommands )
+    {
+        const std::vector<VECTOR2D>& pts = cmd.m_points;
+
+        switch( cmd.m_type )
+        {
+        case RECORDING_GAL::CMD_SET_IS_FILL:
+            m_isFill = cmd.m_flag;
+            break;
+
+        case RECORDING_GAL::CMD_SET_IS_STROKE:
+            m_isStroke = cmd.m_flag;
+            break;
+
+        case RECORDING_GAL::CMD_SET_FILL_COLOR:
+            m_fillColor = cmd.m_color;
+            break;
+
+        case RECORDING_GAL::CMD_SET_STROKE_COLOR:
+            m_strokeColor = cmd.m_color;
+            break;
+
+        case RECORDING_GAL::CMD_SET_LINE_WIDTH:
+            m_lineWidth = cmd.m_args[0];
+            break;
+
+        case RECORDING_GAL::CMD_SET_LAYER_DEPTH:
+            m_depth = cmd.m_args[0];
+            break;
+
+        case RECORDING_GAL::CMD_DRAW_LINE:
+        case RECORDING_GAL::CMD_DRAW_POLYLINE:
+            polyline( pts, false, m_lineWidth, m_strokeColor );
+            break;
+
+        case RECORDING_GAL::CMD_DRAW_LINE_CHAIN:
+        {
+            const auto&           chain = static_cast<const SHAPE_LINE_CHAIN&>( *cmd.m_shape );
+            std::vector<VECTOR2D> points;
+
+            for( int i = 0; i < chain.PointCount(); i++ )
+                points.emplace_back( chain.CPoint( i ) );
+
+            polyline( points, chain.IsClosed(), m_lineWidth, m_strokeColor );
+            break;
+        }
+
+        case RECORDING_GAL::CMD_DRAW_SEGMENT:
+        {
+            double   radius = cmd.m_args[0] / 2.0;
+            double   angle = ( pts[1] - pts[0] ).Angle();
+
+            // Same as the OpenGL GAL: filled segments take the fill color, outlined ones the
+            // stroke color
+            if( m_isFill || cmd.m_args[0] == 1.0 )
+            {
+                line( pts[0], pts[1], cmd.m_args[0], m_fillColor );
+                pie( pts[0], radius, angle + M_PI / 2, angle + 3 * M_PI / 2, m_fillColor );
+                pie( pts[1], radius, angle - M_PI / 2, angle + M_PI / 2, m_fillColor );
+            }
+            else
+            {
+                VECTOR2D n = ( pts[1] - pts[0] ).Perpendicular().Resize( radius );
+
+                line( pts[0] + n, pts[1] + n, m_lineWidth, m_strokeColor );
+                line( pts[0] - n, pts[1] - n, m_lineWidth, m_strokeColor );
+                ring( pts[0], radius, angle + M_PI / 2, angle + 3 * M_PI / 2, m_lineWidth,
+                      m_strokeColor );
+                ring( pts[1], radius, angle - M_PI / 2, angle + M_PI / 2, m_lineWidth,
+                      m_strokeColor );
+            }
+
+            break;
+        }
+
+        case RECORDING_GAL::CMD_DRAW_CIRCLE:
+        case RECORDING_GAL::CMD_DRAW_ARC:
+        {
+            double startAngle = 0.0;
+            double endAngle = 2.0 * M_PI;
+
+            if( cmd.m_type == RECORDING_GAL::CMD_DRAW_ARC )
+            {
+                startAngle = std::min( cmd.m_args[1], cmd.m_args[2] );
+                endAngle = std::max( cmd.m_args[1], cmd.m_args[2] );
+            }
+
+            if( m_isFill )
+                pie( pts[0], cmd.m_args[0], startAngle, endAngle, m_fillColor );
+
+            if( m_isStroke )
+                ring( pts[0], cmd.m_args[0], startAngle, endAngle, m_lineWidth, m_strokeColor );
+
+            break;
+        }
+
+        case RECORDING_GAL::CMD_DRAW_ARC_SEGMENT:
+        {
+            double radius = cmd.m_args[0];
+            double startAngle = std::min( cmd.m_args[1], cmd.m_args[2] );
+            double endAngle = std::max( cmd.m_args[1], cmd.m_args[2] );
+            double width = cmd.m_args[3];
+
+            VECTOR2D start = pts[0] + VECTOR2D( cos( startAngle ), sin( startAngle ) ) * radius;
+            VECTOR2D end = pts[0] + VECTOR2D( cos( endAngle ), sin( endAngle ) ) * radius;
+
+            if( radius <= 0.0 )
+            {
+                pie( pts[0], width / 2.0, 0.0, 2.0 * M_PI, m_fillColor );
+            }
+            else if( m_isFill )
+            {
+                ring( pts[0], radius, startAngle, endAngle, width, m_fillColor );
+                pie( start, width / 2.0, startAngle + M_PI, startAngle + 2 * M_PI, m_fillColor );
+                pie( end, width / 2.0, endAngle, endAngle + M_PI, m_fillColor );
+            }
+            else if( m_isStroke )
+            {
+                ring( pts[0], radius - width / 2.0, startAngle, endAngle, m_lineWidth,
+                      m_strokeColor );
+                ring( pts[0], radius + width / 2.0, startAngle, endAngle, m_lineWidth,
+                      m_strokeColor );
+                ring( start, width / 2.0, startAngle + M_PI, startAngle + 2 * M_PI, m_lineWidth,
+                      m_strokeColor );
+                ring( end, width / 2.0, endAngle, endAngle + M_PI, m_lineWidth, m_strokeColor );
+            }
+
+            break;
+        }
+
+        case RECORDING_GAL::CMD_DRAW_RECTANGLE:
+        {
+            std::vector<VECTOR2D> corners = { pts[0], VECTOR2D( pts[1].x, pts[0].y ), pts[1],
+                                              VECTOR2D( pts[0].x, pts[1].y ) };
+
+            if( m_isFill )
+            {
+                triangle( corners[0], corners[1], corners[2], m_fillColor );
+                triangle( corners[0], corners[2], corners[3], m_fillColor );
+            }
+
+            if( m_isStroke )
+                polyline( corners, true, m_lineWidth, m_strokeColor );
+
+            break;
+        }
+
+        case RECORDING_GAL::CMD_DRAW_POLYGON:
+            polygon( pts );
+            break;
+
+        case RECORDING_GAL::CMD_DRAW_POLYGON_CHAIN:
+        {
+            SHAPE_POLY_SET shape;
+
+            shape.AddOutline( static_cast<const SHAPE_LINE_CHAIN&>( *cmd.m_shape ) );
+            polySet( shape );
+            break;
+        }
+
+        case RECORDING_GAL::CMD_DRAW_POLY_SET:
+            polySet( static_cast<const SHAPE_POLY_SET&>( *cmd.m_shape ) );
+            break;
+
+        case RECORDING_GAL::CMD_DRAW_CURVE:
+        {
+            std::vector<VECTOR2D> output;
+            BEZIER_POLY           bezier( pts );
+
+            bezier.GetPoly( output, cmd.m_args[0] );
+            polyline( output, false, m_lineWidth, m_strokeColor );
+            break;
+        }
+
+        case RECORDING_GAL::CMD_BITMAP_TEXT:
+        {
+            // Bitmap text is drawn from a glyph atlas: a textured quad per character
+            const RECORDING_GAL::BITMAP_TEXT& text = *cmd.m_text;
+            const VECTOR2D&                   size = text.m_glyphSize;
+
+            m_transformStack.push_back( m_transform );
+
+            MATRIX3x3D placement;
+            placement.SetIdentity();
+            placement.SetTranslation( pts[0] );
+            m_transform = m_transform * placement;
+            placement.SetIdentity();
+            placement.SetRotation( cmd.m_args[0] );
+            m_transform = m_transform * placement;
+
+            double x = -size.x * text.m_text.length() / 2.0;
+
+            for( size_t i = 0; i < text.m_text.length(); i++, x += size.x )
+            {
+                VECTOR2D a( x, -size.y / 2.0 );
+                VECTOR2D b( x + size.x, size.y / 2.0 );
+
+                triangle( a, VECTOR2D( b.x, a.y ), b, m_strokeColor );
+                triangle( a, b, VECTOR2D( a.x, b.y ), m_strokeColor );
+            }
+
+            m_transform = m_transformStack.back();
+            m_transformStack.pop_back();
+            break;
+        }
+
+        case RECORDING_GAL::CMD_TRANSFORM:
+            m_transform = m_transform * *cmd.m_matrix;
+            break;
+
+        case RECORDING_GAL::CMD_ROTATE:
+        case RECORDING_GAL::CMD_TRANSLATE:
+        case RECORDING_GAL::CMD_SCALE:
+        {
+            MATRIX3x3D m;
+            m.SetIdentity();
+
+            if( cmd.m_type == RECORDING_GAL::CMD_ROTATE )
+                m.SetRotation( cmd.m_args[0] );
+            else if( cmd.m_type == RECORDING_GAL::CMD_TRANSLATE )
+                m.SetTranslation( pts[0] );
+            else
+                m.SetScale( pts[0] );
+
+            m_transform = m_transform * m;
+            break;
+        }
+
+        case RECORDING_GAL::CMD_SAVE:
+            m_transformStack.push_back( m_transform );
+            break;
+
+        case RECORDING_GAL::CMD_RESTORE:
+            if( !m_transformStack.empty() )
+            {
+                m_transform = m_transformStack.back();
+                m_transformStack.pop_back();
+            }
+
+            break;
+
+        case RECORDING_GAL::CMD_BEGIN_SHAPE:
+        case RECORDING_GAL::CMD_END_SHAPE:
+        case RECORDING_GAL::CMD_DRAW_SHAPE:
+            // The benchmark GAL does not take the instancing support of a target GAL
+            break;
+        }
+    }
+}
+
+} // namespace
+
+
+size_t TessellateCommands( const RECORDING_GAL::COMMANDS& aCommands,
+                           std::vector<TESSELLATED_VERTEX>& aVertices, double aMaxError )
+{
+    size_t      count = aVertices.size();
+    TESSELLATOR tessellator( aVertices, aMaxError );
+
+    tessellator.Run( aCommands );
+
+    return aVertices.size() - count;
+}
@@ -0,0 +1,52 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef RENDER_TESSELLATOR_H
+#define RENDER_TESSELLATOR_H
+
+#include <gal/recording_gal.h>
+
+#include <cstdint>
+#include <vector>
+
+///> A vertex of the triangles recorded calls are tessellated to
+struct TESSELLATED_VERTEX
+{
+    float   x, y, z;
+    uint8_t r, g, b, a;
+};
+
+/**
+ * Function TessellateCommands()
+ * Converts recorded calls to triangles in world coordinates, as a GPU backend without
+ * shaders would have to: lines become quads, curves are split in segments and polygons are
+ * triangulated.  Bitmap text takes a quad per character.
+ * @param aCommands are the calls to tessellate.
+ * @param aVertices gets three vertices per triangle.
+ * @param aMaxError is the maximum distance between curves and their segments (world units).
+ * @return the number of vertices added to aVertices.
+ */
+size_t TessellateCommands( const KIGFX::RECORDING_GAL::COMMANDS& aCommands,
+                           std::vector<TESSELLATED_VERTEX>& aVertices, double aMaxError );
+
+#endif // RENDER_TESSELLATOR_H
@@ -35,6 +35,8 @@
 #include <array>
 #include <functional>
 #include <iterator>
+#include <utility>
+#include <vector>
 
 #ifdef DEBUG
 #define ASSERT assert    // RTree uses ASSERT( condition )
@@ -186,6 +188,19 @@ public:
     /// Remove all entries from tree
     void    RemoveAll();
 
+    /// Insert many entries at once.  The tree is rebuilt with the new and the existing
+    /// entries, packed into full nodes in Sort-Tile-Recursive order: much faster than
+    /// inserting a lot of entries one by one, and the packed tree is faster to search.
+    /// Rebuilding costs a sort of all the entries, so insert a few entries in a large
+    /// tree one by one instead.
+    /// \param a_entries Bounding rects and data of the entries
+    void    BulkInsert( const std::vector<std::pair<Rect, DATATYPE>>& a_entries );
+
+    /// Remove all the entries matching a predicate, and pack the remaining ones
+    /// \param a_remove Returns true for the data to remove
+    /// \return the number of entries removed
+    int     BulkRemove( std::function<bool( const DATATYPE& )> a_remove );
+
     /// Count the data elements in this container.  This is slow as no internal counter is maintained.
     int     Count();
 
@@ -579,6 +594,10 @@ protected:
     void    RemoveAllRec( Node* a_node );
     void    Reset();
     void    CountRec( Node* a_node, int& a_count );
+    void    CollectRec( Node* a_node, std::vector<Branch>& a_branches );
+    void    Pack( std::vector<Branch>& a_branches );
+    void    SortTileRecursive( std::vector<Branch>& a_branches, size_t a_first, size_t a_last,
+                               int a_axis );
 
     bool    SaveRec( Node* a_node, RTFileStream& a_stream );
     bool    LoadRec( Node* a_node, RTFileStream& a_stream );
@@ -895,6 +914,148 @@ void RTREE_QUAL::CountRec( Node* a_node, int& a_count )
 }
 
 
+RTREE_TEMPLATE
+void RTREE_QUAL::BulkInsert( const std::vector<std::pair<Rect, DATATYPE>>& a_entries )
+{
+    std::vector<Branch> branches;
+
+    CollectRec( m_root, branches );
+    branches.reserve( branches.size() + a_entries.size() );
+
+    for( const std::pair<Rect, DATATYPE>& entry : a_entries )
+    {
+        Branch branch;
+        branch.m_rect = entry.first;
+        branch.m_data = entry.second;
+        branches.push_back( branch );
+    }
+
+    Pack( branches );
+}
+
+
+RTREE_TEMPLATE
+int RTREE_QUAL::BulkRemove( std::function<bool( const DATATYPE& )> a_remove )
+{
+    std::vector<Branch> branches;
+
+    CollectRec( m_root, branches );
+
+    size_t count = branches.size();
+
+    branches.erase( std::remove_if( branches.begin(), branches.end(),
+                                    [&]( const Branch& a_branch )
+                                    {
+                                        return a_remove( a_branch.m_data );
+                                    } ),
+                    branches.end() );
+
+    int removed = (int) ( count - branches.size() );
+
+    // Nothing to do if nothing was removed
+    if( removed )
+        Pack( branches );
+
+    return removed;
+}
+
+
+// Appends the data branches of the leaves under a_node
+RTREE_TEMPLATE
+void RTREE_QUAL::CollectRec( Node* a_node, std::vector<Branch>& a_branches )
+{
+    if( a_node->IsInternalNode() ) // not a leaf node
+    {
+        for( int index = 0; index < a_node->m_count; ++index )
+        {
+            CollectRec( a_node->m_branch[index].m_child, a_branches );
+        }
+    }
+    else // A leaf node
+    {
+        a_branches.insert( a_branches.end(), a_node->m_branch,
+                           a_node->m_branch + a_node->m_count );
+    }
+}
+
+
+// Replaces the tree with one built bottom-up from the data branches a_branches (which are
+// used as scratch space): at each level the branches are sorted in STR order and cut into nodes of MAXNODES branches, whose
+// covers are the branches of the level above.  Only the last node of a level may be less
+// than full.
+RTREE_TEMPLATE
+void RTREE_QUAL::Pack( std::vector<Branch>& a_branches )
+{
+    Reset();
+
+    if( a_branches.empty() )
+    {
+        m_root = AllocNode();
+        m_root->m_level = 0;
+        return;
+    }
+
+    std::vector<Branch> parents;
+
+    for( int level = 0; ; ++level )
+    {
+        SortTileRecursive( a_branches, 0, a_branches.size(), 0 );
+
+        parents.clear();
+        parents.reserve( a_branches.size() / MAXNODES + 1 );
+
+        for( size_t first = 0; first < a_branches.size(); first += MAXNODES )
+        {
+            Node* node = AllocNode();
+            node->m_level = level;
+            node->m_count = (int) std::min<size_t>( MAXNODES, a_branches.size() - first );
+
+            std::copy( a_branches.begin() + first, a_branches.begin() + first + node->m_count,
+                       node->m_branch );
+
+            Branch parent;
+            parent.m_rect = NodeCover( node );
+            parent.m_child = node;
+            parents.push_back( parent );
+        }
+
+        if( parents.size() == 1 )
+        {
+            m_root = parents[0].m_child;
+            return;
+        }
+
+        a_branches.swap( parents );
+    }
+}
+
+
+// Sorts the branches a_first..a_last by the centre of their rects along a_axis, then cuts
+// them into slices of whole nodes and sorts each slice along the next axis, so the nodes
+// cut from the result are tiles of about the same size
+RTREE_TEMPLATE
+void RTREE_QUAL::SortTileRecursive( std::vector<Branch>& a_branches, size_t a_first,
+                                    size_t a_last, int a_axis )
+{
+    std::sort( a_branches.begin() + a_first, a_branches.begin() + a_last,
+               [a_axis]( const Branch& a_a, const Branch& a_b )
+               {
+                   return (ELEMTYPEREAL) a_a.m_rect.m_min[a_axis] + a_a.m_rect.m_max[a_axis]
+                          < (ELEMTYPEREAL) a_b.m_rect.m_min[a_axis] + a_b.m_rect.m_max[a_axis];
+               } );
+
+    if( a_axis == NUMDIMS - 1 )
+        return;
+
+    size_t nodes = ( a_last - a_first + MAXNODES - 1 ) / MAXNODES;
+    size_t slices = (size_t) std::ceil( std::pow( (double) nodes, 1.0 / ( NUMDIMS - a_axis ) ) );
+    size_t sliceSize = ( ( nodes + slices - 1 ) / slices ) * MAXNODES;
+
+    for( size_t first = a_first; first < a_last; first += sliceSize )
+        SortTileRecursive( a_branches, first, std::min( first + sliceSize, a_last ), a_axis + 1 );
+}
+
+
 RTREE_TEMPLATE
 bool RTREE_QUAL::Load( const char* a_fileName )
 {